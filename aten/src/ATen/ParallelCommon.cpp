@@ -70,6 +70,10 @@ std::string get_parallel_info() {
      << get_env_var("OMP_NUM_THREADS", "[not set]") << std::endl;
   ss << "\tMKL_NUM_THREADS : "
      << get_env_var("MKL_NUM_THREADS", "[not set]") << std::endl;
+  ss << "\tPYTORCH_INTRAOP_WORK_STEALING : "
+     << get_env_var("PYTORCH_INTRAOP_WORK_STEALING", "[not set]") << std::endl;
+  ss << "\tPYTORCH_CPU_NUMA : "
+     << get_env_var("PYTORCH_CPU_NUMA", "[not set]") << std::endl;
 
   ss << "ATen parallel backend: ";
   #if AT_PARALLEL_OPENMP
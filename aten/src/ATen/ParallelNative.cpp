@@ -5,11 +5,15 @@
 
 #ifndef C10_MOBILE
 #include <c10/core/thread_pool.h>
+#include <c10/util/numa.h>
 #else
 #include <caffe2/utils/threadpool/pthreadpool-cpp.h>
 #endif // C10_MOBILE
 
 #include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -55,6 +59,22 @@ const int CONSUMED = -2;
 //  - CONSUMED - pool is initialized
 std::atomic<int> num_intraop_threads{NOT_SET};
 
+// With NUMA enabled there is one intra-op pool per NUMA node, whose threads
+// are bound to the node. A parallel region runs on the pool of the node the
+// calling thread is on, so that its tasks work on node-local memory, and
+// get_num_threads() is the number of threads of one node.
+int _num_intraop_pools() {
+  static const int num_pools =
+      c10::IsNUMAEnabled() ? std::max(c10::GetNumNUMANodes(), 1) : 1;
+  return num_pools;
+}
+
+// Number of threads a parallel region uses given the total number of
+// intra-op threads.
+int _num_region_threads(int nthreads) {
+  return std::max(nthreads / _num_intraop_pools(), 1);
+}
+
 int _num_pool_threads(int nthreads) {
   if (nthreads == NOT_SET) {
     nthreads = intraop_default_num_threads();
@@ -62,17 +82,60 @@ int _num_pool_threads(int nthreads) {
     TORCH_INTERNAL_ASSERT(nthreads > 0);
   }
   // minus one because of the master thread
-  return nthreads - 1;
+  return _num_region_threads(nthreads) - 1;
 }
 
-TaskThreadPoolBase& _get_intraop_pool() {
-  static std::shared_ptr<TaskThreadPoolBase> pool =
-      ThreadPoolRegistry()->Create(
-          "C10",
+// Intra-op tasks run on the work-stealing pool unless
+// PYTORCH_INTRAOP_WORK_STEALING=0, which selects the FIFO c10::ThreadPool.
+bool _use_work_stealing_pool() {
+  const char* value = std::getenv("PYTORCH_INTRAOP_WORK_STEALING");
+  return !(value && std::strcmp(value, "0") == 0);
+}
+
+std::vector<std::shared_ptr<TaskThreadPoolBase>>& _get_intraop_pools() {
+  static std::vector<std::shared_ptr<TaskThreadPoolBase>> pools = []() {
+    const int pool_size =
+        _num_pool_threads(num_intraop_threads.exchange(CONSUMED));
+    std::vector<std::shared_ptr<TaskThreadPoolBase>> pools;
+    if (_num_intraop_pools() == 1) {
+      // create a separate thread pool for intra-op
+      pools.push_back(ThreadPoolRegistry()->Create(
+          _use_work_stealing_pool() ? "C10WorkStealing" : "C10",
           /* device_id */ 0,
-          /* pool_size */ _num_pool_threads(num_intraop_threads.exchange(CONSUMED)),
-          /* create_new */ true); // create a separate thread pool for intra-op
-  return *pool;
+          /* pool_size */ pool_size,
+          /* create_new */ true));
+    } else {
+      for (int node = 0; node < _num_intraop_pools(); ++node) {
+        if (_use_work_stealing_pool()) {
+          pools.push_back(
+              std::make_shared<PTWorkStealingThreadPool>(pool_size, node));
+        } else {
+          pools.push_back(std::make_shared<PTThreadPool>(pool_size, node));
+        }
+      }
+    }
+    return pools;
+  }();
+  return pools;
+}
+
+// Pool of the NUMA node the current thread runs on.
+TaskThreadPoolBase& _get_intraop_pool() {
+  auto& pools = _get_intraop_pools();
+  if (pools.size() == 1) {
+    return *pools[0];
+  }
+  return *pools[internal::_intraop_pool_index(
+      c10::GetCurrentNUMANode(), pools.size())];
+}
+
+bool _in_intraop_pool() {
+  for (const auto& pool : _get_intraop_pools()) {
+    if (pool->inThreadPool()) {
+      return true;
+    }
+  }
+  return false;
 }
 
 #endif // C10_MOBILE
@@ -81,8 +144,9 @@ TaskThreadPoolBase& _get_intraop_pool() {
 // `fn` will be called with params: (thread_pool_task_id, task_id).
 void _run_with_pool(const std::function<void(int, size_t)>& fn, size_t range) {
 #ifndef C10_MOBILE
+  TaskThreadPoolBase& pool = _get_intraop_pool();
   for (size_t i = 1; i < range; ++i) {
-    _get_intraop_pool().run([fn, i]() { fn((int)i, i); });
+    pool.run([fn, i]() { fn((int)i, i); });
   }
   // Run the first task on the current thread directly.
   fn(0, 0);
@@ -116,6 +180,13 @@ struct ParallelRegionGuard {
 
 namespace internal {
 
+size_t _intraop_pool_index(int numa_node, size_t num_pools) {
+  if (numa_node < 0 || static_cast<size_t>(numa_node) >= num_pools) {
+    return 0;
+  }
+  return numa_node;
+}
+
 void _parallel_run(
   const int64_t begin,
   const int64_t end,
@@ -126,26 +197,38 @@ void _parallel_run(
   size_t num_tasks, chunk_size;
   std::tie(num_tasks, chunk_size) =
       internal::calc_num_tasks_and_chunk_size(begin, end, grain_size);
+  // Each worker claims tasks until none are left, so a worker that got
+  // cheap tasks takes over the rest of the work of the slower ones.
+  const size_t num_workers =
+      std::min(num_tasks, static_cast<size_t>(get_num_threads()));
 
   struct {
     std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
     std::exception_ptr eptr;
+    std::atomic<size_t> next_task{0};
     std::mutex mutex;
     volatile size_t remaining;
     std::condition_variable cv;
   } state;
 
-  auto task = [f, &state, begin, end, chunk_size]
-      (int /* unused */, size_t task_id) {
-    int64_t local_start = begin + task_id * chunk_size;
-    if (local_start < end) {
-      int64_t local_end = std::min(end, (int64_t)(chunk_size + local_start));
-      try {
-        ParallelRegionGuard guard(task_id);
-        f(local_start, local_end, task_id);
-      } catch (...) {
-        if (!state.err_flag.test_and_set()) {
-          state.eptr = std::current_exception();
+  auto task = [f, &state, begin, end, chunk_size, num_tasks]
+      (int /* unused */, size_t worker_id) {
+    {
+      // get_thread_num() is the worker id, so that it stays below
+      // get_num_threads() and identifies one thread at a time.
+      ParallelRegionGuard guard(worker_id);
+      for (size_t task_id = state.next_task++; task_id < num_tasks;
+           task_id = state.next_task++) {
+        int64_t local_start = begin + task_id * chunk_size;
+        int64_t local_end = std::min(end, (int64_t)(chunk_size + local_start));
+        try {
+          f(local_start, local_end, task_id);
+        } catch (...) {
+          if (!state.err_flag.test_and_set()) {
+            state.eptr = std::current_exception();
+          }
+          // skip the tasks that have not started yet
+          state.next_task = num_tasks;
         }
       }
     }
@@ -156,8 +239,8 @@ void _parallel_run(
       }
     }
   };
-  state.remaining = num_tasks;
-  _run_with_pool(task, num_tasks);
+  state.remaining = num_workers;
+  _run_with_pool(task, num_workers);
 
   // Wait for all tasks to finish.
   {
@@ -195,11 +278,13 @@ void set_num_threads(int nthreads) {
     // num_intraop_threads either stores a positive integer or CONSUMED,
     // check that requested size is the same as the current one
     int stored_nthreads = num_intraop_threads.load();
-    if (stored_nthreads <= 0) {
+    if (stored_nthreads > 0) {
+      stored_nthreads = _num_region_threads(stored_nthreads);
+    } else {
       // plus one because of master thread
       stored_nthreads = _get_intraop_pool().size() + 1;
     }
-    if (stored_nthreads != nthreads) {
+    if (stored_nthreads != _num_region_threads(nthreads)) {
       TORCH_WARN(
         "Cannot set number of intraop threads "
         "after parallel work has started or after set_num_threads call "
@@ -219,9 +304,9 @@ int get_num_threads() {
   // because pool cannot be resized after initialization
   int nthreads = num_intraop_threads.load();
   if (nthreads > 0) {
-    return nthreads;
+    return _num_region_threads(nthreads);
   } else if (nthreads == NOT_SET) {
-    return intraop_default_num_threads();
+    return _num_region_threads(intraop_default_num_threads());
   } else {
     TORCH_INTERNAL_ASSERT(nthreads == CONSUMED);
     return _get_intraop_pool().size() + 1;
@@ -242,7 +327,7 @@ bool in_parallel_region() {
   return in_parallel_region_ || (
     num_intraop_threads.load() == CONSUMED &&
     // Needed as intraop_launch() doesn't set in_parallel_region().
-    _get_intraop_pool().inThreadPool()
+    _in_intraop_pool()
   );
 #else
   return in_parallel_region_;
@@ -9,19 +9,31 @@
 namespace at {
 namespace internal {
 
+// Number of tasks per thread a parallel region is split into. Tasks are not
+// bound to threads: threads that are done pick up the remaining tasks, so
+// splitting the range more finely than the number of threads evens out
+// tasks of uneven cost.
+constexpr int64_t TASKS_PER_THREAD = 4;
+
 inline std::tuple<size_t, size_t> calc_num_tasks_and_chunk_size(
     int64_t begin, int64_t end, int64_t grain_size) {
   if ((end - begin) < grain_size) {
     return std::make_tuple(1, std::max((int64_t)0, end - begin));
   }
   // Choose number of tasks based on grain size and number of threads.
-  size_t chunk_size = divup((end - begin), get_num_threads());
+  size_t chunk_size = divup((end - begin), get_num_threads() * TASKS_PER_THREAD);
   // Make sure each task is at least grain_size size.
   chunk_size = std::max((size_t)grain_size, chunk_size);
   size_t num_tasks = divup((end - begin), chunk_size);
   return std::make_tuple(num_tasks, chunk_size);
 }
 
+// Index of the intra-op pool used by a parallel region started on NUMA node
+// `numa_node`, out of `num_pools` pools (one per node with NUMA enabled, a
+// single one otherwise). Falls back to the first pool when the node is
+// unknown (-1) or has no pool of its own.
+CAFFE2_API size_t _intraop_pool_index(int numa_node, size_t num_pools);
+
 CAFFE2_API void _parallel_run(
   const int64_t begin,
   const int64_t end,
@@ -43,9 +43,24 @@ std::shared_ptr<TaskThreadPoolBase> create_c10_threadpool(
   return std::make_shared<PTThreadPool>(pool_size);
 }
 
+std::shared_ptr<TaskThreadPoolBase> create_c10_work_stealing_threadpool(
+    int device_id,
+    int pool_size,
+    bool create_new) {
+  // For now, the only accepted device id is 0
+  TORCH_CHECK(device_id == 0);
+  // Create new thread pool
+  TORCH_CHECK(create_new);
+  return std::make_shared<PTWorkStealingThreadPool>(pool_size);
+}
+
 } // namespace
 
 C10_REGISTER_CREATOR(ThreadPoolRegistry, C10, create_c10_threadpool);
+C10_REGISTER_CREATOR(
+    ThreadPoolRegistry,
+    C10WorkStealing,
+    create_c10_work_stealing_threadpool);
 
 void set_num_interop_threads(int nthreads) {
   TORCH_CHECK(nthreads > 0, "Expected positive number of threads");
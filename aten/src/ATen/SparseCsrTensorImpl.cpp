@@ -0,0 +1,98 @@
+#include <ATen/ATen.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/InitialTensorOptions.h>
+#include <ATen/core/LegacyTypeDispatch.h>
+
+namespace at {
+
+namespace {
+  DeviceType sparseCsrTensorSetToDeviceType(DispatchKeySet key_set) {
+    if (key_set.has(DispatchKey::SparseCsrCPU)) {
+      return kCPU;
+    } else {
+      AT_ERROR("Cannot construct SparseCsrTensor with non-sparse tensor type ID ", key_set);
+    }
+  }
+}
+
+// An empty CSR tensor is a [0, 0] matrix: no rows, so crow_indices holds the
+// single leading zero, and no specified elements.
+SparseCsrTensorImpl::SparseCsrTensorImpl(at::DispatchKeySet key_set, const caffe2::TypeMeta& data_type)
+  :   SparseCsrTensorImpl(key_set, data_type
+      , at::zeros({1}, at::initialTensorOptions().device(sparseCsrTensorSetToDeviceType(key_set)).dtype(ScalarType::Long))
+      , at::empty({0}, at::initialTensorOptions().device(sparseCsrTensorSetToDeviceType(key_set)).dtype(ScalarType::Long))
+      , at::empty({0}, at::initialTensorOptions().device(sparseCsrTensorSetToDeviceType(key_set)).dtype(data_type))) {}
+
+SparseCsrTensorImpl::SparseCsrTensorImpl(
+    at::DispatchKeySet key_set,
+    const caffe2::TypeMeta& data_type,
+    at::Tensor crow_indices,
+    at::Tensor col_indices,
+    at::Tensor values)
+    : TensorImpl(key_set, data_type, values.device()),
+      crow_indices_(std::move(crow_indices)),
+      col_indices_(std::move(col_indices)),
+      values_(std::move(values)) {
+  sizes_ = {0, 0};
+  refresh_numel();
+}
+
+void SparseCsrTensorImpl::resize_and_clear_(int64_t nnz_size, IntArrayRef size) {
+  TORCH_CHECK(allow_tensor_metadata_change(), "resize_and_clear_ ", err_msg_tensor_metadata_change_not_allowed);
+  TORCH_CHECK(size.size() == 2, "sparse CSR tensors must be 2-dimensional, but got size ", size);
+  TORCH_CHECK(nnz_size >= 0, "nnz must be non-negative, but got ", nnz_size);
+
+  crow_indices_ = at::zeros({size[0] + 1}, crow_indices_.options());
+  col_indices_ = at::empty({nnz_size}, col_indices_.options());
+  values_ = at::empty({nnz_size}, values_.options());
+  sizes_ = size.vec();
+  refresh_numel();
+}
+
+void SparseCsrTensorImpl::set_member_tensors(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    IntArrayRef size) {
+  TORCH_CHECK(allow_tensor_metadata_change(), "set_member_tensors ", err_msg_tensor_metadata_change_not_allowed);
+  TORCH_CHECK(size.size() == 2, "sparse CSR tensors must be 2-dimensional, but got size ", size);
+  TORCH_CHECK(values.scalar_type() == typeMetaToScalarType(dtype()), "dtype of values (", values.scalar_type(), ") must match dtype of sparse tensor (", typeMetaToScalarType(dtype()), ")");
+  TORCH_CHECK(values.device() == device(), "device of values (", values.device(), ") must match device of sparse tensor (", device(), ")");
+
+  crow_indices_ = crow_indices;
+  col_indices_ = col_indices;
+  values_ = values;
+  sizes_ = size.vec();
+  refresh_numel();
+}
+
+IntArrayRef SparseCsrTensorImpl::strides() const {
+  AT_ERROR("sparse CSR tensors do not have strides");
+}
+bool SparseCsrTensorImpl::is_contiguous(at::MemoryFormat memory_format) const {
+  AT_ERROR("sparse CSR tensors do not have is_contiguous");
+}
+int64_t SparseCsrTensorImpl::stride(int64_t d) const {
+  AT_ERROR("sparse CSR tensors do not have strides");
+}
+void SparseCsrTensorImpl::set_size(int64_t dim, int64_t new_size) {
+  AT_ERROR("sparse CSR tensors do not have set_size");
+}
+void SparseCsrTensorImpl::set_stride(int64_t dim, int64_t new_stride) {
+  AT_ERROR("sparse CSR tensors do not have set_stride");
+}
+void SparseCsrTensorImpl::set_storage_offset(int64_t storage_offset) {
+  AT_ERROR("sparse CSR tensors do not have set_storage_offset");
+}
+
+bool SparseCsrTensorImpl::has_storage() const {
+  return false;
+}
+const Storage& SparseCsrTensorImpl::storage() const {
+  AT_ERROR("sparse CSR tensors do not have storage");
+}
+int64_t SparseCsrTensorImpl::storage_offset() const {
+  AT_ERROR("sparse CSR tensors do not have storage");
+}
+
+} // namespace at
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/SparseCsrTensorImpl.h>
+
+namespace at { namespace sparse_csr {
+
+// Just for documentary purposes
+using SparseCsrTensor = Tensor;
+
+// This is an internal utility function for getting at the
+// SparseCsrTensorImpl, in the same way as get_sparse_impl does for COO
+// tensors. You should only use this for writing low level setters/getters
+// for SparseCsrTensorImpl fields.
+inline SparseCsrTensorImpl* get_sparse_csr_impl(const SparseCsrTensor& self) {
+  AT_ASSERTM(
+      self.layout() == kSparseCsr,
+      "_internal_get_SparseCsrTensorImpl: not a sparse CSR tensor");
+  return static_cast<SparseCsrTensorImpl*>(self.unsafeGetTensorImpl());
+}
+
+}} // namespace at::sparse_csr
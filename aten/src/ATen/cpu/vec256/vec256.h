@@ -11,6 +11,10 @@
 #include <ATen/cpu/vec256/vec256_bfloat16.h>
 #include <ATen/cpu/vec256/vec256_double.h>
 #include <ATen/cpu/vec256/vec256_int.h>
+#include <ATen/cpu/vec256/vec512_float.h>
+#include <ATen/cpu/vec256/vec512_bfloat16.h>
+#include <ATen/cpu/vec256/vec512_double.h>
+#include <ATen/cpu/vec256/vec512_int.h>
 #include <ATen/cpu/vec256/vec256_qint.h>
 #include <ATen/cpu/vec256/vec256_complex_float.h>
 #include <ATen/cpu/vec256/vec256_complex_double.h>
@@ -230,4 +234,154 @@ inline deinterleave2<float>(const Vec256<float>& a, const Vec256<float>& b) {
 
 #endif // (defined(CPU_CAPABILITY_AVX) || defined(CPU_CAPABILITY_AVX2)) && !defined(_MSC_VER)
 
+#if defined(CPU_CAPABILITY_AVX512) && !defined(_MSC_VER)
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ CAST (AVX512) ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+template<>
+inline Vec256<float> cast<float, double>(const Vec256<double>& src) {
+  return _mm512_castpd_ps(src);
+}
+
+template<>
+inline Vec256<double> cast<double, float>(const Vec256<float>& src) {
+  return _mm512_castps_pd(src);
+}
+
+#define DEFINE_FLOAT_INT_CAST(int_t, float_t, float_ch)            \
+template<>                                                         \
+inline  Vec256<int_t> cast<int_t, float_t>(const Vec256<float_t>& src) {   \
+  return _mm512_castp ## float_ch ## _si512(src);                  \
+}                                                                  \
+template<>                                                         \
+inline Vec256<float_t> cast<float_t, int_t>(const Vec256<int_t>& src) {   \
+  return _mm512_castsi512_p ## float_ch (src);                     \
+}
+
+DEFINE_FLOAT_INT_CAST(int64_t, double, d)
+DEFINE_FLOAT_INT_CAST(int32_t, double, d)
+DEFINE_FLOAT_INT_CAST(int16_t, double, d)
+DEFINE_FLOAT_INT_CAST(int64_t, float, s)
+DEFINE_FLOAT_INT_CAST(int32_t, float, s)
+DEFINE_FLOAT_INT_CAST(int16_t, float, s)
+
+#undef DEFINE_FLOAT_INT_CAST
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ GATHER ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+template<int64_t scale = 1>
+std::enable_if_t<scale == 1 || scale == 2 || scale == 4 || scale == 8, Vec256<double>>
+inline gather(const double* base_addr, const Vec256<int64_t>& vindex) {
+  return _mm512_i64gather_pd(vindex, base_addr, scale);
+}
+
+template<int64_t scale = 1>
+std::enable_if_t<scale == 1 || scale == 2 || scale == 4 || scale == 8, Vec256<float>>
+inline gather(const float* base_addr, const Vec256<int32_t>& vindex) {
+  return _mm512_i32gather_ps(vindex, base_addr, scale);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ MASK GATHER ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// As with AVX2, a lane is gathered if the sign bit of its mask lane is set.
+template<int64_t scale = 1>
+std::enable_if_t<scale == 1 || scale == 2 || scale == 4 || scale == 8, Vec256<double>>
+inline mask_gather(const Vec256<double>& src, const double* base_addr,
+                   const Vec256<int64_t>& vindex, const Vec256<double>& mask) {
+  auto k = _mm512_movepi64_mask(_mm512_castpd_si512(mask));
+  return _mm512_mask_i64gather_pd(src, k, vindex, base_addr, scale);
+}
+
+template<int64_t scale = 1>
+std::enable_if_t<scale == 1 || scale == 2 || scale == 4 || scale == 8, Vec256<float>>
+inline mask_gather(const Vec256<float>& src, const float* base_addr,
+                   const Vec256<int32_t>& vindex, const Vec256<float>& mask) {
+  auto k = _mm512_movepi32_mask(_mm512_castps_si512(mask));
+  return _mm512_mask_i32gather_ps(src, k, vindex, base_addr, scale);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ CONVERT ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// Rounds to nearest like the AVX2 version, but without its range limit.
+template<>
+Vec256<int64_t>
+inline convert_to_int_of_same_size<double>(const Vec256<double> &src) {
+  return _mm512_cvtpd_epi64(src);
+}
+
+template<>
+Vec256<int32_t>
+inline convert_to_int_of_same_size<float>(const Vec256<float> &src) {
+  return _mm512_cvttps_epi32(src);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ INTERLEAVE ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// Unlike AVX2, AVX512 can permute across all lanes of two registers at once,
+// so each output is a single two-source permute.
+
+template <>
+std::pair<Vec256<double>, Vec256<double>>
+inline interleave2<double>(const Vec256<double>& a, const Vec256<double>& b) {
+  // inputs:
+  //   a = {a0, a1, a2, a3, a4, a5, a6, a7}
+  //   b = {b0, b1, b2, b3, b4, b5, b6, b7}
+  // return {a0, b0, a1, b1, a2, b2, a3, b3}
+  //        {a4, b4, a5, b5, a6, b6, a7, b7}
+  const __m512i idx_lo = _mm512_setr_epi64(0, 8, 1, 9, 2, 10, 3, 11);
+  const __m512i idx_hi = _mm512_setr_epi64(4, 12, 5, 13, 6, 14, 7, 15);
+  return std::make_pair(_mm512_permutex2var_pd(a, idx_lo, b),
+                        _mm512_permutex2var_pd(a, idx_hi, b));
+}
+
+template <>
+std::pair<Vec256<float>, Vec256<float>>
+inline interleave2<float>(const Vec256<float>& a, const Vec256<float>& b) {
+  // inputs:
+  //   a = {a0, a1, ..., a15}
+  //   b = {b0, b1, ..., b15}
+  // return {a0, b0, a1, b1, ..., a7, b7}
+  //        {a8, b8, a9, b9, ..., a15, b15}
+  const __m512i idx_lo = _mm512_setr_epi32(
+      0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+  const __m512i idx_hi = _mm512_setr_epi32(
+      8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31);
+  return std::make_pair(_mm512_permutex2var_ps(a, idx_lo, b),
+                        _mm512_permutex2var_ps(a, idx_hi, b));
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ DEINTERLEAVE ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+template <>
+std::pair<Vec256<double>, Vec256<double>>
+inline deinterleave2<double>(const Vec256<double>& a, const Vec256<double>& b) {
+  // inputs:
+  //   a = {a0, b0, a1, b1, a2, b2, a3, b3}
+  //   b = {a4, b4, a5, b5, a6, b6, a7, b7}
+  // return {a0, a1, a2, a3, a4, a5, a6, a7}
+  //        {b0, b1, b2, b3, b4, b5, b6, b7}
+  const __m512i idx_a = _mm512_setr_epi64(0, 2, 4, 6, 8, 10, 12, 14);
+  const __m512i idx_b = _mm512_setr_epi64(1, 3, 5, 7, 9, 11, 13, 15);
+  return std::make_pair(_mm512_permutex2var_pd(a, idx_a, b),
+                        _mm512_permutex2var_pd(a, idx_b, b));
+}
+
+template <>
+std::pair<Vec256<float>, Vec256<float>>
+inline deinterleave2<float>(const Vec256<float>& a, const Vec256<float>& b) {
+  // inputs:
+  //   a = {a0, b0, a1, b1, ..., a7, b7}
+  //   b = {a8, b8, a9, b9, ..., a15, b15}
+  // return {a0, a1, ..., a15}
+  //        {b0, b1, ..., b15}
+  const __m512i idx_a = _mm512_setr_epi32(
+      0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+  const __m512i idx_b = _mm512_setr_epi32(
+      1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+  return std::make_pair(_mm512_permutex2var_ps(a, idx_a, b),
+                        _mm512_permutex2var_ps(a, idx_b, b));
+}
+
+#endif // defined(CPU_CAPABILITY_AVX512) && !defined(_MSC_VER)
+
 }}}
@@ -1048,6 +1048,11 @@ Vec256<c10::quint8> inline maximum(const Vec256<c10::quint8>& a, const Vec256<c1
 //
 // If in the future we relax this requirement (AVX2+), we should probably
 // revisit these implementations
+//
+// They assume 8 floats per Vec256<float>. In AVX512 translation units, where
+// Vec256<float> is wider, they are only good for loads and stores; the
+// quantized kernels themselves are built with AVX2 vectors in that slot (see
+// cmake/Codegen.cmake).
 
 template <
     typename T,
@@ -1092,20 +1097,17 @@ struct Vec256QuantizedConverter {
       Vec256<float> zero_point,
       Vec256<float> scale_zp_premul) const {
     float_vec_return_type rv;
+    float scale_vals[Vec256<float>::size()];
+    float zero_point_vals[Vec256<float>::size()];
+    scale.store(scale_vals);
+    zero_point.store(zero_point_vals);
     for (int i = 0; i < float_num_vecs(); ++i) {
       float tmp_vals[8];
       for (int j = 0; j < 8; ++j) {
         tmp_vals[j] = at::native::dequantize_val<T>(
-            scale[j], zero_point[j], T(vals[8 * i + j]));
+            scale_vals[j], zero_point_vals[j], T(vals[8 * i + j]));
       }
-      rv[i] = Vec256<float>(tmp_vals[0],
-          tmp_vals[1],
-          tmp_vals[2],
-          tmp_vals[3],
-          tmp_vals[4],
-          tmp_vals[5],
-          tmp_vals[6],
-          tmp_vals[7]);
+      rv[i] = Vec256<float>::loadu(tmp_vals, 8);
     }
     return rv;
   }
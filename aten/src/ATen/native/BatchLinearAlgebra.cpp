@@ -5,6 +5,7 @@
 #include <ATen/ExpandUtils.h>
 
 #include <ATen/native/LinearAlgebraUtils.h>
+#include <ATen/native/cpu/BatchLinearAlgebraKernel.h>
 #include <ATen/native/cpu/zmath.h>
 #include <ATen/Parallel.h>
 
@@ -340,9 +341,13 @@ std::tuple<Tensor, Tensor> _solve_helper_cpu(const Tensor& self, const Tensor& A
   auto self_working_copy = cloneBatchedColumnMajor(self);
   auto A_working_copy = cloneBatchedColumnMajor(A);
   std::vector<int64_t> infos(batchCount(self), 0);
-  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "solve_cpu", [&]{
-    apply_solve<scalar_t>(self_working_copy, A_working_copy, infos);
-  });
+  if (use_small_matrix_kernels(A_working_copy)) {
+    small_solve_stub(kCPU, self_working_copy, A_working_copy, infos);
+  } else {
+    AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "solve_cpu", [&]{
+      apply_solve<scalar_t>(self_working_copy, A_working_copy, infos);
+    });
+  }
   if (self.dim() > 2) {
     batchCheckErrors(infos, "solve_cpu");
   } else {
@@ -419,9 +424,13 @@ static void apply_inverse(Tensor& self, std::vector<int64_t>& infos) {
 Tensor _inverse_helper_cpu(const Tensor& self) {
   std::vector<int64_t> infos(batchCount(self), 0);
   auto self_working_copy = cloneBatchedColumnMajor(self);
-  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "inverse_cpu", [&]{
-    apply_inverse<scalar_t>(self_working_copy, infos);
-  });
+  if (use_small_matrix_kernels(self_working_copy)) {
+    small_inverse_stub(kCPU, self_working_copy, infos);
+  } else {
+    AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "inverse_cpu", [&]{
+      apply_inverse<scalar_t>(self_working_copy, infos);
+    });
+  }
   if (self.dim() > 2) {
     batchCheckErrors(infos, "inverse_cpu");
   } else {
@@ -538,9 +547,13 @@ static void apply_cholesky(Tensor& self, bool upper, std::vector<int64_t>& infos
 Tensor _cholesky_helper_cpu(const Tensor& self, bool upper) {
   std::vector<int64_t> infos(batchCount(self), 0);
   auto self_working_copy = cloneBatchedColumnMajor(self);
-  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "cholesky_cpu", [&]{
-    apply_cholesky<scalar_t>(self_working_copy, upper, infos);
-  });
+  if (use_small_matrix_kernels(self_working_copy)) {
+    small_cholesky_stub(kCPU, self_working_copy, upper, infos);
+  } else {
+    AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "cholesky_cpu", [&]{
+      apply_cholesky<scalar_t>(self_working_copy, upper, infos);
+    });
+  }
   if (self.dim() > 2) {
     batchCheckErrors(infos, "cholesky_cpu");
   } else {
@@ -615,9 +628,13 @@ std::tuple<Tensor, Tensor, Tensor> _lu_with_info_cpu(const Tensor& self, bool pi
     self_working_copy = at::empty_like(self, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   } else {
     self_working_copy = cloneBatchedColumnMajor(self);
-    AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "lu_cpu", [&]{
-      apply_lu<scalar_t>(self_working_copy, pivots_tensor, infos_tensor);
-    });
+    if (use_small_matrix_kernels(self_working_copy)) {
+      small_lu_stub(kCPU, self_working_copy, pivots_tensor, infos_tensor);
+    } else {
+      AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "lu_cpu", [&]{
+        apply_lu<scalar_t>(self_working_copy, pivots_tensor, infos_tensor);
+      });
+    }
   }
   if (check_errors) {
     if (self.dim() > 2) {
@@ -1144,4 +1161,9 @@ Tensor& lu_solve_out(Tensor& result, const Tensor& self, const Tensor& LU_data,
   return result;
 }
 
+DEFINE_DISPATCH(small_solve_stub);
+DEFINE_DISPATCH(small_inverse_stub);
+DEFINE_DISPATCH(small_cholesky_stub);
+DEFINE_DISPATCH(small_lu_stub);
+
 }}  // namespace at::native
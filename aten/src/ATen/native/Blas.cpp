@@ -77,7 +77,9 @@ Tensor &addmv_out(Tensor& result, const Tensor &self, const Tensor &mat, const T
 }
 
 Tensor addmv(const Tensor &self, const Tensor &mat, const Tensor &vec, Scalar beta, Scalar alpha) {
-  Tensor result = at::empty({mat.size(0)}, mat.options());
+  // vec, not mat, gives the options: the result is strided even when mat is
+  // sparse.
+  Tensor result = at::empty({mat.size(0)}, vec.options());
   return native::addmv_out(result, self, mat, vec, beta, alpha);
 }
 
@@ -90,7 +92,7 @@ Tensor &mv_out(Tensor& result, const Tensor &self, const Tensor &vec) {
 }
 
 Tensor mv(const Tensor &self, const Tensor &vec) {
-  Tensor result = at::empty({self.size(0)}, self.options());
+  Tensor result = at::empty({self.size(0)}, vec.options());
   return native::mv_out(result, self, vec);
 }
 
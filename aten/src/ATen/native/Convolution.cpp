@@ -1,6 +1,7 @@
 #include <limits>
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/native/cpu/ConvChannelsLastKernel.h>
 #include <ATen/native/cpu/DepthwiseConvKernel.h>
 #include <ATen/native/utils/ParamUtils.h>
 #include <ATen/native/ConvUtils.h>
@@ -43,6 +44,7 @@ struct ConvParams {
   bool is_stride_nonpos() const;
   void view1d_as_2d();
   bool use_cpu_depthwise3x3_winograd(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
+  bool use_cpu_channels_last(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
   bool needs_64bit_indexing_no_split(const at::Tensor& input, const at::Tensor& weight) const;
   bool use_cudnn(const at::Tensor& input, const at::Tensor& weight) const;
   bool use_cudnn_depthwise(const at::Tensor& input, const at::Tensor& weight) const;
@@ -163,6 +165,27 @@ auto ConvParams::use_cpu_depthwise3x3_winograd(
 #endif
 }
 
+// Channels last inputs that no other CPU backend takes go through the direct
+// NHWC kernel (see [Note channels last convolution]) rather than being
+// converted to NCHW for slow_conv2d and back.
+auto ConvParams::use_cpu_channels_last(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const at::Tensor& bias) const -> bool {
+  return (input.device().type() == c10::DeviceType::CPU) &&
+         !input.is_mkldnn() &&
+         (input.ndimension() == 4) &&
+         (input.scalar_type() == at::kFloat || input.scalar_type() == at::kDouble) &&
+         (weight.device().type() == c10::DeviceType::CPU) &&
+         (weight.scalar_type() == input.scalar_type()) &&
+         (weight.ndimension() == 4) &&
+         (!bias.defined() ||
+            ((bias.device().type() == c10::DeviceType::CPU) &&
+             (bias.scalar_type() == input.scalar_type()))) &&
+         (input.suggest_memory_format() == at::MemoryFormat::ChannelsLast) &&
+         !transposed;
+}
+
 auto ConvParams::needs_64bit_indexing_no_split(const at::Tensor& input, const at::Tensor& weight) const -> bool {
   constexpr int64_t int_max = std::numeric_limits<int>::max();
   int64_t numel_input = input.numel();
@@ -776,6 +799,9 @@ at::Tensor _convolution(
         params.stride,
         params.padding,
         params.groups);
+  } else if (params.use_cpu_channels_last(input, weight, bias)) {
+    output = at::_conv2d_channels_last(
+        input, weight, bias, params.stride, params.padding, params.dilation, params.groups);
   } else if (
         !params.transposed && (input.ndimension() == 5) &&
         (input.device().type() == c10::DeviceType::CPU) &&
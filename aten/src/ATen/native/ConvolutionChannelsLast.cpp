@@ -0,0 +1,58 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/ConvUtils.h>
+#include <ATen/native/cpu/ConvChannelsLastKernel.h>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(conv2d_channels_last_stub);
+
+// Direct convolution of channels last inputs, see
+// [Note channels last convolution]. The output is channels last as well.
+Tensor conv2d_channels_last_cpu(
+    const Tensor& self,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups) {
+  TORCH_CHECK(self.dim() == 4, "_conv2d_channels_last: expected a 4D input, got ", self.dim(), "D");
+  TORCH_CHECK(weight.dim() == 4, "_conv2d_channels_last: expected a 4D weight, got ", weight.dim(), "D");
+  TORCH_CHECK(self.scalar_type() == weight.scalar_type(),
+      "_conv2d_channels_last: expected input and weight to have the same dtype, got ",
+      self.scalar_type(), " and ", weight.scalar_type());
+  TORCH_CHECK(groups > 0, "_conv2d_channels_last: non-positive groups is not supported");
+  TORCH_CHECK(self.size(1) == weight.size(1) * groups && weight.size(0) % groups == 0,
+      "_conv2d_channels_last: input of size ", self.sizes(), " and weight of size ",
+      weight.sizes(), " don't match for ", groups, " groups");
+  TORCH_CHECK(!bias.defined() || (bias.dim() == 1 && bias.size(0) == weight.size(0) &&
+                                  bias.scalar_type() == self.scalar_type()),
+      "_conv2d_channels_last: expected a bias of size ", weight.size(0), " and dtype ", self.scalar_type());
+  TORCH_CHECK(stride.size() == 2 && padding.size() == 2 && dilation.size() == 2,
+      "_conv2d_channels_last: expected 2 stride, padding and dilation values");
+
+  auto output_size = conv_output_size(self.sizes(), weight.sizes(), padding, stride, dilation);
+  TORCH_CHECK(output_size[2] > 0 && output_size[3] > 0,
+      "_conv2d_channels_last: calculated output size ", IntArrayRef(output_size), " is too small");
+  Tensor output = at::empty(output_size, self.options().memory_format(MemoryFormat::ChannelsLast));
+  if (output.numel() == 0) {
+    return output;
+  }
+
+  conv2d_channels_last_stub(
+      kCPU,
+      output,
+      self.contiguous(MemoryFormat::ChannelsLast),
+      weight.contiguous(),
+      bias.defined() ? bias.contiguous() : bias,
+      stride,
+      padding,
+      dilation,
+      groups);
+  return output;
+}
+
+}  // namespace native
+}  // namespace at
@@ -13,5 +13,12 @@ using copy_fn = void (*)(TensorIterator&, bool non_blocking);
 
 DECLARE_DISPATCH(copy_fn, copy_stub);
 
+// Copies src into self when both have the same sizes and dtype but different
+// innermost (unit stride) dimensions, i.e. the copy permutes axes, as in
+// .contiguous() after permute() or NCHW <-> NHWC conversions.
+using copy_permute_fn = void (*)(Tensor& self, const Tensor& src);
+
+DECLARE_DISPATCH(copy_permute_fn, copy_permute_stub);
+
 } // namespace native
 } // namespace at
@@ -3,6 +3,7 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/NamedTensorUtils.h>
 #include <ATen/ExpandUtils.h>
+#include <ATen/core/grad_mode.h>
 #include <ATen/native/Distance.h>
 
 namespace at { namespace native {
@@ -11,6 +12,7 @@ DEFINE_DISPATCH(pdist_forward_stub);
 DEFINE_DISPATCH(pdist_backward_stub);
 DEFINE_DISPATCH(cdist_stub);
 DEFINE_DISPATCH(cdist_backward_stub);
+DEFINE_DISPATCH(cdist_topk_stub);
 
 Tensor pairwise_distance(const Tensor& x1, const Tensor& x2, double p, double eps, bool keepdim) {
   return at::norm(x1 - x2 + eps, p, 1, keepdim);
@@ -153,6 +155,64 @@ Tensor _cdist_backward(const Tensor& grad, const Tensor& x1, const Tensor& x2, c
   return grad_x1;
 }
 
+static void check_cdist_topk_inputs(const Tensor& x1, const Tensor& x2, int64_t k, const double p) {
+  TORCH_CHECK(x1.dim() == 2, "cdist_topk only supports 2D tensors, X1 got: ", x1.dim(), "D");
+  TORCH_CHECK(x2.dim() == 2, "cdist_topk only supports 2D tensors, X2 got: ", x2.dim(), "D");
+  TORCH_CHECK(x1.size(1) == x2.size(1), "X1 and X2 must have the same number of columns. X1: ", x1.size(1), " X2: ", x2.size(1));
+  TORCH_CHECK(at::isFloatingType(x1.scalar_type()), "cdist_topk only supports floating-point dtypes, X1 got: ", x1.scalar_type());
+  TORCH_CHECK(x1.scalar_type() == x2.scalar_type(), "X1 and X2 must have the same dtype. X1: ", x1.scalar_type(), " X2: ", x2.scalar_type());
+  TORCH_CHECK(x1.device() == x2.device(), "X1 and X2 must be on the same device. X1: ", x1.device(), " X2: ", x2.device());
+  TORCH_CHECK(p >= 0, "cdist_topk only supports non-negative p values");
+  TORCH_CHECK(k >= 0 && k <= x2.size(0), "cdist_topk: k (", k, ") must be between 0 and the number of rows of X2 (", x2.size(0), ")");
+}
+
+// Distances from every row of x1 to the given rows of x2, differentiably
+static Tensor cdist_topk_gather(const Tensor& x1, const Tensor& x2, const Tensor& indices, const double p, bool cosine) {
+  Tensor neighbours = x2.index_select(0, indices.reshape(-1)).view({indices.size(0), indices.size(1), x2.size(1)});
+  if (cosine) {
+    return at::rsub(at::cosine_similarity(x1.unsqueeze(1), neighbours, 2), 1);
+  }
+  return at::norm(x1.unsqueeze(1) - neighbours, p, 2);
+}
+
+// The k smallest distances of cdist(x1, x2, p) (or 1 - cosine similarity)
+// along each row, with their indices. On CPU the distance matrix is never
+// materialized, see [Note cdist topk]; the distances of the selected
+// neighbours are recomputed when a gradient is needed.
+std::tuple<Tensor, Tensor> cdist_topk(const Tensor& x1, const Tensor& x2, int64_t k, const double p, bool cosine) {
+  check_cdist_topk_inputs(x1, x2, k, p);
+  if (x1.device().type() != kCPU) {
+    Tensor dist = cosine
+        ? at::rsub(at::cosine_similarity(x1.unsqueeze(1), x2.unsqueeze(0), 2), 1)
+        : at::cdist(x1, x2, p);
+    return dist.topk(k, -1, /*largest=*/false, /*sorted=*/true);
+  }
+  Tensor values, indices;
+  std::tie(values, indices) = at::_cdist_topk(x1, x2, k, p, cosine);
+  if (at::GradMode::is_enabled() && (x1.requires_grad() || x2.requires_grad())) {
+    values = cdist_topk_gather(x1, x2, indices, p, cosine);
+  }
+  return std::make_tuple(values, indices);
+}
+
+std::tuple<Tensor, Tensor> _cdist_topk_cpu(const Tensor& x1, const Tensor& x2, int64_t k, const double p, bool cosine) {
+  check_cdist_topk_inputs(x1, x2, k, p);
+  const int64_t r1 = x1.size(0);
+  Tensor values = at::empty({r1, k}, x1.options());
+  Tensor indices = at::empty({r1, k}, x1.options().dtype(kLong));
+  if (r1 == 0 || k == 0) {
+    return std::make_tuple(values, indices);
+  }
+  if (x1.size(1) == 0) {
+    // All distances are zero (cosine distances are one); ties go to the lower index
+    values.fill_(cosine ? 1 : 0);
+    indices.copy_(at::arange(k, indices.options()).expand({r1, k}));
+    return std::make_tuple(values, indices);
+  }
+  cdist_topk_stub(kCPU, values, indices, x1.contiguous(), x2.contiguous(), p, cosine);
+  return std::make_tuple(values, indices);
+}
+
 Tensor _pdist_forward(const Tensor& self, const double p) {
   TORCH_CHECK(self.is_contiguous(), "_pdist_forward requires contiguous input");
   auto device = self.device().type();
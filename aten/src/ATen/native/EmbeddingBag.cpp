@@ -2,6 +2,8 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
+#include <ATen/core/grad_mode.h>
+#include <ATen/native/EmbeddingBag.h>
 
 #include <TH/THBlasUtils.h>
 
@@ -879,5 +881,302 @@ Tensor _embedding_bag_sparse_backward(
   return native::embedding_backward(index_grad, indices, num_weights, -1,
                                     scale_grad_by_freq, true);
 }
+
+DEFINE_DISPATCH(embedding_bag_grouped_stub);
+
+// Reduces the bags of several embedding tables at once. The fused kernel
+// handles every table in a single parallel region and does not materialize
+// offset2bag; it does not record anything for autograd, so calls that need
+// gradients (or run on other devices) go through embedding_bag table by
+// table instead.
+std::vector<Tensor> embedding_bag_grouped(
+    TensorList weights,
+    TensorList indices,
+    TensorList offsets,
+    TensorList per_sample_weights,
+    int64_t mode,
+    bool include_last_offset) {
+  TORCH_CHECK(indices.size() == weights.size() && offsets.size() == weights.size(),
+      "embedding_bag_grouped: expected as many indices and offsets as weights, but got ",
+      weights.size(), " weights, ", indices.size(), " indices and ", offsets.size(), " offsets");
+  TORCH_CHECK(per_sample_weights.empty() || per_sample_weights.size() == weights.size(),
+      "embedding_bag_grouped: expected per_sample_weights to be empty or to have one tensor "
+      "per table, but got ", per_sample_weights.size(), " for ", weights.size(), " tables");
+
+  auto needs_unfused = [](const Tensor& t) {
+    return !t.device().is_cpu() || (at::GradMode::is_enabled() && t.requires_grad());
+  };
+  if (std::none_of(weights.begin(), weights.end(), needs_unfused) &&
+      std::none_of(per_sample_weights.begin(), per_sample_weights.end(), needs_unfused)) {
+    return at::_embedding_bag_grouped_forward_only(
+        weights, indices, offsets, per_sample_weights, mode, include_last_offset);
+  }
+
+  std::vector<Tensor> output;
+  output.reserve(weights.size());
+  for (size_t i = 0; i < weights.size(); i++) {
+    TORCH_CHECK(weights[i].scalar_type() != kByte,
+        "embedding_bag_grouped: 8-bit rowwise weights are only supported on CPU");
+    output.push_back(std::get<0>(at::embedding_bag(
+        weights[i], indices[i], offsets[i], /*scale_grad_by_freq=*/false, mode,
+        /*sparse=*/false, per_sample_weights.empty() ? Tensor() : per_sample_weights[i],
+        include_last_offset)));
+  }
+  return output;
+}
+
+std::vector<Tensor> _embedding_bag_grouped_forward_only_cpu(
+    TensorList weights,
+    TensorList indices,
+    TensorList offsets,
+    TensorList per_sample_weights,
+    int64_t mode,
+    bool include_last_offset) {
+  TORCH_CHECK(mode == MODE_SUM || mode == MODE_MEAN || mode == MODE_MAX,
+      "embedding_bag_grouped: mode has to be 0 (sum), 1 (mean) or 2 (max), but got ", mode);
+  TORCH_CHECK(indices.size() == weights.size() && offsets.size() == weights.size(),
+      "embedding_bag_grouped: expected as many indices and offsets as weights");
+  TORCH_CHECK(per_sample_weights.empty() || per_sample_weights.size() == weights.size(),
+      "embedding_bag_grouped: expected per_sample_weights to be empty or to have one tensor per table");
+  TORCH_CHECK(per_sample_weights.empty() || mode == MODE_SUM,
+      "embedding_bag_grouped: per_sample_weights only supported with mode='sum'");
+
+  const size_t num_tables = weights.size();
+  std::vector<Tensor> weights_(num_tables);
+  std::vector<Tensor> indices_(num_tables);
+  std::vector<Tensor> offsets_(num_tables);
+  std::vector<Tensor> per_sample_weights_(per_sample_weights.size());
+  std::vector<Tensor> output(num_tables);
+
+  for (size_t i = 0; i < num_tables; i++) {
+    const Tensor& weight = weights[i];
+    TORCH_CHECK(weight.dim() == 2,
+        "embedding_bag_grouped: weight of table ", i, " has to be 2-D, but got ", weight.dim(), "-D");
+    TORCH_CHECK(weight.device().is_cpu() && indices[i].device().is_cpu() && offsets[i].device().is_cpu(),
+        "embedding_bag_grouped: expected CPU tensors for table ", i);
+    const ScalarType weight_type = weight.scalar_type();
+    TORCH_CHECK(weight_type == kFloat || weight_type == kDouble || weight_type == kHalf ||
+                weight_type == kBFloat16 || weight_type == kByte,
+        "embedding_bag_grouped: weight of table ", i, " has to be float, double, half, bfloat16 "
+        "or 8-bit rowwise quantized (uint8), but got ", weight_type);
+    // 8-bit rowwise tables store a float scale and bias after every row.
+    const bool byte_rowwise = weight_type == kByte;
+    TORCH_CHECK(!byte_rowwise || weight.size(1) >= 8,
+        "embedding_bag_grouped: 8-bit rowwise weight of table ", i,
+        " has to have at least 8 columns for the scale and bias, but got ", weight.size(1));
+    weights_[i] = weight.stride(1) == 1 ? weight : weight.contiguous();
+
+    TORCH_CHECK(indices[i].dim() == 1 && indices[i].scalar_type() == kLong,
+        "embedding_bag_grouped: indices of table ", i, " have to be a 1-D int64 tensor");
+    TORCH_CHECK(offsets[i].dim() == 1 && offsets[i].scalar_type() == kLong,
+        "embedding_bag_grouped: offsets of table ", i, " have to be a 1-D int64 tensor");
+    indices_[i] = indices[i].contiguous();
+    offsets_[i] = offsets[i].contiguous();
+    const int64_t num_indices = indices_[i].numel();
+    const int64_t num_offsets = offsets_[i].numel();
+    TORCH_CHECK(!include_last_offset || num_offsets >= 1,
+        "include_last_offset: number of offset should be at least 1");
+    const int64_t* offsets_data = offsets_[i].data_ptr<int64_t>();
+    TORCH_CHECK(num_offsets == 0 || offsets_data[0] == 0,
+        "embedding_bag_grouped: offsets[0] of table ", i, " has to be 0, but got ", offsets_data[0]);
+    for (int64_t k = 1; k < num_offsets; k++) {
+      TORCH_CHECK(offsets_data[k - 1] <= offsets_data[k],
+          "embedding_bag_grouped: offsets of table ", i, " have to be non-decreasing");
+    }
+    TORCH_CHECK(num_offsets == 0 || offsets_data[num_offsets - 1] <= num_indices,
+        "embedding_bag_grouped: offsets[-1] of table ", i, " can not be greater than the length ",
+        num_indices, " of its indices, but got ", offsets_data[num_offsets - 1]);
+
+    const ScalarType output_type = byte_rowwise ? kFloat : weight_type;
+    if (!per_sample_weights.empty()) {
+      const Tensor& psw = per_sample_weights[i];
+      TORCH_CHECK(psw.dim() == 1 && psw.numel() == num_indices,
+          "embedding_bag_grouped: per_sample_weights of table ", i,
+          " have to be 1-D with as many elements as its indices");
+      TORCH_CHECK(psw.scalar_type() == output_type,
+          "embedding_bag_grouped: expected per_sample_weights of table ", i, " to have type ",
+          output_type, ", but got ", psw.scalar_type());
+      per_sample_weights_[i] = psw.contiguous();
+    }
+
+    const int64_t num_bags = include_last_offset ? num_offsets - 1 : num_offsets;
+    const int64_t dim = byte_rowwise ? weight.size(1) - 8 : weight.size(1);
+    output[i] = at::empty({num_bags, dim}, weight.options().dtype(output_type));
+  }
+
+  embedding_bag_grouped_stub(
+      kCPU, output, weights_, indices_, offsets_, per_sample_weights_, mode, include_last_offset);
+  return output;
+}
+
+DEFINE_DISPATCH(embedding_bag_backward_update_stub);
+
+namespace {
+
+// Checks the arguments shared by the fused embedding_bag backward + update
+// functions and runs the update. Instead of forming the sparse gradient of
+// weight, indices are stably sorted so that the positions referencing each
+// row are adjacent, and every referenced row is updated once from the rows
+// of grad of its bags.
+void embedding_bag_backward_update_cpu(
+    const char* name,
+    Tensor& weight,
+    Tensor& state1,
+    Tensor& state2,
+    const Tensor& grad,
+    const Tensor& indices,
+    const Tensor& offsets,
+    int64_t mode,
+    const Tensor& per_sample_weights,
+    bool include_last_offset,
+    const EmbeddingBagUpdateOptions& options) {
+  auto indices_arg = TensorArg(indices, "indices", 3);
+  checkScalarType(name, indices_arg, kLong);
+  checkDim(name, indices_arg, 1);
+  auto offsets_arg = TensorArg(offsets, "offsets", 4);
+  checkScalarType(name, offsets_arg, kLong);
+  checkDim(name, offsets_arg, 1);
+  auto weight_arg = TensorArg(weight, "weight", 1);
+  checkScalarTypes(name, weight_arg, {kFloat, kDouble});
+  checkDim(name, weight_arg, 2);
+  auto grad_arg = TensorArg(grad, "grad", 2);
+  checkSameType(name, weight_arg, grad_arg);
+  checkDim(name, grad_arg, 2);
+  TORCH_CHECK(weight.stride(1) == 1,
+      name, ": expected weight to have a unit stride in its last dimension");
+  TORCH_CHECK(mode == MODE_SUM || mode == MODE_MEAN,
+      name, ": only mode sum (0) and mean (1) are supported, but got ", mode);
+
+  const Tensor offsets_ = offsets.contiguous();
+  const int64_t num_offsets = offsets_.numel();
+  const int64_t num_indices = indices.numel();
+  TORCH_CHECK(!include_last_offset || num_offsets >= 1,
+      "include_last_offset: number of offset should be at least 1");
+  const int64_t num_bags = include_last_offset ? num_offsets - 1 : num_offsets;
+  TORCH_CHECK(grad.size(0) == num_bags && grad.size(1) == weight.size(1),
+      name, ": expected grad of size [", num_bags, ", ", weight.size(1), "], but got ", grad.sizes());
+  const int64_t* offsets_data = offsets_.data_ptr<int64_t>();
+  TORCH_CHECK(num_offsets == 0 || offsets_data[0] == 0,
+      name, ": offsets[0] has to be 0, but got ", offsets_data[0]);
+  for (int64_t k = 1; k < num_offsets; k++) {
+    TORCH_CHECK(offsets_data[k - 1] <= offsets_data[k],
+        name, ": offsets have to be non-decreasing");
+  }
+  TORCH_CHECK(num_offsets == 0 || offsets_data[num_offsets - 1] <= num_indices,
+      name, ": offsets[-1] can not be greater than input's length ", num_indices,
+      " but got offsets[-1] of ", offsets_data[num_offsets - 1]);
+
+  Tensor per_sample_weights_;
+  if (per_sample_weights.defined()) {
+    TORCH_CHECK(mode == MODE_SUM,
+        name, ": per_sample_weights only supported with mode='sum'");
+    auto per_sample_weights_arg = TensorArg(per_sample_weights, "per_sample_weights", 6);
+    checkSameType(name, weight_arg, per_sample_weights_arg);
+    TORCH_CHECK(per_sample_weights.dim() == 1 && per_sample_weights.numel() == num_indices,
+        name, ": expected per_sample_weights to be 1-D with as many elements as indices");
+    per_sample_weights_ = per_sample_weights.contiguous();
+  }
+
+  if (num_indices == 0 || weight.numel() == 0) {
+    return;
+  }
+  Tensor sorted_indices, order;
+  std::tie(sorted_indices, order) = at::sort(indices, /*stable=*/true, 0, /*descending=*/false);
+  embedding_bag_backward_update_stub(
+      kCPU, weight, state1, state2, grad.contiguous(), sorted_indices.contiguous(),
+      order.contiguous(), offsets_, per_sample_weights_, mode, include_last_offset, options);
+}
+
+void check_optimizer_state(const char* name, const Tensor& state, const char* state_name,
+                           const Tensor& weight, IntArrayRef expected_size) {
+  TORCH_CHECK(state.scalar_type() == weight.scalar_type() && state.device() == weight.device(),
+      name, ": expected ", state_name, " to have the dtype and device of weight");
+  TORCH_CHECK(state.sizes() == expected_size && state.is_contiguous(),
+      name, ": expected ", state_name, " to be a contiguous tensor of size ", expected_size,
+      ", but got ", state.sizes());
+}
+
+} // anonymous namespace
+
+Tensor& _embedding_bag_backward_sgd_cpu_(
+    Tensor& weight,
+    const Tensor& grad,
+    const Tensor& indices,
+    const Tensor& offsets,
+    int64_t mode,
+    const Tensor& per_sample_weights,
+    bool include_last_offset,
+    double lr,
+    double weight_decay) {
+  EmbeddingBagUpdateOptions options;
+  options.optimizer = EmbeddingBagOptimizer::SGD;
+  options.lr = lr;
+  options.weight_decay = weight_decay;
+  Tensor undefined;
+  embedding_bag_backward_update_cpu(
+      "_embedding_bag_backward_sgd_", weight, undefined, undefined, grad, indices, offsets,
+      mode, per_sample_weights, include_last_offset, options);
+  return weight;
+}
+
+Tensor& _embedding_bag_backward_rowwise_adagrad_cpu_(
+    Tensor& weight,
+    Tensor& momentum,
+    const Tensor& grad,
+    const Tensor& indices,
+    const Tensor& offsets,
+    int64_t mode,
+    const Tensor& per_sample_weights,
+    bool include_last_offset,
+    double lr,
+    double eps,
+    double weight_decay) {
+  const char* name = "_embedding_bag_backward_rowwise_adagrad_";
+  check_optimizer_state(name, momentum, "momentum", weight, {weight.size(0)});
+  EmbeddingBagUpdateOptions options;
+  options.optimizer = EmbeddingBagOptimizer::RowwiseAdagrad;
+  options.lr = lr;
+  options.eps = eps;
+  options.weight_decay = weight_decay;
+  Tensor undefined;
+  embedding_bag_backward_update_cpu(
+      name, weight, momentum, undefined, grad, indices, offsets,
+      mode, per_sample_weights, include_last_offset, options);
+  return weight;
+}
+
+Tensor& _embedding_bag_backward_adam_cpu_(
+    Tensor& weight,
+    Tensor& exp_avg,
+    Tensor& exp_avg_sq,
+    const Tensor& grad,
+    const Tensor& indices,
+    const Tensor& offsets,
+    int64_t mode,
+    const Tensor& per_sample_weights,
+    bool include_last_offset,
+    int64_t step,
+    double lr,
+    double beta1,
+    double beta2,
+    double eps,
+    double weight_decay) {
+  const char* name = "_embedding_bag_backward_adam_";
+  check_optimizer_state(name, exp_avg, "exp_avg", weight, weight.sizes());
+  check_optimizer_state(name, exp_avg_sq, "exp_avg_sq", weight, weight.sizes());
+  TORCH_CHECK(step >= 1, name, ": expected step to be at least 1, but got ", step);
+  EmbeddingBagUpdateOptions options;
+  options.optimizer = EmbeddingBagOptimizer::Adam;
+  options.lr = lr;
+  options.beta1 = beta1;
+  options.beta2 = beta2;
+  options.eps = eps;
+  options.weight_decay = weight_decay;
+  options.step = step;
+  embedding_bag_backward_update_cpu(
+      name, weight, exp_avg, exp_avg_sq, grad, indices, offsets,
+      mode, per_sample_weights, include_last_offset, options);
+  return weight;
+}
 }
 } // namespace at::native
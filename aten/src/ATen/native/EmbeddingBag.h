@@ -0,0 +1,60 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// Reduces the bags of every table of a grouped embedding_bag into output[t].
+// The arguments are validated by _embedding_bag_grouped_forward_only_cpu:
+// indices and offsets are contiguous int64 tensors, every weight has a unit
+// column stride, and per_sample_weights is either empty or holds one
+// contiguous tensor per table.
+using embedding_bag_grouped_fn = void(*)(
+    TensorList output,
+    TensorList weights,
+    TensorList indices,
+    TensorList offsets,
+    TensorList per_sample_weights,
+    int64_t mode,
+    bool include_last_offset);
+
+DECLARE_DISPATCH(embedding_bag_grouped_fn, embedding_bag_grouped_stub);
+
+enum class EmbeddingBagOptimizer { SGD, RowwiseAdagrad, Adam };
+
+// Hyperparameters of the optimizer step fused into the embedding_bag
+// backward. Fields that an optimizer does not use are ignored.
+struct EmbeddingBagUpdateOptions {
+  EmbeddingBagOptimizer optimizer;
+  double lr;
+  double weight_decay;
+  double eps;
+  double beta1;
+  double beta2;
+  int64_t step;
+};
+
+// Applies one optimizer step to every row of weight referenced by indices,
+// using the gradient of embedding_bag (mode sum or mean) w.r.t. that row.
+// sorted_indices and order come from a stable sort of indices, so that the
+// positions referencing the same row are adjacent. state1 and state2 are the
+// optimizer state (the row-wise momentum for RowwiseAdagrad, exp_avg and
+// exp_avg_sq for Adam) and undefined when unused. grad, offsets and
+// per_sample_weights (if defined) are contiguous.
+using embedding_bag_backward_update_fn = void(*)(
+    Tensor& weight,
+    Tensor& state1,
+    Tensor& state2,
+    const Tensor& grad,
+    const Tensor& sorted_indices,
+    const Tensor& order,
+    const Tensor& offsets,
+    const Tensor& per_sample_weights,
+    int64_t mode,
+    bool include_last_offset,
+    const EmbeddingBagUpdateOptions& options);
+
+DECLARE_DISPATCH(embedding_bag_backward_update_fn, embedding_bag_backward_update_stub);
+
+}} // namespace at::native
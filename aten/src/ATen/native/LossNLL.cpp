@@ -3,6 +3,7 @@
 #include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
+#include <ATen/native/cpu/SoftmaxKernel.h>
 
 namespace at {
 namespace native {
@@ -402,6 +403,148 @@ Tensor nll_loss(const Tensor & self, const Tensor & target, const Tensor & weigh
   return std::get<0>(at::nll_loss_forward(self, target, weight, reduction, ignore_index));
 }
 
+namespace {
+
+// See [Note fused cross entropy]; other inputs are handled by
+// log_softmax + nll_loss.
+bool use_fused_cross_entropy(const Tensor& self, const Tensor& target) {
+  return self.device().type() == DeviceType::CPU &&
+      self.layout() == Layout::Strided &&
+      (self.scalar_type() == ScalarType::Float ||
+       self.scalar_type() == ScalarType::Double) &&
+      self.dim() == 2 && target.dim() == 1 &&
+      target.scalar_type() == ScalarType::Long;
+}
+
+void check_cross_entropy_loss_inputs(
+    const Tensor& input,
+    const Tensor& target,
+    const Tensor& weight) {
+  TORCH_CHECK(
+      input.dim() == 2,
+      "cross_entropy_loss: expected 2D input, but got ",
+      input.dim(),
+      "D");
+  TORCH_CHECK(
+      target.dim() == 1,
+      "1D target tensor expected, multi-target not supported");
+  TORCH_CHECK(
+      input.size(0) == target.size(0),
+      "size mismatch (got input: ",
+      input.sizes(),
+      ", target: ",
+      target.sizes(),
+      ")")
+  TORCH_CHECK(
+      !weight.defined() || weight.numel() == input.size(1),
+      "weight tensor should be defined either for all ",
+      input.size(1),
+      " classes or no classes"
+      " but got weight tensor of shape: ",
+      weight.sizes());
+}
+
+} // namespace
+
+std::tuple<Tensor, Tensor, Tensor> cross_entropy_loss_forward_cpu(
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t reduction,
+    int64_t ignore_index) {
+  check_cross_entropy_loss_inputs(self, target, weight);
+  const auto batch_size = self.size(0);
+  auto input = self.contiguous();
+  auto target_contiguous = target.contiguous();
+  auto weight_contiguous = optional_contiguous(weight);
+
+  auto losses = at::empty({batch_size}, input.options());
+  auto row_weights = at::empty({batch_size}, input.options());
+  auto log_sum_exp = at::empty({batch_size}, input.options().dtype(kDouble));
+  cross_entropy_lastdim_kernel(
+      kCPU,
+      losses,
+      row_weights,
+      log_sum_exp,
+      input,
+      target_contiguous,
+      weight_contiguous,
+      ignore_index);
+
+  auto total_weight = row_weights.sum();
+  if (reduction == Reduction::None) {
+    return std::make_tuple(losses, total_weight, log_sum_exp);
+  }
+  auto output = losses.sum();
+  if (reduction == Reduction::Mean &&
+      (total_weight.item<double>() != 0 || input.numel() == 0)) {
+    // allow NaN result for total_weight == 0 case, see nll_loss_out_frame
+    output.div_(total_weight);
+  }
+  return std::make_tuple(output, total_weight, log_sum_exp);
+}
+
+Tensor cross_entropy_loss_backward_cpu(
+    const Tensor& grad_output,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t reduction,
+    int64_t ignore_index,
+    const Tensor& total_weight,
+    const Tensor& log_sum_exp) {
+  check_cross_entropy_loss_inputs(self, target, weight);
+  const auto batch_size = self.size(0);
+  TORCH_CHECK(
+      total_weight.numel() == 1,
+      "expected total_weight to be a single element tensor, got: ",
+      total_weight.sizes());
+  TORCH_CHECK(
+      log_sum_exp.dim() == 1 && log_sum_exp.size(0) == batch_size,
+      "expected log_sum_exp of shape [",
+      batch_size,
+      "], got: ",
+      log_sum_exp.sizes());
+
+  Tensor grad_scale;
+  if (reduction == Reduction::None) {
+    check_dim_size(grad_output, 1, 0, batch_size);
+    grad_scale = grad_output;
+  } else {
+    TORCH_CHECK(
+        grad_output.numel() == 1,
+        "Expected a single element grad_output tensor, but got: ",
+        grad_output.sizes());
+    grad_scale = grad_output.reshape({}).expand({batch_size});
+  }
+  if (reduction == Reduction::Mean) {
+    grad_scale = grad_scale / total_weight;
+  }
+  grad_scale = grad_scale.to(self.scalar_type()).contiguous();
+
+  auto input = self.contiguous();
+  auto grad_input = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  cross_entropy_backward_lastdim_kernel(
+      kCPU,
+      grad_input,
+      grad_scale,
+      input,
+      target.contiguous(),
+      optional_contiguous(weight),
+      log_sum_exp.to(kDouble).contiguous(),
+      ignore_index);
+  return grad_input;
+}
+
+Tensor cross_entropy_loss(const Tensor & self, const Tensor & target, const Tensor & weight, int64_t reduction, int64_t ignore_index) {
+  if (use_fused_cross_entropy(self, target)) {
+    return std::get<0>(at::_cross_entropy_loss_forward(self, target, weight, reduction, ignore_index));
+  }
+  return at::nll_loss(at::log_softmax(self, 1, c10::nullopt), target, weight, reduction, ignore_index);
+}
+
+DEFINE_DISPATCH(cross_entropy_lastdim_kernel);
+DEFINE_DISPATCH(cross_entropy_backward_lastdim_kernel);
 
 } // namespace native
 } // namespace at
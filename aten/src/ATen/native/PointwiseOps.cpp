@@ -92,8 +92,59 @@ Tensor& addcdiv_out(
   return result;
 }
 
+Tensor _fused_pointwise_cpu(
+    const Tensor& self,
+    TensorList operands,
+    IntArrayRef ops,
+    c10::optional<ArrayRef<double>> scalars) {
+  Tensor result = at::empty({0}, self.options());
+  return at::_fused_pointwise_out(result, self, operands, ops, scalars);
+}
+
+Tensor& _fused_pointwise_out_cpu(
+    Tensor& result,
+    const Tensor& self,
+    TensorList operands,
+    IntArrayRef ops,
+    c10::optional<ArrayRef<double>> scalars) {
+  TORCH_CHECK(self.scalar_type() == kFloat || self.scalar_type() == kDouble,
+      "_fused_pointwise: expected a float or double tensor, but got ", self.scalar_type());
+  TORCH_CHECK(!scalars.has_value() || scalars->size() == ops.size(),
+      "_fused_pointwise: expected one scalar per op, but got ", scalars->size(),
+      " scalars for ", ops.size(), " ops");
+  size_t num_tensor_ops = 0;
+  for (int64_t op : ops) {
+    TORCH_CHECK(op >= 0 && op < static_cast<int64_t>(FusedPointwiseOp::NumOps),
+        "_fused_pointwise: unknown op ", op);
+    if (op <= static_cast<int64_t>(FusedPointwiseOp::DivTensor)) {
+      num_tensor_ops++;
+    }
+  }
+  TORCH_CHECK(num_tensor_ops == operands.size(),
+      "_fused_pointwise: expected ", num_tensor_ops, " operands for the tensor ops, but got ",
+      operands.size());
+  std::vector<double> no_scalars;
+  if (!scalars.has_value()) {
+    no_scalars.resize(ops.size(), 0.);
+  }
+
+  checkBackend("_fused_pointwise_cpu", result, self.options().backend());
+  at::TensorIteratorConfig config;
+  config.set_check_mem_overlap(true)
+      .add_output(result)
+      .add_input(self);
+  for (const Tensor& operand : operands) {
+    config.add_input(operand);
+  }
+  auto iter = config.build();
+  fused_pointwise_stub(
+      iter.device_type(), iter, ops, scalars.has_value() ? *scalars : ArrayRef<double>(no_scalars));
+  return result;
+}
+
 DEFINE_DISPATCH(addcmul_stub);
 DEFINE_DISPATCH(addcdiv_stub);
+DEFINE_DISPATCH(fused_pointwise_stub);
 
 } // namespace native
 } // namespace at
@@ -17,5 +17,36 @@ DECLARE_DISPATCH(pointwise_fn, addcdiv_stub);
 DECLARE_DISPATCH(pointwise_fn, smooth_l1_backward_stub);
 DECLARE_DISPATCH(pointwise_fn, mse_backward_stub);
 
+// Steps of _fused_pointwise, which applies a chain of pointwise ops to self
+// in a single pass over memory. Every step has a scalar argument (ignored by
+// steps that take none); the *Tensor steps also consume the next operand.
+// The values are part of the operator's interface and are mirrored in
+// torch/utils/fused_pointwise.py.
+enum class FusedPointwiseOp : int64_t {
+  AddTensor = 0,   // x + scalar * operand
+  SubTensor = 1,   // x - scalar * operand
+  MulTensor = 2,   // x * operand
+  DivTensor = 3,   // x / operand
+  AddScalar = 4,   // x + scalar
+  MulScalar = 5,   // x * scalar
+  DivScalar = 6,   // x / scalar
+  ClampMin = 7,    // max(x, scalar)
+  ClampMax = 8,    // min(x, scalar)
+  Relu = 9,
+  Sigmoid = 10,
+  Tanh = 11,
+  Exp = 12,
+  Log = 13,
+  Neg = 14,
+  Abs = 15,
+  Sqrt = 16,
+  Reciprocal = 17,
+  NumOps = 18,
+};
+
+using fused_pointwise_fn = void (*)(TensorIterator&, IntArrayRef ops, ArrayRef<double> scalars);
+
+DECLARE_DISPATCH(fused_pointwise_fn, fused_pointwise_stub);
+
 } // namespace native
 } // namespace at
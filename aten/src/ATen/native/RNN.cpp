@@ -2,6 +2,7 @@
 
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/core/grad_mode.h>
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/packed_params.h>
@@ -682,6 +683,25 @@ struct SimpleCell : Cell<Tensor, cell_params> {
   }
 };
 
+// Whether the pointwise part of an LSTM or GRU cell (num_gates gates) can
+// run as one fused CPU kernel. The kernels have no derivative, so they are
+// only used when no gradient flows through the cell; inference with either
+// float weights or dynamically quantized ones, whose linear_ih and linear_hh
+// also produce float gates, takes this path.
+bool use_fused_cell_cpu(
+    const Tensor& igates,
+    const Tensor& hgates,
+    const Tensor& state,
+    int64_t num_gates) {
+  const auto dtype = state.scalar_type();
+  return state.device().is_cpu() && (dtype == kFloat || dtype == kDouble) &&
+      igates.scalar_type() == dtype && hgates.scalar_type() == dtype &&
+      state.dim() == 2 && igates.sizes() == hgates.sizes() && igates.dim() == 2 &&
+      igates.size(0) == state.size(0) && igates.size(1) == num_gates * state.size(1) &&
+      !(at::GradMode::is_enabled() &&
+        (igates.requires_grad() || hgates.requires_grad() || state.requires_grad()));
+}
+
 // TODO: can use inplace ops?
 template <typename cell_params>
 struct LSTMCell : Cell<std::tuple<Tensor, Tensor>, cell_params> {
@@ -705,8 +725,16 @@ struct LSTMCell : Cell<std::tuple<Tensor, Tensor>, cell_params> {
       return std::make_tuple(std::move(std::get<0>(result)), std::move(std::get<1>(result)));
     }
 
-    const auto gates = params.linear_hh(hx).add_(
-        pre_compute_input ? input : params.linear_ih(input));
+    const auto igates = pre_compute_input ? input : params.linear_ih(input);
+    const auto hgates = params.linear_hh(hx);
+    if (use_fused_cell_cpu(igates, hgates, cx, 4)) {
+      auto hy = at::empty_like(cx, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+      auto cy = at::empty_like(cx, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+      lstm_cell_fused_stub(kCPU, hy, cy, igates.contiguous(), hgates.contiguous(), cx.contiguous());
+      return std::make_tuple(std::move(hy), std::move(cy));
+    }
+
+    const auto gates = hgates.add_(igates);
     auto chunked_gates = gates.chunk(4, 1);
     auto ingate = chunked_gates[0].sigmoid_();
     auto forgetgate = chunked_gates[1].sigmoid_();
@@ -737,10 +765,15 @@ struct GRUCell : Cell<Tensor, cell_params> {
       // Slice off the workspace argument (it's needed only for AD).
       return std::move(std::get<0>(result));
     }
-    const auto chunked_igates = pre_compute_input
-        ? input.chunk(3, 1)
-        : params.linear_ih(input).chunk(3, 1);
-    auto chunked_hgates = params.linear_hh(hidden).chunk(3, 1);
+    const auto igates = pre_compute_input ? input : params.linear_ih(input);
+    const auto hgates = params.linear_hh(hidden);
+    if (use_fused_cell_cpu(igates, hgates, hidden, 3)) {
+      auto hy = at::empty_like(hidden, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+      gru_cell_fused_stub(kCPU, hy, igates.contiguous(), hgates.contiguous(), hidden.contiguous());
+      return hy;
+    }
+    const auto chunked_igates = igates.chunk(3, 1);
+    auto chunked_hgates = hgates.chunk(3, 1);
     const auto reset_gate =
         chunked_hgates[0].add_(chunked_igates[0]).sigmoid_();
     const auto input_gate =
@@ -1387,6 +1420,8 @@ DEFINE_DISPATCH(lstm_cudnn_stub);
 DEFINE_DISPATCH(lstm_packed_cudnn_stub);
 DEFINE_DISPATCH(lstm_miopen_stub);
 DEFINE_DISPATCH(lstm_packed_miopen_stub);
+DEFINE_DISPATCH(lstm_cell_fused_stub);
+DEFINE_DISPATCH(gru_cell_fused_stub);
 REGISTER_NO_CPU_DISPATCH(lstm_cudnn_stub, lstm_fn);
 REGISTER_NO_CPU_DISPATCH(lstm_packed_cudnn_stub, lstm_packed_fn);
 REGISTER_NO_CPU_DISPATCH(lstm_miopen_stub, lstm_fn);
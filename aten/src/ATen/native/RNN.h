@@ -27,6 +27,16 @@ DECLARE_DISPATCH(rnn_packed_fn, rnn_tanh_packed_miopen_stub);
 DECLARE_DISPATCH(rnn_packed_fn, rnn_relu_packed_cudnn_stub);
 DECLARE_DISPATCH(rnn_packed_fn, rnn_relu_packed_miopen_stub);
 
+// Pointwise part of the LSTM and GRU cells on CPU, in one pass: the gate
+// nonlinearities and the state update, from igates = linear_ih(input) and
+// hgates = linear_hh(hx) (both with their biases). All tensors are
+// contiguous, 2-D and of the same floating dtype; hy and cy are preallocated.
+using lstm_cell_fused_fn = void(*)(Tensor& hy, Tensor& cy, const Tensor& igates, const Tensor& hgates, const Tensor& cx);
+using gru_cell_fused_fn = void(*)(Tensor& hy, const Tensor& igates, const Tensor& hgates, const Tensor& hx);
+
+DECLARE_DISPATCH(lstm_cell_fused_fn, lstm_cell_fused_stub);
+DECLARE_DISPATCH(gru_cell_fused_fn, gru_cell_fused_stub);
+
 inline void check_device(const Tensor& input, const TensorList& params, const TensorList& hiddens) {
   auto input_device = input.device();
 
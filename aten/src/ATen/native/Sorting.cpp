@@ -220,6 +220,74 @@ std::tuple<Tensor, Tensor> topk(
   return std::make_tuple(values, indices);
 }
 
+std::tuple<Tensor&, Tensor&> sort_out_cpu(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t dim,
+    bool descending) {
+  TORCH_CHECK(
+      self.scalar_type() == values.scalar_type(),
+      "sort(): output values must be of the same type as input");
+  TORCH_CHECK(
+      indices.scalar_type() == kLong,
+      "sort(): output indices must be of scalar type Long");
+  dim = maybe_wrap_dim(dim, self.dim(), /*wrap_scalar=*/true);
+
+  // The kernel gathers from `self` while it writes `values`, so sorting a
+  // tensor into itself needs a copy of the input.
+  const Tensor input = values.is_alias_of(self) ? self.clone() : self;
+  values.resize_as_(input);
+  indices.resize_(input.sizes());
+  if (input.dim() == 0 && input.numel() == 1) {
+    values.copy_(input);
+    indices.zero_();
+    return std::forward_as_tuple(values, indices);
+  }
+
+  sort_stub(kCPU, values, indices, input, dim, descending);
+
+  return std::forward_as_tuple(values, indices);
+}
+
+std::tuple<Tensor, Tensor> sort_cpu(
+    const Tensor& self,
+    int64_t dim,
+    bool descending) {
+  Tensor values = at::empty({0}, self.options());
+  Tensor indices = at::empty({0}, self.options().dtype(kLong));
+  return sort_out_cpu(values, indices, self, dim, descending);
+}
+
+// The CPU kernel is always stable; other backends still use an unstable
+// sort, so asking them for a stable one is an error rather than a silent
+// downgrade.
+std::tuple<Tensor&, Tensor&> sort_out(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    c10::optional<bool> stable,
+    int64_t dim,
+    bool descending) {
+  TORCH_CHECK(
+      !stable.value_or(false) || self.device().type() == kCPU,
+      "sort(): stable=True is only supported for CPU tensors, got ",
+      self.device().type());
+  return at::sort_out(values, indices, self, dim, descending);
+}
+
+std::tuple<Tensor, Tensor> sort(
+    const Tensor& self,
+    c10::optional<bool> stable,
+    int64_t dim,
+    bool descending) {
+  TORCH_CHECK(
+      !stable.value_or(false) || self.device().type() == kCPU,
+      "sort(): stable=True is only supported for CPU tensors, got ",
+      self.device().type());
+  return at::sort(self, dim, descending);
+}
+
 std::tuple<Tensor&, Tensor&> median_out(
     Tensor& values,
     Tensor& indices,
@@ -303,6 +371,7 @@ Tensor median_cpu(const Tensor& self) {
   return result.view({});
 }
 
+DEFINE_DISPATCH(sort_stub);
 DEFINE_DISPATCH(topk_stub);
 
 } // namespace native
@@ -20,7 +20,8 @@ namespace at { namespace native {
 
 // This is a pass-through wrapper function that does the size check and
 // inferences. The actual forward implementation function is called
-// at::_fft_with_size which dispatches to _fft_cufft (CUDA) or _fft_mkl (CPU).
+// at::_fft_with_size which dispatches to _fft_cufft (CUDA) or _fft_cpu (CPU),
+// itself _fft_mkl or, without MKL, _fft_bundled.
 static inline Tensor _fft(const Tensor &self, const int64_t signal_ndim,
            const bool complex_input, const bool complex_output,
            const bool inverse, IntArrayRef signal_sizes, const bool normalized,
@@ -0,0 +1,460 @@
+#include <ATen/ATen.h>
+#include <ATen/Config.h>
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/SpectralOpsUtils.h>
+#include <ATen/native/cpu/FFT.h>
+#include <ATen/native/utils/ParamsHash.h>
+
+#include <cmath>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace at { namespace native {
+
+namespace {
+
+constexpr int64_t kFFTDefaultPlanCacheSize = 256;
+
+// Key of the CPU plan cache. Plans are one-dimensional and read their data
+// from gathered lines, so they do not depend on strides or batch sizes.
+struct FFTPlanKey {
+  at::ScalarType scalar_type;
+  int64_t length;
+  bool real;
+};
+
+struct FFTPlanBase {
+  virtual ~FFTPlanBase() = default;
+};
+
+template <typename Plan>
+struct FFTPlanHolder : FFTPlanBase {
+  explicit FFTPlanHolder(int64_t n) : plan(n) {}
+  Plan plan;
+};
+
+// LRU cache of bundled_fft::CFFTPlan and bundled_fft::RFFTPlan, shared by all threads.
+// Plans are handed out as shared pointers, so evicting a plan that is still
+// being executed is safe.
+class FFTPlanCache {
+ public:
+  template <typename scalar_t, bool real>
+  std::shared_ptr<const FFTPlanBase> get(int64_t length) {
+    FFTPlanKey key;
+    std::memset(&key, 0, sizeof(key));
+    key.scalar_type = c10::CppTypeToScalarType<scalar_t>::value;
+    key.length = length;
+    key.real = real;
+
+    using Plan = typename std::conditional<real, bundled_fft::RFFTPlan<scalar_t>, bundled_fft::CFFTPlan<scalar_t>>::type;
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = map_.find(key);
+    if (it != map_.end()) {
+      usage_.splice(usage_.begin(), usage_, it->second);
+      return it->second->second;
+    }
+    std::shared_ptr<const FFTPlanBase> plan = std::make_shared<FFTPlanHolder<Plan>>(length);
+    if (max_size_ == 0) {
+      return plan;
+    }
+    if (usage_.size() >= max_size_) {
+      map_.erase(usage_.back().first);
+      usage_.pop_back();
+    }
+    usage_.emplace_front(key, plan);
+    map_.emplace(key, usage_.begin());
+    return plan;
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    map_.clear();
+    usage_.clear();
+  }
+
+  void resize(int64_t max_size) {
+    TORCH_CHECK(max_size >= 0,
+        "CPU FFT plan cache size must be non-negative, but got ", max_size);
+    std::lock_guard<std::mutex> guard(mutex_);
+    max_size_ = static_cast<size_t>(max_size);
+    while (usage_.size() > max_size_) {
+      map_.erase(usage_.back().first);
+      usage_.pop_back();
+    }
+  }
+
+  int64_t size() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return usage_.size();
+  }
+
+  int64_t max_size() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return max_size_;
+  }
+
+ private:
+  using kv_t = std::pair<FFTPlanKey, std::shared_ptr<const FFTPlanBase>>;
+
+  std::mutex mutex_;
+  std::list<kv_t> usage_;
+  std::unordered_map<FFTPlanKey, std::list<kv_t>::iterator,
+                     ParamsHash<FFTPlanKey>, ParamsEqual<FFTPlanKey>> map_;
+  size_t max_size_ = kFFTDefaultPlanCacheSize;
+};
+
+FFTPlanCache& fft_plan_cache() {
+  static FFTPlanCache cache;
+  return cache;
+}
+
+template <typename scalar_t>
+std::shared_ptr<const FFTPlanHolder<bundled_fft::CFFTPlan<scalar_t>>> get_c2c_plan(int64_t n) {
+  return std::static_pointer_cast<const FFTPlanHolder<bundled_fft::CFFTPlan<scalar_t>>>(
+      fft_plan_cache().get<scalar_t, false>(n));
+}
+
+template <typename scalar_t>
+std::shared_ptr<const FFTPlanHolder<bundled_fft::RFFTPlan<scalar_t>>> get_r2c_plan(int64_t n) {
+  return std::static_pointer_cast<const FFTPlanHolder<bundled_fft::RFFTPlan<scalar_t>>>(
+      fft_plan_cache().get<scalar_t, true>(n));
+}
+
+// The transforms below run over all lines along dim `axis` of a [batch,
+// signal dims...] iteration space `sizes`, with one thread per group of
+// lines. Strides are in scalars, and a complex element is a pair of adjacent
+// scalars.
+int64_t num_lines(IntArrayRef sizes, int64_t axis) {
+  int64_t num = 1;
+  for (int64_t d = 0; d < static_cast<int64_t>(sizes.size()); d++) {
+    if (d != axis) {
+      num *= sizes[d];
+    }
+  }
+  return num;
+}
+
+void line_offsets(
+    IntArrayRef sizes,
+    IntArrayRef in_strides,
+    IntArrayRef out_strides,
+    int64_t axis,
+    int64_t line,
+    int64_t& in_offset,
+    int64_t& out_offset) {
+  in_offset = 0;
+  out_offset = 0;
+  for (int64_t d = sizes.size() - 1; d >= 0; d--) {
+    if (d == axis) {
+      continue;
+    }
+    const int64_t idx = line % sizes[d];
+    line /= sizes[d];
+    in_offset += idx * in_strides[d];
+    out_offset += idx * out_strides[d];
+  }
+}
+
+int64_t line_grain_size(int64_t n) {
+  return divup(at::internal::GRAIN_SIZE, n);
+}
+
+// Complex-to-complex along axis, from in to out (which may be the same).
+template <typename scalar_t>
+void c2c_lines(
+    const scalar_t* in,
+    IntArrayRef in_strides,
+    scalar_t* out,
+    IntArrayRef out_strides,
+    IntArrayRef sizes,
+    int64_t axis,
+    bool forward,
+    scalar_t fct) {
+  using cmplx = bundled_fft::cmplx<scalar_t>;
+  const int64_t n = sizes[axis];
+  const auto plan = get_c2c_plan<scalar_t>(n);
+  const int64_t is = in_strides[axis];
+  const int64_t os = out_strides[axis];
+  at::parallel_for(0, num_lines(sizes, axis), line_grain_size(n), [&](int64_t begin, int64_t end) {
+    std::vector<cmplx> buffer(n + plan->plan.scratch_size());
+    for (int64_t line = begin; line < end; line++) {
+      int64_t in_offset, out_offset;
+      line_offsets(sizes, in_strides, out_strides, axis, line, in_offset, out_offset);
+      const scalar_t* src = in + in_offset;
+      for (int64_t j = 0; j < n; j++) {
+        buffer[j] = cmplx(src[j * is], src[j * is + 1]);
+      }
+      plan->plan.exec(buffer.data(), buffer.data() + n, forward, fct);
+      scalar_t* dst = out + out_offset;
+      for (int64_t j = 0; j < n; j++) {
+        dst[j * os] = buffer[j].real();
+        dst[j * os + 1] = buffer[j].imag();
+      }
+    }
+  });
+}
+
+// Real-to-complex along axis, writing the n / 2 + 1 first elements of every
+// output line. The inverse transform of a real signal is the conjugate of
+// the forward one.
+template <typename scalar_t>
+void r2c_lines(
+    const scalar_t* in,
+    IntArrayRef in_strides,
+    scalar_t* out,
+    IntArrayRef out_strides,
+    IntArrayRef sizes,
+    int64_t axis,
+    bool forward,
+    scalar_t fct) {
+  using cmplx = bundled_fft::cmplx<scalar_t>;
+  const int64_t n = sizes[axis];
+  const int64_t half = infer_ft_real_to_complex_onesided_size(n);
+  const auto plan = get_r2c_plan<scalar_t>(n);
+  const int64_t is = in_strides[axis];
+  const int64_t os = out_strides[axis];
+  const scalar_t sign = forward ? 1 : -1;
+  at::parallel_for(0, num_lines(sizes, axis), line_grain_size(n), [&](int64_t begin, int64_t end) {
+    std::vector<scalar_t> real_buffer(n);
+    std::vector<cmplx> buffer(half + plan->plan.scratch_size());
+    for (int64_t line = begin; line < end; line++) {
+      int64_t in_offset, out_offset;
+      line_offsets(sizes, in_strides, out_strides, axis, line, in_offset, out_offset);
+      const scalar_t* src = in + in_offset;
+      for (int64_t j = 0; j < n; j++) {
+        real_buffer[j] = src[j * is];
+      }
+      plan->plan.forward(real_buffer.data(), buffer.data(), buffer.data() + half, fct);
+      scalar_t* dst = out + out_offset;
+      for (int64_t k = 0; k < half; k++) {
+        dst[k * os] = buffer[k].real();
+        dst[k * os + 1] = sign * buffer[k].imag();
+      }
+    }
+  });
+}
+
+// Complex-to-real along axis, where n is the size of the real output and
+// only the n / 2 + 1 first elements of every input line are read. The
+// forward transform of a Hermitian signal is the inverse transform of its
+// conjugate.
+template <typename scalar_t>
+void c2r_lines(
+    const scalar_t* in,
+    IntArrayRef in_strides,
+    scalar_t* out,
+    IntArrayRef out_strides,
+    IntArrayRef sizes,
+    int64_t axis,
+    bool forward,
+    scalar_t fct) {
+  using cmplx = bundled_fft::cmplx<scalar_t>;
+  const int64_t n = sizes[axis];
+  const int64_t half = infer_ft_real_to_complex_onesided_size(n);
+  const auto plan = get_r2c_plan<scalar_t>(n);
+  const int64_t is = in_strides[axis];
+  const int64_t os = out_strides[axis];
+  const scalar_t sign = forward ? -1 : 1;
+  at::parallel_for(0, num_lines(sizes, axis), line_grain_size(n), [&](int64_t begin, int64_t end) {
+    std::vector<scalar_t> real_buffer(n);
+    std::vector<cmplx> buffer(half + plan->plan.scratch_size());
+    for (int64_t line = begin; line < end; line++) {
+      int64_t in_offset, out_offset;
+      line_offsets(sizes, in_strides, out_strides, axis, line, in_offset, out_offset);
+      const scalar_t* src = in + in_offset;
+      for (int64_t k = 0; k < half; k++) {
+        buffer[k] = cmplx(src[k * is], sign * src[k * is + 1]);
+      }
+      plan->plan.backward(buffer.data(), real_buffer.data(), buffer.data() + half, fct);
+      scalar_t* dst = out + out_offset;
+      for (int64_t j = 0; j < n; j++) {
+        dst[j * os] = real_buffer[j];
+      }
+    }
+  });
+}
+
+// Fills the second half of the last signal dim of a contiguous twosided
+// real-to-complex output from the first one.
+// See NOTE [ Fourier Transform Conjugate Symmetry ] in native/SpectralOpsUtils.h.
+template <typename scalar_t>
+void fill_with_conjugate_symmetry(Tensor& output, int64_t signal_ndim) {
+  const int64_t last = signal_ndim;
+  const int64_t n = output.size(last);
+  const int64_t half = infer_ft_real_to_complex_onesided_size(n);
+  if (half >= n) {
+    return;
+  }
+  scalar_t* data = output.data_ptr<scalar_t>();
+  const auto sizes = output.sizes();
+  const auto strides = output.strides();
+  int64_t num_rows = 1;
+  for (int64_t d = 0; d < last; d++) {
+    num_rows *= sizes[d];
+  }
+  at::parallel_for(0, num_rows, line_grain_size(n), [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; row++) {
+      // Row (b, i_1, ..., i_{K-1}) reads row (b, -i_1, ..., -i_{K-1}).
+      int64_t offset = 0;
+      int64_t mirror_offset = 0;
+      int64_t r = row;
+      for (int64_t d = last - 1; d >= 0; d--) {
+        const int64_t idx = r % sizes[d];
+        r /= sizes[d];
+        offset += idx * strides[d];
+        mirror_offset += (d == 0 ? idx : (sizes[d] - idx) % sizes[d]) * strides[d];
+      }
+      for (int64_t k = half; k < n; k++) {
+        const scalar_t* src = data + mirror_offset + (n - k) * strides[last];
+        scalar_t* dst = data + offset + k * strides[last];
+        dst[0] = src[0];
+        dst[1] = -src[1];
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void fft_bundled_impl(
+    const Tensor& input,
+    Tensor& output,
+    int64_t signal_ndim,
+    bool complex_input,
+    bool complex_output,
+    bool inverse,
+    IntArrayRef checked_signal_sizes,
+    scalar_t fct,
+    bool onesided) {
+  const int64_t last = signal_ndim;
+  const bool forward = !inverse;
+  const scalar_t* in = input.data_ptr<scalar_t>();
+  scalar_t* out = output.data_ptr<scalar_t>();
+  const auto in_strides = input.strides().slice(0, last + 1);
+  const auto out_strides = output.strides().slice(0, last + 1);
+  // Every transform scales by fct in the last pass only.
+  auto pass_fct = [&](bool is_last_pass) {
+    return is_last_pass ? fct : static_cast<scalar_t>(1);
+  };
+
+  if (complex_input && complex_output) {
+    const auto sizes = output.sizes().slice(0, last + 1);
+    c2c_lines<scalar_t>(in, in_strides, out, out_strides, sizes, last, forward, pass_fct(last == 1));
+    for (int64_t axis = last - 1; axis >= 1; axis--) {
+      c2c_lines<scalar_t>(out, out_strides, out, out_strides, sizes, axis, forward, pass_fct(axis == 1));
+    }
+  } else if (!complex_input) {
+    const auto sizes = input.sizes().slice(0, last + 1);
+    r2c_lines<scalar_t>(in, in_strides, out, out_strides, sizes, last, forward, pass_fct(last == 1));
+    std::vector<int64_t> half_sizes = sizes.vec();
+    half_sizes[last] = infer_ft_real_to_complex_onesided_size(sizes[last]);
+    for (int64_t axis = last - 1; axis >= 1; axis--) {
+      c2c_lines<scalar_t>(out, out_strides, out, out_strides, half_sizes, axis, forward, pass_fct(axis == 1));
+    }
+    if (!onesided) {
+      fill_with_conjugate_symmetry<scalar_t>(output, signal_ndim);
+    }
+  } else {
+    const auto sizes = output.sizes().slice(0, last + 1);
+    if (last == 1) {
+      c2r_lines<scalar_t>(in, in_strides, out, out_strides, sizes, last, forward, fct);
+      return;
+    }
+    // The other signal dims are transformed first, on the n / 2 + 1 first
+    // elements of the last one.
+    std::vector<int64_t> half_sizes = sizes.vec();
+    half_sizes[last] = infer_ft_real_to_complex_onesided_size(sizes[last]);
+    std::vector<int64_t> tmp_sizes = half_sizes;
+    tmp_sizes.push_back(2);
+    Tensor tmp = at::empty(tmp_sizes, input.options());
+    scalar_t* tmp_data = tmp.data_ptr<scalar_t>();
+    const auto tmp_strides = tmp.strides().slice(0, last + 1);
+    c2c_lines<scalar_t>(in, in_strides, tmp_data, tmp_strides, half_sizes, last - 1, forward, 1);
+    for (int64_t axis = last - 2; axis >= 1; axis--) {
+      c2c_lines<scalar_t>(tmp_data, tmp_strides, tmp_data, tmp_strides, half_sizes, axis, forward, 1);
+    }
+    c2r_lines<scalar_t>(tmp_data, tmp_strides, out, out_strides, sizes, last, forward, fct);
+  }
+}
+
+} // anonymous namespace
+
+#if AT_MKL_ENABLED()
+// Defined in native/mkl/SpectralOps.cpp.
+Tensor _fft_mkl(const Tensor& self, int64_t signal_ndim,
+                bool complex_input, bool complex_output,
+                bool inverse, IntArrayRef checked_signal_sizes,
+                bool normalized, bool onesided,
+                IntArrayRef output_sizes);
+#endif
+
+// Bundled CPU FFT (see native/cpu/FFT.h), for builds without MKL. Any input
+// strides are supported: every transform gathers the lines it works on.
+Tensor _fft_bundled(const Tensor& self, int64_t signal_ndim,
+                    bool complex_input, bool complex_output,
+                    bool inverse, IntArrayRef checked_signal_sizes,
+                    bool normalized, bool onesided,
+                    IntArrayRef output_sizes) {
+  TORCH_CHECK(self.scalar_type() == kFloat || self.scalar_type() == kDouble,
+              "CPU FFT doesn't support tensor of type: ", toString(self.scalar_type()));
+  Tensor input = self;
+  // Real and imaginary parts must be adjacent.
+  if (complex_input && input.stride(-1) != 1) {
+    input = input.contiguous();
+  }
+  Tensor output = at::empty(output_sizes, input.options());
+  if (input.numel() == 0 || output.numel() == 0) {
+    return output;
+  }
+
+  const int64_t signal_numel = at::prod_intlist(checked_signal_sizes);
+  double scale = 1;
+  if (normalized) {
+    scale = 1.0 / std::sqrt(static_cast<double>(signal_numel));
+  } else if (inverse) {
+    scale = 1.0 / static_cast<double>(signal_numel);
+  }
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "fft_bundled", [&] {
+    fft_bundled_impl<scalar_t>(
+        input, output, signal_ndim, complex_input, complex_output, inverse,
+        checked_signal_sizes, static_cast<scalar_t>(scale), onesided);
+  });
+  return output;
+}
+
+Tensor _fft_cpu(const Tensor& self, int64_t signal_ndim,
+                bool complex_input, bool complex_output,
+                bool inverse, IntArrayRef checked_signal_sizes,
+                bool normalized, bool onesided,
+                IntArrayRef output_sizes) {
+#if AT_MKL_ENABLED()
+  return _fft_mkl(self, signal_ndim, complex_input, complex_output, inverse,
+                  checked_signal_sizes, normalized, onesided, output_sizes);
+#else
+  return _fft_bundled(self, signal_ndim, complex_input, complex_output, inverse,
+                      checked_signal_sizes, normalized, onesided, output_sizes);
+#endif
+}
+
+int64_t _fft_cpu_get_plan_cache_size() {
+  return fft_plan_cache().size();
+}
+
+int64_t _fft_cpu_get_plan_cache_max_size() {
+  return fft_plan_cache().max_size();
+}
+
+void _fft_cpu_set_plan_cache_max_size(int64_t max_size) {
+  fft_plan_cache().resize(max_size);
+}
+
+void _fft_cpu_clear_plan_cache() {
+  fft_plan_cache().clear();
+}
+
+}} // namespace at::native
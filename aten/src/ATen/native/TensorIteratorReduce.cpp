@@ -43,9 +43,12 @@ static void two_pass_reduction(TensorIterator& iter, loop2d_t loop) {
 
   at::parallel_for(0, iter.numel(), internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
     int thread_num = at::get_thread_num();
-    written[thread_num] = true;
     auto slice = buffer[thread_num];
-    slice.copy_(dst);
+    // a thread may run several chunks: only initialize its slice once
+    if (!written[thread_num]) {
+      slice.copy_(dst);
+      written[thread_num] = true;
+    }
 
     auto sub_iter = TensorIterator::reduce_op(slice, iter.input(0));
     sub_iter.serial_for_each(loop, {begin, end});
@@ -21,7 +21,7 @@
 namespace at {
 namespace native {
 
-DEFINE_DISPATCH(cat_serial_stub);
+DEFINE_DISPATCH(cat_contiguous_stub);
 
 Tensor _reshape_from_tensor(const Tensor& self, const Tensor& shape_tensor) {
   TORCH_CHECK(shape_tensor.dim() == 1);
@@ -107,7 +107,6 @@ Tensor & _cat_out_cpu(Tensor& result, TensorList tensors, int64_t dim) {
   // size (i.e. other empty sizes are not skipped).
   // FIXME: warn if this is the case
   bool allSkipped = true;
-  bool allContiguous = true;
   Tensor notSkippedTensor;
 
   // Inputs cannot alias the output tensor
@@ -136,37 +135,16 @@ Tensor & _cat_out_cpu(Tensor& result, TensorList tensors, int64_t dim) {
   TORCH_CHECK(tensors.size() > 0, "expected a non-empty list of Tensors");
   TORCH_CHECK(dim <= notSkippedTensor.dim(), "dimension ", dim, "out of range");
 
-  // when the input tensors are of the same size and strides,
-  // reuse the same iterator for all input tensors
-  bool reuse_iterator = true;
-  bool no_type_promotion = true;
-  // Check the type of the result
-  no_type_promotion = result.dtype() == notSkippedTensor.dtype();
-
   // compute size of the result in the cat dimension
   int64_t cat_dim_size = 0;
   auto first_tensor_mem_format = tensors[0].suggest_memory_format();
   for (int i = 0; i < tensors.size(); i++) {
     auto const &tensor = tensors[i];
     if (should_skip(tensor)) {
-      // don't use fast path for empty tensor
-      allContiguous = false;
       continue;
     }
     check_cat_shape_except_dim(notSkippedTensor, tensor, dim, i);
     cat_dim_size += tensor.size(dim);
-
-    if (!tensor.is_contiguous(first_tensor_mem_format)) {
-      allContiguous = false;
-    }
-
-    if (tensor.sizes() != notSkippedTensor.sizes() ||
-        tensor.strides() != notSkippedTensor.strides()) {
-      reuse_iterator = false;
-    }
-    if (tensor.dtype() != notSkippedTensor.dtype()) {
-      no_type_promotion = false;
-    }
   }
   // compute the size of the result
   auto result_size = notSkippedTensor.sizes().vec();
@@ -176,63 +154,65 @@ Tensor & _cat_out_cpu(Tensor& result, TensorList tensors, int64_t dim) {
     return result;
   }
 
-  // fast path for single thread when both inputs and result are contiguous and not empty
-  allContiguous = allContiguous && result.is_contiguous(first_tensor_mem_format);
-  bool use_serial_kernel = result.numel() < at::internal::GRAIN_SIZE || at::get_num_threads() == 1;
-  ScalarType dtype = notSkippedTensor.scalar_type();
-  if (use_serial_kernel && allContiguous && no_type_promotion && (dtype == ScalarType::Double || dtype == ScalarType::Float)) {
-    cat_serial_stub(kCPU, result, tensors, dim);
-    return result;
+  // Copies input i into its slice of result, converting its dtype if needed.
+  std::vector<int64_t> slice_offsets(tensors.size() + 1, 0);
+  for (int64_t i = 0; i < tensors.size(); i++) {
+    slice_offsets[i + 1] = slice_offsets[i] + (should_skip(tensors[i]) ? 0 : tensors[i].size(dim));
   }
-
-  int64_t offset = 0;
-  if (reuse_iterator &&
-      result.is_contiguous(first_tensor_mem_format) &&
-      no_type_promotion) {
-    auto source_slice = notSkippedTensor;
-    auto slice_dim_size = source_slice.size(dim);
-    auto result_slice = result.narrow(dim, 0, slice_dim_size);
-    auto result_slice_data = result_slice.data_ptr();
-    auto result_stride_bytes = result.stride(dim) * elementSize(result.scalar_type());
-
+  auto copy_slice = [&](int64_t i) {
+    auto result_slice = result.narrow(dim, slice_offsets[i], slice_offsets[i + 1] - slice_offsets[i]);
     auto iter = TensorIteratorConfig()
       .resize_outputs(false)
       .add_output(result_slice)
-      .add_input(source_slice)
+      .add_input(tensors[i])
+      .promote_inputs_to_common_dtype(true)
+      .cast_common_dtype_to_outputs(true)
       .enforce_safe_casting_to_output(true)
       .build();
+    copy_stub(iter.device_type(), iter, false);
+  };
 
-    for (auto const &tensor : tensors) {
-      if (should_skip(tensor)) {
-        continue;
+  if (!result.is_contiguous(first_tensor_mem_format)) {
+    for (int64_t i = 0; i < tensors.size(); i++) {
+      if (!should_skip(tensors[i])) {
+        copy_slice(i);
       }
-      auto source_data = static_cast<char*>(tensor.data_ptr());
-      auto result_data = static_cast<char*>(result_slice_data) + offset * result_stride_bytes;
-      iter.unsafe_replace_operand(0, result_data);
-      iter.unsafe_replace_operand(1, source_data);
-      copy_stub(iter.device_type(), iter, false);
-      offset += slice_dim_size;
     }
-  } else {
-    for (auto const &tensor: tensors) {
-      if (should_skip(tensor)) {
-        continue;
-      }
-      auto slice_dim_size = tensor.size(dim);
-      auto result_slice = result.narrow(dim, offset, slice_dim_size);
-
-      auto iter = TensorIteratorConfig()
-        .resize_outputs(false)
-        .add_output(result_slice)
-        .add_input(tensor)
-        .promote_inputs_to_common_dtype(true)
-        .cast_common_dtype_to_outputs(true)
-        .enforce_safe_casting_to_output(true)
-        .build();
-      copy_stub(iter.device_type(), iter, false);
-      offset += slice_dim_size;
+    return result;
+  }
+
+  // Inputs laid out like result and of the same dtype are copied bytewise by
+  // cat_contiguous_stub, which splits the whole output over threads. The
+  // others need a strided copy or a dtype conversion: small ones are copied
+  // in parallel with each other, large ones one after another with a
+  // parallel copy each.
+  std::vector<Tensor> contiguous_inputs(tensors.size());
+  std::vector<int64_t> slice_sizes(tensors.size());
+  std::vector<int64_t> small_inputs;
+  std::vector<int64_t> large_inputs;
+  for (int64_t i = 0; i < tensors.size(); i++) {
+    slice_sizes[i] = slice_offsets[i + 1] - slice_offsets[i];
+    auto const &tensor = tensors[i];
+    if (should_skip(tensor) || tensor.numel() == 0) {
+      continue;
     }
+    if (tensor.scalar_type() == result.scalar_type() && tensor.is_contiguous(first_tensor_mem_format)) {
+      contiguous_inputs[i] = tensor;
+    } else if (tensor.numel() < at::internal::GRAIN_SIZE) {
+      small_inputs.push_back(i);
+    } else {
+      large_inputs.push_back(i);
+    }
+  }
+  for (int64_t i : large_inputs) {
+    copy_slice(i);
   }
+  at::parallel_for(0, small_inputs.size(), 1, [&](int64_t begin, int64_t end) {
+    for (int64_t k = begin; k < end; k++) {
+      copy_slice(small_inputs[k]);
+    }
+  });
+  cat_contiguous_stub(kCPU, result, contiguous_inputs, slice_sizes, dim);
 
   return result;
 }
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// Fills (output, inverse_indices, counts) with the unique elements of `self`,
+// the index of each input element in `output` (only if return_inverse) and
+// the number of occurrences of each unique element (only if return_counts).
+using unique_fn = void(*)(Tensor&, Tensor&, Tensor&, const Tensor&, bool, bool, bool);
+
+DECLARE_DISPATCH(unique_fn, unique_stub);
+
+}} // namespace at::native
@@ -0,0 +1,394 @@
+#include <ATen/native/cpu/BatchLinearAlgebraKernel.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/LinearAlgebraUtils.h>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// Transposes `count` (<= Vec::size()) length-N columns, `matrix_stride`
+// elements apart, into N vectors holding one column per lane. Missing lanes
+// are filled with the column `pad_row` of the identity, so that padding lanes
+// never hit a zero pivot.
+template <typename scalar_t, int N>
+inline void gather_column(
+    Vec256<scalar_t> (&out)[N],
+    const scalar_t* data,
+    int64_t matrix_stride,
+    int64_t count,
+    int pad_row) {
+  using Vec = Vec256<scalar_t>;
+  __at_align32__ scalar_t buf[N][Vec::size()];
+  for (int64_t l = 0; l < count; l++) {
+    const scalar_t* src = data + l * matrix_stride;
+    for (int i = 0; i < N; i++) {
+      buf[i][l] = src[i];
+    }
+  }
+  for (int64_t l = count; l < Vec::size(); l++) {
+    for (int i = 0; i < N; i++) {
+      buf[i][l] = static_cast<scalar_t>(i == pad_row ? 1 : 0);
+    }
+  }
+  for (int i = 0; i < N; i++) {
+    out[i] = Vec::loadu(buf[i]);
+  }
+}
+
+// Inverse of gather_column for the rows [row_begin, row_end) of the columns.
+template <typename scalar_t, int N>
+inline void scatter_column(
+    const Vec256<scalar_t> (&in)[N],
+    scalar_t* data,
+    int64_t matrix_stride,
+    int64_t count,
+    int row_begin = 0,
+    int row_end = N) {
+  using Vec = Vec256<scalar_t>;
+  __at_align32__ scalar_t buf[N][Vec::size()];
+  for (int i = row_begin; i < row_end; i++) {
+    in[i].store(buf[i]);
+  }
+  for (int64_t l = 0; l < count; l++) {
+    scalar_t* dst = data + l * matrix_stride;
+    for (int i = row_begin; i < row_end; i++) {
+      dst[i] = buf[i][l];
+    }
+  }
+}
+
+template <typename scalar_t, int N>
+inline void gather_matrix(
+    Vec256<scalar_t> (&a)[N][N],
+    const scalar_t* data,
+    int64_t matrix_stride,
+    int64_t count) {
+  Vec256<scalar_t> col[N];
+  for (int j = 0; j < N; j++) {
+    gather_column<scalar_t, N>(col, data + j * N, matrix_stride, count, j);
+    for (int i = 0; i < N; i++) {
+      a[i][j] = col[i];
+    }
+  }
+}
+
+template <typename scalar_t, int N>
+inline void scatter_matrix(
+    const Vec256<scalar_t> (&a)[N][N],
+    scalar_t* data,
+    int64_t matrix_stride,
+    int64_t count) {
+  Vec256<scalar_t> col[N];
+  for (int j = 0; j < N; j++) {
+    for (int i = 0; i < N; i++) {
+      col[i] = a[i][j];
+    }
+    scatter_column<scalar_t, N>(col, data + j * N, matrix_stride, count);
+  }
+}
+
+template <typename scalar_t>
+inline void store_infos(const Vec256<scalar_t>& info, int64_t* infos, int64_t count) {
+  __at_align32__ scalar_t buf[Vec256<scalar_t>::size()];
+  info.store(buf);
+  for (int64_t l = 0; l < count; l++) {
+    infos[l] = static_cast<int64_t>(buf[l]);
+  }
+}
+
+// Records k + 1 as the info of the lanes in `mask` that have no info yet.
+template <typename scalar_t>
+inline void update_info(Vec256<scalar_t>& info, const Vec256<scalar_t>& mask, int k) {
+  using Vec = Vec256<scalar_t>;
+  info = Vec::blendv(info, Vec(static_cast<scalar_t>(k + 1)), mask & (info == Vec(0)));
+}
+
+// LU factorization with partial pivoting, as LAPACK's getrf: the pivot of
+// column k is the first row with the largest |a(i, k)|, piv[k] is the row
+// swapped with row k, and info is the first k + 1 with a zero pivot.
+template <typename scalar_t, int N>
+inline void lu_factor(
+    Vec256<scalar_t> (&a)[N][N],
+    Vec256<scalar_t> (&piv)[N],
+    Vec256<scalar_t>& info) {
+  using Vec = Vec256<scalar_t>;
+  for (int k = 0; k < N; k++) {
+    Vec best = a[k][k].abs();
+    Vec p = Vec(static_cast<scalar_t>(k));
+    for (int i = k + 1; i < N; i++) {
+      const Vec v = a[i][k].abs();
+      const Vec mask = v > best;
+      best = Vec::blendv(best, v, mask);
+      p = Vec::blendv(p, Vec(static_cast<scalar_t>(i)), mask);
+    }
+    piv[k] = p;
+    for (int i = k + 1; i < N; i++) {
+      const Vec mask = p == Vec(static_cast<scalar_t>(i));
+      for (int j = 0; j < N; j++) {
+        const Vec tmp = a[k][j];
+        a[k][j] = Vec::blendv(a[k][j], a[i][j], mask);
+        a[i][j] = Vec::blendv(a[i][j], tmp, mask);
+      }
+    }
+
+    const Vec singular = a[k][k] == Vec(0);
+    update_info(info, singular, k);
+    const Vec inv = Vec::blendv(Vec(1) / a[k][k], Vec(0), singular);
+    for (int i = k + 1; i < N; i++) {
+      a[i][k] = a[i][k] * inv;
+      for (int j = k + 1; j < N; j++) {
+        a[i][j] = a[i][j] - a[i][k] * a[k][j];
+      }
+    }
+  }
+}
+
+// Solves A x = b in place for one right-hand side, given lu_factor's output.
+template <typename scalar_t, int N>
+inline void lu_solve_column(
+    const Vec256<scalar_t> (&a)[N][N],
+    const Vec256<scalar_t> (&piv)[N],
+    Vec256<scalar_t> (&b)[N]) {
+  using Vec = Vec256<scalar_t>;
+  for (int k = 0; k < N; k++) {
+    for (int i = k + 1; i < N; i++) {
+      const Vec mask = piv[k] == Vec(static_cast<scalar_t>(i));
+      const Vec tmp = b[k];
+      b[k] = Vec::blendv(b[k], b[i], mask);
+      b[i] = Vec::blendv(b[i], tmp, mask);
+    }
+  }
+  for (int k = 0; k < N; k++) {
+    for (int i = k + 1; i < N; i++) {
+      b[i] = b[i] - a[i][k] * b[k];
+    }
+  }
+  for (int k = N - 1; k >= 0; k--) {
+    for (int j = k + 1; j < N; j++) {
+      b[k] = b[k] - a[k][j] * b[j];
+    }
+    b[k] = b[k] / a[k][k];
+  }
+}
+
+// Cholesky factorization A = L L^T of the lower triangle of a, as LAPACK's
+// potrf: info is the first k + 1 whose leading minor is not positive definite.
+template <typename scalar_t, int N>
+inline void cholesky_factor(Vec256<scalar_t> (&a)[N][N], Vec256<scalar_t>& info) {
+  using Vec = Vec256<scalar_t>;
+  for (int j = 0; j < N; j++) {
+    Vec d = a[j][j];
+    for (int k = 0; k < j; k++) {
+      d = d - a[j][k] * a[j][k];
+    }
+    // not positive, or NaN
+    const Vec not_positive = Vec::blendv(Vec(1), Vec(0), d > Vec(0));
+    update_info(info, not_positive == Vec(1), j);
+    d = d.sqrt();
+    a[j][j] = d;
+    const Vec inv = Vec(1) / d;
+    for (int i = j + 1; i < N; i++) {
+      Vec s = a[i][j];
+      for (int k = 0; k < j; k++) {
+        s = s - a[i][k] * a[j][k];
+      }
+      a[i][j] = s * inv;
+    }
+  }
+}
+
+// Runs fn(group_begin, count) over the groups of Vec256<scalar_t>::size()
+// matrices of the batch, in parallel.
+template <typename scalar_t, int N, typename F>
+inline void parallel_for_groups(int64_t batch_size, const F& fn) {
+  constexpr int64_t lanes = Vec256<scalar_t>::size();
+  const int64_t num_groups = divup(batch_size, lanes);
+  const int64_t grain_size =
+      std::max<int64_t>(internal::GRAIN_SIZE / (N * N * N * lanes), 1);
+  parallel_for(0, num_groups, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t g = begin; g < end; g++) {
+      const int64_t first = g * lanes;
+      fn(first, std::min(lanes, batch_size - first));
+    }
+  });
+}
+
+template <typename scalar_t, int N>
+struct SmallSolve {
+  static void apply(Tensor& b, Tensor& A, std::vector<int64_t>& infos) {
+    using Vec = Vec256<scalar_t>;
+    auto A_data = A.data_ptr<scalar_t>();
+    auto b_data = b.data_ptr<scalar_t>();
+    const auto A_mat_stride = matrixStride(A);
+    const auto b_mat_stride = matrixStride(b);
+    const auto nrhs = b.size(-1);
+    parallel_for_groups<scalar_t, N>(batchCount(A), [&](int64_t first, int64_t count) {
+      Vec a[N][N];
+      Vec piv[N];
+      Vec info(0);
+      scalar_t* A_working_ptr = A_data + first * A_mat_stride;
+      scalar_t* b_working_ptr = b_data + first * b_mat_stride;
+      gather_matrix<scalar_t, N>(a, A_working_ptr, A_mat_stride, count);
+      lu_factor<scalar_t, N>(a, piv, info);
+      scatter_matrix<scalar_t, N>(a, A_working_ptr, A_mat_stride, count);
+      store_infos(info, infos.data() + first, count);
+      for (int64_t r = 0; r < nrhs; r++) {
+        Vec col[N];
+        gather_column<scalar_t, N>(col, b_working_ptr + r * N, b_mat_stride, count, -1);
+        lu_solve_column<scalar_t, N>(a, piv, col);
+        scatter_column<scalar_t, N>(col, b_working_ptr + r * N, b_mat_stride, count);
+      }
+    });
+  }
+};
+
+template <typename scalar_t, int N>
+struct SmallInverse {
+  static void apply(Tensor& self, std::vector<int64_t>& infos) {
+    using Vec = Vec256<scalar_t>;
+    auto self_data = self.data_ptr<scalar_t>();
+    const auto self_matrix_stride = matrixStride(self);
+    parallel_for_groups<scalar_t, N>(batchCount(self), [&](int64_t first, int64_t count) {
+      Vec a[N][N];
+      Vec piv[N];
+      Vec info(0);
+      scalar_t* self_working_ptr = self_data + first * self_matrix_stride;
+      gather_matrix<scalar_t, N>(a, self_working_ptr, self_matrix_stride, count);
+      lu_factor<scalar_t, N>(a, piv, info);
+      store_infos(info, infos.data() + first, count);
+      for (int r = 0; r < N; r++) {
+        Vec col[N];
+        for (int i = 0; i < N; i++) {
+          col[i] = Vec(static_cast<scalar_t>(i == r ? 1 : 0));
+        }
+        lu_solve_column<scalar_t, N>(a, piv, col);
+        scatter_column<scalar_t, N>(col, self_working_ptr + r * N, self_matrix_stride, count);
+      }
+    });
+  }
+};
+
+template <typename scalar_t, int N>
+struct SmallCholesky {
+  static void apply(Tensor& self, bool upper, std::vector<int64_t>& infos) {
+    using Vec = Vec256<scalar_t>;
+    auto self_data = self.data_ptr<scalar_t>();
+    const auto self_matrix_stride = matrixStride(self);
+    parallel_for_groups<scalar_t, N>(batchCount(self), [&](int64_t first, int64_t count) {
+      Vec a[N][N];
+      Vec info(0);
+      scalar_t* self_working_ptr = self_data + first * self_matrix_stride;
+      gather_matrix<scalar_t, N>(a, self_working_ptr, self_matrix_stride, count);
+      // Like LAPACK, only the requested triangle is read and written.
+      if (upper) {
+        for (int j = 0; j < N; j++) {
+          for (int i = j + 1; i < N; i++) {
+            a[i][j] = a[j][i];
+          }
+        }
+      }
+      cholesky_factor<scalar_t, N>(a, info);
+      store_infos(info, infos.data() + first, count);
+      for (int j = 0; j < N; j++) {
+        Vec col[N];
+        for (int i = 0; i < N; i++) {
+          col[i] = upper ? a[j][i] : a[i][j];
+        }
+        scatter_column<scalar_t, N>(
+            col,
+            self_working_ptr + j * N,
+            self_matrix_stride,
+            count,
+            upper ? 0 : j,
+            upper ? j + 1 : N);
+      }
+    });
+  }
+};
+
+template <typename scalar_t, int N>
+struct SmallLu {
+  static void apply(Tensor& self, Tensor& pivots, Tensor& infos) {
+    using Vec = Vec256<scalar_t>;
+    auto self_data = self.data_ptr<scalar_t>();
+    auto pivots_data = pivots.data_ptr<int>();
+    auto infos_data = infos.data_ptr<int>();
+    const auto self_matrix_stride = matrixStride(self);
+    parallel_for_groups<scalar_t, N>(batchCount(self), [&](int64_t first, int64_t count) {
+      Vec a[N][N];
+      Vec piv[N];
+      Vec info(0);
+      scalar_t* self_working_ptr = self_data + first * self_matrix_stride;
+      gather_matrix<scalar_t, N>(a, self_working_ptr, self_matrix_stride, count);
+      lu_factor<scalar_t, N>(a, piv, info);
+      scatter_matrix<scalar_t, N>(a, self_working_ptr, self_matrix_stride, count);
+
+      __at_align32__ scalar_t buf[Vec::size()];
+      for (int k = 0; k < N; k++) {
+        piv[k].store(buf);
+        for (int64_t l = 0; l < count; l++) {
+          // LAPACK pivots are 1-based
+          pivots_data[(first + l) * N + k] = static_cast<int>(buf[l]) + 1;
+        }
+      }
+      info.store(buf);
+      for (int64_t l = 0; l < count; l++) {
+        infos_data[first + l] = static_cast<int>(buf[l]);
+      }
+    });
+  }
+};
+
+template <template <typename, int> class Kernel, typename scalar_t, typename... Args>
+void dispatch_small_size(int64_t n, Args&&... args) {
+  switch (n) {
+    case 1: Kernel<scalar_t, 1>::apply(std::forward<Args>(args)...); break;
+    case 2: Kernel<scalar_t, 2>::apply(std::forward<Args>(args)...); break;
+    case 3: Kernel<scalar_t, 3>::apply(std::forward<Args>(args)...); break;
+    case 4: Kernel<scalar_t, 4>::apply(std::forward<Args>(args)...); break;
+    case 5: Kernel<scalar_t, 5>::apply(std::forward<Args>(args)...); break;
+    case 6: Kernel<scalar_t, 6>::apply(std::forward<Args>(args)...); break;
+    case 7: Kernel<scalar_t, 7>::apply(std::forward<Args>(args)...); break;
+    case 8: Kernel<scalar_t, 8>::apply(std::forward<Args>(args)...); break;
+    default:
+      TORCH_INTERNAL_ASSERT(false, "unsupported small matrix size ", n);
+  }
+  static_assert(SMALL_MATRIX_MAX_SIZE == 8, "update dispatch_small_size");
+}
+
+void small_solve_kernel(Tensor& b, Tensor& A, std::vector<int64_t>& infos) {
+  AT_DISPATCH_FLOATING_TYPES(A.scalar_type(), "small_solve_cpu", [&] {
+    dispatch_small_size<SmallSolve, scalar_t>(A.size(-1), b, A, infos);
+  });
+}
+
+void small_inverse_kernel(Tensor& self, std::vector<int64_t>& infos) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "small_inverse_cpu", [&] {
+    dispatch_small_size<SmallInverse, scalar_t>(self.size(-1), self, infos);
+  });
+}
+
+void small_cholesky_kernel(Tensor& self, bool upper, std::vector<int64_t>& infos) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "small_cholesky_cpu", [&] {
+    dispatch_small_size<SmallCholesky, scalar_t>(self.size(-1), self, upper, infos);
+  });
+}
+
+void small_lu_kernel(Tensor& self, Tensor& pivots, Tensor& infos) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "small_lu_cpu", [&] {
+    dispatch_small_size<SmallLu, scalar_t>(self.size(-1), self, pivots, infos);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(small_solve_stub, &small_solve_kernel);
+REGISTER_DISPATCH(small_inverse_stub, &small_inverse_kernel);
+REGISTER_DISPATCH(small_cholesky_stub, &small_cholesky_kernel);
+REGISTER_DISPATCH(small_lu_stub, &small_lu_kernel);
+
+}} // namespace at::native
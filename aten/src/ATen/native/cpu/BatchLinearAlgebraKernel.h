@@ -0,0 +1,41 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+#include <vector>
+
+namespace at { namespace native {
+
+// [Note small matrix linear algebra]
+// Batches of small real matrices (up to SMALL_MATRIX_MAX_SIZE rows) are
+// factored without LAPACK: for these sizes the per-call overhead of LAPACK
+// dwarfs the arithmetic. The kernels are specialized on the matrix size at
+// compile time, and a group of Vec256<scalar_t>::size() matrices of the batch
+// is processed at once in structure-of-arrays form, one matrix per SIMD lane
+// (partial pivoting is done per lane with blends). Groups run in parallel.
+//
+// All tensors are batched column-major working copies (see
+// cloneBatchedColumnMajor), and the results, pivots and infos match those of
+// the LAPACK routines they replace (getrf, gesv, getrf + getri, potrf).
+constexpr int64_t SMALL_MATRIX_MAX_SIZE = 8;
+
+static inline bool use_small_matrix_kernels(const Tensor& self) {
+  return self.device().type() == DeviceType::CPU &&
+      (self.scalar_type() == ScalarType::Float ||
+       self.scalar_type() == ScalarType::Double) &&
+      self.size(-1) > 0 && self.size(-1) <= SMALL_MATRIX_MAX_SIZE &&
+      self.size(-2) == self.size(-1);
+}
+
+using small_solve_fn = void(*)(Tensor& /* b */, Tensor& /* A */, std::vector<int64_t>& /* infos */);
+using small_inverse_fn = void(*)(Tensor& /* self */, std::vector<int64_t>& /* infos */);
+using small_cholesky_fn = void(*)(Tensor& /* self */, bool /* upper */, std::vector<int64_t>& /* infos */);
+using small_lu_fn = void(*)(Tensor& /* self */, Tensor& /* pivots */, Tensor& /* infos */);
+
+DECLARE_DISPATCH(small_solve_fn, small_solve_stub);
+DECLARE_DISPATCH(small_inverse_fn, small_inverse_stub);
+DECLARE_DISPATCH(small_cholesky_fn, small_cholesky_stub);
+DECLARE_DISPATCH(small_lu_fn, small_lu_stub);
+
+}} // namespace at::native
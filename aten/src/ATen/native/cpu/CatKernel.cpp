@@ -1,67 +1,72 @@
 #include <ATen/ATen.h>
 
-#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 #include <ATen/native/cpu/CatKernel.h>
-#include <ATen/cpu/vec256/functional.h>
-#include <ATen/cpu/vec256/vec256.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 namespace at { namespace native {
 
 namespace {
 
-struct InputMeta {
-  void* data_ptr;
-  int64_t inner_size;
-
-  InputMeta(const Tensor& t, int64_t dim, int64_t inner)
-    : data_ptr(t.data_ptr())
-    , inner_size(t.size(dim) * inner) {}
-};
+// The output is a sequence of rows, one per index of the dimensions outside
+// dim, and every row is the concatenation of the matching rows of the
+// inputs. The bytes of the whole output are split evenly over threads, so
+// thousands of small inputs and a few large ones parallelize alike; every
+// thread copies its byte range with memcpy, one input row piece at a time.
+void cat_contiguous_kernel(Tensor& result, TensorList tensors, IntArrayRef slice_sizes, int64_t dim) {
+  const int64_t ninputs = tensors.size();
+  const int64_t element_size = result.element_size();
+  const int64_t inner_bytes = result.stride(dim) * element_size;
+  const int64_t row_bytes = result.size(dim) * inner_bytes;
+  if (row_bytes == 0) {
+    return;
+  }
+  const int64_t total_bytes = result.numel() * element_size;
 
-template <typename scalar_t>
-void cat_serial_kernel_impl(Tensor& result, TensorList tensors, int64_t dim) {
-  int64_t outer = result.numel() / (result.size(dim) * result.stride(dim));
-  scalar_t* result_data = result.data_ptr<scalar_t>();
-  int64_t ninputs = tensors.size();
-  std::vector<InputMeta> inputs;
-  inputs.reserve(ninputs);
-  for (auto const &tensor : tensors) {
-    inputs.emplace_back(tensor, dim, result.stride(dim));
+  // Byte offset of every input's piece within an output row.
+  std::vector<int64_t> piece_begin(ninputs + 1, 0);
+  std::vector<const char*> input_data(ninputs, nullptr);
+  for (int64_t j = 0; j < ninputs; j++) {
+    piece_begin[j + 1] = piece_begin[j] + slice_sizes[j] * inner_bytes;
+    if (tensors[j].defined()) {
+      input_data[j] = static_cast<const char*>(tensors[j].data_ptr());
+    }
   }
+  char* result_data = static_cast<char*>(result.data_ptr());
 
-  using Vec = vec256::Vec256<scalar_t>;
-  scalar_t* result_ptr = result_data;
-  for (int64_t i = 0; i < outer; ++i) {
-    for (int64_t j = 0; j < ninputs; j++) {
-      int64_t local_inner = inputs[j].inner_size;
-      scalar_t* input_ptr = (scalar_t*)(inputs[j].data_ptr) + i * local_inner;
-      if (local_inner < Vec::size()) {
-        #ifndef _MSC_VER
-        # pragma unroll
-        #endif
-        for (int64_t k = 0; k < local_inner; k++) {
-          result_ptr[k] = input_ptr[k];
+  at::parallel_for(0, total_bytes, at::internal::GRAIN_SIZE * element_size, [&](int64_t begin, int64_t end) {
+    int64_t row = begin / row_bytes;
+    int64_t pos = begin - row * row_bytes;
+    // Last input whose piece starts at or before pos; inputs with empty
+    // pieces before it are skipped.
+    int64_t j = std::upper_bound(piece_begin.begin(), piece_begin.end(), pos) - piece_begin.begin() - 1;
+    while (begin < end) {
+      const int64_t piece_bytes = piece_begin[j + 1] - piece_begin[j];
+      const int64_t len = std::min(piece_begin[j + 1] - pos, end - begin);
+      if (input_data[j] != nullptr && len > 0) {
+        std::memcpy(
+            result_data + begin,
+            input_data[j] + row * piece_bytes + (pos - piece_begin[j]),
+            len);
+      }
+      begin += len;
+      pos += len;
+      if (pos == piece_begin[j + 1]) {
+        if (++j == ninputs) {
+          j = 0;
+          pos = 0;
+          row++;
         }
-      } else {
-        vec256::map(
-            [](Vec x) { return x; },
-            result_ptr,
-            input_ptr,
-            local_inner);
       }
-      result_ptr += local_inner;
     }
-  }
-}
-
-void cat_serial_kernel(Tensor& result, TensorList tensors, int64_t dim) {
-  AT_DISPATCH_FLOATING_TYPES(result.scalar_type(), "cat_serial_kernel", [&]() {
-    cat_serial_kernel_impl<scalar_t>(result, tensors, dim);
   });
 }
 
 } // anonymous namespace
 
-REGISTER_DISPATCH(cat_serial_stub, &cat_serial_kernel);
+REGISTER_DISPATCH(cat_contiguous_stub, &cat_contiguous_kernel);
 
 }} // at::native
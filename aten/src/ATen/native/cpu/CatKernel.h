@@ -5,7 +5,11 @@
 
 namespace at { namespace native {
 
-using cat_serial_fn = void(*)(Tensor &, TensorList, int64_t);
-DECLARE_DISPATCH(cat_serial_fn, cat_serial_stub);
+// Copies every defined tensors[i] into slice i of result along dim, whose
+// size is slice_sizes[i]; slices of undefined tensors are left untouched.
+// result and the defined tensors are contiguous in the same memory format
+// and have the same dtype.
+using cat_contiguous_fn = void(*)(Tensor& result, TensorList tensors, IntArrayRef slice_sizes, int64_t dim);
+DECLARE_DISPATCH(cat_contiguous_fn, cat_contiguous_stub);
 
 }}  // namespace at::native
@@ -0,0 +1,428 @@
+#include <ATen/native/cpu/ConvChannelsLastKernel.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <list>
+#include <mutex>
+#include <vector>
+
+namespace at {
+namespace native {
+namespace {
+
+// [Note channels last convolution]
+// A direct (implicit GEMM) convolution for channels last tensors, which needs
+// neither an im2col buffer nor a conversion of the input to NCHW.
+//
+// In NHWC, the input channels of one pixel and the output channels of one
+// pixel are both contiguous. The weight is packed into blocks of kBlockVecs
+// vectors of output channels, laid out [kh][kw][ic][block] so that the
+// microkernel streams it linearly, and cached (see [Note packed convolution
+// weights]) so that inference packs each weight once. The microkernel
+// computes kBlockPixels consecutive output pixels of one output row times one
+// block of output channels, keeping all kBlockPixels * kBlockVecs
+// accumulators in registers: every input value is broadcast once and
+// multiplied into kBlockVecs weight vectors. Padding is handled by pointing
+// the pixels that fall outside the input at a row of zeros, which keeps the
+// inner loop free of branches. Output rows are processed in parallel.
+//
+// Depthwise convolutions (one input and one output channel per group) have
+// nothing to reduce over channels, so they are vectorized over the channels
+// instead.
+constexpr int64_t kBlockPixels = 4;
+constexpr int64_t kBlockVecs = 2;
+
+struct ConvShape {
+  int64_t batch;
+  int64_t channels;
+  int64_t in_h;
+  int64_t in_w;
+  int64_t out_channels;
+  int64_t out_h;
+  int64_t out_w;
+  int64_t kernel_h;
+  int64_t kernel_w;
+  int64_t stride_h;
+  int64_t stride_w;
+  int64_t pad_h;
+  int64_t pad_w;
+  int64_t dilation_h;
+  int64_t dilation_w;
+  int64_t groups;
+};
+
+// [Note packed convolution weights]
+// The packed weight (and bias) of the last kPackedWeightCacheSize
+// convolutions are kept, looked up by the storage, data pointer, sizes and
+// version of the weight and bias they were packed from. The storages are
+// held by weak references, so that a storage can't be freed and another one
+// allocated at the same address and mistakenly hit in the cache. An in-place
+// update of the weight, e.g. by an optimizer or load_state_dict, bumps its
+// version and misses; like for autograd's saved tensors, writes that don't
+// bump the version (through .data, or through data_ptr() in C++) are not
+// seen.
+constexpr size_t kPackedWeightCacheSize = 16;
+
+struct PackedConvWeight {
+  Tensor weight;
+  // Undefined for depthwise convolutions, which read the bias directly
+  Tensor bias;
+};
+
+// Identifies the contents of a tensor, see [Note packed convolution weights]
+struct TensorKey {
+  explicit TensorKey(const Tensor& t)
+      : storage(
+            t.defined() ? c10::intrusive_ptr<StorageImpl>::
+                              unsafe_reclaim_from_nonowning(
+                                  t.storage().unsafeGetStorageImpl())
+                        : c10::intrusive_ptr<StorageImpl>()),
+        data(t.defined() ? t.data_ptr() : nullptr),
+        sizes(t.defined() ? t.sizes().vec() : std::vector<int64_t>()),
+        version(
+            t.defined()
+                ? t.unsafeGetTensorImpl()->version_counter().current_version()
+                : 0) {}
+
+  bool same_tensor(const Tensor& t) const {
+    if (!t.defined()) {
+      return data == nullptr;
+    }
+    return !storage.expired() &&
+        storage._unsafe_get_target() == t.storage().unsafeGetStorageImpl() &&
+        data == t.data_ptr() && sizes == t.sizes();
+  }
+
+  bool matches(const Tensor& t) const {
+    return same_tensor(t) &&
+        (!t.defined() ||
+         version ==
+             t.unsafeGetTensorImpl()->version_counter().current_version());
+  }
+
+  c10::weak_intrusive_ptr<StorageImpl> storage;
+  const void* data;
+  std::vector<int64_t> sizes;
+  uint32_t version;
+};
+
+struct PackedWeightCacheEntry {
+  TensorKey weight;
+  TensorKey bias;
+  int64_t groups;
+  PackedConvWeight packed;
+};
+
+struct PackedWeightCache {
+  std::mutex mutex;
+  // Most recently used first
+  std::list<PackedWeightCacheEntry> entries;
+};
+
+PackedWeightCache& packed_weight_cache() {
+  static PackedWeightCache cache;
+  return cache;
+}
+
+// Returns the packed weight of `weight` and `bias`, calling `pack` on a miss
+template <typename PackFn>
+PackedConvWeight get_packed_weight(
+    const Tensor& weight,
+    const Tensor& bias,
+    int64_t groups,
+    const PackFn& pack) {
+  PackedWeightCache& cache = packed_weight_cache();
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto& entries = cache.entries;
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+      if (it->weight.matches(weight) && it->bias.matches(bias) &&
+          it->groups == groups) {
+        entries.splice(entries.begin(), entries, it);
+        return entries.front().packed;
+      }
+    }
+  }
+
+  // Packed without the lock: concurrent misses on one weight pack it twice
+  PackedWeightCacheEntry entry{
+      TensorKey(weight), TensorKey(bias), groups, pack()};
+  PackedConvWeight packed = entry.packed;
+
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  auto& entries = cache.entries;
+  // Drop the entries of freed weights and the older versions of this one
+  entries.remove_if([&](const PackedWeightCacheEntry& e) {
+    return e.weight.storage.expired() || e.weight.same_tensor(weight);
+  });
+  entries.push_front(std::move(entry));
+  if (entries.size() > kPackedWeightCacheSize) {
+    entries.pop_back();
+  }
+  return packed;
+}
+
+// Stores the first `count` lanes of the kBlockVecs vectors of `acc`
+template <typename scalar_t>
+inline void store_block(
+    scalar_t* dst,
+    const vec256::Vec256<scalar_t>* acc,
+    int64_t count) {
+  using Vec = vec256::Vec256<scalar_t>;
+  for (int64_t v = 0; v < kBlockVecs; v++) {
+    const int64_t remaining = count - v * Vec::size();
+    if (remaining >= Vec::size()) {
+      acc[v].store(dst + v * Vec::size());
+    } else if (remaining > 0) {
+      acc[v].store(dst + v * Vec::size(), remaining);
+    }
+  }
+}
+
+template <typename scalar_t>
+PackedConvWeight pack_generic_weight(
+    const Tensor& weight_t,
+    const Tensor& bias_t,
+    const ConvShape& s) {
+  using Vec = vec256::Vec256<scalar_t>;
+  constexpr int64_t block = kBlockVecs * Vec::size();
+  const int64_t ic_g = s.channels / s.groups;
+  const int64_t oc_g = s.out_channels / s.groups;
+  const int64_t oc_blocks = divup(oc_g, block);
+  const int64_t kernel_hw = s.kernel_h * s.kernel_w;
+  const int64_t packed_block_size = kernel_hw * ic_g * block;
+
+  // weight is [out_channels][ic_g][kernel_h][kernel_w]; packed is
+  // [groups][oc_blocks][kernel_h][kernel_w][ic_g][block], zero padded
+  Tensor packed_t = at::zeros({s.groups * oc_blocks * packed_block_size}, weight_t.options());
+  Tensor packed_bias_t = at::zeros({s.groups * oc_blocks * block}, weight_t.options());
+  const scalar_t* weight = weight_t.data_ptr<scalar_t>();
+  const scalar_t* bias = bias_t.defined() ? bias_t.data_ptr<scalar_t>() : nullptr;
+  scalar_t* packed = packed_t.data_ptr<scalar_t>();
+  scalar_t* packed_bias = packed_bias_t.data_ptr<scalar_t>();
+  at::parallel_for(0, s.groups * oc_blocks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t gb = begin; gb < end; gb++) {
+      const int64_t g = gb / oc_blocks;
+      const int64_t oc_begin = (gb % oc_blocks) * block;
+      const int64_t count = std::min(block, oc_g - oc_begin);
+      scalar_t* dst = packed + gb * packed_block_size;
+      for (int64_t o = 0; o < count; o++) {
+        const int64_t oc = g * oc_g + oc_begin + o;
+        for (int64_t c = 0; c < ic_g; c++) {
+          for (int64_t k = 0; k < kernel_hw; k++) {
+            dst[(k * ic_g + c) * block + o] = weight[(oc * ic_g + c) * kernel_hw + k];
+          }
+        }
+        if (bias != nullptr) {
+          packed_bias[gb * block + o] = bias[oc];
+        }
+      }
+    }
+  });
+  return {packed_t, packed_bias_t};
+}
+
+// `packed` and `packed_bias` come from pack_generic_weight
+template <typename scalar_t>
+void conv2d_channels_last_generic(
+    scalar_t* output,
+    const scalar_t* input,
+    const scalar_t* packed,
+    const scalar_t* packed_bias,
+    const ConvShape& s) {
+  using Vec = vec256::Vec256<scalar_t>;
+  constexpr int64_t block = kBlockVecs * Vec::size();
+  const int64_t ic_g = s.channels / s.groups;
+  const int64_t oc_g = s.out_channels / s.groups;
+  const int64_t oc_blocks = divup(oc_g, block);
+  const int64_t kernel_hw = s.kernel_h * s.kernel_w;
+  const int64_t packed_block_size = kernel_hw * ic_g * block;
+
+  // Pixels outside of the input read their channels from here
+  const std::vector<scalar_t> zeros(ic_g, 0);
+
+  const int64_t row_cost = s.out_w * s.out_channels * kernel_hw * ic_g;
+  const int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(1, row_cost));
+  at::parallel_for(0, s.batch * s.out_h, grain_size, [&](int64_t begin, int64_t end) {
+    const scalar_t* src[kBlockPixels];
+    Vec acc[kBlockPixels][kBlockVecs];
+
+    for (int64_t row = begin; row < end; row++) {
+      const int64_t n = row / s.out_h;
+      const int64_t oh = row % s.out_h;
+      scalar_t* out_row = output + row * s.out_w * s.out_channels;
+
+      for (int64_t gb = 0; gb < s.groups * oc_blocks; gb++) {
+        const int64_t g = gb / oc_blocks;
+        const int64_t oc_begin = (gb % oc_blocks) * block;
+        const int64_t count = std::min(block, oc_g - oc_begin);
+        const scalar_t* w_block = packed + gb * packed_block_size;
+        const scalar_t* b_block = packed_bias + gb * block;
+        const scalar_t* in_group = input + g * ic_g;
+
+        for (int64_t ow_begin = 0; ow_begin < s.out_w; ow_begin += kBlockPixels) {
+          const int64_t pixels = std::min(kBlockPixels, s.out_w - ow_begin);
+          for (int64_t p = 0; p < kBlockPixels; p++) {
+            for (int64_t v = 0; v < kBlockVecs; v++) {
+              acc[p][v] = Vec::loadu(b_block + v * Vec::size());
+            }
+          }
+
+          for (int64_t kh = 0; kh < s.kernel_h; kh++) {
+            const int64_t ih = oh * s.stride_h - s.pad_h + kh * s.dilation_h;
+            const bool row_valid = ih >= 0 && ih < s.in_h;
+            for (int64_t kw = 0; kw < s.kernel_w; kw++) {
+              for (int64_t p = 0; p < kBlockPixels; p++) {
+                const int64_t iw = (ow_begin + p) * s.stride_w - s.pad_w + kw * s.dilation_w;
+                const bool valid = row_valid && p < pixels && iw >= 0 && iw < s.in_w;
+                src[p] = valid ? in_group + ((n * s.in_h + ih) * s.in_w + iw) * s.channels : zeros.data();
+              }
+
+              const scalar_t* w = w_block + (kh * s.kernel_w + kw) * ic_g * block;
+              for (int64_t c = 0; c < ic_g; c++, w += block) {
+                Vec w_vec[kBlockVecs];
+                for (int64_t v = 0; v < kBlockVecs; v++) {
+                  w_vec[v] = Vec::loadu(w + v * Vec::size());
+                }
+                for (int64_t p = 0; p < kBlockPixels; p++) {
+                  const Vec x(src[p][c]);
+                  for (int64_t v = 0; v < kBlockVecs; v++) {
+                    acc[p][v] = vec256::fmadd(x, w_vec[v], acc[p][v]);
+                  }
+                }
+              }
+            }
+          }
+
+          for (int64_t p = 0; p < pixels; p++) {
+            store_block(
+                out_row + (ow_begin + p) * s.out_channels + g * oc_g + oc_begin,
+                acc[p],
+                count);
+          }
+        }
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+PackedConvWeight pack_depthwise_weight(const Tensor& weight_t, const ConvShape& s) {
+  const int64_t channels = s.channels;
+  const int64_t kernel_hw = s.kernel_h * s.kernel_w;
+
+  // weight is [channels][1][kernel_h][kernel_w]; packed is [kernel_h][kernel_w][channels]
+  Tensor packed_t = at::empty({kernel_hw * channels}, weight_t.options());
+  const scalar_t* weight = weight_t.data_ptr<scalar_t>();
+  scalar_t* packed = packed_t.data_ptr<scalar_t>();
+  for (int64_t c = 0; c < channels; c++) {
+    for (int64_t k = 0; k < kernel_hw; k++) {
+      packed[k * channels + c] = weight[c * kernel_hw + k];
+    }
+  }
+  return {packed_t, Tensor()};
+}
+
+// `packed` comes from pack_depthwise_weight
+template <typename scalar_t>
+void conv2d_channels_last_depthwise(
+    scalar_t* output,
+    const scalar_t* input,
+    const scalar_t* packed,
+    const scalar_t* bias,
+    const ConvShape& s) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const int64_t channels = s.channels;
+  const int64_t kernel_hw = s.kernel_h * s.kernel_w;
+
+  const int64_t row_cost = s.out_w * channels * kernel_hw;
+  const int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(1, row_cost));
+  at::parallel_for(0, s.batch * s.out_h, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; row++) {
+      const int64_t n = row / s.out_h;
+      const int64_t oh = row % s.out_h;
+      for (int64_t ow = 0; ow < s.out_w; ow++) {
+        scalar_t* out = output + (row * s.out_w + ow) * channels;
+        int64_t c = 0;
+        for (; c < channels; c += Vec::size()) {
+          const int64_t count = std::min<int64_t>(Vec::size(), channels - c);
+          Vec acc = bias != nullptr ? Vec::loadu(bias + c, count) : Vec(0);
+          for (int64_t kh = 0; kh < s.kernel_h; kh++) {
+            const int64_t ih = oh * s.stride_h - s.pad_h + kh * s.dilation_h;
+            if (ih < 0 || ih >= s.in_h) {
+              continue;
+            }
+            for (int64_t kw = 0; kw < s.kernel_w; kw++) {
+              const int64_t iw = ow * s.stride_w - s.pad_w + kw * s.dilation_w;
+              if (iw < 0 || iw >= s.in_w) {
+                continue;
+              }
+              const scalar_t* in = input + ((n * s.in_h + ih) * s.in_w + iw) * channels + c;
+              const scalar_t* w = packed + (kh * s.kernel_w + kw) * channels + c;
+              acc = vec256::fmadd(Vec::loadu(in, count), Vec::loadu(w, count), acc);
+            }
+          }
+          acc.store(out + c, count);
+        }
+      }
+    }
+  });
+}
+
+void conv2d_channels_last_kernel(
+    Tensor& output,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups) {
+  const ConvShape shape{
+      input.size(0),
+      input.size(1),
+      input.size(2),
+      input.size(3),
+      output.size(1),
+      output.size(2),
+      output.size(3),
+      weight.size(2),
+      weight.size(3),
+      stride[0],
+      stride[1],
+      padding[0],
+      padding[1],
+      dilation[0],
+      dilation[1],
+      groups,
+  };
+  const bool depthwise = groups == shape.channels && groups == shape.out_channels;
+
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "conv2d_channels_last", [&] {
+    scalar_t* output_data = output.data_ptr<scalar_t>();
+    const scalar_t* input_data = input.data_ptr<scalar_t>();
+    // Depthwise convolutions don't pack the bias, so it isn't part of the key
+    const PackedConvWeight packed = get_packed_weight(weight, depthwise ? Tensor() : bias, groups, [&] {
+      return depthwise ? pack_depthwise_weight<scalar_t>(weight, shape)
+                       : pack_generic_weight<scalar_t>(weight, bias, shape);
+    });
+    const scalar_t* packed_weight = packed.weight.data_ptr<scalar_t>();
+    if (depthwise) {
+      const scalar_t* bias_data = bias.defined() ? bias.data_ptr<scalar_t>() : nullptr;
+      conv2d_channels_last_depthwise(output_data, input_data, packed_weight, bias_data, shape);
+    } else {
+      const scalar_t* packed_bias = packed.bias.data_ptr<scalar_t>();
+      conv2d_channels_last_generic(output_data, input_data, packed_weight, packed_bias, shape);
+    }
+  });
+}
+
+}  // namespace
+
+REGISTER_DISPATCH(conv2d_channels_last_stub, &conv2d_channels_last_kernel);
+
+}  // namespace native
+}  // namespace at
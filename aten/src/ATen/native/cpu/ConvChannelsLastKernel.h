@@ -0,0 +1,29 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+/*
+  Direct 2d convolution of channels last (NHWC) tensors
+*/
+
+namespace at {
+namespace native {
+
+// Writes the convolution of the channels last `input` with the contiguous
+// `weight` (and optional contiguous `bias`) into the channels last `output`,
+// which is already sized.
+using conv2d_channels_last_fn = void (*)(
+    Tensor& /* output */,
+    const Tensor& /* input */,
+    const Tensor& /* weight */,
+    const Tensor& /* bias */,
+    IntArrayRef /* stride */,
+    IntArrayRef /* padding */,
+    IntArrayRef /* dilation */,
+    int64_t /* groups */);
+
+DECLARE_DISPATCH(conv2d_channels_last_fn, conv2d_channels_last_stub);
+
+}  // namespace native
+}  // namespace at
@@ -1,11 +1,16 @@
 #include <ATen/ATen.h>
 
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/intrinsics.h>
 #include <ATen/native/Copy.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
 #include <c10/util/TypeCast.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace at {
 namespace native {
 namespace {
@@ -64,9 +69,224 @@ static void copy_kernel(TensorIterator& iter, bool non_blocking) {
   }
 }
 
+// Edge of the tiles the permuting copy works on: a 32x32 tile of the source
+// and one of the destination fit in L1 together for every element size.
+constexpr int64_t kPermuteBlockSize = 32;
+
+// Transposes a KxK block, dst[j * ld_dst + i] = src[i * ld_src + j]. The
+// permuting copy only moves bytes, so it works on unsigned integers of the
+// element size; the AVX2 versions shuffle them as floats and doubles, which
+// leaves the bits unchanged.
+template <typename T>
+struct BlockTranspose {
+  static constexpr int64_t kSize = 1;
+  static void apply(const T* src, int64_t /*ld_src*/, T* dst, int64_t /*ld_dst*/) {
+    *dst = *src;
+  }
+};
+
+#if (defined(CPU_CAPABILITY_AVX2) || defined(CPU_CAPABILITY_AVX512)) && !defined(_MSC_VER)
+
+template <>
+struct BlockTranspose<uint32_t> {
+  static constexpr int64_t kSize = 8;
+  static void apply(const uint32_t* src, int64_t ld_src, uint32_t* dst, int64_t ld_dst) {
+    const float* s = reinterpret_cast<const float*>(src);
+    float* d = reinterpret_cast<float*>(dst);
+    __m256 r0 = _mm256_loadu_ps(s);
+    __m256 r1 = _mm256_loadu_ps(s + ld_src);
+    __m256 r2 = _mm256_loadu_ps(s + 2 * ld_src);
+    __m256 r3 = _mm256_loadu_ps(s + 3 * ld_src);
+    __m256 r4 = _mm256_loadu_ps(s + 4 * ld_src);
+    __m256 r5 = _mm256_loadu_ps(s + 5 * ld_src);
+    __m256 r6 = _mm256_loadu_ps(s + 6 * ld_src);
+    __m256 r7 = _mm256_loadu_ps(s + 7 * ld_src);
+
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+    __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+    __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+    __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+    __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+    __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+
+    r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    r4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    r5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    r6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    r7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    _mm256_storeu_ps(d, _mm256_permute2f128_ps(r0, r4, 0x20));
+    _mm256_storeu_ps(d + ld_dst, _mm256_permute2f128_ps(r1, r5, 0x20));
+    _mm256_storeu_ps(d + 2 * ld_dst, _mm256_permute2f128_ps(r2, r6, 0x20));
+    _mm256_storeu_ps(d + 3 * ld_dst, _mm256_permute2f128_ps(r3, r7, 0x20));
+    _mm256_storeu_ps(d + 4 * ld_dst, _mm256_permute2f128_ps(r0, r4, 0x31));
+    _mm256_storeu_ps(d + 5 * ld_dst, _mm256_permute2f128_ps(r1, r5, 0x31));
+    _mm256_storeu_ps(d + 6 * ld_dst, _mm256_permute2f128_ps(r2, r6, 0x31));
+    _mm256_storeu_ps(d + 7 * ld_dst, _mm256_permute2f128_ps(r3, r7, 0x31));
+  }
+};
+
+template <>
+struct BlockTranspose<uint64_t> {
+  static constexpr int64_t kSize = 4;
+  static void apply(const uint64_t* src, int64_t ld_src, uint64_t* dst, int64_t ld_dst) {
+    const double* s = reinterpret_cast<const double*>(src);
+    double* d = reinterpret_cast<double*>(dst);
+    __m256d r0 = _mm256_loadu_pd(s);
+    __m256d r1 = _mm256_loadu_pd(s + ld_src);
+    __m256d r2 = _mm256_loadu_pd(s + 2 * ld_src);
+    __m256d r3 = _mm256_loadu_pd(s + 3 * ld_src);
+
+    __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+    __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+    __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+    __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+
+    _mm256_storeu_pd(d, _mm256_permute2f128_pd(t0, t2, 0x20));
+    _mm256_storeu_pd(d + ld_dst, _mm256_permute2f128_pd(t1, t3, 0x20));
+    _mm256_storeu_pd(d + 2 * ld_dst, _mm256_permute2f128_pd(t0, t2, 0x31));
+    _mm256_storeu_pd(d + 3 * ld_dst, _mm256_permute2f128_pd(t1, t3, 0x31));
+  }
+};
+
+#endif
+
+template <typename T>
+void transpose_scalar(const T* src, int64_t ld_src, T* dst, int64_t ld_dst, int64_t rows, int64_t cols) {
+  for (int64_t i = 0; i < rows; i++) {
+    for (int64_t j = 0; j < cols; j++) {
+      dst[j * ld_dst + i] = src[i * ld_src + j];
+    }
+  }
+}
+
+// dst[j * ld_dst + i] = src[i * ld_src + j] for i < rows, j < cols.
+template <typename T>
+void transpose_tile(const T* src, int64_t ld_src, T* dst, int64_t ld_dst, int64_t rows, int64_t cols) {
+  constexpr int64_t K = BlockTranspose<T>::kSize;
+  int64_t i = 0;
+  for (; i + K <= rows; i += K) {
+    int64_t j = 0;
+    for (; j + K <= cols; j += K) {
+      BlockTranspose<T>::apply(src + i * ld_src + j, ld_src, dst + j * ld_dst + i, ld_dst);
+    }
+    transpose_scalar(src + i * ld_src + j, ld_src, dst + j * ld_dst + i, ld_dst, K, cols - j);
+  }
+  transpose_scalar(src + i * ld_src, ld_src, dst + i, ld_dst, rows - i, cols);
+}
+
+struct PermutedDim {
+  int64_t size;
+  int64_t out_stride;
+  int64_t in_stride;
+};
+
+// The copy is a batch of 2-D transposes between the dimension a that is
+// innermost in the output and the dimension b that is innermost in the
+// input. Both are cut into kPermuteBlockSize tiles, and the tiles of all
+// batches are spread over threads.
+template <typename T>
+void copy_permute(
+    T* out,
+    const T* in,
+    const std::vector<PermutedDim>& batch_dims,
+    const PermutedDim& a,
+    const PermutedDim& b) {
+  int64_t num_batches = 1;
+  for (const auto& d : batch_dims) {
+    num_batches *= d.size;
+  }
+  const int64_t tiles_a = divup(a.size, kPermuteBlockSize);
+  const int64_t tiles_b = divup(b.size, kPermuteBlockSize);
+  const int64_t num_tiles = num_batches * tiles_b * tiles_a;
+  const int64_t grain_size = divup(at::internal::GRAIN_SIZE, kPermuteBlockSize * kPermuteBlockSize);
+
+  at::parallel_for(0, num_tiles, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t tile = begin; tile < end; tile++) {
+      const int64_t a_begin = (tile % tiles_a) * kPermuteBlockSize;
+      const int64_t b_begin = (tile / tiles_a % tiles_b) * kPermuteBlockSize;
+      int64_t batch = tile / tiles_a / tiles_b;
+      int64_t out_offset = a_begin * a.out_stride + b_begin * b.out_stride;
+      int64_t in_offset = a_begin * a.in_stride + b_begin * b.in_stride;
+      for (int64_t d = batch_dims.size() - 1; d >= 0; d--) {
+        const int64_t idx = batch % batch_dims[d].size;
+        batch /= batch_dims[d].size;
+        out_offset += idx * batch_dims[d].out_stride;
+        in_offset += idx * batch_dims[d].in_stride;
+      }
+      transpose_tile(
+          in + in_offset, a.in_stride, out + out_offset, b.out_stride,
+          std::min(kPermuteBlockSize, a.size - a_begin),
+          std::min(kPermuteBlockSize, b.size - b_begin));
+    }
+  });
+}
+
+static void copy_permute_kernel(Tensor& self, const Tensor& src) {
+  std::vector<PermutedDim> dims;
+  for (int64_t d = 0; d < self.dim(); d++) {
+    if (self.size(d) != 1) {
+      dims.push_back({self.size(d), self.stride(d), src.stride(d)});
+    }
+  }
+  // Outermost output dimension first, then merge dimensions that are nested
+  // the same way in both tensors (e.g. H and W when converting NCHW to NHWC).
+  std::stable_sort(dims.begin(), dims.end(), [](const PermutedDim& x, const PermutedDim& y) {
+    return x.out_stride > y.out_stride;
+  });
+  std::vector<PermutedDim> merged;
+  for (const auto& d : dims) {
+    if (!merged.empty() &&
+        merged.back().out_stride == d.out_stride * d.size &&
+        merged.back().in_stride == d.in_stride * d.size) {
+      merged.back() = {merged.back().size * d.size, d.out_stride, d.in_stride};
+    } else {
+      merged.push_back(d);
+    }
+  }
+
+  TORCH_INTERNAL_ASSERT(merged.size() >= 2 && merged.back().out_stride == 1);
+  const PermutedDim a = merged.back();
+  merged.pop_back();
+  auto b_it = std::find_if(merged.begin(), merged.end(), [](const PermutedDim& d) {
+    return d.in_stride == 1;
+  });
+  TORCH_INTERNAL_ASSERT(b_it != merged.end());
+  const PermutedDim b = *b_it;
+  merged.erase(b_it);
+
+  switch (self.element_size()) {
+    case 1:
+      copy_permute(static_cast<uint8_t*>(self.data_ptr()), static_cast<const uint8_t*>(src.data_ptr()), merged, a, b);
+      break;
+    case 2:
+      copy_permute(static_cast<uint16_t*>(self.data_ptr()), static_cast<const uint16_t*>(src.data_ptr()), merged, a, b);
+      break;
+    case 4:
+      copy_permute(static_cast<uint32_t*>(self.data_ptr()), static_cast<const uint32_t*>(src.data_ptr()), merged, a, b);
+      break;
+    case 8:
+      copy_permute(static_cast<uint64_t*>(self.data_ptr()), static_cast<const uint64_t*>(src.data_ptr()), merged, a, b);
+      break;
+    case 16:
+      copy_permute(
+          static_cast<c10::complex<double>*>(self.data_ptr()),
+          static_cast<const c10::complex<double>*>(src.data_ptr()), merged, a, b);
+      break;
+    default:
+      TORCH_INTERNAL_ASSERT(false, "copy_: unexpected element size ", self.element_size());
+  }
+}
+
 } // anonymous namespace
 
 REGISTER_DISPATCH(copy_stub, &copy_kernel);
+REGISTER_DISPATCH(copy_permute_stub, &copy_permute_kernel);
 
 } // namespace native
 } // namespace at
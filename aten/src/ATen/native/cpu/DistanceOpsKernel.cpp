@@ -3,10 +3,12 @@
 #include <numeric>
 #include <iterator>
 #include <algorithm>
+#include <vector>
 
 #include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
 #include <ATen/cpu/vml.h>
+#include <ATen/native/CPUBlas.h>
 
 namespace at { namespace native { namespace {
 
@@ -257,6 +259,175 @@ struct Dist {
     }
   }
 
+  // [Note cdist topk]
+  // cdist_topk finds the k nearest rows of x2 for every row of x1 without
+  // materializing the r1 x r2 distance matrix. Rows of x1 are split into
+  // blocks that run in parallel; each block streams over x2 in tiles of
+  // cdist_topk_candidate_block rows, computes the block x tile distances into
+  // a thread-local buffer and folds them into a bounded max-heap per row.
+  //
+  // For p = 2 and cosine distances the tile is a single GEMM of the inner
+  // products x1_i . x2_j, from which |x1_i|^2 + |x2_j|^2 - 2 x1_i . x2_j (the
+  // squared distance, used only for ranking) resp. 1 - cos(x1_i, x2_j) follow.
+  // The euclidean distances of the k winners are then recomputed directly, so
+  // the returned values don't suffer from the cancellation in the expansion.
+  // Other p use the same map / red / finish loops as cdist.
+  //
+  // Candidates are ordered by (distance, index), with NaN larger than any
+  // distance, which matches a stable sort of the full distance row.
+  using TopkEntry = std::pair<scalar_t, int64_t>;
+
+  static inline bool topk_less(const TopkEntry& a, const TopkEntry& b) {
+    const bool a_nan = std::isnan(a.first);
+    const bool b_nan = std::isnan(b.first);
+    if (a_nan || b_nan) {
+      return a_nan == b_nan ? a.second < b.second : b_nan;
+    }
+    return a.first < b.first || (a.first == b.first && a.second < b.second);
+  }
+
+  // Keeps the k smallest entries pushed so far, largest at the front
+  static inline void topk_push(std::vector<TopkEntry>& heap, int64_t k, const TopkEntry& entry) {
+    if (static_cast<int64_t>(heap.size()) < k) {
+      heap.push_back(entry);
+      std::push_heap(heap.begin(), heap.end(), topk_less);
+    } else if (topk_less(entry, heap.front())) {
+      std::pop_heap(heap.begin(), heap.end(), topk_less);
+      heap.back() = entry;
+      std::push_heap(heap.begin(), heap.end(), topk_less);
+    }
+  }
+
+  template <typename F>
+  static inline scalar_t dist_row(const scalar_t * a, const scalar_t * b, int64_t m, const scalar_t p) {
+    scalar_t agg = 0;
+    for (int64_t x = 0; x < m; x++) {
+      agg = F::red(agg, F::map(std::abs(a[x] - b[x]), p));
+    }
+    return F::finish(agg, p);
+  }
+
+  template <typename F>
+  static void run_parallel_cdist_topk(Tensor& values, Tensor& indices, const Tensor& x1, const Tensor& x2, const scalar_t p, bool use_gemm, bool cosine) {
+    const scalar_t * const x1_start = x1.data_ptr<scalar_t>();
+    const scalar_t * const x2_start = x2.data_ptr<scalar_t>();
+    scalar_t * const values_start = values.data_ptr<scalar_t>();
+    int64_t * const indices_start = indices.data_ptr<int64_t>();
+    const int64_t r1 = x1.size(0);
+    const int64_t r2 = x2.size(0);
+    const int64_t m = x1.size(1);
+    const int64_t k = values.size(1);
+    // Same clamp as cosine_similarity with its default eps
+    const scalar_t cosine_eps = 1e-8;
+    const int64_t cdist_topk_query_block = 64;
+    const int64_t cdist_topk_candidate_block = 512;
+
+    // Squared norms of the rows, for the GEMM expansion
+    std::vector<scalar_t> x1_norm;
+    std::vector<scalar_t> x2_norm;
+    if (use_gemm) {
+      x1_norm.resize(r1);
+      x2_norm.resize(r2);
+      auto row_norms = [m](const scalar_t * start, scalar_t * norm, int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          const scalar_t * row = start + i * m;
+          scalar_t agg = 0;
+          for (int64_t x = 0; x < m; x++) {
+            agg += row[x] * row[x];
+          }
+          norm[i] = agg;
+        }
+      };
+      parallel_for(0, r1, internal::GRAIN_SIZE / (4 * m), [&](int64_t begin, int64_t end) {
+        row_norms(x1_start, x1_norm.data(), begin, end);
+      });
+      parallel_for(0, r2, internal::GRAIN_SIZE / (4 * m), [&](int64_t begin, int64_t end) {
+        row_norms(x2_start, x2_norm.data(), begin, end);
+      });
+    }
+
+    const int64_t query_block = std::min(cdist_topk_query_block, std::max<int64_t>(1, divup(r1, get_num_threads())));
+    const int64_t num_blocks = divup(r1, query_block);
+
+    parallel_for(0, num_blocks, 1, [&](int64_t begin, int64_t end) {
+      std::vector<scalar_t> tile(query_block * std::min(cdist_topk_candidate_block, r2));
+      std::vector<std::vector<TopkEntry>> heaps(query_block);
+      for (auto& heap : heaps) {
+        heap.reserve(k);
+      }
+
+      for (int64_t b = begin; b < end; b++) {
+        const int64_t row_start = b * query_block;
+        const int64_t rows = std::min(query_block, r1 - row_start);
+        const scalar_t * const q = x1_start + row_start * m;
+        for (int64_t i = 0; i < rows; i++) {
+          heaps[i].clear();
+        }
+
+        for (int64_t col_start = 0; col_start < r2; col_start += cdist_topk_candidate_block) {
+          const int64_t cols = std::min(cdist_topk_candidate_block, r2 - col_start);
+          const scalar_t * const c = x2_start + col_start * m;
+          if (use_gemm) {
+            // tile (rows x cols, row-major) = q c^T, i.e. c^T q in column-major terms
+            cpublas::gemm(
+                cpublas::Transpose, cpublas::NoTranspose, cols, rows, m,
+                scalar_t(1), c, m, q, m, scalar_t(0), tile.data(), cols);
+          } else {
+            for (int64_t i = 0; i < rows; i++) {
+              for (int64_t j = 0; j < cols; j++) {
+                tile[i * cols + j] = dist_row<F>(q + i * m, c + j * m, m, p);
+              }
+            }
+          }
+
+          for (int64_t i = 0; i < rows; i++) {
+            const scalar_t * const tile_i = tile.data() + i * cols;
+            for (int64_t j = 0; j < cols; j++) {
+              scalar_t dist = tile_i[j];
+              if (cosine) {
+                const scalar_t n12 = std::sqrt(std::max(x1_norm[row_start + i] * x2_norm[col_start + j], cosine_eps * cosine_eps));
+                dist = 1 - dist / n12;
+              } else if (use_gemm) {
+                dist = x1_norm[row_start + i] + x2_norm[col_start + j] - 2 * dist;
+              }
+              topk_push(heaps[i], k, TopkEntry(dist, col_start + j));
+            }
+          }
+        }
+
+        for (int64_t i = 0; i < rows; i++) {
+          auto& heap = heaps[i];
+          if (use_gemm && !cosine) {
+            for (auto& entry : heap) {
+              entry.first = dist_row<F>(q + i * m, x2_start + entry.second * m, m, p);
+            }
+          }
+          std::sort(heap.begin(), heap.end(), topk_less);
+          scalar_t * const values_i = values_start + (row_start + i) * k;
+          int64_t * const indices_i = indices_start + (row_start + i) * k;
+          for (int64_t l = 0; l < k; l++) {
+            values_i[l] = heap[l].first;
+            indices_i[l] = heap[l].second;
+          }
+        }
+      }
+    });
+  }
+
+  static void apply_cdist_topk(Tensor& values, Tensor& indices, const Tensor& x1, const Tensor& x2, const scalar_t p, bool cosine) {
+    if (cosine || p == 2.0) {
+      run_parallel_cdist_topk<tdist_calc<scalar_t>>(values, indices, x1, x2, p, /*use_gemm=*/true, cosine);
+    } else if (p == 0.0) {
+      run_parallel_cdist_topk<zdist_calc<scalar_t>>(values, indices, x1, x2, p, /*use_gemm=*/false, cosine);
+    } else if (p == 1.0) {
+      run_parallel_cdist_topk<odist_calc<scalar_t>>(values, indices, x1, x2, p, /*use_gemm=*/false, cosine);
+    } else if (std::isinf(p)) {
+      run_parallel_cdist_topk<idist_calc<scalar_t>>(values, indices, x1, x2, p, /*use_gemm=*/false, cosine);
+    } else {
+      run_parallel_cdist_topk<pdist_calc<scalar_t>>(values, indices, x1, x2, p, /*use_gemm=*/false, cosine);
+    }
+  }
+
   // This does a backward pass down a Vec column of the input
   template <typename F>
   inline static void backward_down_column_pdist(const scalar_t * self_i, scalar_t * res_i, const scalar_t * grad_k, const scalar_t * dist_k, const Vec& pvec, int64_t n, int64_t m, int64_t gs, int64_t count = Vec::size()) {
@@ -426,6 +597,12 @@ static void cdist_kernel_impl(Tensor& result, const Tensor& x1, const Tensor& x2
   });
 }
 
+static void cdist_topk_kernel_impl(Tensor& values, Tensor& indices, const Tensor& x1, const Tensor& x2, const double p, bool cosine) {
+  AT_DISPATCH_FLOATING_TYPES(values.scalar_type(), "cdist_topk", [&] {
+    Dist<scalar_t>::apply_cdist_topk(values, indices, x1, x2, p, cosine);
+  });
+}
+
 static void cdist_backward_kernel_impl(Tensor& result, const Tensor& grad, const Tensor& x1, const Tensor& x2, const double p, const Tensor& dist) {
   AT_DISPATCH_FLOATING_TYPES(result.scalar_type(), "cdist_backward", [&] {
     Dist<scalar_t>::apply_backward_cdist(result, grad, x1, x2, p, dist);
@@ -439,5 +616,6 @@ REGISTER_DISPATCH(pdist_forward_stub, &pdist_forward_kernel_impl);
 REGISTER_DISPATCH(pdist_backward_stub, &pdist_backward_kernel_impl);
 REGISTER_DISPATCH(cdist_stub, &cdist_kernel_impl);
 REGISTER_DISPATCH(cdist_backward_stub, &cdist_backward_kernel_impl);
+REGISTER_DISPATCH(cdist_topk_stub, &cdist_topk_kernel_impl);
 
 }}  // namespace at::native
@@ -0,0 +1,286 @@
+#include <ATen/native/EmbeddingBag.h>
+
+#include <ATen/ATen.h>
+#include <ATen/NumericUtils.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace at { namespace native {
+
+namespace {
+
+constexpr int64_t MODE_SUM = 0;
+constexpr int64_t MODE_MEAN = 1;
+constexpr int64_t MODE_MAX = 2;
+
+// Maximum number of work chunks per thread, so that a thread finishing early
+// can still pick up work.
+constexpr int64_t kChunksPerThread = 4;
+
+struct GroupedTable;
+using reduce_bags_fn = void(*)(const GroupedTable&, int64_t bag_begin, int64_t bag_end);
+
+// Raw pointers and sizes of one table, so that the parallel region does not
+// touch Tensor objects.
+struct GroupedTable {
+  int64_t table;
+  const void* weight;
+  int64_t weight_stride;
+  int64_t num_rows;
+  int64_t dim;
+  const int64_t* indices;
+  int64_t num_indices;
+  const int64_t* offsets;
+  int64_t num_offsets;
+  int64_t num_bags;
+  const void* per_sample_weights;
+  void* output;
+  int64_t mode;
+  reduce_bags_fn reduce;
+
+  int64_t bag_end(int64_t bag) const {
+    return bag + 1 < num_offsets ? offsets[bag + 1] : num_indices;
+  }
+
+  // Cost of bags [0, bag): every bag writes a row of the output and reads a
+  // row of weight per index.
+  int64_t cost(int64_t bag) const {
+    return dim * (bag + (bag == 0 ? 0 : bag_end(bag - 1)));
+  }
+};
+
+// Returns row idx of a table as acc_t values. Rows already stored as acc_t
+// are used in place; others are converted into buf.
+template <typename weight_t, typename acc_t>
+struct RowLoader {
+  static const acc_t* load(const GroupedTable& t, int64_t idx, acc_t* buf) {
+    const weight_t* row = static_cast<const weight_t*>(t.weight) + idx * t.weight_stride;
+    for (int64_t j = 0; j < t.dim; j++) {
+      buf[j] = static_cast<acc_t>(row[j]);
+    }
+    return buf;
+  }
+};
+
+template <typename acc_t>
+struct RowLoader<acc_t, acc_t> {
+  static const acc_t* load(const GroupedTable& t, int64_t idx, acc_t* /*buf*/) {
+    return static_cast<const acc_t*>(t.weight) + idx * t.weight_stride;
+  }
+};
+
+// 8-bit rowwise quantized rows, as produced by
+// quantized::embedding_bag_byte_prepack: dim bytes followed by a float scale
+// and a float bias.
+template <>
+struct RowLoader<uint8_t, float> {
+  static const float* load(const GroupedTable& t, int64_t idx, float* buf) {
+    const uint8_t* row = static_cast<const uint8_t*>(t.weight) + idx * t.weight_stride;
+    float scale_bias[2];
+    std::memcpy(scale_bias, row + t.dim, sizeof(scale_bias));
+    for (int64_t j = 0; j < t.dim; j++) {
+      buf[j] = scale_bias[0] * row[j] + scale_bias[1];
+    }
+    return buf;
+  }
+};
+
+template <typename acc_t>
+void axpy_row(int64_t n, acc_t a, const acc_t* x, acc_t* y) {
+  using Vec = vec256::Vec256<acc_t>;
+  const Vec a_vec(a);
+  int64_t j = 0;
+  for (; j < n - (n % Vec::size()); j += Vec::size()) {
+    vec256::fmadd(a_vec, Vec::loadu(x + j), Vec::loadu(y + j)).store(y + j);
+  }
+  for (; j < n; j++) {
+    y[j] += a * x[j];
+  }
+}
+
+template <typename acc_t>
+void max_row(int64_t n, const acc_t* x, acc_t* y) {
+  using Vec = vec256::Vec256<acc_t>;
+  int64_t j = 0;
+  for (; j < n - (n % Vec::size()); j += Vec::size()) {
+    vec256::maximum(Vec::loadu(x + j), Vec::loadu(y + j)).store(y + j);
+  }
+  for (; j < n; j++) {
+    if (_isnan(x[j]) || x[j] > y[j]) {
+      y[j] = x[j];
+    }
+  }
+}
+
+// Reduces bags [bag_begin, bag_end) of one table. Accumulation happens in
+// double for double tables and in float otherwise; for float and double
+// outputs it happens directly in the output row.
+template <typename weight_t, typename out_t>
+void reduce_bags(const GroupedTable& t, int64_t bag_begin, int64_t bag_end) {
+  using acc_t = typename std::conditional<std::is_same<out_t, double>::value, double, float>::type;
+  constexpr bool acc_in_output = std::is_same<out_t, acc_t>::value;
+
+  const int64_t dim = t.dim;
+  const auto* per_sample_weights = static_cast<const out_t*>(t.per_sample_weights);
+  auto* output = static_cast<out_t*>(t.output);
+  std::vector<acc_t> row_buf(std::is_same<weight_t, acc_t>::value ? 0 : dim);
+  std::vector<acc_t> acc_buf(acc_in_output ? 0 : dim);
+
+  for (int64_t bag = bag_begin; bag < bag_end; bag++) {
+    out_t* out = output + bag * dim;
+    acc_t* acc = acc_in_output ? reinterpret_cast<acc_t*>(out) : acc_buf.data();
+    const int64_t k_begin = t.offsets[bag];
+    const int64_t k_end = t.bag_end(bag);
+
+    std::fill(acc, acc + dim, acc_t(0));
+    for (int64_t k = k_begin; k < k_end; k++) {
+      const int64_t idx = t.indices[k];
+      TORCH_CHECK(idx >= 0 && idx < t.num_rows,
+          "embedding_bag_grouped: index ", idx, " of table ", t.table,
+          " is out of range [0, ", t.num_rows, ")");
+      const acc_t* row = RowLoader<weight_t, acc_t>::load(t, idx, row_buf.data());
+      if (t.mode == MODE_MAX) {
+        if (k == k_begin) {
+          std::copy(row, row + dim, acc);
+        } else {
+          max_row(dim, row, acc);
+        }
+      } else {
+        const acc_t scale = per_sample_weights
+            ? static_cast<acc_t>(per_sample_weights[k]) : acc_t(1);
+        axpy_row(dim, scale, row, acc);
+      }
+    }
+    if (t.mode == MODE_MEAN && k_end > k_begin) {
+      const acc_t inv_size = acc_t(1) / (k_end - k_begin);
+      for (int64_t j = 0; j < dim; j++) {
+        acc[j] *= inv_size;
+      }
+    }
+    if (!acc_in_output) {
+      for (int64_t j = 0; j < dim; j++) {
+        out[j] = static_cast<out_t>(acc[j]);
+      }
+    }
+  }
+}
+
+reduce_bags_fn reduce_bags_for(ScalarType weight_type) {
+  switch (weight_type) {
+    case kFloat: return &reduce_bags<float, float>;
+    case kDouble: return &reduce_bags<double, double>;
+    case kHalf: return &reduce_bags<at::Half, at::Half>;
+    case kBFloat16: return &reduce_bags<at::BFloat16, at::BFloat16>;
+    case kByte: return &reduce_bags<uint8_t, float>;
+    default:
+      AT_ERROR("embedding_bag_grouped: unsupported weight type ", weight_type);
+  }
+}
+
+// All bags of all tables are laid out one after the other and split into
+// chunks of equal cost, so that a batch with many small tables and a few
+// large ones keeps every thread busy and pays a single parallel region.
+void embedding_bag_grouped_kernel(
+    TensorList output,
+    TensorList weights,
+    TensorList indices,
+    TensorList offsets,
+    TensorList per_sample_weights,
+    int64_t mode,
+    bool include_last_offset) {
+  const int64_t num_tables = weights.size();
+  std::vector<GroupedTable> tables(num_tables);
+  // Global bag index and cumulative cost at the start of every table.
+  std::vector<int64_t> table_bag_begin(num_tables + 1, 0);
+  std::vector<int64_t> table_cost_begin(num_tables + 1, 0);
+
+  for (int64_t i = 0; i < num_tables; i++) {
+    const Tensor& weight = weights[i];
+    const bool byte_rowwise = weight.scalar_type() == kByte;
+    GroupedTable& t = tables[i];
+    t.table = i;
+    t.weight = weight.data_ptr();
+    t.weight_stride = weight.stride(0);
+    t.num_rows = weight.size(0);
+    t.dim = byte_rowwise ? weight.size(1) - 8 : weight.size(1);
+    t.indices = indices[i].data_ptr<int64_t>();
+    t.num_indices = indices[i].numel();
+    t.offsets = offsets[i].data_ptr<int64_t>();
+    t.num_offsets = offsets[i].numel();
+    t.num_bags = include_last_offset ? t.num_offsets - 1 : t.num_offsets;
+    t.per_sample_weights = per_sample_weights.empty() ? nullptr : per_sample_weights[i].data_ptr();
+    t.output = output[i].data_ptr();
+    t.mode = mode;
+    t.reduce = reduce_bags_for(weight.scalar_type());
+
+    table_bag_begin[i + 1] = table_bag_begin[i] + t.num_bags;
+    table_cost_begin[i + 1] = table_cost_begin[i] + t.cost(t.num_bags);
+  }
+
+  const int64_t total_bags = table_bag_begin[num_tables];
+  const int64_t total_cost = table_cost_begin[num_tables];
+  if (total_bags == 0) {
+    return;
+  }
+  const int64_t num_chunks = std::max<int64_t>(
+      1,
+      std::min<int64_t>(
+          divup(total_cost, at::internal::GRAIN_SIZE),
+          at::get_num_threads() * kChunksPerThread));
+
+  // First global bag of a chunk: the first bag whose cumulative cost reaches
+  // the chunk's share of the total.
+  auto chunk_begin = [&](int64_t chunk) {
+    if (chunk == 0) {
+      return int64_t(0);
+    }
+    if (chunk >= num_chunks) {
+      return total_bags;
+    }
+    const int64_t target = total_cost / num_chunks * chunk;
+    const int64_t i = std::upper_bound(
+        table_cost_begin.begin(), table_cost_begin.begin() + num_tables, target)
+        - table_cost_begin.begin() - 1;
+    const GroupedTable& t = tables[i];
+    const int64_t table_target = target - table_cost_begin[i];
+    int64_t lo = 0;
+    int64_t hi = t.num_bags;
+    while (lo < hi) {
+      const int64_t mid = lo + (hi - lo) / 2;
+      if (t.cost(mid) < table_target) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return table_bag_begin[i] + lo;
+  };
+
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    const int64_t bag_begin = chunk_begin(begin);
+    const int64_t bag_end = chunk_begin(end);
+    // Tables without bags share their begin with the next table, so this
+    // finds the table that actually holds bag_begin.
+    int64_t i = std::upper_bound(table_bag_begin.begin(), table_bag_begin.end(), bag_begin)
+        - table_bag_begin.begin() - 1;
+    for (; i < num_tables && table_bag_begin[i] < bag_end; i++) {
+      const GroupedTable& t = tables[i];
+      const int64_t first = std::max(bag_begin, table_bag_begin[i]) - table_bag_begin[i];
+      const int64_t last = std::min(bag_end, table_bag_begin[i + 1]) - table_bag_begin[i];
+      if (first < last) {
+        t.reduce(t, first, last);
+      }
+    }
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(embedding_bag_grouped_stub, &embedding_bag_grouped_kernel);
+
+}} // namespace at::native
@@ -0,0 +1,202 @@
+#include <ATen/native/EmbeddingBag.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <cmath>
+#include <vector>
+
+namespace at { namespace native {
+
+namespace {
+
+constexpr int64_t MODE_MEAN = 1;
+
+template <typename scalar_t>
+void axpy_row(int64_t n, scalar_t a, const scalar_t* x, scalar_t* y) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const Vec a_vec(a);
+  int64_t j = 0;
+  for (; j < n - (n % Vec::size()); j += Vec::size()) {
+    vec256::fmadd(a_vec, Vec::loadu(x + j), Vec::loadu(y + j)).store(y + j);
+  }
+  for (; j < n; j++) {
+    y[j] += a * x[j];
+  }
+}
+
+// Applies the optimizer step to one row, given its accumulated gradient g
+// (which may be modified).
+template <typename scalar_t>
+void update_row(
+    const EmbeddingBagUpdateOptions& options,
+    int64_t dim,
+    scalar_t* g,
+    scalar_t* w,
+    scalar_t* momentum,
+    scalar_t* exp_avg,
+    scalar_t* exp_avg_sq) {
+  const scalar_t lr = options.lr;
+  if (options.weight_decay != 0) {
+    axpy_row<scalar_t>(dim, options.weight_decay, w, g);
+  }
+  switch (options.optimizer) {
+    case EmbeddingBagOptimizer::SGD: {
+      axpy_row<scalar_t>(dim, -lr, g, w);
+      break;
+    }
+    case EmbeddingBagOptimizer::RowwiseAdagrad: {
+      // A single accumulator per row holding the mean squared gradient.
+      scalar_t sum_sq = 0;
+      for (int64_t j = 0; j < dim; j++) {
+        sum_sq += g[j] * g[j];
+      }
+      *momentum += dim > 0 ? sum_sq / dim : scalar_t(0);
+      const scalar_t step = -lr / (std::sqrt(*momentum) + static_cast<scalar_t>(options.eps));
+      axpy_row<scalar_t>(dim, step, g, w);
+      break;
+    }
+    case EmbeddingBagOptimizer::Adam: {
+      // Lazy Adam as in torch.optim.SparseAdam: moments of rows that are not
+      // referenced by the batch are left untouched.
+      const scalar_t beta1 = options.beta1;
+      const scalar_t beta2 = options.beta2;
+      const scalar_t eps = options.eps;
+      const double bias_correction1 = 1 - std::pow(options.beta1, options.step);
+      const double bias_correction2 = 1 - std::pow(options.beta2, options.step);
+      const scalar_t step_size = options.lr * std::sqrt(bias_correction2) / bias_correction1;
+      for (int64_t j = 0; j < dim; j++) {
+        exp_avg[j] = beta1 * exp_avg[j] + (1 - beta1) * g[j];
+        exp_avg_sq[j] = beta2 * exp_avg_sq[j] + (1 - beta2) * g[j] * g[j];
+        w[j] -= step_size * exp_avg[j] / (std::sqrt(exp_avg_sq[j]) + eps);
+      }
+      break;
+    }
+  }
+}
+
+template <typename scalar_t>
+void embedding_bag_backward_update_kernel_impl(
+    Tensor& weight,
+    Tensor& state1,
+    Tensor& state2,
+    const Tensor& grad,
+    const Tensor& sorted_indices,
+    const Tensor& order,
+    const Tensor& offsets,
+    const Tensor& per_sample_weights,
+    int64_t mode,
+    bool include_last_offset,
+    const EmbeddingBagUpdateOptions& options) {
+  const int64_t num_indices = sorted_indices.numel();
+  const int64_t num_offsets = offsets.numel();
+  const int64_t num_bags = include_last_offset ? num_offsets - 1 : num_offsets;
+  const int64_t num_rows = weight.size(0);
+  const int64_t dim = weight.size(1);
+  const int64_t weight_stride = weight.stride(0);
+  const int64_t grad_stride = grad.stride(0);
+
+  const int64_t* offsets_data = offsets.data_ptr<int64_t>();
+  const int64_t* sorted_data = sorted_indices.data_ptr<int64_t>();
+  const int64_t* order_data = order.data_ptr<int64_t>();
+  const scalar_t* grad_data = grad.data_ptr<scalar_t>();
+  const scalar_t* psw_data = per_sample_weights.defined()
+      ? per_sample_weights.data_ptr<scalar_t>() : nullptr;
+  scalar_t* weight_data = weight.data_ptr<scalar_t>();
+  scalar_t* momentum_data = options.optimizer == EmbeddingBagOptimizer::RowwiseAdagrad
+      ? state1.data_ptr<scalar_t>() : nullptr;
+  scalar_t* exp_avg_data = options.optimizer == EmbeddingBagOptimizer::Adam
+      ? state1.data_ptr<scalar_t>() : nullptr;
+  scalar_t* exp_avg_sq_data = options.optimizer == EmbeddingBagOptimizer::Adam
+      ? state2.data_ptr<scalar_t>() : nullptr;
+
+  auto bag_end = [&](int64_t bag) {
+    return bag + 1 < num_offsets ? offsets_data[bag + 1] : num_indices;
+  };
+
+  // Bag of every position of indices. Positions past the last bag (possible
+  // with include_last_offset) belong to no bag and get -1.
+  std::vector<int64_t> bag_of(num_indices, -1);
+  at::parallel_for(0, num_bags, divup(at::internal::GRAIN_SIZE, 1 + num_indices / std::max<int64_t>(num_bags, 1)),
+      [&](int64_t begin, int64_t end) {
+    for (int64_t bag = begin; bag < end; bag++) {
+      for (int64_t k = offsets_data[bag]; k < bag_end(bag); k++) {
+        bag_of[k] = bag;
+      }
+    }
+  });
+
+  // Runs of equal indices in sorted_indices; every run is one row of weight
+  // and is updated by exactly one thread.
+  std::vector<int64_t> run_begin;
+  for (int64_t k = 0; k < num_indices; k++) {
+    if (k == 0 || sorted_data[k] != sorted_data[k - 1]) {
+      run_begin.push_back(k);
+    }
+  }
+  const int64_t num_runs = run_begin.size();
+  run_begin.push_back(num_indices);
+  if (num_runs == 0) {
+    return;
+  }
+
+  const int64_t grain_size = divup(
+      at::internal::GRAIN_SIZE, std::max<int64_t>(dim, 1) * (1 + num_indices / num_runs));
+  at::parallel_for(0, num_runs, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<scalar_t> g(dim);
+    for (int64_t run = begin; run < end; run++) {
+      const int64_t row = sorted_data[run_begin[run]];
+      TORCH_CHECK(row >= 0 && row < num_rows,
+          "embedding_bag: index ", row, " is out of range [0, ", num_rows, ")");
+      std::fill(g.begin(), g.end(), scalar_t(0));
+      bool referenced = false;
+      for (int64_t k = run_begin[run]; k < run_begin[run + 1]; k++) {
+        const int64_t pos = order_data[k];
+        const int64_t bag = bag_of[pos];
+        if (bag < 0) {
+          continue;
+        }
+        referenced = true;
+        scalar_t scale = psw_data ? psw_data[pos] : scalar_t(1);
+        if (mode == MODE_MEAN) {
+          scale /= bag_end(bag) - offsets_data[bag];
+        }
+        axpy_row<scalar_t>(dim, scale, grad_data + bag * grad_stride, g.data());
+      }
+      if (referenced) {
+        update_row<scalar_t>(
+            options, dim, g.data(), weight_data + row * weight_stride,
+            momentum_data ? momentum_data + row : nullptr,
+            exp_avg_data ? exp_avg_data + row * dim : nullptr,
+            exp_avg_sq_data ? exp_avg_sq_data + row * dim : nullptr);
+      }
+    }
+  });
+}
+
+void embedding_bag_backward_update_kernel(
+    Tensor& weight,
+    Tensor& state1,
+    Tensor& state2,
+    const Tensor& grad,
+    const Tensor& sorted_indices,
+    const Tensor& order,
+    const Tensor& offsets,
+    const Tensor& per_sample_weights,
+    int64_t mode,
+    bool include_last_offset,
+    const EmbeddingBagUpdateOptions& options) {
+  AT_DISPATCH_FLOATING_TYPES(weight.scalar_type(), "embedding_bag_backward_update", [&] {
+    embedding_bag_backward_update_kernel_impl<scalar_t>(
+        weight, state1, state2, grad, sorted_indices, order, offsets,
+        per_sample_weights, mode, include_last_offset, options);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(embedding_bag_backward_update_stub, &embedding_bag_backward_update_kernel);
+
+}} // namespace at::native
@@ -0,0 +1,483 @@
+#pragma once
+
+#include <c10/util/Exception.h>
+#include <c10/util/complex.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Header-only FFT used by the CPU backend of _fft_with_size when ATen is built
+// without MKL. The structure follows FFTPACK / pocketfft:
+//
+//  - CFFTPlan is a complex transform of any length n. n is split into
+//    factors 4, 2, 3, 5 and larger primes, and every factor is one Stockham
+//    pass over the data with precomputed twiddles. When n has a large prime
+//    factor, Bluestein's algorithm is cheaper: the transform is written as a
+//    convolution and computed with transforms of a 2-3-5 smooth length of at
+//    least 2n - 1.
+//  - RFFTPlan is a real-to-complex (and complex-to-real) transform of length
+//    n, computed with a complex transform of length n / 2 when n is even.
+//
+// Plans are immutable once built, so one plan can be used by several threads
+// at once; every call takes a scratch buffer of scratch_size() elements.
+
+namespace at { namespace native { namespace bundled_fft {
+
+template <typename T>
+using cmplx = c10::complex<T>;
+
+template <typename T>
+inline cmplx<T> conj(cmplx<T> a) {
+  return cmplx<T>(a.real(), -a.imag());
+}
+
+// a * -i when fwd, a * i otherwise.
+template <bool fwd, typename T>
+inline cmplx<T> rotate90(cmplx<T> a) {
+  return fwd ? cmplx<T>(a.imag(), -a.real()) : cmplx<T>(-a.imag(), a.real());
+}
+
+// Twiddles are stored for the forward transform, exp(-2 pi i k / n); the
+// backward transform uses their conjugates.
+template <bool fwd, typename T>
+inline cmplx<T> twiddle_mul(cmplx<T> a, cmplx<T> w) {
+  return fwd ? a * w : a * conj(w);
+}
+
+// exp(-2 pi i k / n) for k in [0, n), computed in double.
+template <typename T>
+std::vector<cmplx<T>> unit_roots(int64_t n) {
+  constexpr double two_pi = 6.283185307179586476925286766559;
+  std::vector<cmplx<T>> roots(n);
+  for (int64_t k = 0; k < n; k++) {
+    const double angle = two_pi * static_cast<double>(k) / static_cast<double>(n);
+    roots[k] = cmplx<T>(static_cast<T>(std::cos(angle)), static_cast<T>(-std::sin(angle)));
+  }
+  return roots;
+}
+
+// Factors of n in the order the passes run: 4s, then 2, then odd primes.
+inline std::vector<int64_t> factorize(int64_t n) {
+  std::vector<int64_t> factors;
+  while (n % 4 == 0) {
+    factors.push_back(4);
+    n /= 4;
+  }
+  if (n % 2 == 0) {
+    factors.push_back(2);
+    n /= 2;
+  }
+  for (int64_t d = 3; d * d <= n; d += 2) {
+    while (n % d == 0) {
+      factors.push_back(d);
+      n /= d;
+    }
+  }
+  if (n > 1) {
+    factors.push_back(n);
+  }
+  return factors;
+}
+
+// Rough number of operations of a direct transform of length n; factors
+// without a hand-written pass are penalized.
+inline double cost_guess(int64_t n) {
+  double cost = 0;
+  for (int64_t f : factorize(n)) {
+    cost += f <= 5 ? static_cast<double>(f) : 1.1 * static_cast<double>(f);
+  }
+  return cost * static_cast<double>(n);
+}
+
+// Smallest 2^a 3^b 5^c >= n.
+inline int64_t good_size(int64_t n) {
+  if (n <= 6) {
+    return n;
+  }
+  int64_t best = 1;
+  while (best < n) {
+    best *= 2;
+  }
+  for (int64_t f5 = 1; f5 < best; f5 *= 5) {
+    for (int64_t f35 = f5; f35 < best; f35 *= 3) {
+      int64_t x = f35;
+      while (x < n) {
+        x *= 2;
+      }
+      best = std::min(best, x);
+    }
+  }
+  return best;
+}
+
+template <typename T>
+class CFFTPlan {
+ public:
+  explicit CFFTPlan(int64_t n) : n_(n) {
+    TORCH_CHECK(n >= 1, "fft: expected a positive signal size, but got ", n);
+    const int64_t n2 = good_size(2 * n - 1);
+    if (n > 50 && 1.5 * 2 * cost_guess(n2) < cost_guess(n)) {
+      init_bluestein(n2);
+    } else {
+      init_passes();
+    }
+  }
+
+  int64_t length() const {
+    return n_;
+  }
+
+  // Number of complex elements of the scratch buffer exec() needs.
+  int64_t scratch_size() const {
+    return conv_plan_ ? conv_plan_->length() + conv_plan_->scratch_size() : n_;
+  }
+
+  // Transforms the n elements of data in place, with exp(-2 pi i jk / n) if
+  // forward and exp(2 pi i jk / n) otherwise, and multiplies them by fct.
+  void exec(cmplx<T>* data, cmplx<T>* scratch, bool forward, T fct) const {
+    if (forward) {
+      exec_impl<true>(data, scratch, fct);
+    } else {
+      exec_impl<false>(data, scratch, fct);
+    }
+  }
+
+ private:
+  // A pass of a given radix over l1 groups of radix * ido elements.
+  struct Pass {
+    int64_t radix;
+    int64_t l1;
+    int64_t ido;
+    // Offsets of the (radix - 1) * ido twiddles of this pass in twiddles_,
+    // and of the radix roots of unity in roots_ (generic passes only).
+    int64_t twiddle_offset;
+    int64_t root_offset;
+  };
+
+  void init_passes() {
+    const auto roots = unit_roots<T>(n_);
+    int64_t l1 = 1;
+    for (int64_t radix : factorize(n_)) {
+      const int64_t ido = n_ / (l1 * radix);
+      Pass pass{radix, l1, ido, static_cast<int64_t>(twiddles_.size()), static_cast<int64_t>(roots_.size())};
+      for (int64_t j = 1; j < radix; j++) {
+        for (int64_t i = 0; i < ido; i++) {
+          twiddles_.push_back(roots[j * l1 * i]);
+        }
+      }
+      if (radix > 5) {
+        for (int64_t j = 0; j < radix; j++) {
+          roots_.push_back(roots[j * l1 * ido]);
+        }
+      }
+      passes_.push_back(pass);
+      l1 *= radix;
+    }
+  }
+
+  // X_k = conj(w_k) sum_m (x_m conj(w_m)) w_{k - m}, with w_k = exp(i pi k^2 / n).
+  void init_bluestein(int64_t n2) {
+    constexpr double pi = 3.141592653589793238462643383279;
+    conv_plan_.reset(new CFFTPlan<T>(n2));
+    chirp_.resize(n_);
+    for (int64_t k = 0; k < n_; k++) {
+      // k^2 mod 2n keeps the angle small enough to be accurate.
+      const int64_t k2 = (k * k) % (2 * n_);
+      const double angle = pi * static_cast<double>(k2) / static_cast<double>(n_);
+      chirp_[k] = cmplx<T>(static_cast<T>(std::cos(angle)), static_cast<T>(std::sin(angle)));
+    }
+    chirp_fft_.assign(n2, cmplx<T>(0, 0));
+    chirp_fft_[0] = chirp_[0];
+    for (int64_t k = 1; k < n_; k++) {
+      chirp_fft_[k] = chirp_[k];
+      chirp_fft_[n2 - k] = chirp_[k];
+    }
+    std::vector<cmplx<T>> scratch(conv_plan_->scratch_size());
+    conv_plan_->exec(chirp_fft_.data(), scratch.data(), true, static_cast<T>(1) / static_cast<T>(n2));
+  }
+
+  template <bool fwd>
+  void exec_impl(cmplx<T>* data, cmplx<T>* scratch, T fct) const {
+    if (conv_plan_) {
+      exec_bluestein<fwd>(data, scratch, fct);
+      return;
+    }
+    cmplx<T>* src = data;
+    cmplx<T>* dst = scratch;
+    for (const Pass& pass : passes_) {
+      switch (pass.radix) {
+        case 2:
+          pass2<fwd>(pass, src, dst);
+          break;
+        case 3:
+          pass3<fwd>(pass, src, dst);
+          break;
+        case 4:
+          pass4<fwd>(pass, src, dst);
+          break;
+        case 5:
+          pass5<fwd>(pass, src, dst);
+          break;
+        default:
+          passg<fwd>(pass, src, dst);
+          break;
+      }
+      std::swap(src, dst);
+    }
+    if (src != data) {
+      for (int64_t i = 0; i < n_; i++) {
+        data[i] = src[i] * fct;
+      }
+    } else if (fct != static_cast<T>(1)) {
+      for (int64_t i = 0; i < n_; i++) {
+        data[i] *= fct;
+      }
+    }
+  }
+
+  // The backward transform is the conjugate of the forward transform of the
+  // conjugate.
+  template <bool fwd>
+  void exec_bluestein(cmplx<T>* data, cmplx<T>* scratch, T fct) const {
+    const int64_t n2 = conv_plan_->length();
+    cmplx<T>* work = scratch;
+    for (int64_t k = 0; k < n_; k++) {
+      work[k] = (fwd ? data[k] : conj(data[k])) * conj(chirp_[k]);
+    }
+    std::fill(work + n_, work + n2, cmplx<T>(0, 0));
+    conv_plan_->exec(work, scratch + n2, true, static_cast<T>(1));
+    for (int64_t k = 0; k < n2; k++) {
+      work[k] *= chirp_fft_[k];
+    }
+    conv_plan_->exec(work, scratch + n2, false, static_cast<T>(1));
+    for (int64_t k = 0; k < n_; k++) {
+      const cmplx<T> value = work[k] * conj(chirp_[k]) * fct;
+      data[k] = fwd ? value : conj(value);
+    }
+  }
+
+  // Passes read cc[i + ido * (m + radix * k)], the m-th input of butterfly
+  // (i, k), and write ch[i + ido * (k + l1 * j)], its j-th output.
+  template <bool fwd>
+  void pass2(const Pass& p, const cmplx<T>* cc, cmplx<T>* ch) const {
+    const int64_t ido = p.ido;
+    const int64_t l1 = p.l1;
+    const cmplx<T>* tw = twiddles_.data() + p.twiddle_offset;
+    for (int64_t k = 0; k < l1; k++) {
+      const cmplx<T>* in = cc + ido * 2 * k;
+      for (int64_t i = 0; i < ido; i++) {
+        const cmplx<T> a = in[i];
+        const cmplx<T> b = in[i + ido];
+        ch[i + ido * k] = a + b;
+        ch[i + ido * (k + l1)] = twiddle_mul<fwd>(a - b, tw[i]);
+      }
+    }
+  }
+
+  template <bool fwd>
+  void pass3(const Pass& p, const cmplx<T>* cc, cmplx<T>* ch) const {
+    const int64_t ido = p.ido;
+    const int64_t l1 = p.l1;
+    const cmplx<T>* tw = twiddles_.data() + p.twiddle_offset;
+    const T tw1r = static_cast<T>(-0.5);
+    const T tw1i = static_cast<T>(0.866025403784438646763723170753);
+    for (int64_t k = 0; k < l1; k++) {
+      const cmplx<T>* in = cc + ido * 3 * k;
+      for (int64_t i = 0; i < ido; i++) {
+        const cmplx<T> t0 = in[i];
+        const cmplx<T> t1 = in[i + ido] + in[i + 2 * ido];
+        const cmplx<T> t2 = in[i + ido] - in[i + 2 * ido];
+        const cmplx<T> ca = t0 + t1 * tw1r;
+        const cmplx<T> cb = rotate90<fwd>(t2) * tw1i;
+        ch[i + ido * k] = t0 + t1;
+        ch[i + ido * (k + l1)] = twiddle_mul<fwd>(ca + cb, tw[i]);
+        ch[i + ido * (k + 2 * l1)] = twiddle_mul<fwd>(ca - cb, tw[ido + i]);
+      }
+    }
+  }
+
+  template <bool fwd>
+  void pass4(const Pass& p, const cmplx<T>* cc, cmplx<T>* ch) const {
+    const int64_t ido = p.ido;
+    const int64_t l1 = p.l1;
+    const cmplx<T>* tw = twiddles_.data() + p.twiddle_offset;
+    for (int64_t k = 0; k < l1; k++) {
+      const cmplx<T>* in = cc + ido * 4 * k;
+      for (int64_t i = 0; i < ido; i++) {
+        const cmplx<T> t1 = in[i] + in[i + 2 * ido];
+        const cmplx<T> t2 = in[i] - in[i + 2 * ido];
+        const cmplx<T> t3 = in[i + ido] + in[i + 3 * ido];
+        const cmplx<T> t4 = rotate90<fwd>(in[i + ido] - in[i + 3 * ido]);
+        ch[i + ido * k] = t1 + t3;
+        ch[i + ido * (k + l1)] = twiddle_mul<fwd>(t2 + t4, tw[i]);
+        ch[i + ido * (k + 2 * l1)] = twiddle_mul<fwd>(t1 - t3, tw[ido + i]);
+        ch[i + ido * (k + 3 * l1)] = twiddle_mul<fwd>(t2 - t4, tw[2 * ido + i]);
+      }
+    }
+  }
+
+  template <bool fwd>
+  void pass5(const Pass& p, const cmplx<T>* cc, cmplx<T>* ch) const {
+    const int64_t ido = p.ido;
+    const int64_t l1 = p.l1;
+    const cmplx<T>* tw = twiddles_.data() + p.twiddle_offset;
+    // cos and sin of 2 pi / 5 and 4 pi / 5.
+    const T tw1r = static_cast<T>(0.309016994374947424102293417183);
+    const T tw1i = static_cast<T>(0.951056516295153572116439333379);
+    const T tw2r = static_cast<T>(-0.809016994374947424102293417183);
+    const T tw2i = static_cast<T>(0.587785252292473129168705954639);
+    for (int64_t k = 0; k < l1; k++) {
+      const cmplx<T>* in = cc + ido * 5 * k;
+      for (int64_t i = 0; i < ido; i++) {
+        const cmplx<T> t0 = in[i];
+        const cmplx<T> t1 = in[i + ido] + in[i + 4 * ido];
+        const cmplx<T> t4 = in[i + ido] - in[i + 4 * ido];
+        const cmplx<T> t2 = in[i + 2 * ido] + in[i + 3 * ido];
+        const cmplx<T> t3 = in[i + 2 * ido] - in[i + 3 * ido];
+        const cmplx<T> ca1 = t0 + t1 * tw1r + t2 * tw2r;
+        const cmplx<T> cb1 = rotate90<fwd>(t4 * tw1i + t3 * tw2i);
+        const cmplx<T> ca2 = t0 + t1 * tw2r + t2 * tw1r;
+        const cmplx<T> cb2 = rotate90<fwd>(t4 * tw2i - t3 * tw1i);
+        ch[i + ido * k] = t0 + t1 + t2;
+        ch[i + ido * (k + l1)] = twiddle_mul<fwd>(ca1 + cb1, tw[i]);
+        ch[i + ido * (k + 2 * l1)] = twiddle_mul<fwd>(ca2 + cb2, tw[ido + i]);
+        ch[i + ido * (k + 3 * l1)] = twiddle_mul<fwd>(ca2 - cb2, tw[2 * ido + i]);
+        ch[i + ido * (k + 4 * l1)] = twiddle_mul<fwd>(ca1 - cb1, tw[3 * ido + i]);
+      }
+    }
+  }
+
+  // Any other radix, as a direct DFT of every butterfly.
+  template <bool fwd>
+  void passg(const Pass& p, const cmplx<T>* cc, cmplx<T>* ch) const {
+    const int64_t ido = p.ido;
+    const int64_t l1 = p.l1;
+    const int64_t radix = p.radix;
+    const cmplx<T>* tw = twiddles_.data() + p.twiddle_offset;
+    const cmplx<T>* roots = roots_.data() + p.root_offset;
+    for (int64_t k = 0; k < l1; k++) {
+      const cmplx<T>* in = cc + ido * radix * k;
+      for (int64_t i = 0; i < ido; i++) {
+        cmplx<T> sum = in[i];
+        for (int64_t m = 1; m < radix; m++) {
+          sum += in[i + ido * m];
+        }
+        ch[i + ido * k] = sum;
+        for (int64_t j = 1; j < radix; j++) {
+          sum = in[i];
+          int64_t jm = 0;
+          for (int64_t m = 1; m < radix; m++) {
+            jm += j;
+            if (jm >= radix) {
+              jm -= radix;
+            }
+            sum += twiddle_mul<fwd>(in[i + ido * m], roots[jm]);
+          }
+          ch[i + ido * (k + l1 * j)] = twiddle_mul<fwd>(sum, tw[(j - 1) * ido + i]);
+        }
+      }
+    }
+  }
+
+  int64_t n_;
+  std::vector<Pass> passes_;
+  std::vector<cmplx<T>> twiddles_;
+  std::vector<cmplx<T>> roots_;
+  // Bluestein's algorithm, used instead of passes_ when conv_plan_ is set.
+  std::unique_ptr<CFFTPlan<T>> conv_plan_;
+  std::vector<cmplx<T>> chirp_;
+  // Forward transform of the chirp, divided by the convolution length.
+  std::vector<cmplx<T>> chirp_fft_;
+};
+
+template <typename T>
+class RFFTPlan {
+ public:
+  explicit RFFTPlan(int64_t n) : n_(n), plan_(n % 2 == 0 ? n / 2 : n) {
+    if (n % 2 == 0) {
+      twiddles_ = unit_roots<T>(n);
+      twiddles_.resize(n / 2 + 1);
+    }
+  }
+
+  int64_t length() const {
+    return n_;
+  }
+
+  // Number of complex elements of the scratch buffer forward() and
+  // backward() need.
+  int64_t scratch_size() const {
+    return plan_.length() + plan_.scratch_size();
+  }
+
+  // out[k] = fct * sum_j in[j] exp(-2 pi i jk / n), for k in [0, n / 2].
+  void forward(const T* in, cmplx<T>* out, cmplx<T>* scratch, T fct) const {
+    cmplx<T>* z = scratch;
+    if (n_ % 2 != 0) {
+      for (int64_t j = 0; j < n_; j++) {
+        z[j] = cmplx<T>(in[j], 0);
+      }
+      plan_.exec(z, scratch + n_, true, fct);
+      std::copy(z, z + n_ / 2 + 1, out);
+      return;
+    }
+    // z = even + i * odd samples; their transforms E and O are recovered
+    // from Z with the symmetry of the transforms of real signals, and
+    // X_k = E_k + exp(-2 pi i k / n) O_k.
+    const int64_t h = n_ / 2;
+    for (int64_t j = 0; j < h; j++) {
+      z[j] = cmplx<T>(in[2 * j], in[2 * j + 1]);
+    }
+    plan_.exec(z, scratch + h, true, static_cast<T>(1));
+    const T half = static_cast<T>(0.5) * fct;
+    for (int64_t k = 0; k <= h; k++) {
+      const cmplx<T> zk = z[k == h ? 0 : k];
+      const cmplx<T> zc = conj(z[k == 0 ? 0 : h - k]);
+      const cmplx<T> even = zk + zc;
+      const cmplx<T> odd = rotate90<true>(zk - zc);
+      out[k] = (even + odd * twiddles_[k]) * half;
+    }
+  }
+
+  // out[j] = fct * sum_k X_k exp(2 pi i jk / n), for j in [0, n), where X is
+  // the Hermitian signal whose first n / 2 + 1 elements are in. The
+  // imaginary parts of the elements that have to be real are ignored.
+  void backward(const cmplx<T>* in, T* out, cmplx<T>* scratch, T fct) const {
+    cmplx<T>* z = scratch;
+    if (n_ % 2 != 0) {
+      z[0] = cmplx<T>(in[0].real(), 0);
+      for (int64_t k = 1; k <= n_ / 2; k++) {
+        z[k] = in[k];
+        z[n_ - k] = conj(in[k]);
+      }
+      plan_.exec(z, scratch + n_, false, fct);
+      for (int64_t j = 0; j < n_; j++) {
+        out[j] = z[j].real();
+      }
+      return;
+    }
+    // The inverse of forward(): Z_k = 2 E_k + 2i O_k.
+    const int64_t h = n_ / 2;
+    for (int64_t k = 0; k < h; k++) {
+      const cmplx<T> xk = k == 0 ? cmplx<T>(in[0].real(), 0) : in[k];
+      const cmplx<T> xc = k == 0 ? cmplx<T>(in[h].real(), 0) : conj(in[h - k]);
+      z[k] = (xk + xc) + rotate90<false>((xk - xc) * conj(twiddles_[k]));
+    }
+    plan_.exec(z, scratch + h, false, fct);
+    for (int64_t j = 0; j < h; j++) {
+      out[2 * j] = z[j].real();
+      out[2 * j + 1] = z[j].imag();
+    }
+  }
+
+ private:
+  int64_t n_;
+  CFFTPlan<T> plan_;
+  // exp(-2 pi i k / n) for k in [0, n / 2], when n is even.
+  std::vector<cmplx<T>> twiddles_;
+};
+
+}}} // namespace at::native::bundled_fft
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <ATen/Context.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/cpu/RadixSort.h>
+#include <c10/util/complex.h>
+
+#if (defined(__x86_64__) || defined(__i386__))
+#include <ATen/native/cpu/Intrinsics.h>
+#else
+#define _mm_pause()
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Parallel accumulation of values into arbitrary elements of a tensor,
+// dst[offsets[i]] += values[i], shared by index_put_ with accumulate=true and
+// scatter_add_. Updates of the same element conflict, so one of three
+// strategies is picked from the size of the touched range of dst and from a
+// sample of the offsets:
+//
+//  - Privatized: every thread accumulates into its own zeroed copy of the
+//    touched range, and the copies are then summed into dst. Used when that
+//    range is small next to the number of updates (histograms).
+//  - Sorted: the updates are stable sorted by offset and every run of equal
+//    offsets is summed by a single thread, in the original order. Used when
+//    many updates collide, and always when deterministic algorithms are
+//    requested: the result is then the same as the one of the serial loop.
+//  - Atomic: the updates are applied in place with compare-and-swap loops.
+//    Used when updates rarely collide.
+
+namespace at { namespace native { namespace {
+
+enum class AccumulateStrategy { Atomic, Sorted, Privatized };
+
+// Number of offsets inspected to estimate how often updates collide.
+constexpr int64_t kAccumulateSampleSize = 1024;
+
+template <int nbytes> struct AtomicBits;
+template <> struct AtomicBits<1> { using type = uint8_t; };
+template <> struct AtomicBits<2> { using type = uint16_t; };
+template <> struct AtomicBits<4> { using type = uint32_t; };
+template <> struct AtomicBits<8> { using type = uint64_t; };
+
+// *dst += value as a compare-and-swap loop on the bits of *dst, for any
+// scalar type of 1, 2, 4 or 8 bytes.
+template <typename scalar_t>
+inline void cpu_atomic_add(scalar_t* dst, scalar_t value) {
+  using bits_t = typename AtomicBits<sizeof(scalar_t)>::type;
+  auto* dst_bits = reinterpret_cast<std::atomic<bits_t>*>(dst);
+  bits_t old_bits = dst_bits->load(std::memory_order_relaxed);
+  bits_t new_bits;
+  while (true) {
+    scalar_t old_value;
+    std::memcpy(&old_value, &old_bits, sizeof(scalar_t));
+    scalar_t new_value = old_value;
+    new_value += value;
+    std::memcpy(&new_bits, &new_value, sizeof(scalar_t));
+    if (dst_bits->compare_exchange_weak(old_bits, new_bits)) {
+      return;
+    }
+    _mm_pause();
+  }
+}
+
+// No 16-byte compare-and-swap is assumed; the real and imaginary parts are
+// independent sums.
+template <>
+inline void cpu_atomic_add(c10::complex<double>* dst, c10::complex<double> value) {
+  double* parts = reinterpret_cast<double*>(dst);
+  cpu_atomic_add(parts, value.real());
+  cpu_atomic_add(parts + 1, value.imag());
+}
+
+// Whether n updates are worth the parallel engine; otherwise callers keep
+// their serial loop.
+inline bool use_parallel_accumulate(int64_t n) {
+  return n >= at::internal::GRAIN_SIZE && at::get_num_threads() > 1 &&
+      !at::in_parallel_region();
+}
+
+inline AccumulateStrategy choose_accumulate_strategy(
+    const int64_t* offsets,
+    int64_t n,
+    int64_t range) {
+  if (at::globalContext().deterministic()) {
+    return AccumulateStrategy::Sorted;
+  }
+  if (range * at::get_num_threads() <= n) {
+    return AccumulateStrategy::Privatized;
+  }
+  // Count the offsets of an evenly spaced sample that repeat another one.
+  const int64_t step = std::max<int64_t>(1, n / kAccumulateSampleSize);
+  std::vector<int64_t> sample;
+  sample.reserve(kAccumulateSampleSize + 1);
+  for (int64_t i = 0; i < n; i += step) {
+    sample.push_back(offsets[i]);
+  }
+  std::sort(sample.begin(), sample.end());
+  int64_t repeats = 0;
+  for (size_t i = 1; i < sample.size(); i++) {
+    repeats += sample[i] == sample[i - 1];
+  }
+  return repeats * 8 > static_cast<int64_t>(sample.size())
+      ? AccumulateStrategy::Sorted
+      : AccumulateStrategy::Atomic;
+}
+
+template <typename scalar_t>
+void accumulate_privatized(
+    scalar_t* dst,
+    const int64_t* offsets,
+    const scalar_t* values,
+    int64_t n,
+    int64_t min_offset,
+    int64_t range) {
+  const int64_t num_threads = at::get_num_threads();
+  // Not a std::vector, which would pack bool buffers into bits.
+  std::unique_ptr<scalar_t[]> buffers(new scalar_t[num_threads * range]);
+  std::fill(buffers.get(), buffers.get() + num_threads * range, scalar_t(0));
+  // Elements of the range that no update touches may not belong to dst (it
+  // can be strided), so only touched ones are written back.
+  std::vector<uint8_t> touched(num_threads * range, 0);
+  at::parallel_for(0, n, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    const int64_t tid = at::get_thread_num();
+    scalar_t* buffer = buffers.get() + tid * range - min_offset;
+    uint8_t* buffer_touched = touched.data() + tid * range - min_offset;
+    for (int64_t i = begin; i < end; i++) {
+      buffer[offsets[i]] += values[i];
+      buffer_touched[offsets[i]] = 1;
+    }
+  });
+  at::parallel_for(0, range, at::internal::GRAIN_SIZE / num_threads, [&](int64_t begin, int64_t end) {
+    for (int64_t t = 0; t < num_threads; t++) {
+      const scalar_t* buffer = buffers.get() + t * range;
+      const uint8_t* buffer_touched = touched.data() + t * range;
+      for (int64_t j = begin; j < end; j++) {
+        if (buffer_touched[j]) {
+          dst[min_offset + j] += buffer[j];
+        }
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void accumulate_sorted(
+    scalar_t* dst,
+    const int64_t* offsets,
+    const scalar_t* values,
+    int64_t n,
+    int64_t min_offset) {
+  std::vector<uint64_t> keys_buf(n);
+  std::vector<uint64_t> keys_tmp_buf(n);
+  std::vector<int64_t> idx_buf(n);
+  std::vector<int64_t> idx_tmp_buf(n);
+  at::parallel_for(0, n, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      keys_buf[i] = offsets[i] - min_offset;
+      idx_buf[i] = i;
+    }
+  });
+  uint64_t* keys = keys_buf.data();
+  uint64_t* keys_tmp = keys_tmp_buf.data();
+  int64_t* idx = idx_buf.data();
+  int64_t* idx_tmp = idx_tmp_buf.data();
+  parallel_radix_sort_pairs(keys, idx, keys_tmp, idx_tmp, n);
+
+  // A run of equal keys belongs to the chunk it starts in.
+  at::parallel_for(0, n, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    int64_t i = begin;
+    while (i > 0 && i < end && keys[i] == keys[i - 1]) {
+      i++;
+    }
+    while (i < end) {
+      const uint64_t key = keys[i];
+      scalar_t* d = dst + min_offset + key;
+      scalar_t acc = *d;
+      for (; i < n && keys[i] == key; i++) {
+        acc += values[idx[i]];
+      }
+      *d = acc;
+    }
+  });
+}
+
+template <typename scalar_t>
+void accumulate_atomic(
+    scalar_t* dst,
+    const int64_t* offsets,
+    const scalar_t* values,
+    int64_t n) {
+  at::parallel_for(0, n, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      cpu_atomic_add(dst + offsets[i], values[i]);
+    }
+  });
+}
+
+// dst[offsets[i]] += values[i] for i in [0, n), in parallel. offsets are in
+// elements of dst.
+template <typename scalar_t>
+void cpu_accumulate_at_offsets(
+    scalar_t* dst,
+    const int64_t* offsets,
+    const scalar_t* values,
+    int64_t n) {
+  if (n == 0) {
+    return;
+  }
+  const int64_t num_chunks = std::min<int64_t>(at::get_num_threads(), divup(n, at::internal::GRAIN_SIZE));
+  std::vector<int64_t> chunk_min(num_chunks, offsets[0]);
+  std::vector<int64_t> chunk_max(num_chunks, offsets[0]);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      int64_t lo = offsets[0];
+      int64_t hi = offsets[0];
+      for (int64_t i = n * c / num_chunks; i < n * (c + 1) / num_chunks; i++) {
+        lo = std::min(lo, offsets[i]);
+        hi = std::max(hi, offsets[i]);
+      }
+      chunk_min[c] = lo;
+      chunk_max[c] = hi;
+    }
+  });
+  const int64_t min_offset = *std::min_element(chunk_min.begin(), chunk_min.end());
+  const int64_t range = *std::max_element(chunk_max.begin(), chunk_max.end()) - min_offset + 1;
+
+  switch (choose_accumulate_strategy(offsets, n, range)) {
+    case AccumulateStrategy::Privatized:
+      accumulate_privatized(dst, offsets, values, n, min_offset, range);
+      break;
+    case AccumulateStrategy::Sorted:
+      accumulate_sorted(dst, offsets, values, n, min_offset);
+      break;
+    case AccumulateStrategy::Atomic:
+      accumulate_atomic(dst, offsets, values, n);
+      break;
+  }
+}
+
+}}}  // namespace at::native::<anonymous>
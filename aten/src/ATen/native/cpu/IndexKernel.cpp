@@ -6,7 +6,7 @@
 #include <ATen/native/TensorIterator.h>
 #include <ATen/Parallel.h>
 #include <ATen/cpu/vec256/vec256.h>
-#include <ATen/native/cpu/AtomicAddFloat.h>
+#include <ATen/native/cpu/IndexAccumulate.h>
 
 namespace at { namespace native {
 namespace {
@@ -106,23 +106,42 @@ void index_kernel(TensorIterator& iter, IntArrayRef index_size, IntArrayRef inde
   });
 }
 
+// index_put_ with accumulate=true: the destination offset and the value of
+// every update are gathered in parallel, then applied by the parallel
+// accumulation engine (see IndexAccumulate.h).
+template <typename scalar_t>
+void cpu_index_put_accumulate_kernel(TensorIterator& iter, IntArrayRef index_size, IntArrayRef index_stride) {
+  const int64_t numel = iter.numel();
+  if (!use_parallel_accumulate(numel)) {
+    cpu_index_kernel<scalar_t>(iter, index_size, index_stride, [](char* dst, char* src, int64_t offset) {
+      *(scalar_t*)(dst + offset) += *(scalar_t*)src;
+    }, /*serial_execution=*/true);
+    return;
+  }
+
+  int ntensor = iter.ntensors();
+  char* base = (char*)iter.data_ptr(0);
+  std::vector<int64_t> offsets(numel);
+  std::unique_ptr<scalar_t[]> values(new scalar_t[numel]);
+  at::parallel_for(0, numel, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    int64_t pos = begin;
+    iter.serial_for_each([&](char** data, const int64_t* strides, int64_t n) {
+      auto indexer = Indexer(ntensor - 2, &data[2], &strides[2], index_size, index_stride);
+      for (int64_t i = 0; i < n; i++, pos++) {
+        offsets[pos] = (data[0] + strides[0] * i + indexer.get(i) - base) / sizeof(scalar_t);
+        values[pos] = *(scalar_t*)(data[1] + strides[1] * i);
+      }
+    }, {begin, end});
+  });
+  cpu_accumulate_at_offsets((scalar_t*)base, offsets.data(), values.get(), numel);
+}
+
 void index_put_kernel(TensorIterator& iter, IntArrayRef index_size, IntArrayRef index_stride, bool accumulate) {
   // NOTE: duplicate indices are only supported if accumulate is true.
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(at::ScalarType::Half, at::ScalarType::Bool, at::ScalarType::BFloat16,
     iter.dtype(), "index_put", [&] {
     if (accumulate) {
-      bool use_parallel_for = ((iter.numel() >= internal::GRAIN_SIZE) && (at::get_num_threads() > 1));
-      if (iter.dtype() == at::ScalarType::Float && use_parallel_for) {
-        cpu_index_kernel<float>(iter, index_size, index_stride, [](char* dst, char* src, int64_t offset) {
-          cpu_atomic_add_float((float*)(dst + offset), *(float*)src);
-        });
-      } else {
-        // TODO: investigate parallelization of the accumulate kernel. Unlike the non-accumulate case,
-        // this needs to be thread-safe.
-        cpu_index_kernel<scalar_t>(iter, index_size, index_stride, [](char* dst, char* src, int64_t offset) {
-          *(scalar_t*)(dst + offset) += *(scalar_t*)src;
-        }, /*serial_execution=*/true);
-      }
+      cpu_index_put_accumulate_kernel<scalar_t>(iter, index_size, index_stride);
     } else {
       cpu_index_kernel<scalar_t>(iter, index_size, index_stride, [](char* dst, char* src, int64_t offset) {
         *(scalar_t*)(dst + offset) = *(scalar_t*)src;
@@ -91,12 +91,125 @@ static void mse_backward_cpu_kernel(TensorIterator& iter, Scalar value) {
   });
 }
 
+// Runs all steps on one vector of elements before moving to the next, so that
+// every input is read once and the output written once however long the
+// chain is. Blocks are loaded with partial loads at the end of a run and
+// gathered through a buffer for strided inputs.
+template <typename scalar_t>
+void fused_pointwise_kernel_impl(TensorIterator& iter, IntArrayRef ops, ArrayRef<double> scalars) {
+  using Vec = Vec256<scalar_t>;
+  std::vector<FusedPointwiseOp> steps(ops.size());
+  std::vector<scalar_t> step_scalars(ops.size());
+  for (size_t s = 0; s < ops.size(); s++) {
+    steps[s] = static_cast<FusedPointwiseOp>(ops[s]);
+    step_scalars[s] = static_cast<scalar_t>(scalars[s]);
+    // x - a * t is computed as x + (-a) * t, like sub.
+    if (steps[s] == FusedPointwiseOp::SubTensor) {
+      steps[s] = FusedPointwiseOp::AddTensor;
+      step_scalars[s] = -step_scalars[s];
+    }
+  }
+
+  iter.for_each([&](char** data, const int64_t* strides, int64_t n) {
+    __at_align32__ scalar_t buf[Vec::size()];
+    auto load = [&](int arg, int64_t i, int64_t count) {
+      if (strides[arg] == sizeof(scalar_t)) {
+        return Vec::loadu(data[arg] + i * sizeof(scalar_t), count);
+      }
+      for (int64_t e = 0; e < count; e++) {
+        buf[e] = *reinterpret_cast<scalar_t*>(data[arg] + (i + e) * strides[arg]);
+      }
+      return Vec::loadu(buf, count);
+    };
+
+    for (int64_t i = 0; i < n; i += Vec::size()) {
+      const int64_t count = std::min<int64_t>(Vec::size(), n - i);
+      Vec x = load(1, i, count);
+      int operand = 2;
+      for (size_t s = 0; s < steps.size(); s++) {
+        const Vec scalar(step_scalars[s]);
+        switch (steps[s]) {
+          case FusedPointwiseOp::AddTensor:
+          case FusedPointwiseOp::SubTensor:
+            x = vec256::fmadd(load(operand++, i, count), scalar, x);
+            break;
+          case FusedPointwiseOp::MulTensor:
+            x = x * load(operand++, i, count);
+            break;
+          case FusedPointwiseOp::DivTensor:
+            x = x / load(operand++, i, count);
+            break;
+          case FusedPointwiseOp::AddScalar:
+            x = x + scalar;
+            break;
+          case FusedPointwiseOp::MulScalar:
+            x = x * scalar;
+            break;
+          case FusedPointwiseOp::DivScalar:
+            x = x / scalar;
+            break;
+          case FusedPointwiseOp::ClampMin:
+            x = vec256::maximum(x, scalar);
+            break;
+          case FusedPointwiseOp::ClampMax:
+            x = vec256::minimum(x, scalar);
+            break;
+          case FusedPointwiseOp::Relu:
+            x = vec256::maximum(x, Vec(0));
+            break;
+          case FusedPointwiseOp::Sigmoid:
+            x = (Vec(1) + x.neg().exp()).reciprocal();
+            break;
+          case FusedPointwiseOp::Tanh:
+            x = x.tanh();
+            break;
+          case FusedPointwiseOp::Exp:
+            x = x.exp();
+            break;
+          case FusedPointwiseOp::Log:
+            x = x.log();
+            break;
+          case FusedPointwiseOp::Neg:
+            x = x.neg();
+            break;
+          case FusedPointwiseOp::Abs:
+            x = x.abs();
+            break;
+          case FusedPointwiseOp::Sqrt:
+            x = x.sqrt();
+            break;
+          case FusedPointwiseOp::Reciprocal:
+            x = x.reciprocal();
+            break;
+          case FusedPointwiseOp::NumOps:
+            break;
+        }
+      }
+      if (strides[0] == sizeof(scalar_t)) {
+        x.store(data[0] + i * sizeof(scalar_t), count);
+      } else {
+        x.store(buf, count);
+        for (int64_t e = 0; e < count; e++) {
+          *reinterpret_cast<scalar_t*>(data[0] + (i + e) * strides[0]) = buf[e];
+        }
+      }
+    }
+  });
+}
+
+static void fused_pointwise_kernel(TensorIterator& iter, IntArrayRef ops, ArrayRef<double> scalars) {
+  AT_DISPATCH_FLOATING_TYPES(iter.dtype(0), "_fused_pointwise_cpu", [&] {
+    fused_pointwise_kernel_impl<scalar_t>(iter, ops, scalars);
+  });
+}
+
 } // anonymous namespace
 
 REGISTER_DISPATCH(addcmul_stub, &addcmul_cpu_kernel);
 REGISTER_DISPATCH(addcdiv_stub, &addcdiv_cpu_kernel);
 REGISTER_DISPATCH(smooth_l1_backward_stub, &smooth_l1_backward_cpu_kernel);
 REGISTER_DISPATCH(mse_backward_stub, &mse_backward_cpu_kernel);
+REGISTER_DISPATCH(fused_pointwise_stub, &fused_pointwise_kernel);
 
 } // namespace native
 } // namespace at
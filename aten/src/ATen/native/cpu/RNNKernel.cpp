@@ -0,0 +1,148 @@
+#include <ATen/native/RNN.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <cmath>
+
+namespace at { namespace native {
+
+namespace {
+
+using namespace vec256;
+
+template <typename scalar_t>
+inline scalar_t sigmoid(scalar_t x) {
+  return static_cast<scalar_t>(1) / (static_cast<scalar_t>(1) + std::exp(-x));
+}
+
+template <typename scalar_t>
+inline Vec256<scalar_t> sigmoid(Vec256<scalar_t> x) {
+  return (Vec256<scalar_t>(static_cast<scalar_t>(1)) + x.neg().exp()).reciprocal();
+}
+
+// Rows of the batch are independent; every row is [gate 0 | gate 1 | ...],
+// each gate hidden_size wide, as produced by the [4 * hidden, input] and
+// [3 * hidden, input] weights of LSTM and GRU.
+template <typename scalar_t>
+void lstm_cell_fused_kernel_impl(
+    Tensor& hy,
+    Tensor& cy,
+    const Tensor& igates,
+    const Tensor& hgates,
+    const Tensor& cx) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t batch_size = cx.size(0);
+  const int64_t hidden_size = cx.size(1);
+  const scalar_t* igates_data = igates.data_ptr<scalar_t>();
+  const scalar_t* hgates_data = hgates.data_ptr<scalar_t>();
+  const scalar_t* cx_data = cx.data_ptr<scalar_t>();
+  scalar_t* hy_data = hy.data_ptr<scalar_t>();
+  scalar_t* cy_data = cy.data_ptr<scalar_t>();
+
+  const int64_t grain_size = divup(at::internal::GRAIN_SIZE, 4 * hidden_size);
+  at::parallel_for(0, batch_size, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; b++) {
+      const scalar_t* ig = igates_data + b * 4 * hidden_size;
+      const scalar_t* hg = hgates_data + b * 4 * hidden_size;
+      const scalar_t* c_prev = cx_data + b * hidden_size;
+      scalar_t* h = hy_data + b * hidden_size;
+      scalar_t* c = cy_data + b * hidden_size;
+      int64_t j = 0;
+      for (; j < hidden_size - (hidden_size % Vec::size()); j += Vec::size()) {
+        auto gate = [&](int64_t k) {
+          return Vec::loadu(ig + k * hidden_size + j) + Vec::loadu(hg + k * hidden_size + j);
+        };
+        const Vec ingate = sigmoid(gate(0));
+        const Vec forgetgate = sigmoid(gate(1));
+        const Vec cellgate = gate(2).tanh();
+        const Vec outgate = sigmoid(gate(3));
+        const Vec c_vec = forgetgate * Vec::loadu(c_prev + j) + ingate * cellgate;
+        c_vec.store(c + j);
+        (outgate * c_vec.tanh()).store(h + j);
+      }
+      for (; j < hidden_size; j++) {
+        auto gate = [&](int64_t k) {
+          return ig[k * hidden_size + j] + hg[k * hidden_size + j];
+        };
+        const scalar_t ingate = sigmoid(gate(0));
+        const scalar_t forgetgate = sigmoid(gate(1));
+        const scalar_t cellgate = std::tanh(gate(2));
+        const scalar_t outgate = sigmoid(gate(3));
+        c[j] = forgetgate * c_prev[j] + ingate * cellgate;
+        h[j] = outgate * std::tanh(c[j]);
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void gru_cell_fused_kernel_impl(
+    Tensor& hy,
+    const Tensor& igates,
+    const Tensor& hgates,
+    const Tensor& hx) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t batch_size = hx.size(0);
+  const int64_t hidden_size = hx.size(1);
+  const scalar_t* igates_data = igates.data_ptr<scalar_t>();
+  const scalar_t* hgates_data = hgates.data_ptr<scalar_t>();
+  const scalar_t* hx_data = hx.data_ptr<scalar_t>();
+  scalar_t* hy_data = hy.data_ptr<scalar_t>();
+
+  const int64_t grain_size = divup(at::internal::GRAIN_SIZE, 3 * hidden_size);
+  at::parallel_for(0, batch_size, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; b++) {
+      const scalar_t* ig = igates_data + b * 3 * hidden_size;
+      const scalar_t* hg = hgates_data + b * 3 * hidden_size;
+      const scalar_t* h_prev = hx_data + b * hidden_size;
+      scalar_t* h = hy_data + b * hidden_size;
+      const scalar_t* ig_n = ig + 2 * hidden_size;
+      const scalar_t* hg_n = hg + 2 * hidden_size;
+      int64_t j = 0;
+      for (; j < hidden_size - (hidden_size % Vec::size()); j += Vec::size()) {
+        const Vec reset_gate = sigmoid(Vec::loadu(ig + j) + Vec::loadu(hg + j));
+        const Vec input_gate = sigmoid(
+            Vec::loadu(ig + hidden_size + j) + Vec::loadu(hg + hidden_size + j));
+        const Vec new_gate = (Vec::loadu(ig_n + j) + reset_gate * Vec::loadu(hg_n + j)).tanh();
+        (new_gate + input_gate * (Vec::loadu(h_prev + j) - new_gate)).store(h + j);
+      }
+      for (; j < hidden_size; j++) {
+        const scalar_t reset_gate = sigmoid(ig[j] + hg[j]);
+        const scalar_t input_gate = sigmoid(ig[hidden_size + j] + hg[hidden_size + j]);
+        const scalar_t new_gate = std::tanh(ig_n[j] + reset_gate * hg_n[j]);
+        h[j] = new_gate + input_gate * (h_prev[j] - new_gate);
+      }
+    }
+  });
+}
+
+void lstm_cell_fused_kernel(
+    Tensor& hy,
+    Tensor& cy,
+    const Tensor& igates,
+    const Tensor& hgates,
+    const Tensor& cx) {
+  AT_DISPATCH_FLOATING_TYPES(cx.scalar_type(), "lstm_cell_fused_cpu", [&] {
+    lstm_cell_fused_kernel_impl<scalar_t>(hy, cy, igates, hgates, cx);
+  });
+}
+
+void gru_cell_fused_kernel(
+    Tensor& hy,
+    const Tensor& igates,
+    const Tensor& hgates,
+    const Tensor& hx) {
+  AT_DISPATCH_FLOATING_TYPES(hx.scalar_type(), "gru_cell_fused_cpu", [&] {
+    gru_cell_fused_kernel_impl<scalar_t>(hy, igates, hgates, hx);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(lstm_cell_fused_stub, &lstm_cell_fused_kernel);
+REGISTER_DISPATCH(gru_cell_fused_stub, &gru_cell_fused_kernel);
+
+}} // namespace at::native
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <ATen/NumericUtils.h>
+#include <ATen/Parallel.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+// Radix sort building blocks shared by the CPU sorting kernels.
+//
+// Values are first mapped onto unsigned integer keys whose natural order is
+// the ascending order used by torch.sort: NaNs compare greater than every
+// other value (for numpy compatibility) and -0.0 compares equal to 0.0.
+// (key, index) pairs are then sorted with an LSD radix sort, which is stable:
+// equal keys keep the relative order of their original positions.
+
+namespace at { namespace native { namespace {
+
+// Slices shorter than this are insertion sorted; the histogram setup of a
+// radix pass is not worth it for them.
+constexpr int64_t kRadixSortMinSize = 64;
+// Minimum number of elements each thread sorts before the runs are merged.
+constexpr int64_t kParallelSortMinChunk = 1 << 16;
+
+template <typename scalar_t, typename Enable = void>
+struct RadixKey;
+
+template <>
+struct RadixKey<bool> {
+  using type = uint8_t;
+  static inline type encode(bool v) {
+    return static_cast<type>(v);
+  }
+};
+
+template <typename scalar_t>
+struct RadixKey<scalar_t, typename std::enable_if<
+    std::is_integral<scalar_t>::value && !std::is_same<scalar_t, bool>::value>::type> {
+  using type = typename std::make_unsigned<scalar_t>::type;
+  static inline type encode(scalar_t v) {
+    // Flipping the sign bit maps two's complement onto offset binary.
+    constexpr type sign_flip = std::is_signed<scalar_t>::value
+        ? static_cast<type>(type(1) << (sizeof(type) * 8 - 1))
+        : type(0);
+    return static_cast<type>(static_cast<type>(v) ^ sign_flip);
+  }
+};
+
+template <typename scalar_t, typename bits_t>
+struct FloatRadixKey {
+  using type = bits_t;
+  static inline type encode(scalar_t v) {
+    if (_isnan(v)) {
+      return std::numeric_limits<type>::max();
+    }
+    if (v == scalar_t(0)) {
+      // canonicalize -0.0
+      v = scalar_t(0);
+    }
+    constexpr type sign = static_cast<type>(type(1) << (sizeof(type) * 8 - 1));
+    type bits;
+    std::memcpy(&bits, &v, sizeof(type));
+    // Negative values are stored as sign-magnitude, so their order has to be
+    // reversed; positive values just need to move above the negative ones.
+    return (bits & sign) ? static_cast<type>(~bits) : static_cast<type>(bits | sign);
+  }
+};
+
+template <> struct RadixKey<float> : FloatRadixKey<float, uint32_t> {};
+template <> struct RadixKey<double> : FloatRadixKey<double, uint64_t> {};
+template <> struct RadixKey<at::Half> : FloatRadixKey<at::Half, uint16_t> {};
+template <> struct RadixKey<at::BFloat16> : FloatRadixKey<at::BFloat16, uint16_t> {};
+
+template <typename key_t>
+inline void insertion_sort_pairs(key_t* keys, int64_t* idx, int64_t n) {
+  for (int64_t i = 1; i < n; ++i) {
+    const key_t key = keys[i];
+    const int64_t index = idx[i];
+    int64_t j = i;
+    for (; j > 0 && key < keys[j - 1]; --j) {
+      keys[j] = keys[j - 1];
+      idx[j] = idx[j - 1];
+    }
+    keys[j] = key;
+    idx[j] = index;
+  }
+}
+
+// Stable LSD radix sort of n (key, index) pairs, one byte per pass. Data is
+// ping-ponged between (keys, idx) and (keys_tmp, idx_tmp); on return `keys`
+// and `idx` point at whichever buffer holds the sorted result.
+template <typename key_t>
+void radix_sort_pairs(
+    key_t*& keys,
+    int64_t*& idx,
+    key_t*& keys_tmp,
+    int64_t*& idx_tmp,
+    int64_t n) {
+  constexpr int kRadixBits = 8;
+  constexpr int kRadixSize = 1 << kRadixBits;
+  constexpr int kNumPasses = sizeof(key_t);
+
+  if (n < kRadixSortMinSize) {
+    insertion_sort_pairs(keys, idx, n);
+    return;
+  }
+
+  // Histograms of all passes are built in a single sweep over the keys.
+  std::array<std::array<int64_t, kRadixSize>, kNumPasses> counts{};
+  for (int64_t i = 0; i < n; ++i) {
+    const key_t key = keys[i];
+    for (int pass = 0; pass < kNumPasses; ++pass) {
+      counts[pass][(key >> (pass * kRadixBits)) & (kRadixSize - 1)]++;
+    }
+  }
+
+  for (int pass = 0; pass < kNumPasses; ++pass) {
+    const int shift = pass * kRadixBits;
+    auto& count = counts[pass];
+    // Every key has the same digit: this pass would not move anything.
+    if (count[(keys[0] >> shift) & (kRadixSize - 1)] == n) {
+      continue;
+    }
+    int64_t offset = 0;
+    for (int b = 0; b < kRadixSize; ++b) {
+      const int64_t c = count[b];
+      count[b] = offset;
+      offset += c;
+    }
+    for (int64_t i = 0; i < n; ++i) {
+      const int64_t pos = count[(keys[i] >> shift) & (kRadixSize - 1)]++;
+      keys_tmp[pos] = keys[i];
+      idx_tmp[pos] = idx[i];
+    }
+    std::swap(keys, keys_tmp);
+    std::swap(idx, idx_tmp);
+  }
+}
+
+// Number of elements of `a` among the first `d` outputs of a stable merge of
+// the sorted runs a[0, na) and b[0, nb) (elements of `a` win ties).
+template <typename key_t>
+inline int64_t merge_path_co_rank(
+    int64_t d,
+    const key_t* a,
+    int64_t na,
+    const key_t* b,
+    int64_t nb) {
+  int64_t lo = std::max<int64_t>(0, d - nb);
+  int64_t hi = std::min<int64_t>(d, na);
+  while (lo < hi) {
+    const int64_t i = lo + (hi - lo) / 2;
+    const int64_t j = d - i;
+    if (j > 0 && a[i] <= b[j - 1]) {
+      lo = i + 1;
+    } else {
+      hi = i;
+    }
+  }
+  return lo;
+}
+
+// Writes outputs [d_begin, d_end) of the stable merge of the runs
+// [lo, mid) and [mid, hi) of (keys, idx) to the same positions of
+// (out_keys, out_idx).
+template <typename key_t>
+void merge_pairs_range(
+    const key_t* keys,
+    const int64_t* idx,
+    key_t* out_keys,
+    int64_t* out_idx,
+    int64_t lo,
+    int64_t mid,
+    int64_t hi,
+    int64_t d_begin,
+    int64_t d_end) {
+  const key_t* a = keys + lo;
+  const key_t* b = keys + mid;
+  const int64_t na = mid - lo;
+  const int64_t nb = hi - mid;
+  int64_t i = merge_path_co_rank(d_begin - lo, a, na, b, nb);
+  int64_t j = (d_begin - lo) - i;
+  const int64_t i_end = merge_path_co_rank(d_end - lo, a, na, b, nb);
+  const int64_t j_end = (d_end - lo) - i_end;
+  int64_t out = d_begin;
+  while (i < i_end && j < j_end) {
+    if (b[j] < a[i]) {
+      out_keys[out] = b[j];
+      out_idx[out++] = idx[mid + j++];
+    } else {
+      out_keys[out] = a[i];
+      out_idx[out++] = idx[lo + i++];
+    }
+  }
+  for (; i < i_end; ++i) {
+    out_keys[out] = a[i];
+    out_idx[out++] = idx[lo + i];
+  }
+  for (; j < j_end; ++j) {
+    out_keys[out] = b[j];
+    out_idx[out++] = idx[mid + j];
+  }
+}
+
+// Sorts one large array of (key, index) pairs with all intra-op threads:
+// every thread radix sorts a contiguous chunk, then the sorted runs are
+// merged pairwise. Each merge round is partitioned over the output with
+// merge path co-ranking, so the last rounds are as parallel as the first.
+// Buffer semantics are the same as for radix_sort_pairs.
+template <typename key_t>
+void parallel_radix_sort_pairs(
+    key_t*& keys,
+    int64_t*& idx,
+    key_t*& keys_tmp,
+    int64_t*& idx_tmp,
+    int64_t n) {
+  const int64_t num_chunks = std::min<int64_t>(
+      at::get_num_threads(), n / kParallelSortMinChunk);
+  if (num_chunks <= 1 || at::in_parallel_region()) {
+    radix_sort_pairs(keys, idx, keys_tmp, idx_tmp, n);
+    return;
+  }
+
+  std::vector<int64_t> bounds(num_chunks + 1);
+  for (int64_t c = 0; c <= num_chunks; ++c) {
+    bounds[c] = n * c / num_chunks;
+  }
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; ++c) {
+      const int64_t offset = bounds[c];
+      const int64_t len = bounds[c + 1] - offset;
+      key_t* chunk_keys = keys + offset;
+      int64_t* chunk_idx = idx + offset;
+      key_t* chunk_keys_tmp = keys_tmp + offset;
+      int64_t* chunk_idx_tmp = idx_tmp + offset;
+      radix_sort_pairs(chunk_keys, chunk_idx, chunk_keys_tmp, chunk_idx_tmp, len);
+      if (chunk_keys != keys + offset) {
+        std::copy(chunk_keys, chunk_keys + len, keys + offset);
+        std::copy(chunk_idx, chunk_idx + len, idx + offset);
+      }
+    }
+  });
+
+  while (bounds.size() > 2) {
+    const int64_t num_runs = bounds.size() - 1;
+    at::parallel_for(0, n, kParallelSortMinChunk, [&](int64_t begin, int64_t end) {
+      for (int64_t r = 0; r < num_runs; r += 2) {
+        const int64_t lo = bounds[r];
+        const int64_t mid = bounds[r + 1];
+        const int64_t hi = r + 1 < num_runs ? bounds[r + 2] : mid;
+        const int64_t d_begin = std::max(begin, lo);
+        const int64_t d_end = std::min(end, hi);
+        if (d_begin >= d_end) {
+          continue;
+        }
+        if (mid == hi) {
+          // odd run out, carried over to the next round
+          std::copy(keys + d_begin, keys + d_end, keys_tmp + d_begin);
+          std::copy(idx + d_begin, idx + d_end, idx_tmp + d_begin);
+        } else {
+          merge_pairs_range(keys, idx, keys_tmp, idx_tmp, lo, mid, hi, d_begin, d_end);
+        }
+      }
+    });
+    std::swap(keys, keys_tmp);
+    std::swap(idx, idx_tmp);
+
+    std::vector<int64_t> next_bounds;
+    next_bounds.reserve(num_runs / 2 + 2);
+    for (int64_t r = 0; r < num_runs; r += 2) {
+      next_bounds.push_back(bounds[r]);
+    }
+    next_bounds.push_back(n);
+    bounds = std::move(next_bounds);
+  }
+}
+
+}}}  // namespace at::native::<anonymous>
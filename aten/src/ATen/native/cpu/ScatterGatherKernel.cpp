@@ -3,6 +3,7 @@
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/TensorAdvancedIndexing.h>
 #include <ATen/Parallel.h>
+#include <ATen/native/cpu/IndexAccumulate.h>
 
 namespace at { namespace native {
 
@@ -161,8 +162,8 @@ struct cpu_scatter_gather_base_kernel {
 
     auto index_upper_bound = self_dim_size;
 
-    AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND2(
-      ScalarType::Bool, ScalarType::Half, iter.dtype(),
+    AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(
+      ScalarType::Bool, ScalarType::Half, ScalarType::BFloat16, iter.dtype(),
       method_name, [&] {
         constexpr auto SELF_ITER_STRIDE_IDX = 0;
         constexpr auto INDEX_ITER_STRIDE_IDX = 1;
@@ -256,8 +257,8 @@ struct cpu_scatter_gather_base_kernel {
 
     auto index_upper_bound = is_scatter_like ? self_dim_size : src_dim_size;
 
-    AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND2(
-      ScalarType::Bool, ScalarType::Half, iter.dtype(),
+    AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(
+      ScalarType::Bool, ScalarType::Half, ScalarType::BFloat16, iter.dtype(),
       method_name, [&] {
         constexpr auto SELF_ITER_STRIDE_IDX = 0;
         constexpr auto INDEX_ITER_STRIDE_IDX = 2;
@@ -334,7 +335,71 @@ void scatter_fill_cpu_kernel(Tensor& self, int64_t dim, const Tensor& index, Sca
     self, dim, index, value, "scatter_fill_cpu_", tensor_assign);
 }
 
+// cpu_scatter_gather_base_kernel parallelizes over the positions of index
+// outside of dim, each of which updates its own slice of self, and runs the
+// loop over dim serially. When there are too few of those positions to be
+// split over threads (e.g. a 1-D scatter_add_), the offset and value of
+// every update are gathered in parallel and applied by the parallel
+// accumulation engine (see IndexAccumulate.h) instead.
+void cpu_scatter_add_accumulate_kernel(Tensor& self, int64_t dim, const Tensor& index, const Tensor& src) {
+  auto iter = TensorIteratorConfig()
+    .check_all_same_dtype(false)
+    .resize_outputs(false)
+    .declare_static_shape(index.sizes(), /*squash_dim=*/dim)
+    .add_output(self)
+    .add_input(src)
+    .add_input(index)
+    .build();
+
+  auto self_dim_stride = ensure_nonempty_stride(self, dim);
+  auto self_dim_size = ensure_nonempty_size(self, dim);
+  auto index_dim_stride = ensure_nonempty_stride(index, dim);
+  auto index_dim_size = ensure_nonempty_size(index, dim);
+  auto src_dim_stride = ensure_nonempty_stride(src, dim);
+  const int64_t num_updates = iter.numel() * index_dim_size;
+
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(
+    ScalarType::Bool, ScalarType::Half, ScalarType::BFloat16, iter.dtype(),
+    "scatter_add_", [&] {
+      scalar_t* base = self.data_ptr<scalar_t>();
+      std::vector<int64_t> offsets(num_updates);
+      std::unique_ptr<scalar_t[]> values(new scalar_t[num_updates]);
+      at::parallel_for(0, iter.numel(), divup(internal::GRAIN_SIZE, index_dim_size), [&](int64_t begin, int64_t end) {
+        int64_t pos = begin * index_dim_size;
+        iter.serial_for_each([&](char** data, const int64_t* strides, int64_t n) {
+          for (int64_t nelem = 0; nelem < n; ++nelem) {
+            auto* self_data = (scalar_t*)(data[0] + nelem * strides[0]);
+            auto* src_data = (scalar_t*)(data[1] + nelem * strides[1]);
+            auto* index_data = (int64_t*)(data[2] + nelem * strides[2]);
+            for (int64_t i = 0; i < index_dim_size; ++i, ++pos) {
+              int64_t idx_dim = index_data[i * index_dim_stride];
+              TORCH_CHECK(idx_dim >= 0 && idx_dim < self_dim_size,
+                          "index ", index_data[i * index_dim_stride],
+                          " is out of bounds for dimension ", dim,
+                          " with size ", self_dim_size);
+              offsets[pos] = self_data - base + idx_dim * self_dim_stride;
+              values[pos] = src_data[i * src_dim_stride];
+            }
+          }
+        }, {begin, end});
+      });
+      cpu_accumulate_at_offsets(base, offsets.data(), values.get(), num_updates);
+    }
+  );
+}
+
 void scatter_add_cpu_kernel(Tensor& self, int64_t dim, const Tensor& index, const Tensor& src) {
+  if (index.numel() > 0) {
+    dim = maybe_wrap_dim(dim, self.dim());
+    const int64_t index_dim_size = ensure_nonempty_size(index, dim);
+    if (index.numel() / index_dim_size < internal::GRAIN_SIZE &&
+        use_parallel_accumulate(index.numel())) {
+      scatter_gather_dtype_check("scatter_add_", self, index, src);
+      scatter_shape_check(self, dim, index, src);
+      cpu_scatter_add_accumulate_kernel(self, dim, index, src);
+      return;
+    }
+  }
   cpu_scatter_gather_base_kernel<>()(
     self, dim, index, src,
     "scatter_add_", reduce_add);
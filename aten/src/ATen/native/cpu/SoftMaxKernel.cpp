@@ -2,7 +2,9 @@
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
 #include <numeric>
+#include <vector>
 
 #include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
@@ -184,6 +186,209 @@ inline void _vec_host_softmax_backward_lastdim(
       });
 }
 
+// [Note fused cross entropy] cross_entropy_loss reduces every row of the
+// input to its log-sum-exp with a single read from memory: the row is walked
+// in blocks of CE_BLOCK_SIZE elements, each block is reduced to its max and
+// then summed again while it is still in L1, and the running sum is rescaled
+// whenever the max grows. The [outer_size, dim_size] log-probabilities of
+// log_softmax + nll_loss are never materialized.
+//
+// When there are fewer rows than threads (e.g. a few rows over a large
+// vocabulary), rows are also split into chunks of at least CE_MIN_CHUNK_SIZE
+// elements whose partial (max, sum) pairs are combined afterwards.
+static constexpr int64_t CE_BLOCK_SIZE = 2048;
+static constexpr int64_t CE_MIN_CHUNK_SIZE = 16384;
+
+inline int64_t _cross_entropy_num_chunks(int64_t outer_size, int64_t dim_size) {
+  const int64_t num_threads = at::get_num_threads();
+  if (outer_size >= num_threads)
+    return 1;
+  return std::max<int64_t>(
+      1,
+      std::min(divup(num_threads, outer_size), dim_size / CE_MIN_CHUNK_SIZE));
+}
+
+template <typename scalar_t>
+inline void _vec_max_sum_exp(
+    scalar_t* input_data,
+    int64_t size,
+    scalar_t& max_out,
+    scalar_t& sum_out) {
+  using Vec = vec256::Vec256<scalar_t>;
+  scalar_t max_input = -std::numeric_limits<scalar_t>::infinity();
+  scalar_t sum = 0;
+  for (int64_t b = 0; b < size; b += CE_BLOCK_SIZE) {
+    const int64_t len = std::min(CE_BLOCK_SIZE, size - b);
+    const scalar_t block_max = vec256::reduce_all<scalar_t>(
+        [](Vec& x, Vec& y) { return vec256::maximum(x, y); },
+        input_data + b,
+        len);
+    if (block_max > max_input) {
+      sum *= std::exp(max_input - block_max);
+      max_input = block_max;
+    }
+    sum += vec256::map_reduce_all<scalar_t>(
+        [max_input](Vec x) { return (x - Vec(max_input)).exp(); },
+        [](Vec x, Vec y) { return x + y; },
+        input_data + b,
+        len);
+  }
+  max_out = max_input;
+  sum_out = sum;
+}
+
+template <typename scalar_t>
+inline void _vec_cross_entropy_lastdim(
+    Tensor& losses,
+    Tensor& row_weights,
+    Tensor& log_sum_exp,
+    const Tensor& input,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t ignore_index) {
+  const int64_t outer_size = input.size(0);
+  const int64_t dim_size = input.size(1);
+  scalar_t* input_data_base = input.data_ptr<scalar_t>();
+  const int64_t* target_data = target.data_ptr<int64_t>();
+  const scalar_t* weight_data =
+      weight.defined() ? weight.data_ptr<scalar_t>() : nullptr;
+  scalar_t* loss_data = losses.data_ptr<scalar_t>();
+  scalar_t* row_weight_data = row_weights.data_ptr<scalar_t>();
+  double* lse_data = log_sum_exp.data_ptr<double>();
+
+  const int64_t num_chunks = _cross_entropy_num_chunks(outer_size, dim_size);
+  const int64_t chunk_size = divup(dim_size, num_chunks);
+  std::vector<scalar_t> chunk_max(outer_size * num_chunks);
+  std::vector<scalar_t> chunk_sum(outer_size * num_chunks);
+
+  int64_t grain_size =
+      internal::GRAIN_SIZE / (16 * std::max<int64_t>(chunk_size, 1));
+  if (grain_size < 1)
+    grain_size = 1;
+  parallel_for(
+      0,
+      outer_size * num_chunks,
+      grain_size,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t k = begin; k < end; k++) {
+          const int64_t i = k / num_chunks;
+          const int64_t start = (k % num_chunks) * chunk_size;
+          _vec_max_sum_exp(
+              input_data_base + i * dim_size + start,
+              std::min(chunk_size, dim_size - start),
+              chunk_max[k],
+              chunk_sum[k]);
+        }
+      });
+
+  parallel_for(
+      0,
+      outer_size,
+      internal::GRAIN_SIZE / 16,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          const scalar_t* row_max = chunk_max.data() + i * num_chunks;
+          const scalar_t* row_sum = chunk_sum.data() + i * num_chunks;
+          const scalar_t max_input = *std::max_element(row_max, row_max + num_chunks);
+          scalar_t sum = 0;
+          for (int64_t c = 0; c < num_chunks; c++) {
+            sum += row_max[c] == max_input
+                ? row_sum[c]
+                : row_sum[c] * std::exp(row_max[c] - max_input);
+          }
+          const scalar_t log_sum = std::log(sum);
+          lse_data[i] = static_cast<double>(max_input) + std::log(static_cast<double>(sum));
+
+          const int64_t cur_target = target_data[i];
+          if (cur_target == ignore_index) {
+            loss_data[i] = 0;
+            row_weight_data[i] = 0;
+            continue;
+          }
+          TORCH_CHECK_INDEX(
+              cur_target >= 0 && cur_target < dim_size,
+              "Target ",
+              cur_target,
+              " is out of bounds.");
+          const scalar_t cur_weight = weight_data != nullptr
+              ? weight_data[cur_target]
+              : static_cast<scalar_t>(1);
+          row_weight_data[i] = cur_weight;
+          // Same order of operations as _vec_log_softmax_lastdim.
+          const scalar_t log_prob =
+              input_data_base[i * dim_size + cur_target] - max_input - log_sum;
+          loss_data[i] = -log_prob * cur_weight;
+        }
+      });
+}
+
+template <typename scalar_t>
+inline void _vec_cross_entropy_backward_lastdim(
+    Tensor& grad_input,
+    const Tensor& grad_scale,
+    const Tensor& input,
+    const Tensor& target,
+    const Tensor& weight,
+    const Tensor& log_sum_exp,
+    int64_t ignore_index) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const int64_t outer_size = input.size(0);
+  const int64_t dim_size = input.size(1);
+  scalar_t* grad_input_data_base = grad_input.data_ptr<scalar_t>();
+  const scalar_t* input_data_base = input.data_ptr<scalar_t>();
+  const scalar_t* grad_scale_data = grad_scale.data_ptr<scalar_t>();
+  const int64_t* target_data = target.data_ptr<int64_t>();
+  const scalar_t* weight_data =
+      weight.defined() ? weight.data_ptr<scalar_t>() : nullptr;
+  const double* lse_data = log_sum_exp.data_ptr<double>();
+
+  const int64_t num_chunks = _cross_entropy_num_chunks(outer_size, dim_size);
+  const int64_t chunk_size = divup(dim_size, num_chunks);
+  int64_t grain_size =
+      internal::GRAIN_SIZE / (16 * std::max<int64_t>(chunk_size, 1));
+  if (grain_size < 1)
+    grain_size = 1;
+  parallel_for(
+      0,
+      outer_size * num_chunks,
+      grain_size,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t k = begin; k < end; k++) {
+          const int64_t i = k / num_chunks;
+          const int64_t start = (k % num_chunks) * chunk_size;
+          const int64_t size = std::min(chunk_size, dim_size - start);
+          scalar_t* grad_input_data = grad_input_data_base + i * dim_size + start;
+          const int64_t cur_target = target_data[i];
+          if (cur_target == ignore_index) {
+            std::fill_n(grad_input_data, size, static_cast<scalar_t>(0));
+            continue;
+          }
+          TORCH_CHECK_INDEX(
+              cur_target >= 0 && cur_target < dim_size,
+              "Target ",
+              cur_target,
+              " is out of bounds.");
+          const scalar_t scale = grad_scale_data[i] *
+              (weight_data != nullptr ? weight_data[cur_target]
+                                      : static_cast<scalar_t>(1));
+          // Subtract the double log-sum-exp in two parts, so that large
+          // inputs keep the precision of x - max in log_softmax.
+          const scalar_t lse_hi = static_cast<scalar_t>(lse_data[i]);
+          const scalar_t lse_lo = static_cast<scalar_t>(lse_data[i] - lse_hi);
+          vec256::map(
+              [lse_hi, lse_lo, scale](Vec x) {
+                return ((x - Vec(lse_hi)) - Vec(lse_lo)).exp() * Vec(scale);
+              },
+              grad_input_data,
+              input_data_base + i * dim_size + start,
+              size);
+          if (cur_target >= start && cur_target < start + size) {
+            grad_input_data[cur_target - start] -= scale;
+          }
+        }
+      });
+}
+
 template <typename scalar_t, bool LogSoftMax>
 struct vec_host_softmax_lastdim {
   static void apply(Tensor& output, const Tensor& input) {
@@ -261,6 +466,36 @@ static void log_softmax_backward_lastdim_kernel_impl(
       });
 }
 
+static void cross_entropy_lastdim_kernel_impl(
+    Tensor& losses,
+    Tensor& row_weights,
+    Tensor& log_sum_exp,
+    const Tensor& input,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t ignore_index) {
+  AT_DISPATCH_FLOATING_TYPES(
+      input.scalar_type(), "cross_entropy_lastdim_kernel_impl", [&] {
+        _vec_cross_entropy_lastdim<scalar_t>(
+            losses, row_weights, log_sum_exp, input, target, weight, ignore_index);
+      });
+}
+
+static void cross_entropy_backward_lastdim_kernel_impl(
+    Tensor& grad_input,
+    const Tensor& grad_scale,
+    const Tensor& input,
+    const Tensor& target,
+    const Tensor& weight,
+    const Tensor& log_sum_exp,
+    int64_t ignore_index) {
+  AT_DISPATCH_FLOATING_TYPES(
+      input.scalar_type(), "cross_entropy_backward_lastdim_kernel_impl", [&] {
+        _vec_cross_entropy_backward_lastdim<scalar_t>(
+            grad_input, grad_scale, input, target, weight, log_sum_exp, ignore_index);
+      });
+}
+
 } // anonymous namespace
 
 REGISTER_DISPATCH(softmax_lastdim_kernel, &softmax_lastdim_kernel_impl);
@@ -271,5 +506,11 @@ REGISTER_DISPATCH(
 REGISTER_DISPATCH(
     log_softmax_backward_lastdim_kernel,
     &log_softmax_backward_lastdim_kernel_impl);
+REGISTER_DISPATCH(
+    cross_entropy_lastdim_kernel,
+    &cross_entropy_lastdim_kernel_impl);
+REGISTER_DISPATCH(
+    cross_entropy_backward_lastdim_kernel,
+    &cross_entropy_backward_lastdim_kernel_impl);
 
 }} // namespace at::native
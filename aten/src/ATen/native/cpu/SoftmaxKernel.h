@@ -14,5 +14,16 @@ DECLARE_DISPATCH(forward_fn, log_softmax_lastdim_kernel);
 DECLARE_DISPATCH(backward_fn, softmax_backward_lastdim_kernel);
 DECLARE_DISPATCH(backward_fn, log_softmax_backward_lastdim_kernel);
 
+// Fused log_softmax + nll_loss over the rows of a contiguous 2-D input; see
+// [Note fused cross entropy]. The forward writes the per-row weighted losses,
+// the per-row target weights and the log-sum-exp of each row (as double); the
+// backward scales softmax(input) - one_hot(target) by grad_scale and the
+// target weight.
+using cross_entropy_fn = void(*)(Tensor&, Tensor&, Tensor&, const Tensor&, const Tensor&, const Tensor&, int64_t);
+using cross_entropy_backward_fn = void(*)(Tensor&, const Tensor&, const Tensor&, const Tensor&, const Tensor&, const Tensor&, int64_t);
+
+DECLARE_DISPATCH(cross_entropy_fn, cross_entropy_lastdim_kernel);
+DECLARE_DISPATCH(cross_entropy_backward_fn, cross_entropy_backward_lastdim_kernel);
+
 }
 }
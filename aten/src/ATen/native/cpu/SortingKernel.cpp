@@ -4,11 +4,244 @@
 #include <ATen/NumericUtils.h>
 #include <ATen/native/Sorting.h>
 #include <ATen/native/SortingUtils.h>
+#include <ATen/native/TensorIterator.h>
+#include <ATen/native/cpu/RadixSort.h>
 
 namespace at { namespace native {
 
 namespace {
 
+// Sorts one slice of `self` of length n into (values, indices).
+//
+// The slice is encoded into radix keys (inverted for a descending sort, which
+// keeps the sort stable and puts NaNs first), the (key, position) pairs are
+// radix sorted, and the values are then gathered from `self` through the
+// sorted positions. Long slices are sorted with all intra-op threads unless
+// the caller is already parallelizing over slices.
+template <typename scalar_t, typename key_t>
+void sort_slice(
+    scalar_t* values,
+    int64_t values_stride,
+    int64_t* indices,
+    int64_t indices_stride,
+    const scalar_t* self,
+    int64_t self_stride,
+    int64_t n,
+    bool descending,
+    key_t* keys_buf,
+    int64_t* idx_buf) {
+  key_t* keys = keys_buf;
+  key_t* keys_tmp = keys_buf + n;
+  int64_t* idx = idx_buf;
+  int64_t* idx_tmp = idx_buf + n;
+
+  at::parallel_for(0, n, kParallelSortMinChunk, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const key_t key = RadixKey<scalar_t>::encode(self[i * self_stride]);
+      keys[i] = descending ? static_cast<key_t>(~key) : key;
+      idx[i] = i;
+    }
+  });
+
+  parallel_radix_sort_pairs(keys, idx, keys_tmp, idx_tmp, n);
+
+  at::parallel_for(0, n, kParallelSortMinChunk, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      values[i * values_stride] = self[idx[i] * self_stride];
+      indices[i * indices_stride] = idx[i];
+    }
+  });
+}
+
+static void sort_kernel(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t dim,
+    bool descending) {
+  if (self.numel() == 0) {
+    return;
+  }
+
+  auto iter = TensorIteratorConfig()
+    .check_all_same_dtype(false)
+    .resize_outputs(false)
+    .declare_static_shape(self.sizes(), /*squash_dim=*/dim)
+    .add_output(values)
+    .add_output(indices)
+    .add_input(self)
+    .build();
+
+  const int64_t dim_size = self.size(dim);
+  const auto values_dim_stride = values.stride(dim);
+  const auto indices_dim_stride = indices.stride(dim);
+  const auto self_dim_stride = self.stride(dim);
+
+  AT_DISPATCH_ALL_TYPES_AND3(ScalarType::Bool, ScalarType::Half, ScalarType::BFloat16,
+                             self.scalar_type(), "sort_cpu", [&] {
+    using key_t = typename RadixKey<scalar_t>::type;
+
+    auto loop = [&](char** data, const int64_t* strides, int64_t n) {
+      // ping-pong buffers for the radix sort, reused by all slices of this chunk
+      std::vector<key_t> keys_buf(2 * dim_size);
+      std::vector<int64_t> idx_buf(2 * dim_size);
+      for (int64_t i = 0; i < n; ++i) {
+        sort_slice(
+            reinterpret_cast<scalar_t*>(data[0] + i * strides[0]),
+            values_dim_stride,
+            reinterpret_cast<int64_t*>(data[1] + i * strides[1]),
+            indices_dim_stride,
+            reinterpret_cast<const scalar_t*>(data[2] + i * strides[2]),
+            self_dim_stride,
+            dim_size,
+            descending,
+            keys_buf.data(),
+            idx_buf.data());
+      }
+    };
+
+    // A few long slices leave most threads idle when parallelizing over
+    // slices, so sort them one after another, each with all threads.
+    const int64_t num_slices = iter.numel();
+    if (num_slices < at::get_num_threads() && dim_size >= 2 * kParallelSortMinChunk) {
+      iter.serial_for_each(loop, {0, num_slices});
+    } else {
+      iter.for_each(loop, /*grain_size=*/std::max<int64_t>(1, at::internal::GRAIN_SIZE / dim_size));
+    }
+  });
+}
+
+// Slices at least this long are selected with all intra-op threads when k is
+// small next to them; see topk_parallel_slice.
+constexpr int64_t kParallelTopkMinSize = 2 * kParallelSortMinChunk;
+
+// Orders the values of a topk selection: x goes before y if it is selected
+// first. NaN is treated as the top value, for numpy compatibility.
+template <typename scalar_t>
+struct TopkBefore {
+  bool largest;
+
+  inline bool operator()(scalar_t x, scalar_t y) const {
+    if (largest) {
+      return (_isnan<scalar_t>(x) && !_isnan<scalar_t>(y)) || (x > y);
+    }
+    return (!_isnan<scalar_t>(x) && _isnan<scalar_t>(y)) || (x < y);
+  }
+};
+
+// Selects the top k of one slice of `self` of length n by copying it into a
+// (value, index) queue and partially sorting the queue.
+template <typename scalar_t>
+void topk_slice(
+    scalar_t* values,
+    int64_t values_stride,
+    int64_t* indices,
+    int64_t indices_stride,
+    const scalar_t* self,
+    int64_t self_stride,
+    int64_t n,
+    int64_t k,
+    bool largest,
+    bool sorted) {
+  using elem_t = std::pair<scalar_t, int64_t>;
+  const TopkBefore<scalar_t> before{largest};
+  auto elem_before = [&](const elem_t& x, const elem_t& y) -> bool {
+    return before(x.first, y.first);
+  };
+
+  std::vector<elem_t> queue(n);
+  for (int64_t j = 0; j < n; j++) {
+    queue[j].first = self[j * self_stride];
+    queue[j].second = j;
+  }
+
+  if (k * 64 <= n) {
+    std::partial_sort(queue.begin(), queue.begin() + k, queue.end(), elem_before);
+  } else {
+    std::nth_element(queue.begin(), queue.begin() + k - 1, queue.end(), elem_before);
+    if (sorted) {
+      std::sort(queue.begin(), queue.begin() + k - 1, elem_before);
+    }
+  }
+
+  for (int64_t j = 0; j < k; j++) {
+    values[j * values_stride] = queue[j].first;
+    indices[j * indices_stride] = queue[j].second;
+  }
+}
+
+// Selects the top k of one long slice of `self` with all intra-op threads and
+// without copying it.
+//
+// The slice is split into one chunk per thread, and each thread streams over
+// its chunk keeping the best k elements seen so far in a bounded heap whose
+// front is the worst of them. Once the heap is full, the front acts as a
+// threshold and almost every element is rejected with a single comparison.
+// The per-thread heaps (at most k elements each) are then merged. Equal values
+// favour the lower index, so the result doesn't depend on the split.
+template <typename scalar_t>
+void topk_parallel_slice(
+    scalar_t* values,
+    int64_t values_stride,
+    int64_t* indices,
+    int64_t indices_stride,
+    const scalar_t* self,
+    int64_t self_stride,
+    int64_t n,
+    int64_t k,
+    bool largest,
+    bool sorted) {
+  using elem_t = std::pair<scalar_t, int64_t>;
+  const TopkBefore<scalar_t> before{largest};
+  auto elem_before = [&](const elem_t& x, const elem_t& y) -> bool {
+    return before(x.first, y.first) ||
+        (!before(y.first, x.first) && x.second < y.second);
+  };
+
+  const int64_t num_chunks = std::max<int64_t>(
+      1, std::min<int64_t>(at::get_num_threads(), n / kParallelSortMinChunk));
+  const int64_t chunk_size = divup(n, num_chunks);
+  std::vector<std::vector<elem_t>> heaps(num_chunks);
+
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; ++c) {
+      auto& heap = heaps[c];
+      heap.reserve(k);
+      const int64_t chunk_end = std::min(n, (c + 1) * chunk_size);
+      int64_t i = c * chunk_size;
+      for (; i < chunk_end && static_cast<int64_t>(heap.size()) < k; ++i) {
+        heap.emplace_back(self[i * self_stride], i);
+        std::push_heap(heap.begin(), heap.end(), elem_before);
+      }
+      for (; i < chunk_end; ++i) {
+        // an element equal to the front loses, having a larger index
+        const scalar_t value = self[i * self_stride];
+        if (before(value, heap.front().first)) {
+          std::pop_heap(heap.begin(), heap.end(), elem_before);
+          heap.back() = elem_t(value, i);
+          std::push_heap(heap.begin(), heap.end(), elem_before);
+        }
+      }
+    }
+  });
+
+  std::vector<elem_t> candidates;
+  candidates.reserve(num_chunks * k);
+  for (const auto& heap : heaps) {
+    candidates.insert(candidates.end(), heap.begin(), heap.end());
+  }
+  if (sorted) {
+    std::partial_sort(candidates.begin(), candidates.begin() + k, candidates.end(), elem_before);
+  } else {
+    std::nth_element(candidates.begin(), candidates.begin() + k - 1, candidates.end(), elem_before);
+  }
+
+  for (int64_t j = 0; j < k; j++) {
+    values[j * values_stride] = candidates[j].first;
+    indices[j * indices_stride] = candidates[j].second;
+  }
+}
+
 static void topk_kernel(
     Tensor& values,
     Tensor& indices,
@@ -17,74 +250,59 @@ static void topk_kernel(
     int64_t dim,
     bool largest,
     bool sorted) {
+  if (self.numel() == 0 || k == 0) {
+    return;
+  }
+
+  auto iter = TensorIteratorConfig()
+    .check_all_same_dtype(false)
+    .resize_outputs(false)
+    .declare_static_shape(self.sizes(), /*squash_dim=*/dim)
+    .add_output(values)
+    .add_output(indices)
+    .add_input(self)
+    .build();
+
+  const int64_t dim_size = self.size(dim);
+  const auto values_dim_stride = values.stride(dim);
+  const auto indices_dim_stride = indices.stride(dim);
+  const auto self_dim_stride = self.stride(dim);
+
   AT_DISPATCH_ALL_TYPES(self.scalar_type(), "topk_cpu", [&] {
-    dim_apply(
-        {self, values, indices},
-        dim,
-        [&](int64_t i, TensorList tl) {
-          auto tmp_values = tl[0].accessor<scalar_t, 1>();
-          auto mode_values = tl[1].accessor<scalar_t, 1>();
-          auto mode_indices = tl[2].accessor<int64_t, 1>();
-
-          auto n = tmp_values.size(0);
-          auto use_partial_sort = k * 64 <= n;
-
-          using elem_t = std::pair<scalar_t, int64_t>;
-          std::vector<elem_t> queue(n);
-          for (int64_t j = 0; j < n; j++) {
-            queue[j].first = tmp_values[j];
-            queue[j].second = j;
-          }
-
-          // we want NaN to be sorted as top for numpy compatibility
-          if (use_partial_sort) {
-            if (largest) {
-              std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                });
-            } else {
-              std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                });
-            }
-          } else {
-            if (largest) {
-              std::nth_element(queue.begin(), queue.begin() + k - 1, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                });
-              if (sorted) {
-                std::sort(queue.begin(), queue.begin() + k - 1,
-                  [](const elem_t& x, const elem_t& y) -> bool {
-                    return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                  });
-              }
-            } else {
-              std::nth_element(queue.begin(), queue.begin() + k -1, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                });
-              if (sorted) {
-                std::sort(queue.begin(), queue.begin() + k -1,
-                  [](const elem_t& x, const elem_t& y) -> bool {
-                    return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                  });
-              }
-            }
-          }
-
-          for (int64_t j = 0; j < k; j++) {
-            mode_values[j] = queue[j].first;
-            mode_indices[j] = queue[j].second;
-          }
-        });
+    // A few long slices leave most threads idle when parallelizing over
+    // slices, so select them one after another, each with all threads.
+    const int64_t num_slices = iter.numel();
+    const bool parallel_slice = num_slices < at::get_num_threads() &&
+        dim_size >= kParallelTopkMinSize && k * 64 <= dim_size;
+
+    auto loop = [&](char** data, const int64_t* strides, int64_t n) {
+      for (int64_t i = 0; i < n; ++i) {
+        auto topk_fn = parallel_slice ? topk_parallel_slice<scalar_t> : topk_slice<scalar_t>;
+        topk_fn(
+            reinterpret_cast<scalar_t*>(data[0] + i * strides[0]),
+            values_dim_stride,
+            reinterpret_cast<int64_t*>(data[1] + i * strides[1]),
+            indices_dim_stride,
+            reinterpret_cast<const scalar_t*>(data[2] + i * strides[2]),
+            self_dim_stride,
+            dim_size,
+            k,
+            largest,
+            sorted);
+      }
+    };
+
+    if (parallel_slice) {
+      iter.serial_for_each(loop, {0, num_slices});
+    } else {
+      iter.for_each(loop, /*grain_size=*/std::max<int64_t>(1, at::internal::GRAIN_SIZE / dim_size));
+    }
   });
 }
 
 } // anonymous namespace
 
+REGISTER_DISPATCH(sort_stub, &sort_kernel);
 REGISTER_DISPATCH(topk_stub, &topk_kernel);
 
 }} //at::native
@@ -0,0 +1,170 @@
+#include <ATen/ATen.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/sparse/SparseCsrTensorMath.h>
+
+namespace at { namespace native {
+
+namespace {
+
+// Maximum number of row chunks per thread, so that a thread finishing early
+// can still pick up work.
+constexpr int64_t kChunksPerThread = 4;
+
+// Runs f(row_begin, row_end) in parallel over chunks of rows of equal cost,
+// where a row costs row_cost plus nnz_cost per specified element. Splitting
+// by row count alone leaves most threads idle whenever the row lengths are
+// skewed (power-law graphs, bag-of-words features), since the thread that
+// drew the long rows does nearly all the work.
+template <typename F>
+void parallel_for_csr_rows(
+    const int64_t* crow,
+    int64_t rows,
+    int64_t row_cost,
+    int64_t nnz_cost,
+    const F& f) {
+  const int64_t total = rows * row_cost + crow[rows] * nnz_cost;
+  const int64_t num_chunks = std::max<int64_t>(
+      1,
+      std::min<int64_t>(
+          divup(total, at::internal::GRAIN_SIZE),
+          at::get_num_threads() * kChunksPerThread));
+
+  // First row of a chunk: the first row whose cumulative cost reaches the
+  // chunk's share of the total. crow is non-decreasing, so this is a binary
+  // search.
+  auto chunk_begin = [&](int64_t chunk) {
+    if (chunk >= num_chunks) {
+      return rows;
+    }
+    const int64_t target = total / num_chunks * chunk;
+    int64_t lo = 0;
+    int64_t hi = rows;
+    while (lo < hi) {
+      const int64_t mid = lo + (hi - lo) / 2;
+      if (mid * row_cost + crow[mid] * nnz_cost < target) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  };
+
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    const int64_t row_begin = chunk_begin(begin);
+    const int64_t row_end = chunk_begin(end);
+    if (row_begin < row_end) {
+      f(row_begin, row_end);
+    }
+  });
+}
+
+template <typename scalar_t>
+void addmm_sparse_csr_dense_kernel_impl(
+    Tensor& result,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& dense,
+    scalar_t alpha) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const int64_t rows = result.size(0);
+  const int64_t n = result.size(1);
+  const int64_t* crow = crow_indices.data_ptr<int64_t>();
+  const int64_t* col = col_indices.data_ptr<int64_t>();
+  const scalar_t* val = values.data_ptr<scalar_t>();
+  const scalar_t* dense_data = dense.data_ptr<scalar_t>();
+  scalar_t* result_data = result.data_ptr<scalar_t>();
+
+  parallel_for_csr_rows(crow, rows, 1, n, [&](int64_t row_begin, int64_t row_end) {
+    for (int64_t i = row_begin; i < row_end; i++) {
+      // The output row stays in cache while the rows of dense selected by
+      // the specified elements of row i are accumulated into it.
+      scalar_t* out = result_data + i * n;
+      for (int64_t k = crow[i]; k < crow[i + 1]; k++) {
+        const scalar_t a = alpha * val[k];
+        const Vec a_vec(a);
+        const scalar_t* in = dense_data + col[k] * n;
+        int64_t j = 0;
+        for (; j < n - (n % Vec::size()); j += Vec::size()) {
+          Vec out_vec = vec256::fmadd(a_vec, Vec::loadu(in + j), Vec::loadu(out + j));
+          out_vec.store(out + j);
+        }
+        for (; j < n; j++) {
+          out[j] += a * in[j];
+        }
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void addmv_sparse_csr_kernel_impl(
+    Tensor& result,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& vec,
+    scalar_t alpha) {
+  const int64_t rows = result.size(0);
+  const int64_t* crow = crow_indices.data_ptr<int64_t>();
+  const int64_t* col = col_indices.data_ptr<int64_t>();
+  const scalar_t* val = values.data_ptr<scalar_t>();
+  const scalar_t* vec_data = vec.data_ptr<scalar_t>();
+  scalar_t* result_data = result.data_ptr<scalar_t>();
+
+  parallel_for_csr_rows(crow, rows, 1, 1, [&](int64_t row_begin, int64_t row_end) {
+    for (int64_t i = row_begin; i < row_end; i++) {
+      // Two independent accumulators hide the latency of the gathers from
+      // vec.
+      scalar_t acc0 = 0;
+      scalar_t acc1 = 0;
+      int64_t k = crow[i];
+      const int64_t k_end = crow[i + 1];
+      for (; k + 1 < k_end; k += 2) {
+        acc0 += val[k] * vec_data[col[k]];
+        acc1 += val[k + 1] * vec_data[col[k + 1]];
+      }
+      if (k < k_end) {
+        acc0 += val[k] * vec_data[col[k]];
+      }
+      result_data[i] += alpha * (acc0 + acc1);
+    }
+  });
+}
+
+void addmm_sparse_csr_dense_kernel(
+    Tensor& result,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& dense,
+    Scalar alpha) {
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX(values.scalar_type(), "addmm_sparse_csr_dense", [&] {
+    addmm_sparse_csr_dense_kernel_impl<scalar_t>(
+        result, crow_indices, col_indices, values, dense, alpha.to<scalar_t>());
+  });
+}
+
+void addmv_sparse_csr_kernel(
+    Tensor& result,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& vec,
+    Scalar alpha) {
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX(values.scalar_type(), "addmv_sparse_csr", [&] {
+    addmv_sparse_csr_kernel_impl<scalar_t>(
+        result, crow_indices, col_indices, values, vec, alpha.to<scalar_t>());
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(sparse_csr_addmm_stub, &addmm_sparse_csr_dense_kernel);
+REGISTER_DISPATCH(sparse_csr_addmv_stub, &addmv_sparse_csr_kernel);
+
+}} // namespace at::native
@@ -0,0 +1,284 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/Unique.h>
+#include <ATen/native/cpu/RadixSort.h>
+
+#include <c10/util/flat_hash_map.h>
+
+#include <numeric>
+
+namespace at { namespace native {
+
+namespace {
+
+// Number of evenly spaced input elements used to estimate how many distinct
+// values the input holds.
+constexpr int64_t kUniqueSampleSize = 4096;
+// The hash engine is used when at most this fraction of the sample is
+// distinct: its tables then stay small and cache resident, while the radix
+// engine always has to sort every element.
+constexpr int64_t kUniqueHashMaxDistinctDivisor = 4;
+
+template <typename scalar_t>
+bool unique_prefers_hash(const scalar_t* input, int64_t numel) {
+  if (numel <= kUniqueSampleSize) {
+    return true;
+  }
+  const int64_t stride = numel / kUniqueSampleSize;
+  ska::flat_hash_set<scalar_t> sample;
+  sample.reserve(kUniqueSampleSize);
+  for (int64_t i = 0; i < kUniqueSampleSize; ++i) {
+    sample.insert(input[i * stride]);
+  }
+  return static_cast<int64_t>(sample.size()) * kUniqueHashMaxDistinctDivisor <= kUniqueSampleSize;
+}
+
+// Radix engine: sorts (key, position) pairs of the whole input with all
+// threads, then finds the segment starts of equal keys chunk by chunk (count,
+// scan, fill) and writes the unique values, inverse indices and counts in the
+// same pass. The output is always sorted.
+template <typename scalar_t>
+void unique_radix_cpu(
+    Tensor& output,
+    Tensor& inverse_indices,
+    Tensor& counts,
+    const scalar_t* input,
+    int64_t numel,
+    bool return_inverse,
+    bool return_counts) {
+  using key_t = typename RadixKey<scalar_t>::type;
+  std::vector<key_t> keys_buf(2 * numel);
+  std::vector<int64_t> idx_buf(2 * numel);
+  key_t* keys = keys_buf.data();
+  key_t* keys_tmp = keys + numel;
+  int64_t* idx = idx_buf.data();
+  int64_t* idx_tmp = idx + numel;
+
+  at::parallel_for(0, numel, kParallelSortMinChunk, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      keys[i] = RadixKey<scalar_t>::encode(input[i]);
+      idx[i] = i;
+    }
+  });
+  parallel_radix_sort_pairs(keys, idx, keys_tmp, idx_tmp, numel);
+
+  // NaN != NaN, so every NaN is a unique element of its own.
+  const auto starts_segment = [keys](int64_t i) {
+    return i == 0 || keys[i] != keys[i - 1] ||
+        (std::is_floating_point<scalar_t>::value && keys[i] == std::numeric_limits<key_t>::max());
+  };
+
+  const int64_t num_chunks = std::max<int64_t>(
+      1, std::min<int64_t>(at::get_num_threads(), numel / kParallelSortMinChunk));
+  const auto chunk_begin = [&](int64_t c) { return numel * c / num_chunks; };
+
+  std::vector<int64_t> chunk_offsets(num_chunks + 1, 0);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; ++c) {
+      int64_t num_starts = 0;
+      for (int64_t i = chunk_begin(c); i < chunk_begin(c + 1); ++i) {
+        num_starts += starts_segment(i);
+      }
+      chunk_offsets[c + 1] = num_starts;
+    }
+  });
+  std::partial_sum(chunk_offsets.begin(), chunk_offsets.end(), chunk_offsets.begin());
+  const int64_t num_unique = chunk_offsets[num_chunks];
+
+  output.resize_({num_unique});
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  int64_t* inverse_data = return_inverse ? inverse_indices.data_ptr<int64_t>() : nullptr;
+  std::vector<int64_t> segment_starts(num_unique + 1);
+  segment_starts[num_unique] = numel;
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; ++c) {
+      // a chunk may start in the middle of the previous chunk's last segment
+      int64_t u = chunk_offsets[c] - 1;
+      for (int64_t i = chunk_begin(c); i < chunk_begin(c + 1); ++i) {
+        if (starts_segment(i)) {
+          ++u;
+          segment_starts[u] = i;
+          output_data[u] = input[idx[i]];
+        }
+        if (inverse_data) {
+          inverse_data[idx[i]] = u;
+        }
+      }
+    }
+  });
+
+  if (return_counts) {
+    counts.resize_({num_unique});
+    int64_t* counts_data = counts.data_ptr<int64_t>();
+    at::parallel_for(0, num_unique, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      for (int64_t u = begin; u < end; ++u) {
+        counts_data[u] = segment_starts[u + 1] - segment_starts[u];
+      }
+    });
+  }
+}
+
+// Hash engine: every chunk dedups its part of the input into a thread-local
+// open addressing table, writing local ids as inverse indices. The chunk
+// tables are merged in chunk order, so ids follow the first occurrence of each
+// value in the input, and the inverse indices are then remapped in parallel.
+// If a sorted output is requested, only the (few) unique values are sorted.
+template <typename scalar_t>
+void unique_hash_cpu(
+    Tensor& output,
+    Tensor& inverse_indices,
+    Tensor& counts,
+    const scalar_t* input,
+    int64_t numel,
+    bool sorted,
+    bool return_inverse,
+    bool return_counts) {
+  struct ChunkTable {
+    std::vector<scalar_t> values;
+    std::vector<int64_t> counts;
+    std::vector<int64_t> global_ids;
+  };
+
+  const int64_t num_chunks = std::max<int64_t>(
+      1, std::min<int64_t>(at::get_num_threads(), numel / at::internal::GRAIN_SIZE));
+  const auto chunk_begin = [&](int64_t c) { return numel * c / num_chunks; };
+  std::vector<ChunkTable> tables(num_chunks);
+  int64_t* inverse_data = return_inverse ? inverse_indices.data_ptr<int64_t>() : nullptr;
+
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; ++c) {
+      auto& table = tables[c];
+      ska::flat_hash_map<scalar_t, int64_t> ids;
+      for (int64_t i = chunk_begin(c); i < chunk_begin(c + 1); ++i) {
+        const auto it = ids.emplace(input[i], static_cast<int64_t>(table.values.size()));
+        if (it.second) {
+          table.values.push_back(input[i]);
+          table.counts.push_back(0);
+        }
+        const int64_t id = it.first->second;
+        table.counts[id]++;
+        if (inverse_data) {
+          inverse_data[i] = id;
+        }
+      }
+    }
+  });
+
+  std::vector<scalar_t> unique_values;
+  std::vector<int64_t> unique_counts;
+  bool remap_inverse = num_chunks > 1;
+  if (num_chunks == 1) {
+    unique_values = std::move(tables[0].values);
+    unique_counts = std::move(tables[0].counts);
+    tables[0].global_ids.resize(unique_values.size());
+    std::iota(tables[0].global_ids.begin(), tables[0].global_ids.end(), 0);
+  } else {
+    ska::flat_hash_map<scalar_t, int64_t> ids;
+    for (auto& table : tables) {
+      table.global_ids.resize(table.values.size());
+      for (size_t j = 0; j < table.values.size(); ++j) {
+        const auto it = ids.emplace(table.values[j], static_cast<int64_t>(unique_values.size()));
+        if (it.second) {
+          unique_values.push_back(table.values[j]);
+          unique_counts.push_back(0);
+        }
+        table.global_ids[j] = it.first->second;
+        unique_counts[it.first->second] += table.counts[j];
+      }
+    }
+  }
+
+  const int64_t num_unique = unique_values.size();
+  output.resize_({num_unique});
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  int64_t* counts_data = nullptr;
+  if (return_counts) {
+    counts.resize_({num_unique});
+    counts_data = counts.data_ptr<int64_t>();
+  }
+
+  if (sorted) {
+    using key_t = typename RadixKey<scalar_t>::type;
+    std::vector<key_t> keys_buf(2 * num_unique);
+    std::vector<int64_t> idx_buf(2 * num_unique);
+    key_t* keys = keys_buf.data();
+    key_t* keys_tmp = keys + num_unique;
+    int64_t* idx = idx_buf.data();
+    int64_t* idx_tmp = idx + num_unique;
+    for (int64_t u = 0; u < num_unique; ++u) {
+      keys[u] = RadixKey<scalar_t>::encode(unique_values[u]);
+      idx[u] = u;
+    }
+    radix_sort_pairs(keys, idx, keys_tmp, idx_tmp, num_unique);
+
+    // idx_tmp is free after the sort; reuse it as the id -> rank map
+    int64_t* rank = idx_tmp;
+    for (int64_t r = 0; r < num_unique; ++r) {
+      output_data[r] = unique_values[idx[r]];
+      if (counts_data) {
+        counts_data[r] = unique_counts[idx[r]];
+      }
+      rank[idx[r]] = r;
+    }
+    for (auto& table : tables) {
+      for (auto& id : table.global_ids) {
+        id = rank[id];
+      }
+    }
+    remap_inverse = true;
+  } else {
+    std::copy(unique_values.begin(), unique_values.end(), output_data);
+    if (counts_data) {
+      std::copy(unique_counts.begin(), unique_counts.end(), counts_data);
+    }
+  }
+
+  if (inverse_data && remap_inverse) {
+    at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; ++c) {
+        const int64_t* global_ids = tables[c].global_ids.data();
+        for (int64_t i = chunk_begin(c); i < chunk_begin(c + 1); ++i) {
+          inverse_data[i] = global_ids[inverse_data[i]];
+        }
+      }
+    });
+  }
+}
+
+static void unique_kernel(
+    Tensor& output,
+    Tensor& inverse_indices,
+    Tensor& counts,
+    const Tensor& self,
+    bool sorted,
+    bool return_inverse,
+    bool return_counts) {
+  const Tensor input = self.contiguous();
+  const int64_t numel = input.numel();
+  if (return_inverse) {
+    inverse_indices.resize_(input.sizes());
+  }
+  if (numel == 0) {
+    return;
+  }
+
+  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool, input.scalar_type(), "unique_cpu", [&] {
+    const scalar_t* input_data = input.data_ptr<scalar_t>();
+    if (unique_prefers_hash(input_data, numel)) {
+      unique_hash_cpu(
+          output, inverse_indices, counts, input_data, numel,
+          sorted, return_inverse, return_counts);
+    } else {
+      unique_radix_cpu(
+          output, inverse_indices, counts, input_data, numel,
+          return_inverse, return_counts);
+    }
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(unique_stub, &unique_kernel);
+
+}} // namespace at::native
@@ -0,0 +1,301 @@
+// Basic functions on sparse CSR tensors
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/InitialTensorOptions.h>
+#include <ATen/Layout.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/SparseCsrTensorUtils.h>
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+
+namespace at { namespace native {
+
+using namespace at::sparse_csr;
+
+namespace {
+
+// Strips the autograd metadata, so that the member tensors of a CSR tensor,
+// like those of a COO tensor, never carry any.
+Tensor shallow_copy_member(const Tensor& t) {
+  return Tensor(t.unsafeGetTensorImpl()->shallow_copy_and_detach(
+      /*version_counter=*/t.unsafeGetTensorImpl()->version_counter(),
+      /*allow_tensor_metadata_change=*/true));
+}
+
+// Builds a CSR tensor from members that are known to satisfy the invariants
+// of SparseCsrTensorImpl.
+SparseCsrTensor new_sparse_csr_tensor_unsafe(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    IntArrayRef size) {
+  SparseCsrTensor self = at::detail::make_tensor<SparseCsrTensorImpl>(
+      DispatchKeySet(DispatchKey::SparseCsrCPU), values.dtype());
+  get_sparse_csr_impl(self)->set_member_tensors(
+      shallow_copy_member(crow_indices),
+      shallow_copy_member(col_indices),
+      shallow_copy_member(values),
+      size);
+  return self;
+}
+
+void validate_sparse_csr_tensor_args(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    IntArrayRef size) {
+  TORCH_CHECK(size.size() == 2,
+      "sparse_csr_tensor: expected a 2-D size, but got ", size);
+  TORCH_CHECK(size[0] >= 0 && size[1] >= 0,
+      "sparse_csr_tensor: expected a non-negative size, but got ", size);
+  TORCH_CHECK(crow_indices.layout() == kStrided && col_indices.layout() == kStrided && values.layout() == kStrided,
+      "sparse_csr_tensor: expected crow_indices, col_indices and values to be strided tensors");
+  TORCH_CHECK(crow_indices.scalar_type() == kLong && col_indices.scalar_type() == kLong,
+      "sparse_csr_tensor: crow_indices and col_indices must be int64 tensors");
+  TORCH_CHECK(crow_indices.dim() == 1 && col_indices.dim() == 1 && values.dim() == 1,
+      "sparse_csr_tensor: crow_indices, col_indices and values must be 1-D, but got ",
+      crow_indices.dim(), "-D, ", col_indices.dim(), "-D and ", values.dim(), "-D tensors");
+  TORCH_CHECK(crow_indices.device() == values.device() && col_indices.device() == values.device(),
+      "sparse_csr_tensor: crow_indices, col_indices and values must be on the same device");
+  TORCH_CHECK(values.device().type() == kCPU,
+      "sparse_csr_tensor: sparse CSR tensors are only supported on CPU, but got values on ", values.device());
+  TORCH_CHECK(crow_indices.numel() == size[0] + 1,
+      "sparse_csr_tensor: crow_indices must have size(0) + 1 = ", size[0] + 1,
+      " elements, but got ", crow_indices.numel());
+  TORCH_CHECK(col_indices.numel() == values.numel(),
+      "sparse_csr_tensor: col_indices and values must have the same number of elements, but got ",
+      col_indices.numel(), " and ", values.numel());
+
+  const int64_t nnz = values.numel();
+  auto crow = crow_indices.accessor<int64_t, 1>();
+  TORCH_CHECK(crow[0] == 0,
+      "sparse_csr_tensor: crow_indices[0] must be 0, but got ", crow[0]);
+  TORCH_CHECK(crow[size[0]] == nnz,
+      "sparse_csr_tensor: crow_indices[-1] must be nnz = ", nnz, ", but got ", crow[size[0]]);
+  if (size[0] > 0) {
+    TORCH_CHECK(
+        (crow_indices.narrow(0, 1, size[0]) >= crow_indices.narrow(0, 0, size[0])).all().item<bool>(),
+        "sparse_csr_tensor: crow_indices must be non-decreasing");
+  }
+  if (nnz > 0) {
+    TORCH_CHECK(col_indices.min().item<int64_t>() >= 0 && col_indices.max().item<int64_t>() < size[1],
+        "sparse_csr_tensor: col_indices must be in the range [0, ", size[1], ")");
+  }
+}
+
+} // anonymous namespace
+
+/******************************************************************************
+ * access methods
+ ******************************************************************************/
+
+Tensor crow_indices_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->crow_indices().alias();
+}
+
+Tensor col_indices_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->col_indices().alias();
+}
+
+Tensor values_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->values().alias();
+}
+
+int64_t _nnz_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->nnz();
+}
+
+/******************************************************************************
+ * creation methods
+ ******************************************************************************/
+
+SparseCsrTensor sparse_csr_tensor(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    IntArrayRef size,
+    const TensorOptions& options) {
+  TORCH_CHECK(!options.has_layout() || options.layout() == kSparseCsr,
+      "sparse_csr_tensor: expected sparse CSR layout, but got layout ", options.layout());
+  TORCH_CHECK(!options.pinned_memory(), "Only dense CPU tensors can be pinned");
+  const Tensor values_ = values.to(
+      options.has_dtype() ? typeMetaToScalarType(options.dtype()) : values.scalar_type());
+  validate_sparse_csr_tensor_args(crow_indices, col_indices, values_, size);
+  return new_sparse_csr_tensor_unsafe(crow_indices, col_indices, values_, size);
+}
+
+SparseCsrTensor sparse_csr_tensor(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const TensorOptions& options) {
+  // If the size is not given, the number of rows is given by crow_indices
+  // and the number of columns is inferred as the max column index + 1.
+  TORCH_CHECK(crow_indices.dim() == 1 && crow_indices.numel() >= 1,
+      "sparse_csr_tensor: crow_indices must be a non-empty 1-D tensor");
+  const int64_t rows = crow_indices.numel() - 1;
+  const int64_t cols = col_indices.numel() > 0 ? col_indices.max().item<int64_t>() + 1 : 0;
+  return at::native::sparse_csr_tensor(crow_indices, col_indices, values, {rows, cols}, options);
+}
+
+/******************************************************************************
+ * conversions
+ ******************************************************************************/
+
+SparseCsrTensor dense_to_sparse_csr(const Tensor& self) {
+  TORCH_CHECK(self.dim() == 2,
+      "to_sparse_csr: expected a 2-D tensor, but got a ", self.dim(), "-D tensor");
+  const int64_t rows = self.size(0);
+  const int64_t cols = self.size(1);
+  const Tensor input = self.contiguous();
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(cols, 1));
+
+  Tensor crow_indices = at::empty({rows + 1}, self.options().dtype(kLong));
+  Tensor col_indices;
+  Tensor values;
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(kHalf, kBool, kBFloat16, self.scalar_type(), "dense_to_sparse_csr", [&] {
+    const scalar_t* data = input.data_ptr<scalar_t>();
+    int64_t* crow = crow_indices.data_ptr<int64_t>();
+
+    // Count the specified elements of each row, then scan the counts into
+    // row offsets.
+    crow[0] = 0;
+    at::parallel_for(0, rows, grain_size, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        const scalar_t* row = data + i * cols;
+        int64_t count = 0;
+        for (int64_t j = 0; j < cols; j++) {
+          count += (row[j] != scalar_t(0));
+        }
+        crow[i + 1] = count;
+      }
+    });
+    std::partial_sum(crow, crow + rows + 1, crow);
+
+    const int64_t nnz = crow[rows];
+    col_indices = at::empty({nnz}, crow_indices.options());
+    values = at::empty({nnz}, input.options());
+    int64_t* col = col_indices.data_ptr<int64_t>();
+    scalar_t* val = values.data_ptr<scalar_t>();
+    at::parallel_for(0, rows, grain_size, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        const scalar_t* row = data + i * cols;
+        int64_t k = crow[i];
+        for (int64_t j = 0; j < cols; j++) {
+          if (row[j] != scalar_t(0)) {
+            col[k] = j;
+            val[k] = row[j];
+            k++;
+          }
+        }
+      }
+    });
+  });
+  return new_sparse_csr_tensor_unsafe(crow_indices, col_indices, values, self.sizes());
+}
+
+SparseCsrTensor coo_to_sparse_csr(const Tensor& self) {
+  TORCH_CHECK(self.sparse_dim() == 2 && self.dense_dim() == 0,
+      "to_sparse_csr: expected a sparse tensor with 2 sparse and 0 dense dimensions, but got ",
+      self.sparse_dim(), " sparse and ", self.dense_dim(), " dense dimensions");
+  // Coalescing sorts the indices row-major, which is the order of the CSR
+  // members. This is the only coalesce: the CSR kernels never need one.
+  const bool was_coalesced = self.is_coalesced();
+  const Tensor coalesced = self.coalesce();
+  const Tensor indices = coalesced._indices();
+  const int64_t rows = self.size(0);
+  const int64_t nnz = coalesced._nnz();
+
+  const Tensor row_indices = indices.select(0, 0).contiguous();
+  const int64_t* row = row_indices.data_ptr<int64_t>();
+  Tensor crow_indices = at::empty({rows + 1}, indices.options());
+  int64_t* crow = crow_indices.data_ptr<int64_t>();
+  // The offset of row i is the number of elements in the rows before it.
+  at::parallel_for(0, rows + 1, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      crow[i] = std::lower_bound(row, row + nnz, i) - row;
+    }
+  });
+
+  Tensor col_indices = indices.select(0, 1).clone(at::MemoryFormat::Contiguous);
+  Tensor values = was_coalesced ? coalesced._values().clone() : coalesced._values();
+  return new_sparse_csr_tensor_unsafe(crow_indices, col_indices, values, self.sizes());
+}
+
+Tensor sparse_csr_to_dense(const SparseCsrTensor& self) {
+  const auto impl = get_sparse_csr_impl(self);
+  const int64_t rows = self.size(0);
+  const int64_t cols = self.size(1);
+  const Tensor crow_indices = impl->crow_indices().contiguous();
+  const Tensor col_indices = impl->col_indices().contiguous();
+  const Tensor values = impl->values().contiguous();
+
+  Tensor result = at::zeros({rows, cols}, values.options());
+  if (impl->nnz() == 0) {
+    return result;
+  }
+  const int64_t* crow = crow_indices.data_ptr<int64_t>();
+  const int64_t* col = col_indices.data_ptr<int64_t>();
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(cols, 1));
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(kHalf, kBool, kBFloat16, values.scalar_type(), "sparse_csr_to_dense", [&] {
+    const scalar_t* val = values.data_ptr<scalar_t>();
+    scalar_t* data = result.data_ptr<scalar_t>();
+    at::parallel_for(0, rows, grain_size, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        scalar_t* out = data + i * cols;
+        for (int64_t k = crow[i]; k < crow[i + 1]; k++) {
+          out[col[k]] = val[k];
+        }
+      }
+    });
+  });
+  return result;
+}
+
+Tensor sparse_csr_to_sparse(const SparseCsrTensor& self) {
+  const auto impl = get_sparse_csr_impl(self);
+  const int64_t rows = self.size(0);
+  const int64_t nnz = impl->nnz();
+  const Tensor crow_indices = impl->crow_indices().contiguous();
+  const int64_t* crow = crow_indices.data_ptr<int64_t>();
+
+  Tensor indices = at::empty({2, nnz}, crow_indices.options());
+  indices.select(0, 1).copy_(impl->col_indices());
+  int64_t* row = indices.data_ptr<int64_t>();
+  const int64_t* col = row + nnz;
+  // The result is coalesced when the column indices of every row are
+  // strictly increasing, which holds for all the CSR tensors built by the
+  // conversions but is not required from user-provided ones.
+  std::atomic<bool> coalesced{true};
+  at::parallel_for(0, rows, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    bool sorted = true;
+    for (int64_t i = begin; i < end; i++) {
+      std::fill(row + crow[i], row + crow[i + 1], i);
+      for (int64_t k = crow[i] + 1; k < crow[i + 1]; k++) {
+        sorted = sorted && col[k - 1] < col[k];
+      }
+    }
+    if (!sorted) {
+      coalesced = false;
+    }
+  });
+
+  Tensor result = at::_sparse_coo_tensor_unsafe(
+      indices, impl->values().clone(), self.sizes(), impl->values().options().layout(kSparse));
+  result._coalesced_(coalesced.load());
+  return result;
+}
+
+Tensor sparse_csr_to_sparse(const SparseCsrTensor& self, int64_t sparse_dim) {
+  TORCH_CHECK(sparse_dim == 2,
+      "to_sparse: a sparse CSR tensor can only be converted to a sparse tensor with 2 sparse dimensions, but got sparse_dim = ",
+      sparse_dim);
+  return sparse_csr_to_sparse(self);
+}
+
+}} // namespace at::native
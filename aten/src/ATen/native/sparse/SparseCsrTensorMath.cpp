@@ -0,0 +1,141 @@
+#include <ATen/native/sparse/SparseCsrTensorMath.h>
+
+#include <ATen/ATen.h>
+#include <ATen/ExpandUtils.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/SparseCsrTensorUtils.h>
+
+namespace at { namespace native {
+
+using namespace at::sparse_csr;
+
+DEFINE_DISPATCH(sparse_csr_addmm_stub);
+DEFINE_DISPATCH(sparse_csr_addmv_stub);
+
+namespace {
+
+// Sets r to beta * t. With beta == 0, t is ignored, so that nan and inf in t
+// do not propagate (as in the dense addmm).
+void scale_into(Tensor& r, const Tensor& t, Scalar beta) {
+  if (beta.toComplexDouble() == 0.) {
+    r.zero_();
+  } else {
+    if (!r.is_same(t)) {
+      r.copy_(t);
+    }
+    if (beta.toComplexDouble() != 1.) {
+      r.mul_(beta);
+    }
+  }
+}
+
+} // anonymous namespace
+
+// --------------------------------------------------------------------
+// addmm(Tensor, SparseCsrTensor, Tensor, Scalar, Scalar)  [broadcasts]
+// --------------------------------------------------------------------
+
+Tensor& addmm_out_sparse_csr_dense_cpu(
+    Tensor& result,
+    const Tensor& self,
+    const SparseCsrTensor& sparse,
+    const Tensor& dense,
+    Scalar beta,
+    Scalar alpha) {
+  TORCH_CHECK(sparse.layout() == kSparseCsr,
+      "addmm: Argument #2 (mat1): expected a sparse CSR tensor, but got layout ", sparse.layout());
+  TORCH_CHECK(dense.layout() == kStrided,
+      "addmm: Argument #3 (mat2): expected a strided tensor, but got layout ", dense.layout());
+  TORCH_CHECK(self.layout() == kStrided && result.layout() == kStrided,
+      "addmm: expected 'self' and 'out' to be strided tensors");
+  TORCH_CHECK(dense.dim() == 2,
+      "addmm: matrices expected, got ", dense.dim(), "D tensor");
+  TORCH_CHECK(sparse.scalar_type() == dense.scalar_type() && result.scalar_type() == dense.scalar_type(),
+      "addmm: expected mat1, mat2 and out to have the same dtype, but got ",
+      sparse.scalar_type(), ", ", dense.scalar_type(), " and ", result.scalar_type());
+
+  // ixj * jxk = ixk
+  const int64_t dim_i = sparse.size(0);
+  const int64_t dim_j = sparse.size(1);
+  const int64_t dim_k = dense.size(1);
+  TORCH_CHECK(dense.size(0) == dim_j,
+      "addmm: Argument #3 (dense): Expected dim 0 size ", dim_j, ", got ", dense.size(0));
+
+  Tensor b_self;
+  std::tie(b_self) = expand_size(self, {dim_i, dim_k}, "addmm_out");
+  result.resize_({dim_i, dim_k});
+
+  // The kernel accumulates into a contiguous buffer; result is used
+  // directly when it is one.
+  Tensor r = result.is_contiguous() ? result : at::empty({dim_i, dim_k}, result.options());
+  scale_into(r, b_self, beta);
+
+  const auto impl = get_sparse_csr_impl(sparse);
+  if (impl->nnz() > 0 && dim_k > 0) {
+    sparse_csr_addmm_stub(
+        kCPU, r, impl->crow_indices().contiguous(), impl->col_indices().contiguous(),
+        impl->values().contiguous(), dense.contiguous(), alpha);
+  }
+  if (!r.is_same(result)) {
+    result.copy_(r);
+  }
+  return result;
+}
+
+Tensor addmm_sparse_csr_dense_cpu(
+    const Tensor& self,
+    const SparseCsrTensor& sparse,
+    const Tensor& dense,
+    Scalar beta,
+    Scalar alpha) {
+  Tensor r = at::empty({0}, dense.options());
+  return addmm_out_sparse_csr_dense_cpu(r, self, sparse, dense, beta, alpha);
+}
+
+Tensor mm_sparse_csr(const SparseCsrTensor& self, const Tensor& mat2) {
+  Tensor t = at::zeros({}, mat2.options());
+  Tensor r = at::empty({0}, mat2.options());
+  return addmm_out_sparse_csr_dense_cpu(r, t, self, mat2, 0, 1);
+}
+
+Tensor& mm_out_sparse_csr(Tensor& result, const SparseCsrTensor& self, const Tensor& mat2) {
+  Tensor t = at::zeros({}, mat2.options());
+  return addmm_out_sparse_csr_dense_cpu(result, t, self, mat2, 0, 1);
+}
+
+// --------------------------------------------------------------------
+// addmv(Tensor, SparseCsrTensor, Tensor, Scalar, Scalar)
+// --------------------------------------------------------------------
+
+// Called by addmv_out once result holds a copy of self, see Blas.cpp.
+Tensor& addmv_impl_sparse_csr_cpu(
+    Tensor& result,
+    const Tensor& self,
+    const SparseCsrTensor& mat,
+    const Tensor& vec,
+    Scalar beta,
+    Scalar alpha) {
+  TORCH_CHECK(mat.layout() == kSparseCsr,
+      "addmv: Argument #2 (mat): expected a sparse CSR tensor, but got layout ", mat.layout());
+  TORCH_CHECK(vec.layout() == kStrided && result.layout() == kStrided,
+      "addmv: expected 'vec' and 'out' to be strided tensors");
+  TORCH_CHECK(mat.scalar_type() == vec.scalar_type() && result.scalar_type() == vec.scalar_type(),
+      "addmv: expected mat, vec and out to have the same dtype, but got ",
+      mat.scalar_type(), ", ", vec.scalar_type(), " and ", result.scalar_type());
+
+  Tensor r = result.is_contiguous() ? result : at::empty({result.size(0)}, result.options());
+  scale_into(r, result, beta);
+
+  const auto impl = get_sparse_csr_impl(mat);
+  if (impl->nnz() > 0) {
+    sparse_csr_addmv_stub(
+        kCPU, r, impl->crow_indices().contiguous(), impl->col_indices().contiguous(),
+        impl->values().contiguous(), vec.contiguous(), alpha);
+  }
+  if (!r.is_same(result)) {
+    result.copy_(r);
+  }
+  return result;
+}
+
+}} // namespace at::native
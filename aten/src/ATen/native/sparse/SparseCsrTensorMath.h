@@ -0,0 +1,17 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// result += alpha * csr @ dense, where csr is given by its crow_indices,
+// col_indices and values. result is a contiguous tensor already scaled by
+// beta; dense is 2-D (addmm) or 1-D (addmv) and contiguous.
+using sparse_csr_addmm_fn = void(*)(Tensor& result, const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values, const Tensor& dense, Scalar alpha);
+using sparse_csr_addmv_fn = void(*)(Tensor& result, const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values, const Tensor& vec, Scalar alpha);
+
+DECLARE_DISPATCH(sparse_csr_addmm_fn, sparse_csr_addmm_stub);
+DECLARE_DISPATCH(sparse_csr_addmv_fn, sparse_csr_addmv_stub);
+
+}} // namespace at::native
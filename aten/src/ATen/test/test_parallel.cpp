@@ -3,10 +3,12 @@
 #include <ATen/ATen.h>
 #include <ATen/DLConvertor.h>
 #include <ATen/Parallel.h>
+#include <c10/util/numa.h>
 
 #include <iostream>
 #include <string.h>
 #include <sstream>
+#include <vector>
 
 using namespace at;
 
@@ -69,3 +71,36 @@ TEST(TestParallel, IntraOpLaunchFuture) {
 
   ASSERT_TRUE(v1 == 1 && v2 == 2);
 }
+
+#if AT_PARALLEL_NATIVE
+TEST(TestParallel, IntraOpPoolIndex) {
+  // One pool per NUMA node: regions run on the pool of the current node.
+  ASSERT_EQ(at::internal::_intraop_pool_index(0, 2), 0u);
+  ASSERT_EQ(at::internal::_intraop_pool_index(1, 2), 1u);
+  // Unknown node, or a node without a pool, falls back to the first pool.
+  ASSERT_EQ(at::internal::_intraop_pool_index(-1, 2), 0u);
+  ASSERT_EQ(at::internal::_intraop_pool_index(2, 2), 0u);
+  // NUMA disabled or unavailable: a single pool for every node.
+  ASSERT_EQ(at::internal::_intraop_pool_index(-1, 1), 0u);
+  ASSERT_EQ(at::internal::_intraop_pool_index(1, 1), 0u);
+}
+#endif
+
+TEST(TestParallel, NUMAPoolFallback) {
+  if (c10::IsNUMAEnabled() && c10::GetNumNUMANodes() > 1) {
+    return;
+  }
+  // With a single intra-op pool every index is still visited exactly once,
+  // and thread ids stay below get_num_threads().
+  const int num_threads = at::get_num_threads();
+  std::vector<int> visited(1000, 0);
+  at::parallel_for(0, 1000, 1, [&](int64_t begin, int64_t end) {
+    ASSERT_LT(at::get_thread_num(), num_threads);
+    for (auto i = begin; i < end; ++i) {
+      visited[i]++;
+    }
+  });
+  for (int v : visited) {
+    ASSERT_EQ(v, 1);
+  }
+}
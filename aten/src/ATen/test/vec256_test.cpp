@@ -3,7 +3,9 @@
 #include <ATen/cpu/vec256/vec256.h>
 #include <ATen/ATen.h>
 
+#include <algorithm>
 #include <functional>
+#include <iostream>
 
 using namespace at::vec256;
 
@@ -350,12 +352,12 @@ TEST(Vec256TestFloat, CopyTest) {
 }
 
 TEST(Vec256TestFloat, arangeTest) {
-  at::Tensor arange_output_ref = at::zeros({8});
-  at::Tensor arange_output_vectorized = at::zeros({8});
+  at::Tensor arange_output_ref = at::zeros({Vec256<float>::size()});
+  at::Tensor arange_output_vectorized = at::zeros({Vec256<float>::size()});
   float base = 7.f;
   float step = 5.f;
   float* ref_output_ptr = arange_output_ref.data_ptr<float>();
-  for (int64_t i = 0; i < 8; ++i) {
+  for (int64_t i = 0; i < Vec256<float>::size(); ++i) {
     ref_output_ptr[i] = base + i * step;
   }
   float* vec_output_ptr = arange_output_vectorized.data_ptr<float>();
@@ -413,10 +415,14 @@ TEST(Vec256TestFloat, Blend) {
   int32_t full_int_mask = 0xFFFFFFFF;
   float* full_ptr = reinterpret_cast<float*>(&full_int_mask);
   float full_float_mask = *full_ptr;
-  Vec256<float> float_mask(full_float_mask, 0.f, full_float_mask, 0.f,
-                           0.f, full_float_mask, 0.f, 0.f);
+  // Lanes 0, 2 and 5 of every group of 8, whatever the vector width.
   float float_mask_array[Vec256<float>::size()];
-  float_mask.store(float_mask_array);
+  for (int64_t i = 0; i < Vec256<float>::size(); ++i) {
+    const int64_t lane = i % 8;
+    float_mask_array[i] =
+      (lane == 0 || lane == 2 || lane == 5) ? full_float_mask : 0.f;
+  }
+  auto float_mask = Vec256<float>::loadu(float_mask_array);
   ref_res_ptr = ref_res.data_ptr<float>();
   for (size_t i = 0; i < num_els; ++i) {
     if (float_mask_array[i % Vec256<float>::size()] != 0) {
@@ -664,8 +670,114 @@ TEST(Vec256TestFloat, check_fmadd) {
   ASSERT_TRUE(check_almost_equal(ref_res, vec_res, 1e-6));
 }
 
+// Checks loads, stores, blends and the element-wise arithmetic of Vec256<T>
+// against scalar code, for the types that have a vectorized implementation
+// besides float.
+template <typename T>
+void ArithmeticTestHelper() {
+  constexpr int64_t size = Vec256<T>::size();
+  T a[size], b[size], res[size];
+  // Small integers, so that all results are exact in every tested type.
+  for (int64_t i = 0; i < size; ++i) {
+    a[i] = static_cast<T>(static_cast<int>(i % 11) - 5);
+    b[i] = static_cast<T>(3 - static_cast<int>(i % 7));
+  }
+  auto check = [&](const Vec256<T>& vec, const std::function<T(T, T)>& op) {
+    vec.store(res);
+    for (int64_t i = 0; i < size; ++i) {
+      ASSERT_EQ(
+        static_cast<double>(res[i]), static_cast<double>(op(a[i], b[i])))
+        << "at index " << i;
+    }
+  };
+  const auto a_elements = Vec256<T>::loadu(a);
+  const auto b_elements = Vec256<T>::loadu(b);
+
+  check(a_elements, [](T x, T /* unused */) { return x; });
+  check(a_elements + b_elements, [](T x, T y) -> T { return x + y; });
+  check(a_elements - b_elements, [](T x, T y) -> T { return x - y; });
+  check(a_elements * b_elements, [](T x, T y) -> T { return x * y; });
+  check(
+    at::vec256::minimum(a_elements, b_elements),
+    [](T x, T y) { return std::min(x, y); });
+  check(
+    at::vec256::maximum(a_elements, b_elements),
+    [](T x, T y) { return std::max(x, y); });
+
+  for (int64_t count : {int64_t(0), int64_t(1), size / 2, size}) {
+    // set() takes the first `count` elements from its second argument.
+    int64_t index = 0;
+    check(
+      Vec256<T>::set(a_elements, b_elements, count),
+      [&](T x, T y) { return index++ < count ? y : x; });
+
+    // Partial loads read the first `count` elements, partial stores leave
+    // the remaining ones untouched.
+    Vec256<T>::loadu(a, count).store(res);
+    for (int64_t i = 0; i < count; ++i) {
+      ASSERT_EQ(static_cast<double>(res[i]), static_cast<double>(a[i]));
+    }
+    std::copy(b, b + size, res);
+    a_elements.store(res, count);
+    for (int64_t i = 0; i < size; ++i) {
+      const T expected = i < count ? a[i] : b[i];
+      ASSERT_EQ(static_cast<double>(res[i]), static_cast<double>(expected));
+    }
+  }
+
+  Vec256<T>::arange(static_cast<T>(1), 2).store(res);
+  for (int64_t i = 0; i < size; ++i) {
+    ASSERT_EQ(static_cast<double>(res[i]), static_cast<double>(1 + 2 * i));
+  }
+}
+
+TEST(Vec256TestDouble, Arithmetic) {
+  ArithmeticTestHelper<double>();
+}
+
+TEST(Vec256TestInt64, Arithmetic) {
+  ArithmeticTestHelper<int64_t>();
+}
+
+TEST(Vec256TestInt32, Arithmetic) {
+  ArithmeticTestHelper<int32_t>();
+}
+
+TEST(Vec256TestInt16, Arithmetic) {
+  ArithmeticTestHelper<int16_t>();
+}
+
+TEST(Vec256TestBFloat16, Arithmetic) {
+  ArithmeticTestHelper<at::BFloat16>();
+}
+
+// The test is built once per CPU capability (see caffe2/CMakeLists.txt).
+// Returns whether this machine can run the instructions of the capability
+// it was built for.
+bool cpu_capability_supported() {
+#if defined(_MSC_VER)
+  return true;
+#elif defined(CPU_CAPABILITY_AVX512)
+  return __builtin_cpu_supports("avx512f") &&
+    __builtin_cpu_supports("avx512bw") &&
+    __builtin_cpu_supports("avx512vl") &&
+    __builtin_cpu_supports("avx512dq");
+#elif defined(CPU_CAPABILITY_AVX2)
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#elif defined(CPU_CAPABILITY_AVX)
+  return __builtin_cpu_supports("avx");
+#else
+  return true;
+#endif
+}
+
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
+  if (!cpu_capability_supported()) {
+    std::cout << "Skipping: the CPU does not support the instructions this "
+              << "test was built for" << std::endl;
+    return 0;
+  }
   at::manual_seed(42);
   return RUN_ALL_TESTS();
 }
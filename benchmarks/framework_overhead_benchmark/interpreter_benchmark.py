@@ -0,0 +1,125 @@
+from __future__ import absolute_import, division, print_function, unicode_literals
+import argparse
+import time
+
+import torch
+from typing import List
+
+""" TorchScript interpreter overhead benchmark.
+Runs scripted loops whose bodies do almost no work besides executing
+interpreter instructions, so the time per loop iteration tracks the cost
+of instruction dispatch. Every workload exercises one instruction pattern
+that the interpreter can fuse into a superinstruction:
+    scalar_ops:  loads, OP and STORE (LOAD_OP_STORE)
+    attr_chain:  a load and a chain of GET_ATTRs (GET_ATTR_CHAIN)
+    list_op:     a LIST_CONSTRUCT feeding an OP (LIST_CONSTRUCT_OP)
+    decode_loop: control flow over scalars and a list, as in a decoding loop
+Compare against a run with --disable_superinstructions; the setting only
+applies to code compiled after it is made, so it is made once per process.
+Example run:
+python interpreter_benchmark.py
+python interpreter_benchmark.py --disable_superinstructions
+python interpreter_benchmark.py --workloads scalar_ops,attr_chain --num_loop_iters 100000
+"""
+
+
+def scalar_ops(n: int) -> int:
+    x = 0
+    for i in range(n):
+        y = x * 3 + i
+        x = y % 1000003
+    return x
+
+
+class Leaf(torch.nn.Module):
+    def __init__(self):
+        super(Leaf, self).__init__()
+        self.scale = 3
+
+
+class Middle(torch.nn.Module):
+    def __init__(self):
+        super(Middle, self).__init__()
+        self.leaf = Leaf()
+
+
+class AttrChain(torch.nn.Module):
+    def __init__(self):
+        super(AttrChain, self).__init__()
+        self.middle = Middle()
+
+    def forward(self, n: int) -> int:
+        x = 0
+        for i in range(n):
+            x = (x + self.middle.leaf.scale * i) % 1000003
+        return x
+
+
+def list_op(n: int) -> int:
+    x = 0
+    for i in range(n):
+        x = x + len([i, x, 1])
+    return x
+
+
+def decode_loop(n: int) -> int:
+    tokens: List[int] = []
+    state = 1
+    for i in range(n):
+        state = (state * 1103515245 + 12345) % 2147483648
+        if state % 7 == 0 or len(tokens) > 64:
+            tokens = [state % 100]
+        else:
+            tokens.append(state % 100)
+    return len(tokens)
+
+
+WORKLOADS = {
+    "scalar_ops": lambda: torch.jit.script(scalar_ops),
+    "attr_chain": lambda: torch.jit.script(AttrChain()),
+    "list_op": lambda: torch.jit.script(list_op),
+    "decode_loop": lambda: torch.jit.script(decode_loop),
+}
+
+
+def benchmark_workload(name, args):
+    fn = WORKLOADS[name]()
+    # the first runs profile and optimize the workload
+    for _ in range(args.num_warmup_iters):
+        fn(args.num_loop_iters)
+
+    start = time.time()
+    for _ in range(args.num_iters):
+        fn(args.num_loop_iters)
+    end = time.time()
+    return (end - start) * 1e9 / args.num_iters / args.num_loop_iters
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--workloads", default=",".join(WORKLOADS), type=str)
+    parser.add_argument("--num_loop_iters", type=int, default=10000)
+    parser.add_argument("--num_warmup_iters", type=int, default=5)
+    parser.add_argument("--num_iters", type=int, default=20)
+    parser.add_argument("--disable_superinstructions", default=False, dest="disable_superinstructions",
+                        action="store_true")
+    args = parser.parse_args()
+
+    workloads = args.workloads.split(",")
+    for name in workloads:
+        if name not in WORKLOADS:
+            print("Workload {} is not supported: Supported workloads are:{}".format(name, list(WORKLOADS)))
+            return
+
+    superinstructions = not args.disable_superinstructions
+    torch._C._jit_set_superinstructions_enabled(superinstructions)
+    print("Superinstructions: {}".format(superinstructions))
+    print("===================================")
+    for name in workloads:
+        latency_ns = benchmark_workload(name, args)
+        print("{}, latency per loop iter (ns):{:.1f}".format(name, latency_ns))
+    print("===================================")
+
+
+if __name__ == "__main__":
+    main()
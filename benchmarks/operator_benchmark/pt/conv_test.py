@@ -129,6 +129,41 @@ op_bench.generate_pt_test(conv_2d_configs_short + conv_2d_configs_long,
                           ConvTranspose2dBenchmark)
 
 
+# Configs for channels last Conv2d on CPU, including grouped and depthwise
+conv_2d_channels_last_configs = op_bench.config_list(
+    attr_names=[
+        'IC', 'OC', 'kernel', 'stride', 'N', 'H', 'W', 'G', 'pad',
+    ],
+    attrs=[
+        [64, 64, 3, 1, 1, 56, 56, 1, 1],
+        [128, 128, 3, 2, 4, 28, 28, 1, 1],
+        [256, 256, 1, 1, 4, 14, 14, 1, 0],
+        [128, 128, 3, 1, 4, 28, 28, 32, 1],
+        [256, 256, 3, 1, 4, 14, 14, 256, 1],
+    ],
+    cross_product_configs={
+        'device': ['cpu'],
+    },
+    tags=['short']
+)
+
+
+class Conv2dChannelsLastBenchmark(op_bench.TorchBenchmarkBase):
+    def init(self, IC, OC, kernel, stride, N, H, W, G, pad, device):
+        self.input = torch.rand(N, IC, H, W, device=device).to(memory_format=torch.channels_last)
+        self.conv2d = nn.Conv2d(
+            IC, OC, kernel, stride=stride, groups=G, padding=pad).to(
+                device=device, memory_format=torch.channels_last)
+        self.set_module_name('Conv2dChannelsLast')
+
+    def forward(self):
+        return self.conv2d(self.input)
+
+
+op_bench.generate_pt_test(conv_2d_channels_last_configs,
+                          Conv2dChannelsLastBenchmark)
+
+
 """
 Microbenchmarks for Conv3d and ConvTranspose3d operators.
 """
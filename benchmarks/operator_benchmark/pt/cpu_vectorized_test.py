@@ -0,0 +1,70 @@
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+from __future__ import unicode_literals
+
+
+import operator_benchmark as op_bench
+import torch
+
+
+"""
+Microbenchmarks for the vectorized CPU pointwise and reduction kernels.
+
+These kernels are compiled once per CPU capability, so running this file with
+ATEN_CPU_CAPABILITY=avx2 and ATEN_CPU_CAPABILITY=avx512 compares the two
+Vec256 backends on the same machine.
+"""
+
+
+cpu_vectorized_configs_short = op_bench.config_list(
+    attr_names=['M', 'N'],
+    attrs=[
+        [256, 1024],
+    ],
+    cross_product_configs={
+        'dtype': [torch.float, torch.double, torch.bfloat16],
+    },
+    tags=['short']
+)
+
+
+cpu_vectorized_configs_long = op_bench.cross_product_configs(
+    M=[64, 1024],
+    N=[1024, 4096],
+    dtype=[torch.float, torch.double, torch.bfloat16],
+    tags=['long']
+)
+
+
+cpu_vectorized_ops_list = op_bench.op_list(
+    attr_names=['op_name', 'op_func'],
+    attrs=[
+        ['add', lambda x, y: torch.add(x, y)],
+        ['mul', lambda x, y: torch.mul(x, y)],
+        ['maximum', lambda x, y: torch.max(x, y)],
+        ['exp', lambda x, y: torch.exp(x)],
+        ['sigmoid', lambda x, y: torch.sigmoid(x)],
+        ['sum', lambda x, y: torch.sum(x, dim=1)],
+        ['softmax', lambda x, y: torch.softmax(x, dim=1)],
+    ],
+)
+
+
+class CPUVectorizedBenchmark(op_bench.TorchBenchmarkBase):
+    def init(self, M, N, dtype, op_func):
+        self.input_one = torch.rand(M, N).to(dtype)
+        self.input_two = torch.rand(M, N).to(dtype)
+        self.op_func = op_func
+
+    def forward(self):
+        return self.op_func(self.input_one, self.input_two)
+
+
+op_bench.generate_pt_tests_from_op_list(cpu_vectorized_ops_list,
+                                        cpu_vectorized_configs_short + cpu_vectorized_configs_long,
+                                        CPUVectorizedBenchmark)
+
+
+if __name__ == "__main__":
+    op_bench.benchmark_runner.main()
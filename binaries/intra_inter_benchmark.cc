@@ -1,6 +1,8 @@
 #include "ATen/ATen.h"
 #include "ATen/Parallel.h"
 
+#include "c10/core/thread_pool.h"
+#include "c10/core/work_stealing_thread_pool.h"
 #include "c10/util/Flags.h"
 #include "caffe2/core/init.h"
 
@@ -21,6 +23,13 @@ C10_DEFINE_int(benchmark_iter, 10, "Number of times to run benchmark")
 C10_DEFINE_bool(extra_stats, false,
     "Collect extra stats; warning: skews results");
 C10_DEFINE_string(task_type, "add", "Tensor operation: add or mm");
+C10_DEFINE_bool(compare_pools, false,
+    "Compare the FIFO and the work-stealing thread pools on parallel loops "
+    "with uneven chunk costs, instead of running the task tree benchmark");
+C10_DEFINE_int(pool_clients, 4,
+    "Number of threads running parallel loops concurrently (compare_pools)");
+C10_DEFINE_int(pool_loops, 256,
+    "Number of parallel loops run by each client (compare_pools)");
 
 namespace {
 std::atomic<int> counter{0};
@@ -103,6 +112,90 @@ void print_runtime_stats(const std::vector<float>& runtimes) {
             << std::endl;
 }
 
+// Runs a parallel loop over FLAGS_sub_iter iterations on `pool` the way
+// at::parallel_for does with the native backend: the calling thread and
+// num_workers - 1 pool tasks keep claiming chunks until none are left.
+// One iteration in eight is much more expensive than the others, so chunks
+// have uneven costs.
+void ragged_parallel_loop(c10::TaskThreadPoolBase& pool, int num_workers) {
+  constexpr int64_t kChunksPerWorker = 4;
+  const int64_t num_chunks = num_workers * kChunksPerWorker;
+  const int64_t chunk_size = (FLAGS_sub_iter + num_chunks - 1) / num_chunks;
+
+  std::atomic<int64_t> next_chunk{0};
+  std::atomic<int> remaining{num_workers};
+  std::mutex done_mutex;
+  std::condition_variable done_cv;
+
+  auto worker = [&]() {
+    for (int64_t chunk = next_chunk++; chunk < num_chunks;
+         chunk = next_chunk++) {
+      const int64_t end =
+          std::min<int64_t>(FLAGS_sub_iter, (chunk + 1) * chunk_size);
+      for (int64_t i = chunk * chunk_size; i < end; ++i) {
+        const int64_t cost = (i * 2654435761u) % 8 == 0 ? 4096 : 64;
+        volatile float acc = 0;
+        for (int64_t k = 0; k < cost; ++k) {
+          acc = acc * 0.5f + 1.0f;
+        }
+      }
+    }
+    if (--remaining == 0) {
+      std::unique_lock<std::mutex> lk(done_mutex);
+      done_cv.notify_one();
+    }
+  };
+  for (int w = 1; w < num_workers; ++w) {
+    pool.run(worker);
+  }
+  worker();
+
+  std::unique_lock<std::mutex> lk(done_mutex);
+  while (remaining > 0) {
+    done_cv.wait(lk);
+  }
+}
+
+void compare_pools() {
+  const int num_workers = std::max(at::get_num_threads(), 2);
+  c10::ThreadPool fifo_pool(num_workers - 1);
+  c10::WorkStealingThreadPool work_stealing_pool(num_workers - 1);
+
+  std::cout << "Running " << FLAGS_pool_clients << " clients x "
+            << FLAGS_pool_loops << " parallel loops of " << FLAGS_sub_iter
+            << " iterations, using " << num_workers << " threads per loop"
+            << std::endl;
+
+  typedef std::chrono::high_resolution_clock clock;
+  typedef std::chrono::milliseconds ms;
+
+  const std::vector<std::pair<const char*, c10::TaskThreadPoolBase*>> pools = {
+    {"FIFO thread pool", &fifo_pool},
+    {"work-stealing thread pool", &work_stealing_pool},
+  };
+  for (const auto& named_pool : pools) {
+    std::vector<float> runtimes;
+    for (auto bench_iter = 0; bench_iter < FLAGS_benchmark_iter; ++bench_iter) {
+      auto start_time = clock::now();
+      std::vector<std::thread> clients;
+      for (auto client = 0; client < FLAGS_pool_clients; ++client) {
+        clients.emplace_back([&named_pool, num_workers]() {
+          for (auto loop = 0; loop < FLAGS_pool_loops; ++loop) {
+            ragged_parallel_loop(*named_pool.second, num_workers);
+          }
+        });
+      }
+      for (auto& client : clients) {
+        client.join();
+      }
+      runtimes.push_back(static_cast<float>(
+          std::chrono::duration_cast<ms>(clock::now() - start_time).count()));
+    }
+    std::cout << named_pool.first << ": ";
+    print_runtime_stats(runtimes);
+  }
+}
+
 int main(int argc, char** argv) {
   if (!c10::ParseCommandLineFlags(&argc, &argv)) {
     std::cout << "Failed to parse command line flags" << std::endl;
@@ -118,6 +211,11 @@ int main(int argc, char** argv) {
     at::set_num_threads(FLAGS_intra_op_threads);
   }
 
+  if (FLAGS_compare_pools) {
+    compare_pools();
+    return 0;
+  }
+
   TORCH_CHECK(FLAGS_task_type == "add" || FLAGS_task_type == "mm");
   run_mm = FLAGS_task_type == "mm";
 
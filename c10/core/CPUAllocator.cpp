@@ -71,8 +71,8 @@ void* alloc_cpu(size_t nbytes) {
       nbytes,
       " bytes. Buy new RAM!");
 
-  // move data to a thread's NUMA node
-  NUMAMove(data, nbytes, GetCurrentNUMANode());
+  // move data to the requested or the thread's NUMA node
+  NUMAMove(data, nbytes, GetAllocationNUMANode());
   CHECK(
       !FLAGS_caffe2_cpu_allocator_do_zero_fill ||
       !FLAGS_caffe2_cpu_allocator_do_junk_fill)
@@ -86,6 +86,31 @@ void* alloc_cpu(size_t nbytes) {
   return data;
 }
 
+namespace {
+thread_local int requested_numa_node_id = -1;
+} // namespace
+
+NUMAAllocationGuard::NUMAAllocationGuard(int numa_node_id)
+    : prev_numa_node_id_(requested_numa_node_id) {
+  requested_numa_node_id = numa_node_id;
+}
+
+NUMAAllocationGuard::~NUMAAllocationGuard() {
+  requested_numa_node_id = prev_numa_node_id_;
+}
+
+int NUMAAllocationGuard::requested() {
+  return requested_numa_node_id;
+}
+
+int GetAllocationNUMANode() {
+  if (!IsNUMAEnabled()) {
+    return -1;
+  }
+  const int requested = requested_numa_node_id;
+  return requested >= 0 ? requested : GetCurrentNUMANode();
+}
+
 void free_cpu(void* data) {
 #ifdef _MSC_VER
   _aligned_free(data);
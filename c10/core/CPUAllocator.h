@@ -37,6 +37,29 @@ C10_API void memset_junk(void* data, size_t num);
 C10_API void* alloc_cpu(size_t nbytes);
 C10_API void free_cpu(void* data);
 
+// While a NUMAAllocationGuard is alive, CPU memory allocated by the current
+// thread is placed on the given NUMA node instead of the node the thread is
+// running on. Has no effect unless NUMA is enabled (see IsNUMAEnabled).
+class C10_API NUMAAllocationGuard {
+ public:
+  explicit NUMAAllocationGuard(int numa_node_id);
+  ~NUMAAllocationGuard();
+
+  NUMAAllocationGuard(const NUMAAllocationGuard&) = delete;
+  NUMAAllocationGuard& operator=(const NUMAAllocationGuard&) = delete;
+
+  // Node requested by the innermost guard of the current thread, or -1.
+  static int requested();
+
+ private:
+  int prev_numa_node_id_;
+};
+
+// NUMA node CPU memory allocated by the current thread goes to: the node
+// requested with NUMAAllocationGuard, or else the current node. -1 when NUMA
+// is disabled.
+C10_API int GetAllocationNUMANode();
+
 // A simple struct that is used to report C10's memory allocation and
 // deallocation status to the profiler
 class C10_API ProfiledCPUMemoryReporter {
@@ -0,0 +1,590 @@
+#include <c10/core/CPUCachingAllocator.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/core/DeviceType.h>
+#include <c10/util/llvmMathExtras.h>
+
+namespace c10 {
+
+// The registered allocators and their priorities, defined in Allocator.cpp.
+// setEnabled swaps the CPU entry directly so that disabling puts back
+// exactly the allocator and priority that were there before.
+extern C10_API at::Allocator*
+    allocator_array[at::COMPILE_TIME_MAX_DEVICE_TYPES];
+extern C10_API uint8_t allocator_priority[at::COMPILE_TIME_MAX_DEVICE_TYPES];
+
+namespace CPUCachingAllocator {
+
+namespace {
+
+// Every block starts with a header recording its size, so that freeing a
+// pointer needs no lookup. The header keeps the data gAlignment-aligned.
+constexpr size_t kHeaderSize = gAlignment >= 32 ? gAlignment : 32;
+// Smallest size class.
+constexpr size_t kMinBlockSize = 64;
+// Largest request served from the small pool.
+constexpr size_t kSmallSize = 1048576;
+// Large blocks are rounded up to (and aligned on) the huge page size.
+constexpr size_t kLargeRoundSize = 2097152;
+// Bytes of small blocks a thread caches before spilling to the global pool.
+constexpr size_t kThreadCacheMaxBytes = 4194304;
+// Priority of the CPU allocator while the caching allocator is enabled: wins
+// over the default allocator, registered with priority 0, whatever the
+// static initialization order.
+constexpr uint8_t kAllocatorPriority = 1;
+
+// Four size classes per power of two: index 0 is kMinBlockSize, after that
+// the classes between 2^k and 2^(k+1) are 2^k * {1.25, 1.5, 1.75, 2}.
+constexpr size_t kMinBlockSizeLog2 = 6;
+constexpr size_t kNumSmallClasses = 1 + 4 * (20 - kMinBlockSizeLog2);
+
+inline size_t size_class_index(size_t nbytes) {
+  if (nbytes <= kMinBlockSize) {
+    return 0;
+  }
+  const size_t log2 = llvm::Log2_64(nbytes - 1);
+  const size_t step = size_t(1) << (log2 - 2);
+  const size_t k = (nbytes - (size_t(1) << log2) + step - 1) / step;
+  return 1 + 4 * (log2 - kMinBlockSizeLog2) + (k - 1);
+}
+
+inline size_t size_class_size(size_t index) {
+  if (index == 0) {
+    return kMinBlockSize;
+  }
+  const size_t log2 = (index - 1) / 4 + kMinBlockSizeLog2;
+  const size_t k = (index - 1) % 4 + 1;
+  return (size_t(1) << log2) + k * (size_t(1) << (log2 - 2));
+}
+
+struct BlockHeader {
+  // total size of the block, header included
+  size_t size;
+  StatType pool;
+  // NUMA node the block was placed on, -1 if none
+  int numa_node;
+};
+
+static_assert(sizeof(BlockHeader) <= kHeaderSize, "block header too large");
+
+inline void* block_data(BlockHeader* block) {
+  return reinterpret_cast<char*>(block) + kHeaderSize;
+}
+
+inline BlockHeader* data_block(void* data) {
+  return reinterpret_cast<BlockHeader*>(
+      reinterpret_cast<char*>(data) - kHeaderSize);
+}
+
+void* system_alloc(size_t size, bool large) {
+  void* data = nullptr;
+  const size_t alignment = large ? kLargeRoundSize : gAlignment;
+#ifdef __ANDROID__
+  data = memalign(alignment, size);
+#elif defined(_MSC_VER)
+  data = _aligned_malloc(size, alignment);
+#else
+  if (posix_memalign(&data, alignment, size) != 0) {
+    data = nullptr;
+  }
+#endif
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (data && large) {
+    // Best effort: fails harmlessly if transparent huge pages are disabled.
+    madvise(data, size, MADV_HUGEPAGE);
+  }
+#endif
+  return data;
+}
+
+void system_free(void* data) {
+#ifdef _MSC_VER
+  _aligned_free(data);
+#else
+  free(data);
+#endif
+}
+
+// Same as Stat, but updated concurrently by all threads without a lock.
+struct AtomicStat {
+  std::atomic<int64_t> current{0};
+  std::atomic<int64_t> peak{0};
+  std::atomic<int64_t> allocated{0};
+  std::atomic<int64_t> freed{0};
+
+  void update(int64_t amount) {
+    const int64_t now =
+        current.fetch_add(amount, std::memory_order_relaxed) + amount;
+    int64_t prev = peak.load(std::memory_order_relaxed);
+    while (now > prev &&
+           !peak.compare_exchange_weak(prev, now, std::memory_order_relaxed)) {
+    }
+    if (amount > 0) {
+      allocated.fetch_add(amount, std::memory_order_relaxed);
+    } else {
+      freed.fetch_add(-amount, std::memory_order_relaxed);
+    }
+  }
+
+  Stat get() const {
+    Stat stat;
+    stat.current = current.load(std::memory_order_relaxed);
+    stat.peak = peak.load(std::memory_order_relaxed);
+    stat.allocated = allocated.load(std::memory_order_relaxed);
+    stat.freed = freed.load(std::memory_order_relaxed);
+    return stat;
+  }
+};
+
+typedef std::array<AtomicStat, static_cast<size_t>(StatType::NUM_TYPES)>
+    AtomicStatArray;
+
+void update_stat_array(
+    AtomicStatArray& stat_array,
+    int64_t amount,
+    StatType pool) {
+  stat_array[static_cast<size_t>(StatType::AGGREGATE)].update(amount);
+  stat_array[static_cast<size_t>(pool)].update(amount);
+}
+
+StatArray get_stat_array(const AtomicStatArray& stat_array) {
+  StatArray result;
+  for (size_t i = 0; i < stat_array.size(); ++i) {
+    result[i] = stat_array[i].get();
+  }
+  return result;
+}
+
+void reset_accumulated_stat_array(AtomicStatArray& stat_array) {
+  for (auto& stat : stat_array) {
+    stat.allocated.store(0, std::memory_order_relaxed);
+    stat.freed.store(0, std::memory_order_relaxed);
+  }
+}
+
+void reset_peak_stat_array(AtomicStatArray& stat_array) {
+  for (auto& stat : stat_array) {
+    stat.peak.store(
+        stat.current.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+  }
+}
+
+class CachingAllocatorImpl;
+CachingAllocatorImpl& impl();
+
+// Small blocks freed by a thread, reused by the same thread without locking.
+struct ThreadCache {
+  std::array<std::vector<BlockHeader*>, kNumSmallClasses> bins;
+  size_t cached_bytes = 0;
+  // Value of the global epoch when this cache was last synchronized;
+  // emptyCache() bumps the global epoch to make every thread drop its cache.
+  uint64_t epoch = 0;
+
+  ~ThreadCache();
+};
+
+// Set once the calling thread's cache has been destroyed at thread exit:
+// memory freed after that point goes straight to the global pool.
+thread_local bool thread_cache_destroyed = false;
+
+ThreadCache* thread_cache() {
+  if (thread_cache_destroyed) {
+    return nullptr;
+  }
+  static thread_local ThreadCache cache;
+  return &cache;
+}
+
+class CachingAllocatorImpl {
+ public:
+  BlockHeader* malloc(size_t nbytes) {
+    BlockHeader* block = nbytes <= kSmallSize ? malloc_small(nbytes)
+                                              : malloc_large(nbytes);
+    update_stat_array(stats_.allocation, 1, block->pool);
+    update_stat_array(stats_.allocated_bytes, block->size, block->pool);
+    return block;
+  }
+
+  void free(BlockHeader* block) {
+    update_stat_array(stats_.allocation, -1, block->pool);
+    update_stat_array(
+        stats_.allocated_bytes, -static_cast<int64_t>(block->size), block->pool);
+    update_stat_array(stats_.cached, 1, block->pool);
+    update_stat_array(stats_.cached_bytes, block->size, block->pool);
+
+    if (block->pool == StatType::SMALL_POOL) {
+      ThreadCache* cache = synced_thread_cache();
+      if (cache && cache->cached_bytes + block->size <= kThreadCacheMaxBytes) {
+        cache->bins[size_class_index(block->size - kHeaderSize)].push_back(
+            block);
+        cache->cached_bytes += block->size;
+        return;
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      small_blocks_[size_class_index(block->size - kHeaderSize)].push_back(
+          block);
+    } else {
+      std::lock_guard<std::mutex> lock(mutex_);
+      large_blocks_.emplace(block->size, block);
+    }
+  }
+
+  void emptyCache() {
+    epoch_.fetch_add(1, std::memory_order_relaxed);
+    synced_thread_cache();
+
+    std::vector<BlockHeader*> blocks;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto& bin : small_blocks_) {
+        blocks.insert(blocks.end(), bin.begin(), bin.end());
+        bin.clear();
+      }
+      for (const auto& entry : large_blocks_) {
+        blocks.push_back(entry.second);
+      }
+      large_blocks_.clear();
+    }
+    for (BlockHeader* block : blocks) {
+      release_block(block);
+    }
+  }
+
+  // Returns every block of the cache to the system.
+  void release_thread_cache(ThreadCache& cache) {
+    for (auto& bin : cache.bins) {
+      for (BlockHeader* block : bin) {
+        release_block(block);
+      }
+      bin.clear();
+    }
+    cache.cached_bytes = 0;
+  }
+
+  // Hands the blocks of an exiting thread's cache over to the global pool.
+  void flush_thread_cache(ThreadCache& cache) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < kNumSmallClasses; ++i) {
+      auto& bin = small_blocks_[i];
+      bin.insert(bin.end(), cache.bins[i].begin(), cache.bins[i].end());
+      cache.bins[i].clear();
+    }
+    cache.cached_bytes = 0;
+  }
+
+  CPUAllocatorStats getStats() {
+    CPUAllocatorStats stats;
+    stats.allocation = get_stat_array(stats_.allocation);
+    stats.segment = get_stat_array(stats_.segment);
+    stats.cached = get_stat_array(stats_.cached);
+    stats.allocated_bytes = get_stat_array(stats_.allocated_bytes);
+    stats.reserved_bytes = get_stat_array(stats_.reserved_bytes);
+    stats.cached_bytes = get_stat_array(stats_.cached_bytes);
+    stats.num_thread_cache_hits = stats_.num_thread_cache_hits.load();
+    stats.num_alloc_retries = stats_.num_alloc_retries.load();
+    stats.num_ooms = stats_.num_ooms.load();
+    return stats;
+  }
+
+  void resetAccumulatedStats() {
+    reset_accumulated_stat_array(stats_.allocation);
+    reset_accumulated_stat_array(stats_.segment);
+    reset_accumulated_stat_array(stats_.cached);
+    reset_accumulated_stat_array(stats_.allocated_bytes);
+    reset_accumulated_stat_array(stats_.reserved_bytes);
+    reset_accumulated_stat_array(stats_.cached_bytes);
+    stats_.num_thread_cache_hits = 0;
+    stats_.num_alloc_retries = 0;
+    stats_.num_ooms = 0;
+  }
+
+  void resetPeakStats() {
+    reset_peak_stat_array(stats_.allocation);
+    reset_peak_stat_array(stats_.segment);
+    reset_peak_stat_array(stats_.cached);
+    reset_peak_stat_array(stats_.allocated_bytes);
+    reset_peak_stat_array(stats_.reserved_bytes);
+    reset_peak_stat_array(stats_.cached_bytes);
+  }
+
+ private:
+  struct {
+    AtomicStatArray allocation;
+    AtomicStatArray segment;
+    AtomicStatArray cached;
+    AtomicStatArray allocated_bytes;
+    AtomicStatArray reserved_bytes;
+    AtomicStatArray cached_bytes;
+    std::atomic<int64_t> num_thread_cache_hits{0};
+    std::atomic<int64_t> num_alloc_retries{0};
+    std::atomic<int64_t> num_ooms{0};
+  } stats_;
+
+  std::mutex mutex_;
+  std::array<std::vector<BlockHeader*>, kNumSmallClasses> small_blocks_;
+  // large cached blocks, keyed by size for best-fit lookup
+  std::multimap<size_t, BlockHeader*> large_blocks_;
+  std::atomic<uint64_t> epoch_{0};
+
+  ThreadCache* synced_thread_cache() {
+    ThreadCache* cache = thread_cache();
+    if (cache) {
+      const uint64_t epoch = epoch_.load(std::memory_order_relaxed);
+      if (C10_UNLIKELY(cache->epoch != epoch)) {
+        release_thread_cache(*cache);
+        cache->epoch = epoch;
+      }
+    }
+    return cache;
+  }
+
+  // Migrates a reused block to `numa_node` if it was placed elsewhere.
+  static void place_block(BlockHeader* block, int numa_node) {
+    if (numa_node >= 0 && block->numa_node != numa_node) {
+      NUMAMove(block, block->size, numa_node);
+      block->numa_node = numa_node;
+    }
+  }
+
+  BlockHeader* take_cached(BlockHeader* block) {
+    update_stat_array(stats_.cached, -1, block->pool);
+    update_stat_array(
+        stats_.cached_bytes, -static_cast<int64_t>(block->size), block->pool);
+    return block;
+  }
+
+  BlockHeader* malloc_small(size_t nbytes) {
+    const size_t index = size_class_index(nbytes);
+    ThreadCache* cache = synced_thread_cache();
+    if (cache && !cache->bins[index].empty()) {
+      BlockHeader* block = cache->bins[index].back();
+      cache->bins[index].pop_back();
+      cache->cached_bytes -= block->size;
+      stats_.num_thread_cache_hits.fetch_add(1, std::memory_order_relaxed);
+      // The block was freed by this thread, so it is assumed to be on the
+      // thread's node unless another node is requested explicitly.
+      if (NUMAAllocationGuard::requested() >= 0) {
+        place_block(block, GetAllocationNUMANode());
+      }
+      return take_cached(block);
+    }
+    const int numa_node = GetAllocationNUMANode();
+    BlockHeader* block = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto& bin = small_blocks_[index];
+      if (!bin.empty()) {
+        block = bin.back();
+        bin.pop_back();
+      }
+    }
+    if (block) {
+      place_block(block, numa_node);
+      return take_cached(block);
+    }
+    return alloc_block(
+        nbytes, kHeaderSize + size_class_size(index), StatType::SMALL_POOL);
+  }
+
+  BlockHeader* malloc_large(size_t nbytes) {
+    const size_t size = (nbytes + kHeaderSize + kLargeRoundSize - 1) /
+        kLargeRoundSize * kLargeRoundSize;
+    BlockHeader* block = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      // best fit, as long as it wastes at most a quarter of the block
+      auto it = large_blocks_.lower_bound(size);
+      if (it != large_blocks_.end() && it->first - size <= size / 4) {
+        block = it->second;
+        large_blocks_.erase(it);
+      }
+    }
+    if (block) {
+      place_block(block, GetAllocationNUMANode());
+      return take_cached(block);
+    }
+    return alloc_block(nbytes, size, StatType::LARGE_POOL);
+  }
+
+  BlockHeader* alloc_block(size_t nbytes, size_t size, StatType pool) {
+    const bool large = pool == StatType::LARGE_POOL;
+    void* data = system_alloc(size, large);
+    if (!data) {
+      // Give the cached memory back and try again.
+      stats_.num_alloc_retries.fetch_add(1, std::memory_order_relaxed);
+      emptyCache();
+      data = system_alloc(size, large);
+    }
+    if (!data) {
+      stats_.num_ooms.fetch_add(1, std::memory_order_relaxed);
+      CAFFE_THROW(
+          "CPUCachingAllocator: not enough memory: you tried to allocate ",
+          nbytes,
+          " bytes.");
+    }
+    // move data to the requested or the thread's NUMA node
+    const int numa_node = GetAllocationNUMANode();
+    NUMAMove(data, size, numa_node);
+
+    BlockHeader* block = static_cast<BlockHeader*>(data);
+    block->size = size;
+    block->pool = pool;
+    block->numa_node = numa_node;
+    update_stat_array(stats_.segment, 1, pool);
+    update_stat_array(stats_.reserved_bytes, size, pool);
+    return block;
+  }
+
+  void release_block(BlockHeader* block) {
+    update_stat_array(stats_.cached, -1, block->pool);
+    update_stat_array(
+        stats_.cached_bytes, -static_cast<int64_t>(block->size), block->pool);
+    update_stat_array(stats_.segment, -1, block->pool);
+    update_stat_array(
+        stats_.reserved_bytes, -static_cast<int64_t>(block->size), block->pool);
+    system_free(block);
+  }
+};
+
+CachingAllocatorImpl& impl() {
+  // Intentionally leaked: tensors may still be freed during static
+  // destruction.
+  static CachingAllocatorImpl* impl = new CachingAllocatorImpl();
+  return *impl;
+}
+
+ThreadCache::~ThreadCache() {
+  impl().flush_thread_cache(*this);
+  thread_cache_destroyed = true;
+}
+
+struct CachingCPUAllocator final : at::Allocator {
+  at::DataPtr allocate(size_t nbytes) const override {
+    if (nbytes == 0) {
+      return {nullptr, nullptr, &ReportAndDelete, at::Device(DeviceType::CPU)};
+    }
+    // We might have clowny upstream code that tries to alloc a negative
+    // number of bytes. Let's catch it early.
+    CAFFE_ENFORCE(
+        ((ptrdiff_t)nbytes) >= 0,
+        "CPUCachingAllocator seems to have been called with negative number: ",
+        nbytes);
+
+    void* data = block_data(impl().malloc(nbytes));
+    CHECK(
+        !FLAGS_caffe2_cpu_allocator_do_zero_fill ||
+        !FLAGS_caffe2_cpu_allocator_do_junk_fill)
+      << "Cannot request both zero-fill and junk-fill at the same time";
+    if (FLAGS_caffe2_cpu_allocator_do_zero_fill) {
+      memset(data, 0, nbytes);
+    } else if (FLAGS_caffe2_cpu_allocator_do_junk_fill) {
+      memset_junk(data, nbytes);
+    }
+    profiledCPUMemoryReporter().New(data, nbytes);
+    return {data, data, &ReportAndDelete, at::Device(DeviceType::CPU)};
+  }
+
+  static void ReportAndDelete(void* ptr) {
+    if (!ptr) {
+      return;
+    }
+    profiledCPUMemoryReporter().Delete(ptr);
+    impl().free(data_block(ptr));
+  }
+
+  at::DeleterFnPtr raw_deleter() const override {
+    return &ReportAndDelete;
+  }
+};
+
+CachingCPUAllocator g_caching_cpu_alloc;
+
+// The CPU allocator replaced by setEnabled(true), restored by
+// setEnabled(false)
+struct EnabledState {
+  std::mutex mutex;
+  bool enabled = false;
+  at::Allocator* previous_allocator = nullptr;
+  uint8_t previous_priority = 0;
+};
+
+EnabledState& enabledState() {
+  static EnabledState state;
+  return state;
+}
+
+struct EnableFromEnvironment {
+  EnableFromEnvironment() {
+    const char* env = std::getenv("PYTORCH_CPU_CACHING_ALLOCATOR");
+    if (env && std::strcmp(env, "1") == 0) {
+      setEnabled(true);
+    }
+  }
+};
+
+EnableFromEnvironment g_enable_from_environment;
+
+} // namespace
+
+at::Allocator* get() {
+  return &g_caching_cpu_alloc;
+}
+
+void setEnabled(bool enabled) {
+  auto& state = enabledState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  if (enabled == state.enabled) {
+    return;
+  }
+  const int cpu = static_cast<int>(DeviceType::CPU);
+  if (enabled) {
+    state.previous_allocator = allocator_array[cpu];
+    state.previous_priority = allocator_priority[cpu];
+    allocator_array[cpu] = get();
+    allocator_priority[cpu] =
+        std::max(state.previous_priority, kAllocatorPriority);
+  } else {
+    // Enabled from the environment before the default allocator registered
+    allocator_array[cpu] = state.previous_allocator
+        ? state.previous_allocator
+        : GetDefaultCPUAllocator();
+    allocator_priority[cpu] = state.previous_priority;
+  }
+  state.enabled = enabled;
+}
+
+bool isEnabled() {
+  return GetCPUAllocator() == get();
+}
+
+void emptyCache() {
+  impl().emptyCache();
+}
+
+CPUAllocatorStats getStats() {
+  return impl().getStats();
+}
+
+void resetAccumulatedStats() {
+  impl().resetAccumulatedStats();
+}
+
+void resetPeakStats() {
+  impl().resetPeakStats();
+}
+
+} // namespace CPUCachingAllocator
+} // namespace c10
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <c10/core/Allocator.h>
+#include <c10/macros/Export.h>
+
+namespace c10 {
+
+// Caching allocator for CPU tensors.
+//
+// The default CPU allocator goes to posix_memalign/free on every tensor
+// allocation. Workloads that create many short-lived tensors of recurring
+// sizes (e.g. inference servers) spend a lot of time in malloc and, for large
+// buffers, in page faults when memory is given back to the OS and touched
+// again. This allocator keeps freed blocks around for reuse instead:
+//
+// - Small requests (<= 1MB) are rounded up to one of four size classes per
+//   power of two. Freed small blocks go to a per-thread cache first, which
+//   is accessed without locking, and spill over to a global pool shared by
+//   all threads.
+// - Large requests are rounded up to a multiple of 2MB and backed by
+//   transparent huge pages where available. They are cached in a global
+//   pool and reused for any request that wastes at most a quarter of the
+//   block.
+//
+// The allocator is opt-in: call setEnabled(true), or set the environment
+// variable PYTORCH_CPU_CACHING_ALLOCATOR=1 before the process starts, to make
+// it the allocator returned by GetCPUAllocator(). Cached memory is only
+// returned to the system by emptyCache().
+
+namespace CPUCachingAllocator {
+
+struct Stat {
+  int64_t current = 0;
+  int64_t peak = 0;
+  int64_t allocated = 0;
+  int64_t freed = 0;
+};
+
+enum struct StatType : uint64_t {
+  AGGREGATE = 0,
+  SMALL_POOL = 1,
+  LARGE_POOL = 2,
+  NUM_TYPES = 3  // remember to update this whenever a new stat type is added
+};
+
+typedef std::array<Stat, static_cast<size_t>(StatType::NUM_TYPES)> StatArray;
+
+// Struct containing memory allocator summary statistics.
+struct CPUAllocatorStats {
+  // COUNT: allocations requested by client code
+  StatArray allocation;
+  // COUNT: blocks obtained from the system
+  StatArray segment;
+  // COUNT: freed blocks held in the per-thread caches or the global pool
+  StatArray cached;
+
+  // SUM: bytes of the blocks handed out to client code
+  StatArray allocated_bytes;
+  // SUM: bytes obtained from the system
+  StatArray reserved_bytes;
+  // SUM: bytes of freed blocks held in the caches
+  StatArray cached_bytes;
+
+  // COUNT: allocations served from the calling thread's cache
+  int64_t num_thread_cache_hits = 0;
+  // COUNT: failed system allocations that result in a cache flush and retry
+  int64_t num_alloc_retries = 0;
+  // COUNT: total number of out-of-memory errors thrown
+  int64_t num_ooms = 0;
+};
+
+C10_API at::Allocator* get();
+// Makes the caching allocator the CPU allocator, or restores the allocator
+// and priority it replaced. Blocks allocated while it was enabled stay valid
+// and are still returned to its caches when freed.
+C10_API void setEnabled(bool enabled);
+C10_API bool isEnabled();
+// Returns all cached blocks of the global pool and of the calling thread's
+// cache to the system. Blocks cached by other threads are released the next
+// time those threads allocate or free memory.
+C10_API void emptyCache();
+C10_API CPUAllocatorStats getStats();
+C10_API void resetAccumulatedStats();
+C10_API void resetPeakStats();
+
+} // namespace CPUCachingAllocator
+} // namespace c10
@@ -26,6 +26,8 @@ const char* toString(DispatchKey t) {
       return "HIP";
     case DispatchKey::SparseHIP:
       return "SparseHIP";
+    case DispatchKey::SparseCsrCPU:
+      return "SparseCsrCPU";
     case DispatchKey::FPGA:
       return "FPGA";
     case DispatchKey::MSNPU:
@@ -99,6 +99,7 @@ enum class DispatchKey : uint8_t {
   SparseCUDA, // registered at build/aten/src/ATen/SparseCUDAType.cpp
   SparseHIP, // TODO: I think this is not actually used, due to Note
              // [Masquerading as CUDA]
+  SparseCsrCPU, // registered at build/aten/src/ATen/SparseCsrCPUType.cpp
 
   // Here are reserved backends for user-defined backends, see Note [Private use
   // DispatchKey]
@@ -6,11 +6,12 @@
 #include <iostream>
 
 namespace c10 {
-enum class Layout : int8_t { Strided, Sparse, Mkldnn, NumOptions };
+enum class Layout : int8_t { Strided, Sparse, Mkldnn, SparseCsr, NumOptions };
 
 constexpr auto kStrided = Layout::Strided;
 constexpr auto kSparse = Layout::Sparse;
 constexpr auto kMkldnn = Layout::Mkldnn;
+constexpr auto kSparseCsr = Layout::SparseCsr;
 
 inline Layout layout_from_backend(Backend backend) {
   switch (backend) {
@@ -20,6 +21,8 @@ inline Layout layout_from_backend(Backend backend) {
       return Layout::Sparse;
     case Backend::MkldnnCPU:
       return Layout::Mkldnn;
+    case Backend::SparseCsrCPU:
+      return Layout::SparseCsr;
     default:
       return Layout::Strided;
   }
@@ -33,6 +36,8 @@ inline std::ostream& operator<<(std::ostream& stream, at::Layout layout) {
       return stream << "Sparse";
     case at::kMkldnn:
       return stream << "Mkldnn";
+    case at::kSparseCsr:
+      return stream << "SparseCsr";
     default:
       AT_ERROR("Unknown layout");
   }
@@ -437,6 +437,10 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
            key_set_.has(DispatchKey::SparseHIP);
   }
 
+  bool is_sparse_csr() const {
+    return key_set_.has(DispatchKey::SparseCsrCPU);
+  }
+
   bool is_quantized() const {
     // NB: This method is not virtual and avoid dispatches for performance reasons.
     return key_set_.has(DispatchKey::QuantizedCPU) ||
@@ -491,6 +495,8 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
       return kSparse;
     } else if (is_mkldnn()) {
       return kMkldnn;
+    } else if (is_sparse_csr()) {
+      return kSparseCsr;
     } else {
       return kStrided;
     }
@@ -0,0 +1,175 @@
+#include <c10/core/work_stealing_thread_pool.h>
+
+namespace c10 {
+
+namespace {
+// Pool and worker index of the current thread, if it is a pool thread.
+thread_local const WorkStealingThreadPool* current_pool_ = nullptr;
+thread_local std::size_t current_worker_ = 0;
+} // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(
+      int pool_size,
+      int numa_node_id,
+      std::function<void()> init_thread)
+    : threads_(pool_size < 0 ? defaultNumThreads() : pool_size),
+      available_(threads_.size()),
+      running_(true),
+      numa_node_id_(numa_node_id) {
+  for (std::size_t i = 0; i < threads_.size(); ++i) {
+    workers_.emplace_back(new Worker());
+  }
+  for (std::size_t i = 0; i < threads_.size(); ++i) {
+    threads_[i] = std::thread([this, i, init_thread](){
+      if (init_thread) {
+        init_thread();
+      }
+      current_pool_ = this;
+      current_worker_ = i;
+      this->main_loop(i);
+    });
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  // Set running flag to false then notify all threads.
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    running_ = false;
+    condition_.notify_all();
+  }
+
+  for (auto& t : threads_) {
+    try {
+      t.join();
+    } catch (const std::exception&) {
+    }
+  }
+}
+
+size_t WorkStealingThreadPool::size() const {
+  return threads_.size();
+}
+
+size_t WorkStealingThreadPool::numAvailable() const {
+  return available_;
+}
+
+bool WorkStealingThreadPool::inThreadPool() const {
+  return current_pool_ == this;
+}
+
+void WorkStealingThreadPool::run(std::function<void()> func) {
+  if (threads_.size() == 0) {
+    throw std::runtime_error("No threads to run a task");
+  }
+  // Counted before the push, so that a worker popping the task never sees
+  // the counter go negative.
+  pending_.fetch_add(1);
+
+  // Pool threads keep the tasks they spawn, other threads spread theirs
+  // over the workers.
+  const bool local = current_pool_ == this;
+  const std::size_t index = local
+      ? current_worker_
+      : next_worker_.fetch_add(1, std::memory_order_relaxed) % threads_.size();
+  {
+    Worker& worker = *workers_[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (local) {
+      worker.tasks.emplace_back(std::move(func));
+    } else {
+      worker.tasks.emplace_front(std::move(func));
+    }
+  }
+
+  // Pairs with the increment of sleeping_ followed by the check of pending_
+  // in main_loop: either the worker sees the new task, or we see it asleep.
+  if (sleeping_.load() > 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    condition_.notify_one();
+  }
+}
+
+void WorkStealingThreadPool::waitWorkComplete() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (pending_.load() != 0 || available_.load() != threads_.size()) {
+    completed_.wait(lock);
+  }
+}
+
+bool WorkStealingThreadPool::pop_task(
+    std::size_t index,
+    std::function<void()>& task) {
+  Worker& worker = *workers_[index];
+  std::lock_guard<std::mutex> lock(worker.mutex);
+  if (worker.tasks.empty()) {
+    return false;
+  }
+  // Most recently pushed task first: its data is likely still in cache.
+  task = std::move(worker.tasks.back());
+  worker.tasks.pop_back();
+  return true;
+}
+
+bool WorkStealingThreadPool::steal_task(
+    std::size_t index,
+    std::function<void()>& task) {
+  const std::size_t num_workers = workers_.size();
+  for (std::size_t i = 1; i < num_workers; ++i) {
+    Worker& victim = *workers_[(index + i) % num_workers];
+    std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+    if (!lock.owns_lock() || victim.tasks.empty()) {
+      continue;
+    }
+    // Oldest task of the victim, the one it would run last.
+    task = std::move(victim.tasks.front());
+    victim.tasks.pop_front();
+    return true;
+  }
+  return false;
+}
+
+void WorkStealingThreadPool::main_loop(std::size_t index) {
+  while (running_) {
+    std::function<void()> task;
+    if (pop_task(index, task) || steal_task(index, task)) {
+      // Decrement count, indicating thread is no longer available. This
+      // must happen before the task stops counting as pending, otherwise
+      // waitWorkComplete() could see no pending task and all threads
+      // available before the task has run.
+      --available_;
+      pending_.fetch_sub(1);
+
+      // Run the task.
+      try {
+        task();
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "Exception in thread pool task: " << e.what();
+      } catch (...) {
+        LOG(ERROR) << "Exception in thread pool task: unknown";
+      }
+      // Destruct the task before reporting completion, in case it holds
+      // shared_ptr arguments bound via bind.
+      task = nullptr;
+
+      // Increment count, indicating thread is available.
+      if (++available_ == threads_.size() && pending_.load() == 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        completed_.notify_all();
+      }
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++sleeping_;
+    // A failed steal may just have lost a try_lock race: only sleep when
+    // there is nothing left to pick up.
+    while (pending_.load() == 0 && running_) {
+      condition_.wait(lock);
+    }
+    --sleeping_;
+  } // while running_
+}
+
+} // namespace c10
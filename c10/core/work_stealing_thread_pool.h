@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <c10/core/thread_pool.h>
+
+namespace c10 {
+
+// Thread pool with one task deque per worker.
+//
+// ThreadPool funnels every submission and every dequeue through a single
+// mutex-protected queue, which becomes a point of contention when many
+// threads submit small tasks concurrently. Here each worker owns a deque:
+// tasks submitted from a worker thread are pushed to (and popped from) the
+// back of its own deque, tasks submitted from other threads are spread over
+// the workers round-robin, and idle workers steal from the front of other
+// workers' deques before going to sleep.
+class C10_API WorkStealingThreadPool : public c10::TaskThreadPoolBase {
+ public:
+  WorkStealingThreadPool() = delete;
+
+  explicit WorkStealingThreadPool(
+      int pool_size,
+      int numa_node_id = -1,
+      std::function<void()> init_thread = nullptr);
+
+  ~WorkStealingThreadPool();
+
+  size_t size() const override;
+
+  size_t numAvailable() const override;
+
+  bool inThreadPool() const override;
+
+  void run(std::function<void()> func) override;
+
+  /// @brief Wait for all the submitted tasks to complete
+  void waitWorkComplete();
+
+ private:
+  struct Worker {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  bool pop_task(std::size_t index, std::function<void()>& task);
+  bool steal_task(std::size_t index, std::function<void()>& task);
+
+  // @brief Entry point for pool threads.
+  void main_loop(std::size_t index);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+  // Tasks submitted but not picked up by a worker yet.
+  std::atomic<int64_t> pending_{0};
+  std::atomic<std::size_t> available_;
+  std::atomic<std::size_t> next_worker_{0};
+  // Guards sleeping and waking up workers.
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::condition_variable completed_;
+  std::atomic<int> sleeping_{0};
+  std::atomic_bool running_;
+  int numa_node_id_;
+};
+
+} // namespace c10
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/util/numa.h>
+
+using namespace c10;
+
+TEST(NUMAAllocationGuard, NestsAndRestores) {
+  ASSERT_EQ(NUMAAllocationGuard::requested(), -1);
+  {
+    NUMAAllocationGuard outer(0);
+    ASSERT_EQ(NUMAAllocationGuard::requested(), 0);
+    {
+      NUMAAllocationGuard inner(1);
+      ASSERT_EQ(NUMAAllocationGuard::requested(), 1);
+    }
+    ASSERT_EQ(NUMAAllocationGuard::requested(), 0);
+  }
+  ASSERT_EQ(NUMAAllocationGuard::requested(), -1);
+}
+
+TEST(NUMAAllocationGuard, IsThreadLocal) {
+  NUMAAllocationGuard guard(1);
+  int other_thread_requested = 0;
+  std::thread t(
+      [&] { other_thread_requested = NUMAAllocationGuard::requested(); });
+  t.join();
+  ASSERT_EQ(other_thread_requested, -1);
+  ASSERT_EQ(NUMAAllocationGuard::requested(), 1);
+}
+
+TEST(GetAllocationNUMANode, DisabledWithoutNUMA) {
+  const bool prev_enabled = FLAGS_caffe2_cpu_numa_enabled;
+  FLAGS_caffe2_cpu_numa_enabled = false;
+  if (!IsNUMAEnabled()) {
+    ASSERT_EQ(GetAllocationNUMANode(), -1);
+    NUMAAllocationGuard guard(0);
+    ASSERT_EQ(GetAllocationNUMANode(), -1);
+  }
+  FLAGS_caffe2_cpu_numa_enabled = prev_enabled;
+}
+
+TEST(GetAllocationNUMANode, SingleNode) {
+  const bool prev_enabled = FLAGS_caffe2_cpu_numa_enabled;
+  FLAGS_caffe2_cpu_numa_enabled = true;
+  // Only meaningful on a single-node machine built with NUMA support.
+  if (IsNUMAEnabled() && GetNumNUMANodes() == 1) {
+    ASSERT_EQ(GetAllocationNUMANode(), 0);
+    {
+      NUMAAllocationGuard guard(0);
+      ASSERT_EQ(GetAllocationNUMANode(), 0);
+      void* data = alloc_cpu(1 << 20);
+      ASSERT_EQ(GetNUMANode(data), 0);
+      free_cpu(data);
+    }
+    ASSERT_EQ(GetAllocationNUMANode(), 0);
+  }
+  FLAGS_caffe2_cpu_numa_enabled = prev_enabled;
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/core/CPUCachingAllocator.h>
+
+using namespace c10;
+
+namespace {
+
+const CPUCachingAllocator::Stat& aggregate(
+    const CPUCachingAllocator::StatArray& stat_array) {
+  return stat_array[static_cast<size_t>(
+      CPUCachingAllocator::StatType::AGGREGATE)];
+}
+
+} // namespace
+
+TEST(CPUCachingAllocator, ReusesFreedBlocks) {
+  at::Allocator* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+
+  void* first = nullptr;
+  {
+    at::DataPtr ptr = allocator->allocate(1000);
+    first = ptr.get();
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(first) % gAlignment, 0);
+  }
+  // Same size class, served from the thread cache.
+  at::DataPtr ptr = allocator->allocate(1020);
+  ASSERT_EQ(ptr.get(), first);
+
+  at::DataPtr large = allocator->allocate(5 << 20);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(large.get()) % gAlignment, 0);
+  void* large_data = large.get();
+  large.clear();
+  at::DataPtr large_again = allocator->allocate((5 << 20) - 100);
+  ASSERT_EQ(large_again.get(), large_data);
+}
+
+TEST(CPUCachingAllocator, Stats) {
+  at::Allocator* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+  CPUCachingAllocator::resetAccumulatedStats();
+  CPUCachingAllocator::resetPeakStats();
+
+  {
+    at::DataPtr a = allocator->allocate(100);
+    at::DataPtr b = allocator->allocate(3 << 20);
+    auto stats = CPUCachingAllocator::getStats();
+    ASSERT_EQ(aggregate(stats.allocation).current, 2);
+    ASSERT_EQ(
+        stats.allocation[static_cast<size_t>(
+            CPUCachingAllocator::StatType::SMALL_POOL)].current,
+        1);
+    ASSERT_EQ(
+        stats.allocation[static_cast<size_t>(
+            CPUCachingAllocator::StatType::LARGE_POOL)].current,
+        1);
+    ASSERT_GE(aggregate(stats.allocated_bytes).current, (3 << 20) + 100);
+    ASSERT_EQ(aggregate(stats.cached).current, 0);
+  }
+
+  auto stats = CPUCachingAllocator::getStats();
+  ASSERT_EQ(aggregate(stats.allocation).current, 0);
+  ASSERT_EQ(aggregate(stats.allocation).peak, 2);
+  ASSERT_EQ(aggregate(stats.allocated_bytes).current, 0);
+  ASSERT_EQ(aggregate(stats.cached).current, 2);
+  ASSERT_EQ(
+      aggregate(stats.cached_bytes).current,
+      aggregate(stats.reserved_bytes).current);
+
+  {
+    at::DataPtr a = allocator->allocate(100);
+  }
+  stats = CPUCachingAllocator::getStats();
+  ASSERT_EQ(stats.num_thread_cache_hits, 1);
+  ASSERT_EQ(aggregate(stats.segment).allocated, 2);
+
+  CPUCachingAllocator::emptyCache();
+  stats = CPUCachingAllocator::getStats();
+  ASSERT_EQ(aggregate(stats.segment).current, 0);
+  ASSERT_EQ(aggregate(stats.reserved_bytes).current, 0);
+  ASSERT_EQ(aggregate(stats.cached_bytes).current, 0);
+}
+
+TEST(CPUCachingAllocator, CrossThreadFree) {
+  at::Allocator* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+
+  at::DataPtr ptr = allocator->allocate(4096);
+  std::thread t([&]() {
+    ptr.clear();
+    // The block stays in this thread's cache until the thread exits.
+  });
+  t.join();
+  auto stats = CPUCachingAllocator::getStats();
+  ASSERT_EQ(aggregate(stats.allocation).current, 0);
+  ASSERT_EQ(aggregate(stats.cached).current, 1);
+
+  CPUCachingAllocator::emptyCache();
+  stats = CPUCachingAllocator::getStats();
+  ASSERT_EQ(aggregate(stats.reserved_bytes).current, 0);
+}
+
+TEST(CPUCachingAllocator, SetEnabled) {
+  CPUCachingAllocator::setEnabled(true);
+  ASSERT_TRUE(CPUCachingAllocator::isEnabled());
+  ASSERT_EQ(GetCPUAllocator(), CPUCachingAllocator::get());
+  CPUCachingAllocator::setEnabled(false);
+  ASSERT_FALSE(CPUCachingAllocator::isEnabled());
+  ASSERT_EQ(GetCPUAllocator(), GetDefaultCPUAllocator());
+}
+
+TEST(CPUCachingAllocator, SetEnabledRestoresPreviousAllocator) {
+  struct OtherAllocator final : at::Allocator {
+    at::DataPtr allocate(size_t nbytes) const override {
+      return GetDefaultCPUAllocator()->allocate(nbytes);
+    }
+    at::DeleterFnPtr raw_deleter() const override {
+      return GetDefaultCPUAllocator()->raw_deleter();
+    }
+  };
+  OtherAllocator other;
+  SetCPUAllocator(&other);
+
+  CPUCachingAllocator::setEnabled(true);
+  CPUCachingAllocator::setEnabled(true);
+  ASSERT_EQ(GetCPUAllocator(), CPUCachingAllocator::get());
+  // Default priority allocators don't replace the caching allocator
+  SetCPUAllocator(GetDefaultCPUAllocator());
+  ASSERT_EQ(GetCPUAllocator(), CPUCachingAllocator::get());
+
+  CPUCachingAllocator::setEnabled(false);
+  ASSERT_EQ(GetCPUAllocator(), &other);
+  // ...but do once it is disabled again
+  SetCPUAllocator(GetDefaultCPUAllocator());
+  ASSERT_EQ(GetCPUAllocator(), GetDefaultCPUAllocator());
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <c10/core/work_stealing_thread_pool.h>
+
+using namespace c10;
+
+TEST(WorkStealingThreadPool, RunsAllTasks) {
+  WorkStealingThreadPool pool(4);
+  ASSERT_EQ(pool.size(), 4);
+  ASSERT_FALSE(pool.inThreadPool());
+
+  std::atomic<int> counter{0};
+  for (int i = 0; i < 1000; ++i) {
+    pool.run([&counter]() { ++counter; });
+  }
+  pool.waitWorkComplete();
+  ASSERT_EQ(counter.load(), 1000);
+  ASSERT_EQ(pool.numAvailable(), 4);
+}
+
+TEST(WorkStealingThreadPool, WaitsForPoppedTasks) {
+  WorkStealingThreadPool pool(2);
+  std::atomic<int> counter{0};
+  // A task that was popped but has not started yet must still be waited
+  // for.
+  for (int i = 0; i < 200; ++i) {
+    pool.run([&counter]() {
+      std::this_thread::sleep_for(std::chrono::microseconds(10));
+      ++counter;
+    });
+    pool.waitWorkComplete();
+    ASSERT_EQ(counter.load(), i + 1);
+  }
+}
+
+TEST(WorkStealingThreadPool, NestedTasks) {
+  WorkStealingThreadPool pool(3);
+  std::atomic<int> counter{0};
+  std::atomic<int> in_pool{0};
+  for (int i = 0; i < 10; ++i) {
+    pool.run([&]() {
+      in_pool += pool.inThreadPool();
+      // Tasks spawned by a worker land on its own deque and get stolen by
+      // the idle workers.
+      for (int j = 0; j < 100; ++j) {
+        pool.run([&counter]() { ++counter; });
+      }
+    });
+  }
+  pool.waitWorkComplete();
+  ASSERT_EQ(counter.load(), 1000);
+  ASSERT_EQ(in_pool.load(), 10);
+}
+
+TEST(WorkStealingThreadPool, ExceptionInTask) {
+  WorkStealingThreadPool pool(2);
+  std::atomic<int> counter{0};
+  pool.run([]() { throw std::runtime_error("task failure"); });
+  pool.run([&counter]() { ++counter; });
+  pool.waitWorkComplete();
+  ASSERT_EQ(counter.load(), 1);
+}
@@ -6,6 +6,8 @@ C10_DEFINE_bool(caffe2_cpu_numa_enabled, false, "Use NUMA whenever possible.");
 #include <numa.h>
 #include <numaif.h>
 #include <unistd.h>
+#include <cstdlib>
+#include <cstring>
 #define C10_ENABLE_NUMA
 #endif
 
@@ -16,7 +18,16 @@ namespace c10 {
 
 #ifdef C10_ENABLE_NUMA
 bool IsNUMAEnabled() {
-  return FLAGS_caffe2_cpu_numa_enabled && numa_available() >= 0;
+  // Setting PYTORCH_CPU_NUMA=1 has the same effect as the flag, for
+  // processes that do not parse command line flags.
+  static const bool env_enabled = [] {
+    const char* value = std::getenv("PYTORCH_CPU_NUMA");
+    return value && std::strcmp(value, "1") == 0;
+  }();
+  // numa_available() is a system call, and this is called on every
+  // allocation.
+  static const bool available = numa_available() >= 0;
+  return (FLAGS_caffe2_cpu_numa_enabled || env_enabled) && available;
 }
 
 void NUMABind(int numa_node_id) {
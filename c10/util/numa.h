@@ -8,7 +8,8 @@ C10_DECLARE_bool(caffe2_cpu_numa_enabled);
 namespace c10 {
 
 /**
- * Check whether NUMA is enabled
+ * Check whether NUMA is enabled, either with the caffe2_cpu_numa_enabled
+ * flag or by setting the PYTORCH_CPU_NUMA=1 environment variable
  */
 C10_API bool IsNUMAEnabled();
 
@@ -110,6 +110,16 @@ if(INTERN_BUILD_ATEN_OPS)
     endif(MSVC)
   endif(CXX_AVX2_FOUND)
 
+  if(CXX_AVX512_FOUND)
+    set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DHAVE_AVX512_CPU_DEFINITION")
+    list(APPEND CPU_CAPABILITY_NAMES "AVX512")
+    if(MSVC)
+      list(APPEND CPU_CAPABILITY_FLAGS "${OPT_FLAG}/arch:AVX512")
+    else(MSVC)
+      list(APPEND CPU_CAPABILITY_FLAGS "${OPT_FLAG} -mavx512f -mavx512bw -mavx512vl -mavx512dq -mfma")
+    endif(MSVC)
+  endif(CXX_AVX512_FOUND)
+
   list(LENGTH CPU_CAPABILITY_NAMES NUM_CPU_CAPABILITY_NAMES)
   math(EXPR NUM_CPU_CAPABILITY_NAMES "${NUM_CPU_CAPABILITY_NAMES}-1")
 
@@ -128,6 +138,15 @@ if(INTERN_BUILD_ATEN_OPS)
       else(MSVC)
         set(EXTRA_FLAGS "-DCPU_CAPABILITY=${CPU_CAPABILITY} -DCPU_CAPABILITY_${CPU_CAPABILITY}")
       endif(MSVC)
+      # The quantized Vec256 types only have 256-bit implementations, so the
+      # AVX512 build of the quantized kernels uses the AVX2 vectors.
+      if(("${NAME}" MATCHES "^native/quantized/cpu/kernels/") AND ("${CPU_CAPABILITY}" STREQUAL "AVX512"))
+        if(MSVC)
+          set(EXTRA_FLAGS "/DCPU_CAPABILITY=AVX512 /DCPU_CAPABILITY_AVX2")
+        else(MSVC)
+          set(EXTRA_FLAGS "-DCPU_CAPABILITY=AVX512 -DCPU_CAPABILITY_AVX2")
+        endif(MSVC)
+      endif()
       # Disable certain warnings for GCC-9.X
       if(CMAKE_COMPILER_IS_GNUCXX AND (CMAKE_CXX_COMPILER_VERSION VERSION_GREATER 9.0.0))
         if(("${NAME}" STREQUAL "native/cpu/GridSamplerKernel.cpp") AND ("${CPU_CAPABILITY}" STREQUAL "DEFAULT"))
@@ -1,9 +1,46 @@
 #include "test/cpp/jit/test_base.h"
 #include "test/cpp/jit/test_utils.h"
 
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/runtime/instruction.h>
+
+#include <sstream>
+
 namespace torch {
 namespace jit {
 
+namespace {
+
+// %y is stored and loaded twice; the list is built for aten::cat
+const auto superinstructions_graph = R"IR(
+  graph(%a : Tensor, %b : Tensor, %n : int):
+    %zero : int = prim::Constant[value=0]()
+    %one : int = prim::Constant[value=1]()
+    %true : bool = prim::Constant[value=1]()
+    %x : Tensor = prim::Loop(%n, %true, %a)
+      block0(%i : int, %acc : Tensor):
+        %y : Tensor = aten::add(%acc, %b, %one)
+        %z : Tensor = aten::mul(%y, %y)
+        -> (%true, %z)
+    %l : Tensor[] = prim::ListConstruct(%x, %b)
+    %c : Tensor = aten::cat(%l, %zero)
+    return (%c)
+)IR";
+
+std::string codeString(const Code& code) {
+  std::ostringstream ss;
+  ss << code;
+  return ss.str();
+}
+
+Stack runCode(const Code& code, Stack stack) {
+  InterpreterState interp(code);
+  interp.run(stack);
+  return stack;
+}
+
+} // namespace
+
 void testInterp() {
   constexpr int batch_size = 4;
   constexpr int input_size = 256;
@@ -27,5 +64,57 @@ void testInterp() {
   ASSERT_TRUE(exactlyEqual(outputs[0], hx));
   ASSERT_TRUE(exactlyEqual(outputs[1], cx));
 }
+
+void testInterpSuperinstructions() {
+  auto graph = std::make_shared<Graph>();
+  parseIR(superinstructions_graph, graph.get());
+  Code code(graph, "");
+  testing::FileCheck()
+      .check("LOAD_OP_STORE")
+      ->check("LIST_CONSTRUCT_OP")
+      ->run(codeString(code));
+  // the bytecode, e.g. as exported for mobile, has no superinstructions
+  for (const Instruction& inst : code.instructions()) {
+    ASSERT_TRUE(
+        inst.op != LOAD_OP_STORE && inst.op != GET_ATTR_CHAIN &&
+        inst.op != LIST_CONSTRUCT_OP);
+  }
+
+  getSuperinstructionsEnabled() = false;
+  Code unfused_code(graph, "");
+  getSuperinstructionsEnabled() = true;
+  testing::FileCheck()
+      .check_not("LOAD_OP_STORE")
+      ->check_not("LIST_CONSTRUCT_OP")
+      ->run(codeString(unfused_code));
+
+  auto a = at::randn({2, 3});
+  auto b = at::randn({2, 3});
+  auto x = a;
+  for (int i = 0; i < 3; i++) {
+    x = (x + b) * (x + b);
+  }
+  auto expected = at::cat({x, b}, 0);
+  for (const Code* c : {&code, &unfused_code}) {
+    auto outputs = runCode(*c, {a, b, 3});
+    ASSERT_EQ(outputs.size(), 1);
+    ASSERT_TRUE(outputs[0].toTensor().equal(expected));
+  }
+
+  Module sub("sub");
+  sub.register_attribute("scale", IntType::get(), 3);
+  Module m("m");
+  m.register_module("sub", sub);
+  m.define(R"JIT(
+    def forward(self, x: int) -> int:
+      return self.sub.scale * x
+  )JIT");
+  Code method_code(m.get_method("forward").graph(), "forward");
+  testing::FileCheck().check("GET_ATTR_CHAIN")->run(codeString(method_code));
+  auto outputs = runCode(method_code, {m._ivalue(), 5});
+  ASSERT_EQ(outputs.size(), 1);
+  ASSERT_EQ(outputs[0].toInt(), 15);
+}
+
 } // namespace jit
 } // namespace torch
@@ -0,0 +1,129 @@
+#include <test/cpp/jit/test_base.h>
+
+#include <ATen/ATen.h>
+
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/ir/irparser.h>
+#include <torch/csrc/jit/passes/freeze_module.h>
+#include <torch/csrc/jit/runtime/static/impl.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// %2, %4 and %5 are intermediates written by out variants; %4 and %5 stay
+// alive through the list %6
+const auto static_runtime_graph = R"IR(
+  graph(%a : Tensor, %b : Tensor, %w : Tensor):
+    %alpha : int = prim::Constant[value=1]()
+    %dim : int = prim::Constant[value=1]()
+    %2 : Tensor = aten::mm(%a, %w)
+    %3 : Tensor = aten::add(%2, %b, %alpha)
+    %4 : Tensor = aten::relu(%3)
+    %5 : Tensor = aten::tanh(%4)
+    %6 : Tensor[] = prim::ListConstruct(%4, %5)
+    %7 : Tensor = aten::cat(%6, %dim)
+    return (%7, %3)
+)IR";
+
+std::vector<at::Tensor> staticRuntimeReference(
+    const at::Tensor& a,
+    const at::Tensor& b,
+    const at::Tensor& w) {
+  auto x = at::mm(a, w) + b;
+  auto y = at::relu(x);
+  return {at::cat({y, at::tanh(y)}, 1), x};
+}
+
+} // namespace
+
+void testStaticRuntime() {
+  auto graph = std::make_shared<Graph>();
+  parseIR(static_runtime_graph, graph.get());
+  StaticRuntime runtime(graph);
+
+  // %3 and %7 are graph outputs
+  ASSERT_EQ(runtime.num_managed_tensors(), 3);
+
+  // Repeated runs reuse the arena; a larger shape grows it
+  for (int64_t rows : {4, 4, 16, 16, 8}) {
+    auto a = at::randn({rows, 8});
+    auto b = at::randn({rows, 5});
+    auto w = at::randn({8, 5});
+    auto outputs = runtime.run(std::vector<at::Tensor>{a, b, w});
+    auto expected = staticRuntimeReference(a, b, w);
+    ASSERT_EQ(outputs.size(), 2);
+    for (size_t i = 0; i < outputs.size(); i++) {
+      ASSERT_TRUE(outputs[i].allclose(expected[i]));
+    }
+    ASSERT_TRUE(runtime.managed_bytes() >= rows * 5 * sizeof(float));
+  }
+
+  // Outputs of one run are not overwritten by the next
+  auto a = at::randn({2, 8});
+  auto b = at::randn({2, 5});
+  auto w = at::randn({8, 5});
+  auto first = runtime.run(std::vector<at::Tensor>{a, b, w});
+  auto first_copy = first[0].clone();
+  runtime.run(std::vector<at::Tensor>{a * 2, b, w});
+  ASSERT_TRUE(first[0].equal(first_copy));
+}
+
+void testStaticRuntimeCUDA() {
+  auto graph = std::make_shared<Graph>();
+  parseIR(static_runtime_graph, graph.get());
+  StaticRuntime runtime(graph);
+
+  // Only CPU tensors are placed in the arena, also when the inputs move
+  // between devices
+  bool ran_on_cpu = false;
+  for (auto device : {at::kCUDA, at::kCUDA, at::kCPU, at::kCUDA}) {
+    auto a = at::randn({4, 8}, device);
+    auto b = at::randn({4, 5}, device);
+    auto w = at::randn({8, 5}, device);
+    auto outputs = runtime.run(std::vector<at::Tensor>{a, b, w});
+    auto expected = staticRuntimeReference(a, b, w);
+    ASSERT_EQ(outputs.size(), 2);
+    for (size_t i = 0; i < outputs.size(); i++) {
+      ASSERT_EQ(outputs[i].device().type(), device);
+      ASSERT_TRUE(outputs[i].allclose(expected[i]));
+    }
+    if (device == at::kCPU) {
+      ran_on_cpu = true;
+    }
+    if (ran_on_cpu) {
+      ASSERT_TRUE(runtime.managed_bytes() >= 4 * 5 * sizeof(float));
+    } else {
+      ASSERT_EQ(runtime.managed_bytes(), 0);
+    }
+  }
+}
+
+void testStaticRuntimeModule() {
+  Module m("m");
+  m.register_parameter("weight", at::randn({4, 3}), false);
+  m.register_parameter("bias", at::randn({4}), false);
+  m.define(R"(
+    def forward(self, x):
+      h = torch.sigmoid(torch.addmm(self.bias, x, self.weight.t()))
+      return h.sum(1, keepdim=True) * x
+  )");
+  auto frozen = freeze_module(m);
+  StaticRuntime runtime(frozen);
+
+  for (int64_t rows : {3, 7}) {
+    auto x = at::randn({rows, 3});
+    std::vector<IValue> inputs{x};
+    auto expected = m.forward(inputs).toTensor();
+    auto outputs = runtime.run(inputs);
+    ASSERT_EQ(outputs.size(), 1);
+    ASSERT_TRUE(outputs[0].toTensor().allclose(expected));
+  }
+
+  // Only frozen modules are supported
+  ASSERT_THROWS_WITH(StaticRuntime{m}, "frozen module");
+}
+
+} // namespace jit
+} // namespace torch
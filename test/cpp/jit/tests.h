@@ -95,7 +95,10 @@ namespace jit {
   _(LiteInterpreterSetState)           \
   _(TorchbindIValueAPI)                \
   _(LiteInterpreterDict)               \
-  _(FusionAliasing)
+  _(FusionAliasing)                    \
+  _(StaticRuntime)                     \
+  _(StaticRuntimeModule)               \
+  _(InterpSuperinstructions)
 
 #if defined(USE_CUDA)
 #define TH_FORALL_TESTS_CUDA(_)   \
@@ -105,6 +108,7 @@ namespace jit {
   _(GraphExecutor)                \
   _(ModuleConversion)             \
   _(Interp)                       \
+  _(StaticRuntimeCUDA)            \
   _(GPU_IrGraphGenerator)         \
   _(GPU_FusionDispatch)           \
   _(GPU_FusionClear)              \
@@ -174,7 +178,8 @@ namespace jit {
   _(Fusion)                     \
   _(GraphExecutor)              \
   _(ModuleConversion)           \
-  _(Interp)
+  _(Interp)                     \
+  _(StaticRuntimeCUDA)
 #endif
 
 #define DECLARE_JIT_TEST(name) void test##name();
@@ -1213,6 +1213,74 @@ void testLLVMDynamicShape2D() {
   testWithSize(37, 11);
 }
 
+void testLLVMParallelDynamicShape2D() {
+  KernelScope kernel_scope;
+  auto testWithSize = [](int32_t M, int32_t N) {
+    VarHandle m("m", kInt);
+    VarHandle n("n", kInt);
+    Buffer a(BufHandle("a", {m, n}, kFloat));
+    Buffer b(BufHandle("b", {n}, kFloat));
+    Tensor* c = Compute(
+        "c", {{m, "m"}, {n, "n"}}, [&](const VarHandle& i, const VarHandle& j) {
+          return a(i, j) + b(j);
+        });
+    LoopNest l({c});
+    std::vector<For*> loops = l.getLoopStmtsFor(c);
+    l.parallelize(loops[0]);
+    l.prepareForCodegen();
+    Stmt* s = l.root_stmt();
+    LLVMCodeGen cg(s, {a, b, c, m, n});
+    std::vector<float> aData(M * N);
+    std::iota(aData.begin(), aData.end(), 0);
+    std::vector<float> bData(N);
+    std::iota(bData.begin(), bData.end(), 0);
+    std::vector<float> cData(M * N, 0.0f);
+    std::vector<float> cRef(M * N);
+    for (int i = 0; i < M; i++) {
+      for (int j = 0; j < N; j++) {
+        cRef[i * N + j] = aData[i * N + j] + bData[j];
+      }
+    }
+    cg.call({aData, bData, cData, M, N});
+    ExpectAllNear(cData, cRef, 1e-7);
+  };
+  testWithSize(1, 8);
+  testWithSize(64, 32);
+  testWithSize(37, 11);
+}
+
+void testLLVMParallelInnerLoop() {
+  KernelScope kernel_scope;
+  const int M = 8;
+  const int N = 300;
+  Buffer a(BufHandle("a", {M, N}, kFloat));
+  Tensor* c = Compute(
+      "c", {{M, "i"}, {N, "j"}}, [&](const VarHandle& i, const VarHandle& j) {
+        return a(i, j) * cast<float>(i + 1);
+      });
+  LoopNest l({c});
+  std::vector<For*> loops = l.getLoopStmtsFor(c);
+  // The body of the parallel loop uses the index of the serial one
+  l.parallelize(loops[1], 16);
+  ASSERT_TRUE(loops[1]->loop_options().is_parallel());
+  ASSERT_EQ(loops[1]->loop_options().parallel_grain_size(), 16);
+  l.prepareForCodegen();
+  Stmt* s = IRSimplifier::simplify(l.root_stmt());
+  LLVMCodeGen cg(s, {a, c});
+
+  PaddedBuffer<float> a_v(M, N, "a_v");
+  PaddedBuffer<float> c_v(M, N, "c_v");
+  PaddedBuffer<float> c_ref(M, N, "c_ref");
+  for (int i = 0; i < M; i++) {
+    for (int j = 0; j < N; j++) {
+      a_v(i, j) = i * N + j;
+      c_ref(i, j) = a_v(i, j) * (i + 1);
+    }
+  }
+  cg.call({a_v, c_v});
+  ExpectAllNear(c_v, c_ref, 1e-5);
+}
+
 void testLLVMEmptyStmt() {
   KernelScope kernel_scope;
   Stmt* s = new Block({});
@@ -3248,6 +3248,25 @@ class TestONNXRuntime(unittest.TestCase):
         y = torch.empty(3, 2, 7, dtype=torch.long).random_(5)
         self._crossentropyloss(x, y)
 
+    @skipIfUnsupportedMinOpsetVersion(12)
+    def test_cross_entropy_loss_op(self):
+        # scripted or C++ models call the fused op directly
+        class CrossEntropyLossOp(torch.nn.Module):
+            def __init__(self, weight, reduction, ignore_index):
+                super(CrossEntropyLossOp, self).__init__()
+                self.weight = weight
+                self.reduction = reduction
+                self.ignore_index = ignore_index
+
+            def forward(self, input, target):
+                return torch._C._nn.cross_entropy_loss(input, target, self.weight, self.reduction,
+                                                       self.ignore_index)
+
+        x = torch.randn(3, 5)
+        y = torch.empty(3, dtype=torch.long).random_(5)
+        for weight, reduction, ignore_index in itertools.product([None, torch.randn(5)], [0, 1, 2], [-100, 1]):
+            self.run_test(CrossEntropyLossOp(weight, reduction, ignore_index), input=(x, y))
+
     def _crossentropyloss(self, x, y):
         class CrossEntropyLossNone(torch.nn.Module):
             def __init__(self):
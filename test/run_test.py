@@ -54,6 +54,9 @@ TESTS = [
     'test_vulkan',
     'test_quantization',
     'test_sparse',
+    'test_sparse_csr',
+    'test_fused_pointwise',
+    'test_tensor_arena',
     'test_serialization',
     'test_show_pickle',
     'test_torch',
@@ -0,0 +1,113 @@
+import torch
+
+from torch.testing._internal.common_utils import TestCase, run_tests, load_tests
+from torch.utils.fused_pointwise import defer, DeferredTensor
+
+# load_tests from torch.testing._internal.common_utils is used to automatically filter tests for
+# sharding on sandcastle. This line silences flake warnings
+load_tests = load_tests
+
+
+class TestFusedPointwise(TestCase):
+
+    def test_fused_op(self):
+        # op codes as in FusedPointwiseOp
+        for dtype in [torch.float, torch.double]:
+            x = torch.randn(37, 11, dtype=dtype)
+            a = torch.randn(37, 11, dtype=dtype)
+            b = torch.rand(37, 11, dtype=dtype) + 0.5
+            ops = [2, 0, 1, 3, 4, 5, 6, 7, 8, 9]
+            scalars = [0., 2., 0.5, 0., 1., 3., 4., -1., 1., 0.]
+            result = torch._fused_pointwise(x, [a, b, a, b], ops, scalars)
+            expected = ((x * a).add(b, alpha=2).sub(a, alpha=0.5) / b + 1) * 3 / 4
+            expected = expected.clamp(-1, 1).relu()
+            self.assertEqual(result, expected)
+
+            ops = list(range(10, 18))
+            result = torch._fused_pointwise(b, [], ops, [0.] * len(ops))
+            expected = b.sigmoid().tanh().exp().log().neg().abs().sqrt().reciprocal()
+            self.assertEqual(result, expected)
+
+    def test_fused_op_strided(self):
+        x = torch.randn(20, 30)
+        a = torch.randn(30, 20).t()
+        b = torch.randn(30)
+        out = torch.empty(30, 20).t()
+        torch._fused_pointwise(x, [a, b], [0, 2], [1., 0.], out=out)
+        self.assertEqual(out, (x + a) * b)
+
+        # a single pass can write back into its input
+        expected = x.clone()
+        expected[:, ::2] = expected[:, ::2].mul(2).relu()
+        torch._fused_pointwise(x[:, ::2], [], [5, 9], [2., 0.], out=x[:, ::2])
+        self.assertEqual(x, expected)
+
+    def test_fused_op_errors(self):
+        x = torch.randn(4)
+        with self.assertRaisesRegex(RuntimeError, "float or double"):
+            torch._fused_pointwise(x.long(), [], [9], [0.])
+        with self.assertRaisesRegex(RuntimeError, "unknown op"):
+            torch._fused_pointwise(x, [], [18], [0.])
+        with self.assertRaisesRegex(RuntimeError, "one scalar per op"):
+            torch._fused_pointwise(x, [], [9, 9], [0.])
+        with self.assertRaisesRegex(RuntimeError, "operands"):
+            torch._fused_pointwise(x, [], [0], [1.])
+
+    def test_chain(self):
+        x = torch.randn(100, 33)
+        a = torch.randn(100, 33)
+        d = defer(x).mul(2).add(a, alpha=3).sub(1).div(4).clamp(min=-0.5).sigmoid()
+        self.assertIsInstance(d, DeferredTensor)
+        expected = x.mul(2).add(a, alpha=3).sub(1).div(4).clamp(min=-0.5).sigmoid()
+        self.assertEqual(d.shape, x.shape)
+        self.assertEqual(d.materialize(), expected)
+
+        d = (defer(x) * a + 2) / 3 - a
+        self.assertEqual(d.materialize(), (x * a + 2) / 3 - a)
+        d = 1 - defer(x).abs()
+        self.assertEqual(d.materialize(), 1 - x.abs())
+
+    def test_inplace(self):
+        x = torch.randn(64)
+        b = torch.randn(64)
+        x_copy = x.clone()
+        d = defer(x)
+        y = d.mul(2)
+        self.assertIs(d.add_(b).relu_(), d)
+        # x is written when the chain runs, after y has read it
+        self.assertEqual(x, x_copy)
+        self.assertEqual(y.materialize(), x_copy.mul(2))
+        self.assertIs(d.materialize(), x)
+        self.assertEqual(x, x_copy.add(b).relu())
+
+        # an operand aliasing the written tensor sees the pending steps
+        x = x_copy.clone()
+        d = defer(x)
+        d.mul_(2)
+        d += x
+        d.materialize()
+        self.assertEqual(x, x_copy * 4)
+
+    def test_flush_on_other_ops(self):
+        x = torch.randn(16, 8)
+        w = torch.randn(8, 4)
+        d = defer(x).tanh().mul(3)
+        self.assertEqual(d.sum(), x.tanh().mul(3).sum())
+        self.assertEqual(torch.mm(d, w), torch.mm(x.tanh().mul(3), w))
+        self.assertEqual(torch.relu(defer(x).neg()).materialize(), x.neg().relu())
+
+    def test_eager_fallback(self):
+        # broadcasting, integer and autograd inputs run eagerly
+        x = torch.randn(5, 3)
+        b = torch.randn(3)
+        self.assertEqual(defer(x).add(b).exp().materialize(), x.add(b).exp())
+        i = torch.arange(6)
+        self.assertEqual(defer(i).mul(2).add(1).materialize(), i * 2 + 1)
+        r = torch.randn(5, requires_grad=True)
+        out = defer(r).mul(2).sigmoid().materialize()
+        out.sum().backward()
+        self.assertEqual(r.grad, (2 * r).sigmoid() * (1 - (2 * r).sigmoid()) * 2)
+
+
+if __name__ == '__main__':
+    run_tests()
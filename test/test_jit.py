@@ -5241,6 +5241,69 @@ a")
             bailout_graph_str = str(my_unsqueeze.graph_for(a))
             FileCheck().check_count("prim::BailOut", 2).run(bailout_graph_str)
 
+    @unittest.skipIf(GRAPH_EXECUTOR != ProfilingMode.PROFILING, "skip if profiling isn't enabled")
+    def test_profile_cache(self):
+        src = dedent("""
+            def f(x, y):
+                return (x + y) * y
+        """)
+        a, b = torch.rand(2, 3), torch.rand(2, 3)
+
+        with enable_profiling_mode_for_profiling_tests(), tempfile.TemporaryDirectory() as cache_dir:
+            old_cache_dir = torch._C._jit_set_profile_cache_dir(cache_dir)
+            try:
+                cu = torch.jit.CompilationUnit(src)
+                for _ in range(3):
+                    self.assertEqual(cu.f(a, b), (a + b) * b)
+                files = sorted(os.listdir(cache_dir))
+                self.assertEqual(len(files), 2)
+                plan, profile = (os.path.join(cache_dir, name) for name in files)
+                self.assertTrue(os.path.basename(plan).startswith("plan_"))
+                self.assertTrue(os.path.basename(profile).startswith("profile_"))
+
+                # a new executor for the same graph starts from the cached plan, without the profile
+                os.remove(profile)
+                cu = torch.jit.CompilationUnit(src)
+                self.assertEqual(cu.f(a, b), (a + b) * b)
+                graph = torch.jit.last_executed_optimized_graph()
+                FileCheck().check("prim::BailOut").run(graph)
+                FileCheck().check_not("prim::profile").run(graph)
+                self.assertEqual(sorted(os.listdir(cache_dir)), [os.path.basename(plan)])
+
+                # other shapes fail the guards of the cached plan
+                c, d = torch.rand(4), torch.rand(4)
+                self.assertEqual(cu.f(c, d), (c + d) * d)
+
+                # an invalid plan is ignored and stored again
+                with open(plan, "w") as f:
+                    f.write("garbage")
+                cu = torch.jit.CompilationUnit(src)
+                with warnings.catch_warnings(record=True) as w:
+                    warnings.simplefilter("always")
+                    for _ in range(3):
+                        self.assertEqual(cu.f(a, b), (a + b) * b)
+                self.assertTrue(any("invalid cached plan" in str(warning.message) for warning in w))
+                self.assertTrue(os.path.exists(plan) and os.path.exists(profile))
+
+                # without a plan, the cached profile skips the profiling runs
+                os.remove(plan)
+                cu = torch.jit.CompilationUnit(src)
+                self.assertEqual(cu.f(a, b), (a + b) * b)
+                FileCheck().check_not("prim::profile").run(torch.jit.last_executed_optimized_graph())
+
+                # an invalid profile is ignored
+                os.remove(plan)
+                with open(profile, "w") as f:
+                    f.write("garbage")
+                cu = torch.jit.CompilationUnit(src)
+                with warnings.catch_warnings(record=True) as w:
+                    warnings.simplefilter("always")
+                    self.assertEqual(cu.f(a, b), (a + b) * b)
+                self.assertTrue(any("invalid cached profile" in str(warning.message) for warning in w))
+                FileCheck().check("prim::profile").run(torch.jit.last_executed_optimized_graph())
+            finally:
+                torch._C._jit_set_profile_cache_dir(old_cache_dir)
+
     def test_resize_input_ops(self):
         # resize_ and resize_as resize the input tensor. because our shape analysis
         # is flow invariant, we set any Tensor that can alias a resized Tensor
@@ -3,6 +3,10 @@ from __future__ import division
 from __future__ import print_function
 from __future__ import unicode_literals
 
+import os
+import subprocess
+import sys
+import tempfile
 import unittest
 import torch
 import torch.nn as nn
@@ -16,6 +20,7 @@ from torch.testing._internal.jit_utils import JitTestCase, enable_cpu_fuser, _in
 from textwrap import dedent
 from itertools import product, permutations
 
+from te_utils import LLVMCodeGenCreated
 from test_jit import backward_graph, all_backward_graphs, get_lstm_inputs, get_milstm_inputs, \
     LSTMCellC, LSTMCellF, LSTMCellS, MiLSTMCell
 
@@ -24,6 +29,17 @@ if GRAPH_EXECUTOR == ProfilingMode.PROFILING:
     torch._C._jit_set_profiling_mode(True)
 
 
+def _llvm_enabled():
+    try:
+        torch._C._jit_get_trigger_value('llvm_codegen_created')
+        return True
+    except Exception:
+        return False
+
+
+LLVM_ENABLED = _llvm_enabled()
+
+
 def strip_profiling_nodes(nodes):
     profiling_opcodes = set(['prim::BailoutTemplate', 'prim::BailOut'])
     return [n for n in nodes if n.kind() not in profiling_opcodes]
@@ -897,6 +913,74 @@ class TestFuser(JitTestCase):
         self.assertGraphContainsExactly(
             ge.graph_for(*inputs), 'prim::FusionGroup', 0, consider_subgraphs=True)
 
+    @unittest.skipIf(IS_SANDCASTLE, "NYI: fuser CPU support for Sandcastle")
+    @unittest.skipIf(sys.platform == 'win32', "no kernel cache on Windows")
+    def test_kernel_cache_cpu(self):
+        # The cache directory is read once per process, so run the fused
+        # function in fresh processes. Only kernels built by the host compiler
+        # are cached, so the in-process lowering is turned off.
+        script = dedent("""
+            import sys
+            import torch
+            torch._C._jit_set_profiling_executor(False)
+            torch._C._jit_set_profiling_mode(False)
+            torch._C._jit_override_can_fuse_on_cpu(True)
+
+            @torch.jit.script
+            def f(x, y):
+                return (x + y).sigmoid() * 2
+
+            @torch.jit.script
+            def g(x, y):
+                return (x * y).tanh() - 1
+
+            x, y = torch.randn(4, 4), torch.randn(4, 4)
+            if len(sys.argv) > 1:
+                # Compiles another kernel first, so that f's kernel gets a
+                # different name from the per-process counter
+                for _ in range(3):
+                    g(x, y)
+            for _ in range(3):
+                out = f(x, y)
+            assert torch.allclose(out, (x + y).sigmoid() * 2)
+        """)
+        with tempfile.TemporaryDirectory() as cache_dir:
+            env = dict(os.environ, PYTORCH_FUSER_CACHE_DIR=cache_dir, PYTORCH_FUSER_DISABLE_LLVM='1')
+            subprocess.check_call([sys.executable, '-c', script], env=env)
+            kernels = sorted(os.listdir(cache_dir))
+            self.assertEqual(len(kernels), 1)
+            mtime = os.path.getmtime(os.path.join(cache_dir, kernels[0]))
+
+            # The second process loads the cached kernel
+            subprocess.check_call([sys.executable, '-c', script], env=env)
+            self.assertEqual(sorted(os.listdir(cache_dir)), kernels)
+            self.assertEqual(os.path.getmtime(os.path.join(cache_dir, kernels[0])), mtime)
+
+            # The key doesn't depend on the order kernels are compiled in
+            subprocess.check_call([sys.executable, '-c', script, 'g_first'], env=env)
+            self.assertEqual(len(os.listdir(cache_dir)), 2)
+            self.assertIn(kernels[0], os.listdir(cache_dir))
+            self.assertEqual(os.path.getmtime(os.path.join(cache_dir, kernels[0])), mtime)
+
+    @unittest.skipIf(IS_SANDCASTLE, "NYI: fuser CPU support for Sandcastle")
+    @unittest.skipIf(not LLVM_ENABLED, "requires a build with LLVM")
+    @enable_cpu_fuser
+    def test_in_process_kernel_cpu(self):
+        llvm_created = LLVMCodeGenCreated()
+
+        def f(x, y, z):
+            mask = x > y
+            a = torch.where(mask, x, y).clamp(min=-0.5, max=0.5)
+            b = (x * z).sigmoid() - y.tanh() * 2
+            return torch.cat([a.abs().sqrt(), torch.max(b, z)], dim=1)
+
+        x = torch.randn(4, 8)
+        y = torch.randn(8, 4).t()
+        z = torch.randn(4, 8)
+        ge = self.checkScript(f, (x, y, z))
+        self.assertAllFused(ge.graph_for(x, y, z))
+        self.assertGreater(llvm_created.elapsed_value(), 0)
+
     @unittest.skipIf(IS_SANDCASTLE, "NYI: fuser CPU support for Sandcastle")
     @enable_cpu_fuser
     def test_where_and_typing(self):
@@ -43,7 +43,7 @@ from torch.testing._internal.common_nn import NNTestCase, NewModuleTest, NewCrit
     ctcloss_reference, new_module_tests
 from torch.testing._internal.common_device_type import instantiate_device_type_tests, dtypes, \
     dtypesIfCUDA, skipCUDAIfNoCudnn, skipCUDAIfCudnnVersionLessThan, onlyCUDA, \
-    skipCUDAIfRocm, skipCUDAIf, skipCUDAIfNotRocm, largeCUDATensorTest, onlyOnCPUAndCUDA, \
+    skipCUDAIfRocm, skipCUDAIf, skipCUDAIfNotRocm, largeCUDATensorTest, onlyOnCPUAndCUDA, onlyCPU, \
     deviceCountAtLeast
 from torch.nn import MultiheadAttention
 
@@ -3055,6 +3055,136 @@ class TestNN(NNTestCase):
         self.assertTrue(a.ne(torch.arange(1, 7, dtype=a.dtype).view(2, 3)).all())
         self.assertTrue(a.norm(p=opts["norm_type"], dim=1).le(opts["max_norm"]).all())
 
+    def _embedding_bag_grouped_inputs(self, num_tables, dtype=torch.float, include_last_offset=False):
+        weights, inputs, offsets = [], [], []
+        for t in range(num_tables):
+            # skewed table sizes and bag lengths, including empty bags
+            num_rows = random.randint(1, 50)
+            dim = random.randint(1, 20)
+            bag_sizes = torch.randint(0, 3 if t % 2 else 30, (random.randint(1, 8),))
+            weights.append(torch.randn(num_rows, dim, dtype=torch.double).to(dtype))
+            inputs.append(torch.randint(0, num_rows, (int(bag_sizes.sum()),)))
+            o = torch.cat([bag_sizes.new_zeros(1), bag_sizes.cumsum(0)])
+            offsets.append(o if include_last_offset else o[:-1])
+        return weights, inputs, offsets
+
+    def test_embedding_bag_grouped(self):
+        for mode, include_last_offset, dtype in itertools.product(
+                ['sum', 'mean', 'max'], [False, True], [torch.float, torch.double]):
+            weights, inputs, offsets = self._embedding_bag_grouped_inputs(12, dtype, include_last_offset)
+            outputs = F.embedding_bag_grouped(inputs, weights, offsets, mode=mode,
+                                              include_last_offset=include_last_offset)
+            self.assertEqual(len(outputs), len(weights))
+            for output, weight, input, offset in zip(outputs, weights, inputs, offsets):
+                expected = F.embedding_bag(input, weight, offset, mode=mode,
+                                           include_last_offset=include_last_offset)
+                self.assertEqual(output, expected)
+
+        weights, inputs, offsets = self._embedding_bag_grouped_inputs(5)
+        per_sample_weights = [torch.randn(i.shape) for i in inputs]
+        outputs = F.embedding_bag_grouped(inputs, weights, offsets, per_sample_weights=per_sample_weights)
+        for output, weight, input, offset, psw in zip(outputs, weights, inputs, offsets, per_sample_weights):
+            self.assertEqual(output, F.embedding_bag(input, weight, offset, mode='sum',
+                                                     per_sample_weights=psw))
+
+    def test_embedding_bag_grouped_low_precision(self):
+        weights, inputs, offsets = self._embedding_bag_grouped_inputs(6)
+        for dtype in [torch.half, torch.bfloat16]:
+            outputs = F.embedding_bag_grouped(inputs, [w.to(dtype) for w in weights], offsets)
+            for output, weight, input, offset in zip(outputs, weights, inputs, offsets):
+                self.assertEqual(output.dtype, dtype)
+                expected = F.embedding_bag(input, weight.to(dtype).float(), offset, mode='sum')
+                self.assertEqual(output.float(), expected, atol=0.1, rtol=1e-2)
+
+        # 8-bit rowwise tables hold the scale and bias after every row and
+        # return float embeddings of the dequantized rows
+        packed = [torch.ops.quantized.embedding_bag_byte_prepack(w) for w in weights]
+        outputs = F.embedding_bag_grouped(inputs, packed, offsets, mode='mean')
+        for output, p, input, offset in zip(outputs, packed, inputs, offsets):
+            self.assertEqual(output.dtype, torch.float)
+            dequantized = torch.ops.quantized.embedding_bag_byte_unpack(p)
+            expected = F.embedding_bag(input, dequantized, offset, mode='mean')
+            self.assertEqual(output, expected)
+
+    def test_embedding_bag_grouped_autograd(self):
+        weights, inputs, offsets = self._embedding_bag_grouped_inputs(4)
+        weights = [w.requires_grad_() for w in weights]
+        outputs = F.embedding_bag_grouped(inputs, weights, offsets)
+        sum(o.sum() for o in outputs).backward()
+        for weight, input, offset in zip(weights, inputs, offsets):
+            expected = torch.zeros_like(weight)
+            expected.index_add_(0, input, torch.ones(input.numel(), weight.size(1), dtype=weight.dtype))
+            self.assertEqual(weight.grad, expected)
+
+    def test_embedding_bag_grouped_errors(self):
+        weights = [torch.randn(5, 3)]
+        with self.assertRaisesRegex(RuntimeError, "out of range"):
+            F.embedding_bag_grouped([torch.tensor([0, 5])], weights, [torch.tensor([0])])
+        with self.assertRaisesRegex(RuntimeError, "non-decreasing"):
+            F.embedding_bag_grouped([torch.tensor([0, 1])], weights, [torch.tensor([0, 2, 1])])
+        with self.assertRaisesRegex(RuntimeError, "as many indices and offsets"):
+            F.embedding_bag_grouped([torch.tensor([0, 1])], weights, [])
+
+    def _embedding_bag_backward_update_inputs(self, mode):
+        weight = torch.randn(30, 7, dtype=torch.double)
+        # repeated indices within and across bags, and an empty bag
+        input = torch.tensor([3, 5, 3, 0, 29, 5, 5, 12, 3])
+        offsets = torch.tensor([0, 3, 3, 6])
+        grad = torch.randn(offsets.numel(), weight.size(1), dtype=torch.double)
+        per_sample_weights = torch.randn(input.numel(), dtype=torch.double) if mode == 'sum' else None
+        ref = weight.clone().requires_grad_()
+        F.embedding_bag(input, ref, offsets, mode=mode, per_sample_weights=per_sample_weights).backward(grad)
+        touched = torch.zeros(weight.size(0), dtype=torch.bool)
+        touched[input] = True
+        return weight, input, offsets, grad, per_sample_weights, ref.grad, touched
+
+    def test_embedding_bag_backward_sgd(self):
+        for mode, weight_decay in itertools.product(['sum', 'mean'], [0, 0.1]):
+            weight, input, offsets, grad, psw, full_grad, touched = self._embedding_bag_backward_update_inputs(mode)
+            expected = weight.clone()
+            g = full_grad[touched] + weight_decay * weight[touched]
+            expected[touched] -= 0.5 * g
+            torch._embedding_bag_backward_sgd_(weight, grad, input, offsets, 0 if mode == 'sum' else 1, psw,
+                                               False, 0.5, weight_decay)
+            self.assertEqual(weight, expected)
+
+    def test_embedding_bag_backward_rowwise_adagrad(self):
+        for mode in ['sum', 'mean']:
+            weight, input, offsets, grad, psw, full_grad, touched = self._embedding_bag_backward_update_inputs(mode)
+            momentum = torch.rand(weight.size(0), dtype=torch.double)
+            expected_momentum = momentum.clone()
+            expected_momentum[touched] += full_grad[touched].pow(2).mean(1)
+            expected = weight.clone()
+            expected[touched] -= 0.1 * full_grad[touched] / (expected_momentum[touched].sqrt() + 1e-10).unsqueeze(1)
+            torch._embedding_bag_backward_rowwise_adagrad_(weight, momentum, grad, input, offsets,
+                                                           0 if mode == 'sum' else 1, psw, False, 0.1)
+            self.assertEqual(momentum, expected_momentum)
+            self.assertEqual(weight, expected)
+
+    def test_embedding_bag_backward_adam(self):
+        weight, input, offsets, grad, psw, _, _ = self._embedding_bag_backward_update_inputs('sum')
+        ref = weight.clone().requires_grad_()
+        optimizer = torch.optim.SparseAdam([ref], lr=0.01)
+        exp_avg = torch.zeros_like(weight)
+        exp_avg_sq = torch.zeros_like(weight)
+        for step in range(1, 4):
+            optimizer.zero_grad()
+            F.embedding_bag(input, ref, offsets, mode='sum', sparse=True, per_sample_weights=psw).backward(grad)
+            optimizer.step()
+            torch._embedding_bag_backward_adam_(weight, exp_avg, exp_avg_sq, grad, input, offsets, 0, psw,
+                                                False, step, 0.01)
+            self.assertEqual(weight, ref.detach())
+
+    def test_embedding_bag_backward_update_errors(self):
+        weight, input, offsets, grad, _, _, _ = self._embedding_bag_backward_update_inputs('max')
+        with self.assertRaisesRegex(RuntimeError, "only mode sum"):
+            torch._embedding_bag_backward_sgd_(weight, grad, input, offsets, 2, None, False, 0.1)
+        with self.assertRaisesRegex(RuntimeError, "out of range"):
+            torch._embedding_bag_backward_sgd_(weight, grad, input + 1, offsets, 0, None, False, 0.1)
+        with self.assertRaisesRegex(RuntimeError, "momentum"):
+            torch._embedding_bag_backward_rowwise_adagrad_(weight, torch.zeros(3, dtype=torch.double), grad,
+                                                           input, offsets, 0, None, False, 0.1)
+
     def test_fractional_max_pool2d(self):
         x = torch.randn(1, 2, 7, 7, requires_grad=True)
         samples = x.new(1, 2, 2).uniform_()
@@ -4666,6 +4796,31 @@ class TestNN(NNTestCase):
 
             (hx + cx).sum().backward()
 
+    def test_rnn_fused_cell_cpu(self):
+        # Without gradients, LSTM and GRU cells on CPU run their pointwise
+        # part as one fused kernel; compare with the autograd path, and use
+        # hidden sizes that are not multiples of the vector width.
+        for dtype, hidden_size, bidirectional in product(
+                (torch.float, torch.double), (5, 16, 37), (False, True)):
+            for module in (nn.LSTM, nn.GRU):
+                rnn = module(7, hidden_size, num_layers=2, bidirectional=bidirectional).to(dtype)
+                input = torch.randn(6, 4, 7, dtype=dtype)
+                expected, expected_hidden = rnn(input)
+                with torch.no_grad():
+                    actual, actual_hidden = rnn(input)
+                self.assertEqual(actual, expected)
+                self.assertEqual(actual_hidden, expected_hidden)
+
+            for module in (nn.LSTMCell, nn.GRUCell):
+                cell = module(7, hidden_size).to(dtype)
+                input = torch.randn(4, 7, dtype=dtype)
+                hx = torch.randn(4, hidden_size, dtype=dtype)
+                state = (hx, torch.randn(4, hidden_size, dtype=dtype)) if module is nn.LSTMCell else hx
+                expected = cell(input, state)
+                with torch.no_grad():
+                    actual = cell(input, state)
+                self.assertEqual(actual, expected)
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     def test_pack_sequence_batch_sizes_throw(self):
         with self.assertRaisesRegex(ValueError, r"batch_sizes should always be on CPU"):
@@ -11339,6 +11494,91 @@ class TestNNDeviceType(NNTestCase):
         helper(1, 16, 56, 56, out_channels=16, kernel_size=3, groups=1)
         helper(1, 16, 56, 56, out_channels=16, kernel_size=3, groups=16)
 
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_conv_cpu_nhwc(self, device, dtype):
+        def helper(n, c, h, w, out_channels, kernel_size, groups, stride=1, padding=0, dilation=1, bias=True):
+            input = torch.randint(-3, 3, (n, c, h, w), dtype=dtype, device=device)\
+                .to(memory_format=torch.channels_last)
+            input.requires_grad_()
+            conv = nn.Conv2d(c, out_channels, kernel_size, groups=groups, stride=stride,
+                             padding=padding, dilation=dilation, bias=bias)\
+                .to(device=device, dtype=dtype, memory_format=torch.channels_last)
+            for p in conv.parameters():
+                p.data = torch.randint_like(p, -3, 3)
+
+            # use FP64 channels-first conv as reference
+            ref_input = input.detach().clone().contiguous().double().requires_grad_()
+            ref_conv = nn.Conv2d(c, out_channels, kernel_size, groups=groups, stride=stride,
+                                 padding=padding, dilation=dilation, bias=bias)
+            ref_conv.load_state_dict(conv.state_dict())
+            ref_conv = ref_conv.to(device=device, dtype=torch.double, memory_format=torch.contiguous_format)
+
+            out = conv(input)
+            ref_out = ref_conv(ref_input)
+
+            grad = torch.randint_like(out, -3, 3)
+            ref_grad = grad.detach().clone().double().contiguous()
+
+            out.backward(grad)
+            ref_out.backward(ref_grad)
+
+            self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+            self.assertEqual(out, ref_out, exact_dtype=False)
+            self.assertEqual(conv.weight.grad, ref_conv.weight.grad, exact_dtype=False)
+            if bias:
+                self.assertEqual(conv.bias.grad, ref_conv.bias.grad, exact_dtype=False)
+            self.assertEqual(input.grad, ref_input.grad, exact_dtype=False)
+
+        # Test the native channels-last kernels: with mkldnn enabled, the float
+        # convolutions would go to mkldnn instead.
+        with torch.backends.mkldnn.flags(enabled=False):
+            helper(2, 8, 4, 4, out_channels=4, kernel_size=3, groups=1)
+            helper(2, 8, 4, 4, out_channels=8, kernel_size=3, groups=8)
+            helper(2, 8, 4, 4, out_channels=16, kernel_size=3, groups=8)
+            helper(2, 6, 7, 9, out_channels=9, kernel_size=(2, 3), groups=3, stride=(2, 1), padding=(1, 2))
+            helper(1, 5, 9, 7, out_channels=37, kernel_size=3, groups=1, padding=2, dilation=2, bias=False)
+            helper(1, 3, 5, 5, out_channels=3, kernel_size=5, groups=3, stride=3, padding=2, bias=False)
+            helper(1, 16, 56, 56, out_channels=16, kernel_size=3, groups=1)
+            helper(1, 16, 56, 56, out_channels=16, kernel_size=3, groups=16)
+
+            if dtype == torch.double:
+                input = torch.randn(2, 4, 5, 6, dtype=dtype, device=device)\
+                    .to(memory_format=torch.channels_last).requires_grad_()
+                for groups in [1, 2, 4]:
+                    weight = torch.randn(4, 4 // groups, 3, 2, dtype=dtype, device=device, requires_grad=True)
+                    bias = torch.randn(4, dtype=dtype, device=device, requires_grad=True)
+                    gradcheck(lambda i, w, b: F.conv2d(i, w, b, stride=(1, 2), padding=1, groups=groups),
+                              (input, weight, bias))
+                    gradgradcheck(lambda i, w, b: F.conv2d(i, w, b, stride=(1, 2), padding=1, groups=groups),
+                                  (input, weight, bias))
+
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_conv_cpu_nhwc_weight_update(self, device, dtype):
+        # Channels last convolutions cache their packed weights: in-place updates
+        # and new weights must be seen by the next call.
+        with torch.backends.mkldnn.flags(enabled=False):
+            for groups in [1, 8]:
+                conv = nn.Conv2d(8, 8, 3, padding=1, groups=groups).to(device=device, dtype=dtype)
+                input = torch.randn(2, 8, 6, 6, dtype=dtype, device=device).to(memory_format=torch.channels_last)
+
+                def check():
+                    with torch.no_grad():
+                        out = conv(input)
+                        ref_out = F.conv2d(input.contiguous(), conv.weight, conv.bias, padding=1, groups=groups)
+                    self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+                    self.assertEqual(out, ref_out)
+
+                check()
+                check()
+                with torch.no_grad():
+                    conv.weight.mul_(2)
+                    conv.bias.add_(1)
+                check()
+                conv.weight = nn.Parameter(torch.randn_like(conv.weight))
+                check()
+
     def _run_conv(self, layer, device, inp, grad, ref_conv, ref_input, ref_out,
                   input_format, weight_format, grad_format, output_format):
         conv = layer(inp.size(1), grad.size(1),
@@ -11504,6 +11744,46 @@ class TestNNDeviceType(NNTestCase):
         helper([2, 3, 5, 7])
         helper([2, 3, 5, 7, 9])
 
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_cross_entropy_loss_fused(self, device, dtype):
+        # 2D inputs on CPU use a fused kernel; compare it with log_softmax +
+        # nll_loss, including a large vocabulary whose rows are split in chunks
+        for n, c in [(15, 10), (2, 40000), (0, 5)]:
+            input = torch.randn(n, c, device=device, dtype=dtype) * 10
+            target = torch.randint(c, (n,), device=device)
+            if n > 2:
+                target[1] = -100
+            for weight in (None, torch.rand(c, device=device, dtype=dtype)):
+                for reduction in ('none', 'mean', 'sum'):
+                    x = input.clone().requires_grad_()
+                    x_ref = input.clone().requires_grad_()
+                    out = F.cross_entropy(x, target, weight, reduction=reduction)
+                    expected = F.nll_loss(F.log_softmax(x_ref, 1), target, weight, reduction=reduction)
+                    self.assertEqual(out, expected)
+
+                    grad = torch.randn_like(out)
+                    out.backward(grad)
+                    expected.backward(grad)
+                    self.assertEqual(x.grad, x_ref.grad)
+
+        # large logits keep the precision of log_softmax, see #11752
+        input = torch.tensor([[1e4, 1e4 + 1, 1e4 + 2]], device=device, dtype=dtype, requires_grad=True)
+        target = torch.tensor([0], device=device)
+        out = F.cross_entropy(input, target)
+        self.assertEqual(out, torch.tensor(2.4076, dtype=dtype), atol=1e-4, rtol=0)
+        out.backward()
+        self.assertEqual(input.grad, torch.tensor([[0.0900 - 1, 0.2447, 0.6652]], dtype=dtype), atol=1e-4, rtol=0)
+
+        input = torch.randn(4, 6, device=device, dtype=torch.double, requires_grad=True)
+        target = torch.tensor([0, 5, -100, 2], device=device)
+        weight = torch.rand(6, device=device, dtype=torch.double)
+        for reduction in ('none', 'mean', 'sum'):
+            gradgradcheck(lambda x: F.cross_entropy(x, target, weight, reduction=reduction), (input,))
+
+        with self.assertRaisesRegex(IndexError, 'out of bounds'):
+            F.cross_entropy(input, torch.tensor([0, 1, 6, 2], device=device))
+
     def test_softshrink_negative(self, device):
         input = torch.randn(5, device=device, requires_grad=True)
         m = torch.nn.Softshrink(-1)
@@ -0,0 +1,177 @@
+import torch
+
+import io
+import itertools
+import pickle
+from torch.testing._internal.common_utils import TestCase, run_tests, load_tests
+
+# load_tests from torch.testing._internal.common_utils is used to automatically filter tests for
+# sharding on sandcastle. This line silences flake warnings
+load_tests = load_tests
+
+
+class TestSparseCSR(TestCase):
+
+    def _gen_sparse_csr(self, size, nnz, dtype=torch.double):
+        rows, cols = size
+        nnz = min(nnz, rows * cols)
+        crow_indices = torch.zeros(rows + 1, dtype=torch.long)
+        col_indices = torch.zeros(nnz, dtype=torch.long)
+        if nnz > 0:
+            flat = torch.randperm(rows * cols)[:nnz].sort()[0]
+            col_indices = flat % cols
+            crow_indices[1:] = torch.bincount(flat // cols, minlength=rows).cumsum(0)
+        values = torch.randn(nnz, dtype=torch.double).to(dtype)
+        return torch.sparse_csr_tensor(crow_indices, col_indices, values, size)
+
+    def test_constructor(self):
+        crow_indices = [0, 2, 2, 3]
+        col_indices = [0, 2, 1]
+        x = torch.sparse_csr_tensor(crow_indices, col_indices, [1, 2, 3], [3, 3])
+        self.assertEqual(x.layout, torch.sparse_csr)
+        self.assertEqual(x.dtype, torch.int64)
+        self.assertEqual(x.shape, (3, 3))
+        self.assertEqual(x._nnz(), 3)
+        self.assertEqual(x.crow_indices(), torch.tensor(crow_indices))
+        self.assertEqual(x.col_indices(), torch.tensor(col_indices))
+        self.assertEqual(x.values(), torch.tensor([1, 2, 3]))
+
+        x = torch.sparse_csr_tensor(crow_indices, col_indices, [1., 2., 3.], dtype=torch.float32)
+        self.assertEqual(x.dtype, torch.float32)
+        # size is inferred from crow_indices and the largest column index
+        self.assertEqual(x.shape, (3, 3))
+
+    def test_constructor_invariants(self):
+        with self.assertRaisesRegex(RuntimeError, "crow_indices"):
+            torch.sparse_csr_tensor([1, 2, 2, 3], [0, 2, 1], [1., 2., 3.], [3, 3])
+        with self.assertRaisesRegex(RuntimeError, "crow_indices"):
+            torch.sparse_csr_tensor([0, 2, 1, 3], [0, 2, 1], [1., 2., 3.], [3, 3])
+        with self.assertRaisesRegex(RuntimeError, "crow_indices"):
+            torch.sparse_csr_tensor([0, 2, 2, 3], [0, 2], [1., 2.], [3, 3])
+        with self.assertRaisesRegex(RuntimeError, "crow_indices"):
+            torch.sparse_csr_tensor([0, 2, 3], [0, 2, 1], [1., 2., 3.], [3, 3])
+        with self.assertRaisesRegex(RuntimeError, "col_indices"):
+            torch.sparse_csr_tensor([0, 2, 2, 3], [0, 3, 1], [1., 2., 3.], [3, 3])
+        with self.assertRaisesRegex(RuntimeError, "col_indices"):
+            torch.sparse_csr_tensor([0, 2, 2, 3], [0, -1, 1], [1., 2., 3.], [3, 3])
+        with self.assertRaisesRegex(RuntimeError, "2-D"):
+            torch.sparse_csr_tensor([0, 2, 2, 3], [0, 2, 1], [1., 2., 3.], [3, 3, 1])
+
+    def test_dense_conversion(self):
+        for dtype in [torch.float, torch.double, torch.long, torch.cfloat]:
+            dense = torch.randn(7, 5, dtype=torch.double).to(dtype)
+            dense[dense.real.abs() < 0.5 if dtype.is_complex else dense.abs() < 0.5] = 0
+            csr = dense.to_sparse_csr()
+            self.assertEqual(csr.layout, torch.sparse_csr)
+            self.assertEqual(csr.dtype, dtype)
+            self.assertEqual(csr._nnz(), int((dense != 0).sum()))
+            self.assertEqual(csr.to_dense(), dense)
+
+        empty = torch.zeros(4, 0).to_sparse_csr()
+        self.assertEqual(empty.crow_indices(), torch.zeros(5, dtype=torch.long))
+        self.assertEqual(empty.to_dense(), torch.zeros(4, 0))
+
+    def test_coo_conversion(self):
+        dense = torch.randn(6, 9)
+        dense[dense.abs() < 0.7] = 0
+        coo = dense.to_sparse()
+        csr = coo.to_sparse_csr()
+        self.assertEqual(csr.to_dense(), dense)
+
+        back = csr.to_sparse()
+        self.assertEqual(back.layout, torch.sparse_coo)
+        self.assertTrue(back.is_coalesced())
+        self.assertEqual(back._indices(), coo.coalesce()._indices())
+        self.assertEqual(back.to_dense(), dense)
+
+        # an uncoalesced COO input is summed over duplicate entries
+        i = torch.tensor([[0, 1, 0, 1], [2, 0, 2, 1]])
+        v = torch.tensor([1., 2., 3., 4.])
+        coo = torch.sparse_coo_tensor(i, v, (2, 3))
+        self.assertEqual(coo.to_sparse_csr().to_dense(), coo.to_dense())
+
+        with self.assertRaisesRegex(RuntimeError, "2 sparse and 0 dense"):
+            torch.sparse_coo_tensor(i[:1], v, (2,)).to_sparse_csr()
+
+    def test_unsorted_columns(self):
+        # columns within a row need not be sorted
+        x = torch.sparse_csr_tensor([0, 3, 3], [2, 0, 1], [1., 2., 3.], [2, 3])
+        self.assertEqual(x.to_dense(), torch.tensor([[2., 3., 1.], [0., 0., 0.]]))
+        coo = x.to_sparse()
+        self.assertFalse(coo.is_coalesced())
+        self.assertEqual(coo.to_dense(), x.to_dense())
+
+    def test_matmul(self):
+        for dtype, (m, k, n), nnz in itertools.product(
+                [torch.float, torch.double, torch.cdouble],
+                [(10, 20, 30), (1, 5, 1), (50, 40, 3), (4, 0, 6)],
+                [0, 5, 100]):
+            csr = self._gen_sparse_csr((m, k), nnz, dtype)
+            dense_csr = csr.to_dense()
+            mat = torch.randn(k, n, dtype=torch.double).to(dtype)
+            vec = torch.randn(k, dtype=torch.double).to(dtype)
+            t = torch.randn(m, n, dtype=torch.double).to(dtype)
+            y = torch.randn(m, dtype=torch.double).to(dtype)
+
+            self.assertEqual(torch.mm(csr, mat), torch.mm(dense_csr, mat))
+            self.assertEqual(torch.mv(csr, vec), torch.mv(dense_csr, vec))
+            self.assertEqual(torch.addmm(t, csr, mat, beta=0.5, alpha=2),
+                             torch.addmm(t, dense_csr, mat, beta=0.5, alpha=2))
+            self.assertEqual(torch.addmv(y, csr, vec, beta=0.5, alpha=2),
+                             torch.addmv(y, dense_csr, vec, beta=0.5, alpha=2))
+
+            out = torch.empty(n, m, dtype=dtype).t()
+            torch.mm(csr, mat, out=out)
+            self.assertEqual(out, torch.mm(dense_csr, mat))
+
+    def test_addmm_beta_zero(self):
+        csr = self._gen_sparse_csr((5, 4), 8)
+        mat = torch.randn(4, 3)
+        t = torch.full((5, 3), float('nan'))
+        self.assertEqual(torch.addmm(t, csr, mat, beta=0), torch.mm(csr, mat))
+        self.assertEqual(torch.addmm(torch.randn(3), csr, mat, beta=0), torch.mm(csr, mat))
+
+    def test_matmul_skewed_rows(self):
+        # one row holds almost all specified elements, so the row chunks
+        # handed to the threads have very different row counts
+        dense = torch.zeros(1000, 64)
+        dense[3] = torch.randn(64)
+        dense[::7, ::5] = torch.randn(143, 13)
+        csr = dense.to_sparse_csr()
+        mat = torch.randn(64, 17)
+        self.assertEqual(torch.mm(csr, mat), torch.mm(dense, mat))
+        vec = torch.randn(64)
+        self.assertEqual(torch.mv(csr, vec), torch.mv(dense, vec))
+
+    def test_matmul_errors(self):
+        csr = self._gen_sparse_csr((5, 4), 8)
+        with self.assertRaisesRegex(RuntimeError, "size"):
+            torch.mm(csr, torch.randn(3, 2))
+        with self.assertRaisesRegex(RuntimeError, "dtype"):
+            torch.mm(csr, torch.randn(4, 2, dtype=torch.float))
+
+    def test_print(self):
+        x = torch.sparse_csr_tensor([0, 2, 2, 3], [0, 2, 1], [1., 2., 3.], [3, 3])
+        s = str(x)
+        self.assertIn('crow_indices=tensor([0, 2, 2, 3])', s)
+        self.assertIn('col_indices=tensor([0, 2, 1])', s)
+        self.assertIn('nnz=3', s)
+        self.assertIn('layout=torch.sparse_csr', s)
+
+    def test_pickle(self):
+        x = self._gen_sparse_csr((6, 7), 10)
+        y = pickle.loads(pickle.dumps(x))
+        self.assertEqual(y.layout, torch.sparse_csr)
+        self.assertEqual(y.to_dense(), x.to_dense())
+
+        buf = io.BytesIO()
+        torch.save(x, buf)
+        buf.seek(0)
+        y = torch.load(buf)
+        self.assertEqual(y.crow_indices(), x.crow_indices())
+        self.assertEqual(y.col_indices(), x.col_indices())
+        self.assertEqual(y.values(), x.values())
+
+
+if __name__ == '__main__':
+    run_tests()
@@ -0,0 +1,72 @@
+import torch
+
+from torch.testing._internal.common_utils import TestCase, run_tests, load_tests
+from torch.utils.tensor_arena import TensorArena
+
+# load_tests from torch.testing._internal.common_utils is used to automatically filter tests for
+# sharding on sandcastle. This line silences flake warnings
+load_tests = load_tests
+
+
+class TestTensorArena(TestCase):
+
+    def _in_arena(self, arena, t):
+        begin = arena.buffer.data_ptr()
+        end = begin + arena.buffer.numel() * arena.buffer.element_size()
+        return begin <= t.data_ptr() < end
+
+    def test_cat(self):
+        arena = TensorArena(1000)
+        tensors = [torch.randn(3, 4), torch.randn(5, 4), torch.randn(0, 4), torch.randn(2, 4)]
+        result = arena.cat(tensors)
+        self.assertEqual(result, torch.cat(tensors))
+        self.assertTrue(self._in_arena(arena, result))
+        self.assertEqual(arena.free, 1000 - 40)
+
+        tensors = [torch.randn(3, 2), torch.randn(3, 7).t().t()[:, :5], torch.randn(3, 1)]
+        result = arena.cat(tensors, dim=-1)
+        self.assertEqual(result, torch.cat(tensors, dim=-1))
+        self.assertTrue(self._in_arena(arena, result))
+        self.assertEqual(arena.free, 1000 - 40 - 24)
+
+        # 1-D empty tensors are skipped, as by torch.cat
+        tensors = [torch.randn(2, 3), torch.empty(0), torch.randn(1, 3)]
+        self.assertEqual(arena.cat(tensors), torch.cat(tensors))
+
+    def test_stack(self):
+        arena = TensorArena(1000, dtype=torch.double)
+        tensors = [torch.randn(4, 5, dtype=torch.double) for _ in range(6)]
+        for dim in [0, 1, 2, -1]:
+            result = arena.stack(tensors, dim)
+            self.assertEqual(result, torch.stack(tensors, dim))
+            self.assertTrue(self._in_arena(arena, result))
+        self.assertEqual(arena.free, 1000 - 4 * 120)
+
+    def test_dtype_conversion(self):
+        arena = TensorArena(100, dtype=torch.double)
+        tensors = [torch.randn(2, 3), torch.randn(4, 3, dtype=torch.double)]
+        result = arena.cat(tensors)
+        self.assertEqual(result.dtype, torch.double)
+        self.assertEqual(result, torch.cat([t.double() for t in tensors]))
+
+        arena = TensorArena(100, dtype=torch.long)
+        with self.assertRaisesRegex(RuntimeError, "can't be cast"):
+            arena.cat([torch.randn(2, 3)])
+        self.assertEqual(arena.free, 100)
+
+    def test_full_and_reset(self):
+        arena = TensorArena(10)
+        first = arena.cat([torch.ones(6)])
+        with self.assertRaisesRegex(RuntimeError, "does not fit"):
+            arena.cat([torch.ones(3), torch.ones(2)])
+        self.assertEqual(arena.free, 4)
+        arena.reset()
+        self.assertEqual(arena.free, 10)
+        second = arena.stack([torch.zeros(5), torch.zeros(5)])
+        self.assertEqual(second, torch.zeros(2, 5))
+        # the arena is reused, so the first result was overwritten
+        self.assertEqual(first, torch.zeros(6))
+
+
+if __name__ == '__main__':
+    run_tests()
@@ -24,14 +24,14 @@ from random import randrange
 from torch import multiprocessing as mp
 from torch.testing._internal.common_methods_invocations import tri_tests_args, run_additional_tri_tests, \
     _compare_trilu_indices
-from torch.testing._internal.common_utils import TestCase, iter_indices, TEST_NUMPY, TEST_SCIPY, TEST_MKL, \
+from torch.testing._internal.common_utils import TestCase, iter_indices, TEST_NUMPY, TEST_SCIPY, \
     TEST_LIBROSA, TEST_WITH_ROCM, run_tests, skipIfNoLapack, suppress_warnings, \
     IS_WINDOWS, NO_MULTIPROCESSING_SPAWN, do_test_dtypes, do_test_empty_full, \
     IS_SANDCASTLE, load_tests, slowTest, skipCUDANonDefaultStreamIf, skipCUDAMemoryLeakCheckIf, \
     BytesIOContext, skipIfRocm, torch_to_numpy_dtype_dict, skipIfNoSciPy, IS_MACOS, IS_PPC
 from multiprocessing.reduction import ForkingPickler
 from torch.testing._internal.common_device_type import instantiate_device_type_tests, \
-    skipCPUIfNoLapack, skipCPUIfNoMkl, skipCUDAIfNoMagma, skipCUDAIfRocm, skipCUDAIfNotRocm, onlyCUDA, onlyCPU, \
+    skipCPUIfNoLapack, skipCUDAIfNoMagma, skipCUDAIfRocm, skipCUDAIfNotRocm, onlyCUDA, onlyCPU, \
     dtypes, dtypesIfCUDA, dtypesIfCPU, deviceCountAtLeast, skipCUDAIf, precisionOverride, \
     PYTORCH_CUDA_MEMCHECK, largeCUDATensorTest, largeTensorTest, onlyOnCPUAndCUDA
 from typing import Dict, List, Tuple, Union
@@ -798,6 +798,44 @@ class AbstractTestCases:
             self.assertEqual(y[:, 0], range(100))
             self.assertEqual(y[:, 40], range(4000, 4100))
 
+        def test_copy_permute(self):
+            def reference(x, dims):
+                # Element by element through the last dimension of the result,
+                # which never takes the tiled permute path.
+                out = torch.empty(x.permute(dims).shape, dtype=x.dtype)
+                for idx in product(*[range(n) for n in out.shape[:-1]]):
+                    out[idx] = x.permute(dims)[idx].clone()
+                return out
+
+            cases = [
+                ((100, 100), (1, 0)),
+                ((3, 64, 65), (1, 2, 0)),
+                ((64, 65, 3), (2, 0, 1)),
+                ((2, 16, 33, 35), (0, 2, 3, 1)),
+                ((5, 6, 7, 8, 9), (4, 2, 0, 3, 1)),
+            ]
+            for dtype in [torch.bool, torch.uint8, torch.int16, torch.bfloat16, torch.float,
+                          torch.double, torch.complex64, torch.complex128]:
+                for shape, dims in cases:
+                    x = torch.randn(shape).mul(10).to(dtype)
+                    y = x.permute(dims).contiguous()
+                    self.assertTrue(y.is_contiguous())
+                    self.assertEqual(y, reference(x, dims), atol=0, rtol=0)
+
+            # NCHW <-> NHWC
+            x = torch.randn(4, 16, 30, 30)
+            y = x.contiguous(memory_format=torch.channels_last)
+            self.assertEqual(y, x, atol=0, rtol=0)
+            self.assertEqual(y.contiguous(), x, atol=0, rtol=0)
+
+            # Non-contiguous destination
+            x = torch.randn(80, 70)
+            out = torch.zeros(70, 100)
+            out[:, 10:90].copy_(x.t())
+            self.assertEqual(out[:, 10:90], x.t(), atol=0, rtol=0)
+            self.assertEqual(out[:, :10].abs().sum(), 0)
+            self.assertEqual(out[:, 90:].abs().sum(), 0)
+
         def test_device(self):
             cpu = torch.device('cpu')
             self.assertEqual('cpu', str(cpu))
@@ -2104,7 +2142,6 @@ class AbstractTestCases:
             _test_complex((50,), 2, lambda x: x.as_strided([5, 5, 2], [4, 2, 2]))
             _test_complex((50,), 2, lambda x: x.as_strided([5, 5, 2], [4, 3, 1]))
 
-        @unittest.skipIf(not TEST_MKL, "PyTorch is built without MKL support")
         def test_fft_ifft_rfft_irfft(self):
             self._test_fft_ifft_rfft_irfft(self)
 
@@ -4850,6 +4887,44 @@ tensor([[[1.+1.j, 1.+1.j, 1.+1.j,  ..., 1.+1.j, 1.+1.j, 1.+1.j],
         def test_parallel_info(self):
             torch.__config__.parallel_info()
 
+        def test_cpu_caching_allocator(self):
+            was_enabled = torch._C._cpu_isCachingAllocatorEnabled()
+            try:
+                torch._C._cpu_setCachingAllocatorEnabled(True)
+                self.assertTrue(torch._C._cpu_isCachingAllocatorEnabled())
+                torch._C._cpu_resetAccumulatedMemoryStats()
+                torch._C._cpu_resetPeakMemoryStats()
+
+                x = torch.empty(1 << 16, dtype=torch.uint8)
+                stats = torch._C._cpu_memoryStats()
+                self.assertGreaterEqual(stats["allocation"]["all"]["allocated"], 1)
+                self.assertGreaterEqual(stats["allocated_bytes"]["all"]["current"], 1 << 16)
+                self.assertGreaterEqual(stats["allocated_bytes"]["all"]["peak"], 1 << 16)
+                for key in ["num_thread_cache_hits", "num_alloc_retries", "num_ooms"]:
+                    self.assertIn(key, stats)
+                for key in ["allocation", "segment", "cached", "allocated_bytes", "reserved_bytes", "cached_bytes"]:
+                    self.assertEqual(set(stats[key]), {"all", "small_pool", "large_pool"})
+
+                # freed blocks are cached and returned to the system by empty_cache
+                del x
+                stats = torch._C._cpu_memoryStats()
+                self.assertGreaterEqual(stats["allocation"]["all"]["freed"], 1)
+                cached_bytes = stats["cached_bytes"]["all"]["current"]
+                self.assertGreaterEqual(cached_bytes, 1 << 16)
+                torch._C._cpu_emptyCache()
+                self.assertLess(torch._C._cpu_memoryStats()["cached_bytes"]["all"]["current"], cached_bytes)
+
+                torch._C._cpu_resetAccumulatedMemoryStats()
+                self.assertEqual(torch._C._cpu_memoryStats()["allocation"]["all"]["freed"], 0)
+
+                # disabling restores the previous allocator
+                torch._C._cpu_setCachingAllocatorEnabled(False)
+                self.assertFalse(torch._C._cpu_isCachingAllocatorEnabled())
+                with self.assertRaisesRegex(RuntimeError, "expects a bool"):
+                    torch._C._cpu_setCachingAllocatorEnabled(1)
+            finally:
+                torch._C._cpu_setCachingAllocatorEnabled(was_enabled)
+
         @slowTest
         def test_slow_test(self):
             # Just a smoketest to make sure our slowTest decorator works.
@@ -7156,6 +7231,42 @@ class TestTorchDeviceType(TestCase):
         self.assertEqual(a, b)
         self.assertEqual(w[:6], y.view(-1)[:6])
 
+    @onlyCPU
+    def test_cat_many_inputs(self, device):
+        # Contiguous inputs are copied together, the others one by one.
+        def reference(tensors, dim, dtype):
+            result_size = list(tensors[0].shape)
+            result_size[dim] = sum(t.shape[dim] for t in tensors)
+            result = torch.empty(result_size, dtype=dtype)
+            offset = 0
+            for t in tensors:
+                result.narrow(dim, offset, t.shape[dim]).copy_(t)
+                offset += t.shape[dim]
+            return result
+
+        for dtype in [torch.uint8, torch.bool, torch.int64, torch.half, torch.float, torch.complex128]:
+            for dim in range(3):
+                tensors = []
+                for i in range(3000):
+                    size = [3, 4, 5]
+                    size[dim] = i % 4
+                    t = torch.randn(size).mul(10).to(dtype)
+                    if i % 7 == 0:
+                        t = torch.randn(list(reversed(size))).mul(10).to(dtype).permute(2, 1, 0)
+                    tensors.append(t)
+                self.assertEqual(torch.cat(tensors, dim), reference(tensors, dim, dtype), atol=0, rtol=0)
+
+        # mixed dtypes, including inputs large enough for a parallel copy
+        tensors = [torch.randn(100, 64), torch.randn(1000, 64, dtype=torch.double),
+                   torch.randint(10, (5, 64)), torch.randn(64, 2000).t()]
+        self.assertEqual(torch.cat(tensors), reference(tensors, 0, torch.double), atol=0, rtol=0)
+
+        # channels_last inputs and output
+        tensors = [torch.randn(2, c, 5, 6).contiguous(memory_format=torch.channels_last) for c in range(1, 40)]
+        result = torch.cat(tensors, 1)
+        self.assertTrue(result.is_contiguous(memory_format=torch.channels_last))
+        self.assertEqual(result, reference(tensors, 1, torch.float), atol=0, rtol=0)
+
     def test_cat_out_channels_last(self, device):
         x = torch.randn((4, 3, 8, 8))
         y = torch.randn(x.shape)
@@ -7812,6 +7923,62 @@ class TestTorchDeviceType(TestCase):
         x_exp = torch.Tensor(solve(A.cpu().numpy(), b.cpu().numpy())).to(dtype=dtype, device=device)
         self.assertEqual(x, x_exp)
 
+    @onlyCPU
+    @unittest.skipIf(not TEST_NUMPY, "NumPy not found")
+    @dtypes(torch.float, torch.double)
+    def test_linalg_small_matrices_batched(self, device, dtype):
+        # Real matrices of up to 8 rows do not go through LAPACK on CPU, see
+        # [Note small matrix linear algebra]. Batch sizes cover partially
+        # filled groups of SIMD lanes.
+        from torch.testing._internal.common_utils import random_symmetric_pd_matrix
+
+        def lu_pivots(a):
+            # partial pivoting as in LAPACK's getrf, with 1-based pivots
+            a = a.copy()
+            n = a.shape[0]
+            pivots = []
+            for k in range(n):
+                p = k + int(np.argmax(np.abs(a[k:, k])))
+                pivots.append(p + 1)
+                a[[k, p]] = a[[p, k]]
+                a[k + 1:, k] /= a[k, k]
+                a[k + 1:, k + 1:] -= np.outer(a[k + 1:, k], a[k, k + 1:])
+            return pivots
+
+        tol = dict(atol=1e-3, rtol=1e-3) if dtype == torch.float else dict(atol=1e-10, rtol=1e-10)
+        for n, batch in product(range(1, 9), [(), (1,), (13,), (3, 7)]):
+            A = torch.randn(*batch, n, n, dtype=dtype, device=device) + n * torch.eye(n, dtype=dtype, device=device)
+            b = torch.randn(*batch, n, 3, dtype=dtype, device=device)
+            A_np = A.double().numpy()
+
+            x, LU = torch.solve(b, A)
+            self.assertEqual(x, torch.from_numpy(np.linalg.solve(A_np, b.double().numpy())).to(dtype), **tol)
+            self.assertEqual(A.inverse(), torch.from_numpy(np.linalg.inv(A_np)).to(dtype), **tol)
+
+            A = torch.randn(*batch, n, n, dtype=dtype, device=device)
+            LU, pivots = A.lu()
+            P, L, U = torch.lu_unpack(LU, pivots)
+            self.assertEqual(P.matmul(L).matmul(U), A, **tol)
+            self.assertEqual(pivots.reshape(-1, n).tolist(), [lu_pivots(a) for a in A.double().numpy().reshape(-1, n, n)])
+
+            S = random_symmetric_pd_matrix(n, *batch, dtype=dtype, device=device) + torch.eye(n, dtype=dtype, device=device)
+            for upper in (False, True):
+                C = torch.cholesky(S, upper=upper)
+                C_exp = torch.from_numpy(np.linalg.cholesky(S.double().numpy())).to(dtype)
+                self.assertEqual(C, C_exp.transpose(-2, -1) if upper else C_exp, **tol)
+
+        A = torch.randn(5, 4, 4, dtype=dtype, device=device)
+        A[2, :, 1] = 0
+        with self.assertRaisesRegex(RuntimeError, r'For batch 2: U\(2,2\) is zero'):
+            A.inverse()
+        with self.assertRaisesRegex(RuntimeError, r'For batch 2: U\(2,2\) is zero'):
+            torch.solve(torch.randn(5, 4, 1, dtype=dtype, device=device), A)
+        self.assertEqual(A.lu(get_infos=True)[2].tolist(), [0, 0, 2, 0, 0])
+        S = torch.eye(3, dtype=dtype, device=device).repeat(3, 1, 1)
+        S[1, 2, 2] = -1
+        with self.assertRaisesRegex(RuntimeError, r'For batch 1: U\(3,3\) is zero'):
+            torch.cholesky(S)
+
     @slowTest
     @skipCUDAIfNoMagma
     @skipCPUIfNoLapack
@@ -11612,6 +11779,54 @@ class TestTorchDeviceType(TestCase):
             self.assertTrue(y.is_contiguous())
             self.assertEqual(expected, actual)
 
+    @dtypes(torch.float, torch.double)
+    def test_cdist_topk(self, device, dtype):
+        def check(x, y, k, p, cosine):
+            if cosine:
+                dist = 1 - torch.nn.functional.cosine_similarity(x[:, None, :], y[None, :, :], dim=-1)
+            else:
+                dist = self._brute_cdist(x, y, p=p)
+            values, indices = torch.cdist_topk(x, y, k, p=p, cosine=cosine)
+            expected_values, _ = dist.topk(k, dim=-1, largest=False)
+            self.assertEqual(values, expected_values)
+            # indices may only differ between equal distances
+            self.assertEqual(dist.gather(1, indices), expected_values)
+
+        # the candidate rows are processed in tiles of 512
+        for r1, r2, m in [(1, 1, 3), (5, 7, 4), (70, 600, 10), (130, 1100, 3)]:
+            x = torch.randn(r1, m, device=device, dtype=dtype)
+            y = torch.randn(r2, m, device=device, dtype=dtype)
+            for k in [0, 1, min(r2, 5), r2]:
+                for p in [0, 1, 2, 1.5, float('inf')]:
+                    check(x, y, k, p, False)
+                check(x, y, k, 2, True)
+            # non-contiguous inputs
+            check(x.t().contiguous().t(), y.t().contiguous().t(), 1, 2, False)
+
+        # no columns: every distance is 0, ties go to the lower index
+        values, indices = torch.cdist_topk(torch.randn(3, 0, device=device, dtype=dtype),
+                                           torch.randn(4, 0, device=device, dtype=dtype), 2)
+        self.assertEqual(values, torch.zeros(3, 2, device=device, dtype=dtype))
+        self.assertEqual(indices, torch.tensor([[0, 1]] * 3, device=device))
+
+        # duplicate rows in x2 tie, and NaN distances sort last
+        x = torch.tensor([[0., 0.]], device=device, dtype=dtype)
+        y = torch.tensor([[1., 0.], [float('nan'), 0.], [0., 1.], [1., 0.]], device=device, dtype=dtype)
+        values, indices = torch.cdist_topk(x, y, 4, p=1)
+        self.assertEqual(indices, torch.tensor([[0, 2, 3, 1]], device=device))
+        self.assertTrue(values[0, 3].isnan())
+
+        with self.assertRaisesRegex(RuntimeError, "must be between 0 and the number of rows"):
+            torch.cdist_topk(x, y, 5)
+        with self.assertRaisesRegex(RuntimeError, "same number of columns"):
+            torch.cdist_topk(x, torch.randn(3, 3, device=device, dtype=dtype), 1)
+
+        if dtype == torch.double:
+            x = torch.randn(4, 3, device=device, dtype=dtype, requires_grad=True)
+            y = torch.randn(6, 3, device=device, dtype=dtype, requires_grad=True)
+            for p, cosine in [(2, False), (1.5, False), (2, True)]:
+                torch.autograd.gradcheck(lambda x, y: torch.cdist_topk(x, y, 3, p=p, cosine=cosine)[0], (x, y))
+
     def test_multinomial_constraints(self, device):
         x = torch.empty(1, 2, 3, dtype=torch.double, device=device)
         self.assertRaisesRegex(
@@ -12884,6 +13099,78 @@ class TestTorchDeviceType(TestCase):
                                             [False, True, False, True, False],
                                             [True, False, True, False, True]], device=device))
 
+    @onlyCPU
+    def test_index_put_scatter_add_accumulate_parallel(self, device):
+        # Large enough for the parallel accumulation engine; the cases cover a
+        # small destination (histogram), a hot index and spread out indices.
+        n = 100000
+
+        def cases():
+            yield 64, torch.randint(64, (n,))
+            hot = torch.randint(n * 10, (n,))
+            hot[::2] = 12345
+            yield n * 10, hot
+            yield n * 10, torch.randint(n * 10, (n,))
+
+        num_threads = torch.get_num_threads()
+        for dtype in [torch.int64, torch.int32, torch.int16, torch.uint8, torch.bool,
+                      torch.float, torch.double, torch.complex64, torch.complex128]:
+            for size, index in cases():
+                src = torch.randint(0, 2, (n,)).to(dtype)
+                torch.set_num_threads(1)
+                try:
+                    expected_put = torch.zeros(size, dtype=dtype).index_put_((index,), src, accumulate=True)
+                    expected_scatter = torch.zeros(size, dtype=dtype).scatter_add_(0, index, src)
+                finally:
+                    torch.set_num_threads(num_threads)
+                actual_put = torch.zeros(size, dtype=dtype).index_put_((index,), src, accumulate=True)
+                actual_scatter = torch.zeros(size, dtype=dtype).scatter_add_(0, index, src)
+                self.assertEqual(actual_put, expected_put, atol=0, rtol=0)
+                self.assertEqual(actual_scatter, expected_scatter, atol=0, rtol=0)
+
+        # Spread out indices hit every element a few times, which bfloat16
+        # sums exactly.
+        size, index = list(cases())[2]
+        src = torch.randint(0, 2, (n,)).to(torch.bfloat16)
+        expected = torch.zeros(size).index_put_((index,), src.float(), accumulate=True)
+        self.assertEqual(torch.zeros(size, dtype=torch.bfloat16).index_put_((index,), src, accumulate=True).float(),
+                         expected, atol=0, rtol=0)
+        self.assertEqual(torch.zeros(size, dtype=torch.bfloat16).scatter_add_(0, index, src).float(),
+                         expected, atol=0, rtol=0)
+
+        # With deterministic algorithms the result matches the serial loop
+        # bit for bit.
+        for size, index in cases():
+            src = torch.randn(n, dtype=torch.double)
+            torch.set_num_threads(1)
+            try:
+                expected = torch.randn(size, dtype=torch.double)
+                dst = expected.clone()
+                expected.index_put_((index,), src, accumulate=True)
+            finally:
+                torch.set_num_threads(num_threads)
+            deterministic = torch.is_deterministic()
+            torch.set_deterministic(True)
+            try:
+                dst.index_put_((index,), src, accumulate=True)
+            finally:
+                torch.set_deterministic(deterministic)
+            self.assertEqual(dst, expected, atol=0, rtol=0)
+
+        # Strided destination and multi-dimensional scatter_add_ along dim 0.
+        dst = torch.zeros(200, 3, dtype=torch.double)
+        index = torch.randint(200, (n,))
+        src = torch.randint(0, 5, (n,)).double()
+        dst[:, 1].index_put_((index,), src, accumulate=True)
+        self.assertEqual(dst[:, 1], torch.bincount(index, src, minlength=200), atol=0, rtol=0)
+        self.assertEqual(dst[:, 0].abs().sum() + dst[:, 2].abs().sum(), 0)
+
+        index2d = torch.randint(50, (n, 2))
+        src2d = torch.randint(0, 5, (n, 2)).double()
+        out = torch.zeros(50, 2, dtype=torch.double).scatter_add_(0, index2d, src2d)
+        for j in range(2):
+            self.assertEqual(out[:, j], torch.bincount(index2d[:, j], src2d[:, j], minlength=50), atol=0, rtol=0)
+
     def test_masked_scatter_bool_tensor(self, device):
         src = torch.tensor([True, True, True], device=device)
         dst = torch.tensor([False, False, False], device=device)
@@ -13803,8 +14090,7 @@ class TestTorchDeviceType(TestCase):
 
     # passes on ROCm w/ python 2.7, fails w/ python 3.6
     @skipCUDAIfRocm
-    # stft -> rfft -> _fft -> _fft_with_size -> _fft_mkl
-    @skipCPUIfNoMkl
+    # stft -> rfft -> _fft -> _fft_with_size -> _fft_cpu
     @dtypes(torch.double)
     def test_stft(self, device, dtype):
         if not TEST_LIBROSA:
@@ -13866,7 +14152,6 @@ class TestTorchDeviceType(TestCase):
         _test((10,), 5, 4, win_sizes=(1, 1), expected_error=RuntimeError)
 
     @skipIfRocm
-    @unittest.skipIf(not TEST_MKL, "PyTorch is built without MKL support")
     def test_fft_input_modification(self, device):
         # FFT functions should not modify their input (gh-34551)
 
@@ -13886,8 +14171,81 @@ class TestTorchDeviceType(TestCase):
         _ = torch.irfft(half_spectrum_copy, 2, signal_sizes=(2, 2))
         self.assertEqual(half_spectrum, half_spectrum_copy)
 
+    @staticmethod
+    def _fft_bundled(x, signal_ndim, complex_input, complex_output, inverse, signal_sizes):
+        output_sizes = [x.size(0)] + list(signal_sizes)
+        if not complex_input:
+            output_sizes[-1] = signal_sizes[-1] // 2 + 1
+        if complex_output:
+            output_sizes.append(2)
+        return torch._fft_bundled(x, signal_ndim, complex_input, complex_output, inverse,
+                                  signal_sizes, False, True, output_sizes)
+
+    @onlyCPU
+    @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
+    @dtypes(torch.float, torch.double)
+    def test_fft_bundled(self, device, dtype):
+        # _fft_with_size only uses the bundled FFT in builds without MKL, so
+        # call it directly. Sizes cover the radix 2, 3, 4 and 5 passes, a
+        # large prime (Bluestein's algorithm) and non-contiguous inputs.
+        tol = dict(atol=1e-4, rtol=1e-4) if dtype == torch.float else dict(atol=1e-10, rtol=1e-10)
+
+        def to_complex(x):
+            return x[..., 0].numpy() + 1j * x[..., 1].numpy()
+
+        def from_complex(a):
+            return torch.from_numpy(np.stack([a.real, a.imag], -1)).to(dtype)
+
+        for signal_sizes in ((16,), (60,), (97,), (1,), (12, 10), (5, 7, 9), (6, 1, 8)):
+            signal_ndim = len(signal_sizes)
+            axes = tuple(range(1, signal_ndim + 1))
+            for contiguous in (True, False):
+                if contiguous:
+                    real = torch.randn(3, *signal_sizes, dtype=dtype)
+                    cplx = torch.randn(3, *signal_sizes, 2, dtype=dtype)
+                else:
+                    real = torch.randn(3, *signal_sizes, 2, dtype=dtype)[..., 0]
+                    cplx = torch.randn(6, *signal_sizes, 2, dtype=dtype)[::2]
+
+                res = self._fft_bundled(real, signal_ndim, False, True, False, signal_sizes)
+                self.assertEqual(res, from_complex(np.fft.rfftn(real.numpy(), axes=axes)), **tol)
+
+                res = self._fft_bundled(cplx, signal_ndim, True, True, False, signal_sizes)
+                self.assertEqual(res, from_complex(np.fft.fftn(to_complex(cplx), axes=axes)), **tol)
+                res = self._fft_bundled(cplx, signal_ndim, True, True, True, signal_sizes)
+                self.assertEqual(res, from_complex(np.fft.ifftn(to_complex(cplx), axes=axes)), **tol)
+
+                half = from_complex(np.fft.rfftn(real.numpy(), axes=axes))
+                res = self._fft_bundled(half, signal_ndim, True, False, True, signal_sizes)
+                self.assertEqual(res, real, **tol)
+
+    @onlyCPU
+    def test_fft_cpu_plan_cache(self, device):
+        plan_cache = torch.backends.cpu.fft_plan_cache
+        original = plan_cache.max_size
+        x = torch.randn(4, 30, 2)
+        try:
+            plan_cache.clear()
+            self.assertEqual(plan_cache.size, 0)
+            self._fft_bundled(x, 1, True, True, False, (30,))
+            self.assertEqual(plan_cache.size, 1)
+            self._fft_bundled(x, 1, True, True, True, (30,))
+            self.assertEqual(plan_cache.size, 1)
+            self._fft_bundled(x[..., 0], 1, False, True, False, (30,))
+            self.assertEqual(plan_cache.size, 2)
+
+            plan_cache.max_size = 1
+            self.assertEqual(plan_cache.size, 1)
+            plan_cache.max_size = 0
+            self.assertEqual(plan_cache.size, 0)
+            self._fft_bundled(x, 1, True, True, False, (30,))
+            self.assertEqual(plan_cache.size, 0)
+            with self.assertRaisesRegex(RuntimeError, "must be non-negative"):
+                plan_cache.max_size = -1
+        finally:
+            plan_cache.max_size = original
+
     @onlyOnCPUAndCUDA
-    @unittest.skipIf(not TEST_MKL, "PyTorch is built without MKL support")
     @dtypes(torch.double)
     def test_istft_round_trip_simple_cases(self, device, dtype):
         """stft -> istft should recover the original signale"""
@@ -13900,7 +14258,6 @@ class TestTorchDeviceType(TestCase):
         _test(torch.zeros(4, dtype=dtype, device=device), 4, 4)
 
     @onlyOnCPUAndCUDA
-    @unittest.skipIf(not TEST_MKL, "PyTorch is built without MKL support")
     @dtypes(torch.double)
     def test_istft_round_trip_various_params(self, device, dtype):
         """stft -> istft should recover the original signale"""
@@ -14003,7 +14360,6 @@ class TestTorchDeviceType(TestCase):
 
     @onlyOnCPUAndCUDA
     @skipIfRocm
-    @skipCPUIfNoMkl
     @dtypes(torch.double)
     def test_istft_of_sine(self, device, dtype):
         def _test(amplitude, L, n):
@@ -14038,7 +14394,6 @@ class TestTorchDeviceType(TestCase):
 
     @onlyOnCPUAndCUDA
     @skipIfRocm
-    @skipCPUIfNoMkl
     @dtypes(torch.double)
     def test_istft_linearity(self, device, dtype):
         num_trials = 100
@@ -14103,7 +14458,6 @@ class TestTorchDeviceType(TestCase):
             _test(data_size, kwargs)
 
     @onlyOnCPUAndCUDA
-    @skipCPUIfNoMkl
     @skipIfRocm
     def test_batch_istft(self, device):
         original = torch.tensor([
@@ -14733,6 +15087,50 @@ class TestTorchDeviceType(TestCase):
             expected = x / x.norm(p, 0, keepdim=True).clamp(min=1)
             self.assertEqual(res, expected, msg="renorm failed for {}-norm".format(p))
 
+    @onlyCPU
+    @dtypes(*(torch.testing.get_all_int_dtypes() + torch.testing.get_all_fp_dtypes()))
+    def test_sort_stable(self, device, dtype):
+        # many duplicates, so the order of equal keys is observable
+        x = torch.randint(0, 8, (3, 500), device=device).to(dtype)
+        for descending in (False, True):
+            for stable in (None, True):
+                values, indices = torch.sort(x, dim=-1, descending=descending, stable=stable)
+                self.assertEqual(x.gather(-1, indices), values, atol=0, rtol=0)
+                expected_values, _ = torch.sort(x.double(), dim=-1, descending=descending)
+                self.assertEqual(values.double(), expected_values, atol=0, rtol=0)
+                # equal keys keep the order of their original positions
+                same = values[:, 1:] == values[:, :-1]
+                self.assertTrue((indices[:, 1:] > indices[:, :-1])[same].all())
+
+    @onlyCPU
+    @dtypes(torch.float, torch.double, torch.int64, torch.int32)
+    def test_sort_large_slice(self, device, dtype):
+        # long enough to take the multithreaded radix sort + merge path
+        n = 1 << 18
+        x = torch.randint(-1000, 1000, (n,), device=device).to(dtype)
+        if dtype.is_floating_point:
+            x[::997] = float('nan')
+            x[::1009] = -0.0
+        for descending in (False, True):
+            values, indices = x.sort(descending=descending)
+            self.assertEqual(x[indices], values, atol=0, rtol=0)
+            self.assertEqual(values, torch.from_numpy(np.sort(x.numpy(), kind='stable')[::-1 if descending else 1].copy()),
+                             atol=0, rtol=0)
+            same = values[1:] == values[:-1]
+            self.assertTrue((indices[1:] > indices[:-1])[same].all())
+
+        # few long slices along a non-contiguous dim
+        y = x.view(4, -1).t()
+        values, indices = y.sort(dim=0)
+        self.assertEqual(y.gather(0, indices), values, atol=0, rtol=0)
+        self.assertEqual(values, y.contiguous().sort(dim=0)[0], atol=0, rtol=0)
+
+    @onlyCUDA
+    def test_sort_stable_unsupported(self, device):
+        x = torch.randn(10, device=device)
+        with self.assertRaisesRegex(RuntimeError, "stable=True is only supported for CPU"):
+            torch.sort(x, stable=True)
+
     @onlyCUDA
     def test_topk_noncontiguous_gpu(self, device):
         t = torch.randn(20, device=device)[::2]
@@ -14778,6 +15176,34 @@ class TestTorchDeviceType(TestCase):
         self.assertEqual(val, expected_val, atol=0, rtol=0)
         self.assertEqual(ind, expected_ind, atol=0, rtol=0)
 
+    @onlyCPU
+    @dtypes(torch.float, torch.int64)
+    def test_topk_long_slice(self, device, dtype):
+        # slices this long are split across threads, with per-thread heaps
+        n = 1 << 18
+        x = torch.randint(-1000, 1000, (n,), device=device).to(dtype)
+        if dtype.is_floating_point:
+            x[torch.randint(n, (5,))] = float('nan')
+        for largest in [True, False]:
+            sorted_x, _ = x.sort(descending=largest)
+            for k in [1, 100, 1000]:
+                val, idx = x.topk(k, largest=largest)
+                self.assertEqual(val, sorted_x[:k], atol=0, rtol=0)
+                self.assertEqual(x[idx], val, atol=0, rtol=0)
+
+                val, idx = x.topk(k, largest=largest, sorted=False)
+                self.assertEqual(val.sort(descending=largest)[0], sorted_x[:k], atol=0, rtol=0)
+                self.assertEqual(x[idx], val, atol=0, rtol=0)
+
+        # a few long slices, and a non-contiguous one
+        x = torch.randn(2, n, device=device).to(dtype)
+        val, idx = x.topk(10, dim=1)
+        self.assertEqual(val, x.sort(dim=1, descending=True)[0][:, :10], atol=0, rtol=0)
+        x = x.t()
+        val, idx = x.topk(10, dim=0)
+        self.assertEqual(val, x.sort(dim=0, descending=True)[0][:10], atol=0, rtol=0)
+        self.assertEqual(x.gather(0, idx), val, atol=0, rtol=0)
+
 
 
 
@@ -15216,6 +15642,25 @@ class TestTorchDeviceType(TestCase):
                                     count += 1
                             self.assertEqual(j, count)
 
+    @onlyCPU
+    @dtypes(torch.int64, torch.int32, torch.float, torch.double)
+    def test_unique_large(self, device, dtype):
+        # few distinct values take the hash engine, many take the radix engine
+        for high in (100, 1 << 30):
+            x = torch.randint(0, high, (300000,), device=device).to(dtype)
+            expected = np.unique(x.numpy(), return_inverse=True, return_counts=True)
+            for sort_output in (True, False):
+                unique, inverse, counts = torch.unique(x, sorted=sort_output, return_inverse=True, return_counts=True)
+                self.assertEqual(unique[inverse], x, atol=0, rtol=0)
+                if sort_output:
+                    self.assertEqual(unique, torch.from_numpy(expected[0]), atol=0, rtol=0)
+                    self.assertEqual(inverse, torch.from_numpy(expected[1]), atol=0, rtol=0)
+                    self.assertEqual(counts, torch.from_numpy(expected[2]), atol=0, rtol=0)
+                else:
+                    order = unique.argsort()
+                    self.assertEqual(unique[order], torch.from_numpy(expected[0]), atol=0, rtol=0)
+                    self.assertEqual(counts[order], torch.from_numpy(expected[2]), atol=0, rtol=0)
+
     @dtypes(*set(torch.testing.get_all_dtypes()) - {torch.bfloat16, torch.complex64, torch.complex128})
     def test_unique_consecutive(self, device, dtype):
         if dtype is torch.half and self.device_type == 'cpu':
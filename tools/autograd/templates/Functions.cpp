@@ -1066,6 +1066,39 @@ Tensor binary_cross_entropy_double_backward_grad_output(const Tensor & grad, con
   return ggO;
 }
 
+// Per-row factor of the cross entropy gradient: the class weight of the
+// target, 0 for ignored targets, divided by the total weight for Mean.
+static Tensor cross_entropy_loss_row_scale(const Tensor & self, const Tensor & target, const Tensor & weight, int64_t reduction, int64_t ignore_index, const Tensor & total_weight) {
+  auto ignored = target.eq(ignore_index);
+  auto safe_target = target.masked_fill(ignored, 0);
+  auto scale = weight.defined() ? weight.index_select(0, safe_target) : at::ones(target.sizes(), self.options());
+  scale = scale.masked_fill(ignored, 0);
+  if (reduction == at::Reduction::Mean) {
+    scale = scale / total_weight;
+  }
+  return scale.unsqueeze(1);
+}
+
+Tensor cross_entropy_loss_double_backward(const Tensor & grad, const Tensor & grad_output, const Tensor & self, const Tensor & target, const Tensor & weight, int64_t reduction, int64_t ignore_index, const Tensor & total_weight, const Tensor & log_sum_exp) {
+  auto probs = (self - log_sum_exp.to(self.scalar_type()).unsqueeze(1)).exp();
+  auto gO = reduction == at::Reduction::None ? grad_output.unsqueeze(1) : grad_output;
+  auto scale = gO * cross_entropy_loss_row_scale(self, target, weight, reduction, ignore_index, total_weight);
+  // the gradient is scale * (softmax(self) - one_hot(target)), so only the
+  // softmax contributes to the second derivative
+  return scale * probs * (grad - (grad * probs).sum(1, true));
+}
+
+Tensor cross_entropy_loss_double_backward_grad_output(const Tensor & grad, const Tensor & self, const Tensor & target, const Tensor & weight, int64_t reduction, int64_t ignore_index, const Tensor & total_weight, const Tensor & log_sum_exp) {
+  auto probs = (self - log_sum_exp.to(self.scalar_type()).unsqueeze(1)).exp();
+  auto scale = cross_entropy_loss_row_scale(self, target, weight, reduction, ignore_index, total_weight);
+  auto ggO = (grad * probs).sum(1, true) - grad.gather(1, target.masked_fill(target.eq(ignore_index), 0).unsqueeze(1));
+  ggO = (ggO * scale).squeeze(1);
+  if (reduction != at::Reduction::None) {
+    return ggO.sum();
+  }
+  return ggO;
+}
+
 Tensor l1_loss_double_backward_grad_output(const Tensor & grad, const Tensor & input, const Tensor & target, int64_t reduction) {
   auto output = l1_loss_backward(grad, input, target, at::Reduction::None);
   if (reduction == at::Reduction::Mean) {
@@ -1711,6 +1744,42 @@ std::tuple<Tensor, Tensor> atan2_backward(const Tensor& grad, const Tensor& self
             output_mask[1] ? grad * -self * recip : Tensor() };
 }
 
+// The direct channels last convolution has no backward kernel of its own;
+// every group goes through slow_conv_dilated2d_backward instead.
+std::tuple<Tensor, Tensor, Tensor> conv2d_channels_last_backward(
+    const Tensor & grad,
+    const Tensor & self,
+    const Tensor & weight,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups,
+    std::array<bool, 3> output_mask) {
+  auto kernel_size = weight.sizes().slice(2);
+  if (groups == 1) {
+    return at::slow_conv_dilated2d_backward(grad, self, weight, kernel_size, stride, padding, dilation, output_mask);
+  }
+
+  const int64_t in_channels = self.size(1) / groups;
+  const int64_t out_channels = weight.size(0) / groups;
+  std::vector<Tensor> grad_inputs, grad_weights, grad_biases;
+  for (int64_t g = 0; g < groups; ++g) {
+    Tensor grad_input, grad_weight, grad_bias;
+    std::tie(grad_input, grad_weight, grad_bias) = at::slow_conv_dilated2d_backward(
+        grad.narrow(1, g * out_channels, out_channels),
+        self.narrow(1, g * in_channels, in_channels),
+        weight.narrow(0, g * out_channels, out_channels),
+        kernel_size, stride, padding, dilation, output_mask);
+    grad_inputs.push_back(grad_input);
+    grad_weights.push_back(grad_weight);
+    grad_biases.push_back(grad_bias);
+  }
+  return std::tuple<Tensor, Tensor, Tensor>(
+      output_mask[0] ? at::cat(grad_inputs, 1) : Tensor(),
+      output_mask[1] ? at::cat(grad_weights, 0) : Tensor(),
+      output_mask[2] ? at::cat(grad_biases, 0) : Tensor());
+}
+
 // TODO: Seriously consider writing the derivative formulas for
 // each output separately; there is not all that much sharing
 // of computation going on here.
@@ -126,6 +126,7 @@ def get_ignored_functions():
         torch.result_type,
         torch.scalar_tensor,
         torch.sparse_coo_tensor,
+        torch.sparse_csr_tensor,
         torch.tril_indices,
         torch.triu_indices,
         torch.vander,
@@ -233,6 +234,7 @@ def get_testing_overrides():
         torch.cartesian_prod: lambda *tensors: -1,
         torch.cat: lambda tensors, dim=0, out=None: -1,
         torch.cdist: lambda x1, c2, p=2, compute_mode=None: -1,
+        torch.cdist_topk: lambda x1, x2, k, p=2, cosine=False: -1,
         torch.ceil: lambda input, out=None: -1,
         torch.celu: lambda input, alhpa=1., inplace=False: -1,
         torch.chain_matmul: lambda *matrices: -1,
@@ -290,6 +292,8 @@ def get_testing_overrides():
                           sparse=False: -1),
         torch.embedding_bag: (lambda input, weight, offsets, max_norm=None, norm_type=2, scale_grad_by_freq=False,
                               mode='mean', sparse=False, per_sample_weights=None: -1),
+        torch.embedding_bag_grouped: (lambda weights, indices, offsets, per_sample_weights, mode=0,
+                                      include_last_offset=False: -1),
         torch.empty_like: lambda input, dtype=None, layout=None, device=None, requires_grad=False: -1,
         torch.eq: lambda input, other, out=None: -1,
         torch.equal: lambda input, other: -1,
@@ -469,6 +473,8 @@ def get_testing_overrides():
         torch.nn.functional.embedding_bag: (lambda input, weight, offsets=None, max_norm=None, norm_type=2,
                                             scale_grad_by_freq=False, mode='mean', sparse=False, per_sample_weights=None,
                                             include_last_offset=False: -1),
+        torch.nn.functional.embedding_bag_grouped: (lambda inputs, weights, offsets, mode='sum',
+                                                    per_sample_weights=None, include_last_offset=False: -1),
         torch.nn.functional.feature_alpha_dropout: lambda input, p=0.5, training=False, inplace=False: -1,
         torch.nn.functional.fold: lambda input, output_size, kernel_size, dilation=1, padding=0, stride=1: -1,
         torch.nn.functional.fractional_max_pool2d: (lambda input, kernel_size, output_size=None, output_ratio=None,
@@ -637,7 +643,7 @@ def get_testing_overrides():
         torch.spmm: lambda input, mat2: -1,
         torch.softmax: lambda input, dim, dtype=None: -1,
         torch.solve: lambda input, A, out=None: -1,
-        torch.sort: lambda input, dim=-1, descending=False, out=None: -1,
+        torch.sort: lambda input, dim=-1, descending=False, stable=None, out=None: -1,
         torch.split: lambda tensor, split_size_or_sections, dim=0: -1,
         torch.split_with_sizes: lambda tensor, split_size_or_sections, dim=0: -1,
         torch.sqrt: lambda input, out=None: -1,
@@ -1414,11 +1414,35 @@ error.
 
 See also :meth:`Tensor.indices`.
 
+If :attr:`self` is a sparse CSR tensor (i.e., with ``torch.sparse_csr`` layout),
+this returns a view of its values tensor.
+
 .. note::
   This method can only be called on a coalesced sparse tensor. See
   :meth:`Tensor.coalesce` for details.
 """)
 
+add_docstr_all('crow_indices',
+               r"""
+crow_indices() -> Tensor
+
+If :attr:`self` is a sparse CSR tensor (i.e., with ``torch.sparse_csr`` layout),
+this returns a view of its compressed row indices. Otherwise, this throws an
+error.
+
+See also :meth:`Tensor.col_indices`.
+""")
+
+add_docstr_all('col_indices',
+               r"""
+col_indices() -> Tensor
+
+If :attr:`self` is a sparse CSR tensor (i.e., with ``torch.sparse_csr`` layout),
+this returns a view of its column indices. Otherwise, this throws an error.
+
+See also :meth:`Tensor.crow_indices`.
+""")
+
 add_docstr_all('gt',
                r"""
 gt(other) -> Tensor
@@ -2869,7 +2893,7 @@ See :func:`torch.solve`
 
 add_docstr_all('sort',
                r"""
-sort(dim=-1, descending=False) -> (Tensor, LongTensor)
+sort(dim=-1, descending=False, stable=None) -> (Tensor, LongTensor)
 
 See :func:`torch.sort`
 """)
@@ -3318,6 +3342,23 @@ Example::
            size=(3, 3), nnz=1, layout=torch.sparse_coo)
 """)
 
+add_docstr_all('to_sparse_csr',
+               r"""
+to_sparse_csr() -> Tensor
+Returns a copy of the tensor in ``torch.sparse_csr`` layout. :attr:`self` must be
+a 2-D strided tensor or a sparse COO tensor with 2 sparse and no dense dimensions.
+See :func:`torch.sparse_csr_tensor`.
+
+Example::
+
+    >>> d = torch.tensor([[0, 0, 0], [9, 0, 10], [0, 0, 0]])
+    >>> d.to_sparse_csr()
+    tensor(crow_indices=tensor([0, 0, 2, 2]),
+           col_indices=tensor([0, 2]),
+           values=tensor([ 9, 10]), size=(3, 3), nnz=2,
+           layout=torch.sparse_csr)
+""")
+
 add_docstr_all('to_mkldnn',
                r"""
 to_mkldnn() -> Tensor
@@ -1114,6 +1114,42 @@ Example::
     tensor([-0., -1., -1.,  1.])
 """.format(**common_args))
 
+add_docstr(torch.cdist_topk,
+           r"""
+cdist_topk(x1, x2, k, p=2, cosine=False) -> (Tensor, LongTensor)
+
+Returns the :attr:`k` nearest rows of :attr:`x2` to every row of :attr:`x1`,
+as a tuple ``(values, indices)`` of the distances, in ascending order, and
+the row indices into :attr:`x2`.
+
+The result is the same as ``torch.cdist(x1, x2, p).topk(k, largest=False)``,
+or with :attr:`cosine` ``(1 - cosine similarity).topk(k, largest=False)``,
+but on CPU the full :math:`P \times R` distance matrix is never
+materialized: blocks of :attr:`x1` are processed in parallel, and each
+keeps a running top-k while streaming over :attr:`x2`. Euclidean and cosine
+distances are ranked using matrix multiplication, and the distances of the
+selected neighbours are then computed directly. Ties are broken by the
+lower index.
+
+Args:
+    x1 (Tensor): input tensor of shape :math:`P \times M`.
+    x2 (Tensor): input tensor of shape :math:`R \times M`.
+    k (int): the number of neighbours, at most :math:`R`.
+    p (float, optional): p value for the p-norm distance between the rows,
+        :math:`\in [0, \infty]`. Default: 2
+    cosine (bool, optional): use the cosine distance :math:`1 - \cos(x1_i, x2_j)`
+        instead of the p-norm distance. Default: ``False``
+
+Example::
+
+    >>> a = torch.tensor([[0., 0.], [1., 1.]])
+    >>> b = torch.tensor([[1., 0.], [3., 3.], [0., 1.], [1., 1.]])
+    >>> torch.cdist_topk(a, b, 2)
+    (tensor([[1., 1.],
+            [0., 1.]]), tensor([[0, 2],
+            [3, 0]]))
+""")
+
 add_docstr(torch.real,
            r"""
 real(input) -> Tensor
@@ -5642,7 +5678,7 @@ Example::
 
 add_docstr(torch.sort,
            r"""
-sort(input, dim=-1, descending=False, out=None) -> (Tensor, LongTensor)
+sort(input, dim=-1, descending=False, stable=None, out=None) -> (Tensor, LongTensor)
 
 Sorts the elements of the :attr:`input` tensor along a given dimension
 in ascending order by value.
@@ -5652,6 +5688,10 @@ If :attr:`dim` is not given, the last dimension of the `input` is chosen.
 If :attr:`descending` is ``True`` then the elements are sorted in descending
 order by value.
 
+If :attr:`stable` is ``True`` then the sorting routine becomes stable, preserving
+the order of equivalent elements. Sorting on CPU is always stable; other devices
+do not support ``stable=True`` yet.
+
 A namedtuple of (values, indices) is returned, where the `values` are the
 sorted values and `indices` are the indices of the elements in the original
 `input` tensor.
@@ -5660,6 +5700,8 @@ Args:
     {input}
     dim (int, optional): the dimension to sort along
     descending (bool, optional): controls the sorting order (ascending or descending)
+    stable (bool, optional): makes the sorting routine stable, which guarantees that
+        the order of equivalent elements is preserved
     out (tuple, optional): the output tuple of (`Tensor`, `LongTensor`) that can
         be optionally given to be used as output buffers
 
@@ -5796,6 +5838,50 @@ Example::
 .. _torch.sparse: https://pytorch.org/docs/stable/sparse.html
 """.format(**factory_common_args))
 
+add_docstr(torch.sparse_csr_tensor,
+           r"""
+sparse_csr_tensor(crow_indices, col_indices, values, size=None, dtype=None, device=None, requires_grad=False) -> Tensor
+
+Constructs a 2-D sparse tensor in CSR (Compressed Sparse Row) format with the given
+:attr:`values` at the given :attr:`col_indices`. The column indices and values of row ``i``
+are ``col_indices[crow_indices[i]:crow_indices[i + 1]]`` and
+``values[crow_indices[i]:crow_indices[i + 1]]``. Matrix products of a CSR tensor with a
+dense matrix or vector (:func:`torch.mm`, :func:`torch.addmm`, :func:`torch.mv`,
+:func:`torch.addmv`) do not need to coalesce the sparse operand, and are parallelized over
+rows of equal work. CSR tensors are only supported on CPU and do not support autograd.
+
+Args:
+    crow_indices (Tensor): 1-D int64 tensor of size ``size[0] + 1``. ``crow_indices[0]`` is 0,
+        ``crow_indices[-1]`` is the number of specified elements, and ``crow_indices`` is
+        non-decreasing.
+    col_indices (Tensor): 1-D int64 tensor with the column index of every specified element.
+    values (Tensor): 1-D tensor with the value of every specified element.
+    size (list, tuple, or :class:`torch.Size`, optional): Size of the sparse tensor. If not
+        provided, the number of rows is ``crow_indices.numel() - 1`` and the number of columns
+        is the largest column index plus one.
+    dtype (:class:`torch.dtype`, optional): the desired data type of returned tensor.
+        Default: if None, infers data type from :attr:`values`.
+    device (:class:`torch.device`, optional): the desired device of returned tensor.
+        Only the CPU is supported.
+    {requires_grad}
+
+Example::
+
+    >>> crow_indices = torch.tensor([0, 2, 2, 3])
+    >>> col_indices = torch.tensor([0, 2, 1])
+    >>> values = torch.tensor([1., 2., 3.])
+    >>> S = torch.sparse_csr_tensor(crow_indices, col_indices, values, [3, 3])
+    >>> S
+    tensor(crow_indices=tensor([0, 2, 2, 3]),
+           col_indices=tensor([0, 2, 1]),
+           values=tensor([1., 2., 3.]), size=(3, 3), nnz=3,
+           layout=torch.sparse_csr)
+    >>> S.to_dense()
+    tensor([[1., 0., 2.],
+            [0., 0., 0.],
+            [0., 3., 0.]])
+""".format(**factory_common_args))
+
 add_docstr(torch.sqrt,
            r"""
 sqrt(input, out=None) -> Tensor
@@ -7417,9 +7503,10 @@ The inverse of this function is :func:`~torch.ifft`.
     Due to limited dynamic range of half datatype, performing this operation in half
     precision may cause the first element of result to overflow for certain inputs.
 
-.. warning::
-    For CPU tensors, this method is currently only available with MKL. Use
-    :func:`torch.backends.mkl.is_available` to check if MKL is installed.
+.. note::
+    For CPU tensors, MKL is used when PyTorch is built with it (see
+    :func:`torch.backends.mkl.is_available`), and a bundled FFT otherwise,
+    with its own plan cache. See :ref:`cpu-fft-plan-cache` for more details.
 
 Arguments:
     input (Tensor): the input tensor of at least :attr:`signal_ndim` ``+ 1``
@@ -7516,9 +7603,10 @@ The inverse of this function is :func:`~torch.fft`.
     Due to limited dynamic range of half datatype, performing this operation in half
     precision may cause the first element of result to overflow for certain inputs.
 
-.. warning::
-    For CPU tensors, this method is currently only available with MKL. Use
-    :func:`torch.backends.mkl.is_available` to check if MKL is installed.
+.. note::
+    For CPU tensors, MKL is used when PyTorch is built with it (see
+    :func:`torch.backends.mkl.is_available`), and a bundled FFT otherwise,
+    with its own plan cache. See :ref:`cpu-fft-plan-cache` for more details.
 
 Arguments:
     input (Tensor): the input tensor of at least :attr:`signal_ndim` ``+ 1``
@@ -7604,9 +7692,10 @@ The inverse of this function is :func:`~torch.irfft`.
     Due to limited dynamic range of half datatype, performing this operation in half
     precision may cause the first element of result to overflow for certain inputs.
 
-.. warning::
-    For CPU tensors, this method is currently only available with MKL. Use
-    :func:`torch.backends.mkl.is_available` to check if MKL is installed.
+.. note::
+    For CPU tensors, MKL is used when PyTorch is built with it (see
+    :func:`torch.backends.mkl.is_available`), and a bundled FFT otherwise,
+    with its own plan cache. See :ref:`cpu-fft-plan-cache` for more details.
 
 Arguments:
     input (Tensor): the input tensor of at least :attr:`signal_ndim` dimensions
@@ -7685,9 +7774,10 @@ The inverse of this function is :func:`~torch.rfft`.
     Due to limited dynamic range of half datatype, performing this operation in half
     precision may cause the first element of result to overflow for certain inputs.
 
-.. warning::
-    For CPU tensors, this method is currently only available with MKL. Use
-    :func:`torch.backends.mkl.is_available` to check if MKL is installed.
+.. note::
+    For CPU tensors, MKL is used when PyTorch is built with it (see
+    :func:`torch.backends.mkl.is_available`), and a bundled FFT otherwise,
+    with its own plan cache. See :ref:`cpu-fft-plan-cache` for more details.
 
 Arguments:
     input (Tensor): the input tensor of at least :attr:`signal_ndim` ``+ 1``
@@ -169,6 +169,10 @@ def _rebuild_sparse_tensor(layout, data):
         result = torch._sparse_coo_tensor_unsafe(indices, values, size)
         _sparse_tensors_to_validate.append(result)
         return result
+    elif layout == torch.sparse_csr:
+        # The CSR constructor validates its arguments itself.
+        crow_indices, col_indices, values, size = data
+        return torch.sparse_csr_tensor(crow_indices, col_indices, values, size)
 
     raise NotImplementedError("rebuilding sparse tensor for layout %s" % (layout))
 
@@ -0,0 +1,27 @@
+import torch
+
+
+class FFTPlanCache(object):
+    r"""
+    Represents the plan cache of the bundled CPU FFT, used when PyTorch is
+    built without MKL. The attributes `size` and `max_size`, and method
+    `clear`, can fetch and/ or change properties of the C++ plan cache.
+    """
+
+    @property
+    def size(self):
+        return torch._fft_cpu_get_plan_cache_size()
+
+    @property
+    def max_size(self):
+        return torch._fft_cpu_get_plan_cache_max_size()
+
+    @max_size.setter
+    def max_size(self, value):
+        torch._fft_cpu_set_plan_cache_max_size(value)
+
+    def clear(self):
+        return torch._fft_cpu_clear_plan_cache()
+
+
+fft_plan_cache = FFTPlanCache()
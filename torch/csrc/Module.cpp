@@ -9,6 +9,7 @@
 #include <cstdlib>
 #include <libshm.h>
 #include <TH/TH.h>
+#include <c10/core/CPUCachingAllocator.h>
 #include <c10/util/Logging.h>
 #include <ATen/ATen.h>
 #include <ATen/ExpandUtils.h>
@@ -534,6 +535,90 @@ PyObject *THPModule_isEnabledXNNPACK(PyObject * /* unused */)
   else Py_RETURN_FALSE;
 }
 
+PyObject *THPModule_setCPUCachingAllocatorEnabled(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_caching_allocator_enabled expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  c10::CPUCachingAllocator::setEnabled(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_isCPUCachingAllocatorEnabled(PyObject *_unused, PyObject *noargs)
+{
+  if (c10::CPUCachingAllocator::isEnabled()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
+PyObject *THPModule_cpuEmptyCache(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  c10::CPUCachingAllocator::emptyCache();
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_cpuMemoryStats(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  using c10::CPUCachingAllocator::StatType;
+  using c10::CPUCachingAllocator::Stat;
+  using c10::CPUCachingAllocator::StatArray;
+  using c10::CPUCachingAllocator::CPUAllocatorStats;
+
+  const auto statToDict = [](const Stat& stat) {
+    py::dict dict;
+
+    dict["current"] = stat.current;
+    dict["peak"] = stat.peak;
+    dict["allocated"] = stat.allocated;
+    dict["freed"] = stat.freed;
+    return dict;
+  };
+
+  const auto statArrayToDict = [=](const StatArray& statArray) {
+    const std::array<const char*, static_cast<size_t>(StatType::NUM_TYPES)> statTypeNames = {
+      "all", "small_pool", "large_pool"
+    };
+    py::dict dict;
+    for (size_t i = 0; i < statTypeNames.size(); ++i) {
+      dict[statTypeNames[i]] = statToDict(statArray[i]);
+    }
+    return dict;
+  };
+
+  const CPUAllocatorStats stats = c10::CPUCachingAllocator::getStats();
+
+  py::dict result;
+  result["num_thread_cache_hits"] = stats.num_thread_cache_hits;
+  result["num_alloc_retries"] = stats.num_alloc_retries;
+  result["num_ooms"] = stats.num_ooms;
+  result["allocation"] = statArrayToDict(stats.allocation);
+  result["segment"] = statArrayToDict(stats.segment);
+  result["cached"] = statArrayToDict(stats.cached);
+  result["allocated_bytes"] = statArrayToDict(stats.allocated_bytes);
+  result["reserved_bytes"] = statArrayToDict(stats.reserved_bytes);
+  result["cached_bytes"] = statArrayToDict(stats.cached_bytes);
+
+  return result.release().ptr();
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject *THPModule_cpuResetAccumulatedMemoryStats(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  c10::CPUCachingAllocator::resetAccumulatedStats();
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_cpuResetPeakMemoryStats(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  c10::CPUCachingAllocator::resetPeakStats();
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
 //NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, modernize-avoid-c-arrays)
 static PyMethodDef TorchMethods[] = {
   {"_initExtension",  (PyCFunction)THPModule_initExtension,   METH_O,       nullptr},
@@ -578,6 +663,12 @@ static PyMethodDef TorchMethods[] = {
   {"_set_qengine", (PyCFunction)THPModule_setQEngine, METH_O, nullptr},
   {"_supported_qengines", (PyCFunction)THPModule_supportedQEngines, METH_NOARGS, nullptr},
   {"_is_xnnpack_enabled", (PyCFunction)THPModule_isEnabledXNNPACK, METH_NOARGS, nullptr},
+  {"_cpu_setCachingAllocatorEnabled", (PyCFunction)THPModule_setCPUCachingAllocatorEnabled, METH_O, nullptr},
+  {"_cpu_isCachingAllocatorEnabled", (PyCFunction)THPModule_isCPUCachingAllocatorEnabled, METH_NOARGS, nullptr},
+  {"_cpu_emptyCache", (PyCFunction)THPModule_cpuEmptyCache, METH_NOARGS, nullptr},
+  {"_cpu_memoryStats", (PyCFunction)THPModule_cpuMemoryStats, METH_NOARGS, nullptr},
+  {"_cpu_resetAccumulatedMemoryStats", (PyCFunction)THPModule_cpuResetAccumulatedMemoryStats, METH_NOARGS, nullptr},
+  {"_cpu_resetPeakMemoryStats", (PyCFunction)THPModule_cpuResetPeakMemoryStats, METH_NOARGS, nullptr},
   {nullptr, nullptr, 0, nullptr}
 };
 
@@ -778,6 +778,14 @@ inline Tensor cross_entropy(
       enumtype::get_enum_name(reduction),
       " is not valid");
   }
+  if (input.dim() == 2) {
+    return torch::cross_entropy_loss(
+      input,
+      target,
+      weight,
+      enumtype::reduction_get_enum(reduction_),
+      ignore_index);
+  }
   return torch::nn::functional::detail::nll_loss(
     torch::nn::functional::detail::log_softmax(input, 1, c10::nullopt),
     target,
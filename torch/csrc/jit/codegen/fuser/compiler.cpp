@@ -4,6 +4,7 @@
 #include <ATen/core/jit_type.h>
 #include <c10/util/Exception.h>
 #include <torch/csrc/jit/codegen/fuser/codegen.h>
+#include <torch/csrc/jit/codegen/fuser/cpu/llvm_kernel.h>
 #include <torch/csrc/jit/codegen/fuser/interface.h>
 #include <torch/csrc/jit/codegen/fuser/kernel_cache.h>
 #include <torch/csrc/jit/codegen/fuser/tensor_desc.h>
@@ -281,6 +282,21 @@ std::shared_ptr<FusedKernel> compileKernel(
 
   const bool use_cuda = device.is_cuda();
   const std::string name = "kernel_" + c10::to_string(next_kernel_id++);
+  if (!use_cuda) {
+    // See [In-process CPU kernels]
+    if (auto kernel = cpu::compileLLVMKernel(
+            name,
+            *graph,
+            flat_inputs,
+            flat_outputs,
+            input_desc,
+            output_desc,
+            chunk_desc,
+            concat_desc,
+            spec.hasRandom())) {
+      return kernel;
+    }
+  }
   std::string code =
       generateKernel(name, *graph, flat_inputs, flat_outputs, use_cuda);
   const FusedKernelConstructor& kernel_ctor =
@@ -6,7 +6,15 @@
 #include <torch/csrc/jit/frontend/code_template.h>
 #include <torch/csrc/utils/memory.h>
 
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -283,6 +291,123 @@ static void disas(const std::string& so_file) {
   AT_ASSERT(r == 0);
 }
 
+// [Fuser kernel cache]
+// Kernels compiled with the host compiler (those the in-process lowering of
+// llvm_kernel.cpp doesn't handle) can be kept on disk across processes, so
+// that a restarted process loads them instead of invoking the compiler
+// again. The cache is off unless $PYTORCH_FUSER_CACHE_DIR names its
+// directory; failing to create that directory disables it too. A kernel is
+// named by a hash of its source and of the compile command. The source is
+// hashed with the kernel name, which comes from a per-process counter,
+// replaced by a placeholder, and the kernel is then compiled under a name
+// derived from the hash, so the same fusion maps to the same file in every
+// process. Kernels are written under a temporary name and renamed into
+// place, so concurrent processes never load a partially written one.
+#ifdef _WIN32
+static std::string kernelCacheDir() {
+  return "";
+}
+#else
+static std::string makeKernelCacheDir() {
+  const char* env = getenv("PYTORCH_FUSER_CACHE_DIR");
+  std::string dir = env ? env : "";
+  if (dir.empty()) {
+    return dir;
+  }
+  // Create the missing components of the path; mkdir fails harmlessly on
+  // the existing ones.
+  for (size_t pos = dir.find('/', 1); pos != std::string::npos;
+       pos = dir.find('/', pos + 1)) {
+    mkdir(dir.substr(0, pos).c_str(), 0755);
+  }
+  mkdir(dir.c_str(), 0755);
+  struct stat st;
+  if (stat(dir.c_str(), &st) != 0 || !S_ISDIR(st.st_mode) ||
+      access(dir.c_str(), W_OK) != 0) {
+    TORCH_WARN(
+        "pytorch jit fuser can't use ",
+        dir,
+        " as its kernel cache, fused CPU kernels won't be cached");
+    return "";
+  }
+  return dir;
+}
+
+static std::string kernelCacheDir() {
+  static const std::string dir = makeKernelCacheDir();
+  return dir;
+}
+#endif
+
+// 64-bit FNV-1a; unlike std::hash it is the same in every process and build
+static uint64_t hashString(const std::string& str, uint64_t hash) {
+  for (unsigned char c : str) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+// Replaces every occurrence of `from` in `str` with `to`
+static std::string replaceAll(
+    std::string str,
+    const std::string& from,
+    const std::string& to) {
+  for (size_t pos = str.find(from); pos != std::string::npos;
+       pos = str.find(from, pos + to.size())) {
+    str.replace(pos, from.size(), to);
+  }
+  return str;
+}
+
+// Returns the name to compile the kernel `name` with source `code` under:
+// "kernel_" followed by a hash of the compile command and of the source
+// with `name` taken out, so that it doesn't depend on the order in which
+// the process compiled its kernels. See [Fuser kernel cache]
+static std::string stableKernelName(
+    const std::string& name,
+    const std::string& code) {
+  uint64_t hash = 14695981039346656037ULL;
+  hash = hashString(compile_string, hash);
+  hash = hashString(getConfig().cxx, hash);
+  hash = hashString(replaceAll(code, name, "${kernelName}"), hash);
+  std::ostringstream stable_name;
+  stable_name << "kernel_" << std::hex << hash;
+  return stable_name.str();
+}
+
+// Returns the path of the cached kernel `stable_name`, or an empty string if
+// the cache is disabled.
+static std::string cachedKernelPath(const std::string& stable_name) {
+  const std::string dir = kernelCacheDir();
+  if (dir.empty()) {
+    return dir;
+  }
+  return dir + "/" + stable_name +
+      so_template.substr(so_template.size() - so_suffix_len);
+}
+
+// Copies the kernel at `so_file` into the cache. Failures only mean the
+// kernel will be compiled again by the next process.
+static void storeCachedKernel(
+    const std::string& so_file,
+    const std::string& cached_path) {
+  const std::string tmp_path =
+      cached_path + ".tmp" + std::to_string(static_cast<long>(getpid()));
+  {
+    std::ifstream src(so_file, std::ios::binary);
+    std::ofstream dst(tmp_path, std::ios::binary | std::ios::trunc);
+    dst << src.rdbuf();
+    if (!src || !dst) {
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), cached_path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+  }
+}
+
 FusedKernelCPU::FusedKernelCPU(
     std::string name,
     std::string code,
@@ -299,21 +424,41 @@ FusedKernelCPU::FusedKernelCPU(
           std::move(chunk_desc),
           std::move(concat_desc),
           has_random) {
-  TempFile so_file(so_template, so_suffix_len);
-  TempFile cpp_file(cpp_template, cpp_suffix_len);
-  cpp_file.write(code_);
-  cpp_file.sync();
+  // See [Fuser kernel cache]
+  const std::string stable_name = stableKernelName(name_, code_);
+  const std::string cached_path = cachedKernelPath(stable_name);
+  if (!cached_path.empty()) {
+    std::ifstream cached(cached_path);
+    if (cached.good()) {
+      try {
+        so_lib = make_unique<at::DynamicLibrary>(cached_path.c_str());
+      } catch (const c10::Error&) {
+        // Not a loadable kernel, compile it again below
+        so_lib = nullptr;
+      }
+    }
+  }
+
+  if (!so_lib) {
+    TempFile so_file(so_template, so_suffix_len);
+    TempFile cpp_file(cpp_template, cpp_suffix_len);
+    cpp_file.write(replaceAll(code_, name_, stable_name));
+    cpp_file.sync();
 #ifdef _MSC_VER
-  so_file.close();
-  cpp_file.close();
+    so_file.close();
+    cpp_file.close();
 #endif
-  runCompiler(cpp_file.name(), so_file.name());
-  if (debugFuser() >= 2)
-    disas(so_file.name());
-  so_lib = make_unique<at::DynamicLibrary>(so_file.name().c_str());
+    runCompiler(cpp_file.name(), so_file.name());
+    if (debugFuser() >= 2)
+      disas(so_file.name());
+    if (!cached_path.empty()) {
+      storeCachedKernel(so_file.name(), cached_path);
+    }
+    so_lib = make_unique<at::DynamicLibrary>(so_file.name().c_str());
+  }
 #pragma GCC diagnostic ignored "-Wpedantic"
-  kernel =
-      reinterpret_cast<void (*)(uint32_t, void**)>(so_lib->sym(name_.c_str()));
+  kernel = reinterpret_cast<void (*)(uint32_t, void**)>(
+      so_lib->sym(stable_name.c_str()));
 #pragma GCC diagnostic pop
 }
 
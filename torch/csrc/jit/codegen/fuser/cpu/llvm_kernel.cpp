@@ -0,0 +1,562 @@
+#include <torch/csrc/jit/codegen/fuser/cpu/llvm_kernel.h>
+
+#include <c10/util/Exception.h>
+#include <torch/csrc/jit/codegen/fuser/compiler.h>
+#include <torch/csrc/jit/codegen/fuser/tensor_info.h>
+#include <torch/csrc/jit/ir/constants.h>
+
+#ifdef TORCH_ENABLE_LLVM
+#include <torch/csrc/jit/tensorexpr/buffer.h>
+#include <torch/csrc/jit/tensorexpr/ir.h>
+#include <torch/csrc/jit/tensorexpr/ir_printer.h>
+#include <torch/csrc/jit/tensorexpr/llvm_codegen.h>
+#include <torch/csrc/jit/tensorexpr/mem_arena.h>
+#include <torch/csrc/jit/tensorexpr/stmt.h>
+#endif
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+namespace fuser {
+namespace cpu {
+
+// [In-process CPU kernels]
+// When the build has LLVM, CPU fusions are lowered to a tensorexpr loop and
+// compiled in process by the LLVM backend instead of running the host C++
+// compiler on the generated source. The loop is the one generateKernel
+// writes: one iteration per element of the fused map, each tensor indexed
+// through its runtime sizes and strides, and the ops computed in the calc
+// type of their output as encodeRHS does. The kernel takes its arguments in
+// the order the executor packs them (numel, then each flattened input,
+// then each flattened output), with every tensor expanded into its data
+// pointer followed by its sizes and strides, so launching it only collects
+// pointers into the TensorInfos. Fusions the lowering doesn't handle, and
+// all fusions when PYTORCH_FUSER_DISABLE_LLVM is set, go through the host
+// compiler as before.
+#ifdef TORCH_ENABLE_LLVM
+
+namespace te = ::torch::jit::tensorexpr;
+
+namespace {
+
+// Matches the OMP_THRESHOLD of the C++ kernels
+constexpr int64_t kParallelGrainSize = 100000;
+
+using ValueMap = std::unordered_map<const Value*, te::ExprHandle>;
+
+struct FusedKernelLLVM : public ::torch::jit::fuser::FusedKernel {
+  FusedKernelLLVM(
+      std::string name,
+      std::string code,
+      std::vector<TensorDesc> input_desc,
+      std::vector<TensorDesc> output_desc,
+      std::vector<PartitionDesc> chunk_desc,
+      std::vector<PartitionDesc> concat_desc,
+      bool has_random,
+      std::vector<int64_t> arg_dims,
+      std::unique_ptr<te::KernelArena> arena,
+      std::unique_ptr<te::LLVMCodeGen> codegen)
+      : FusedKernel(
+            std::move(name),
+            std::move(code),
+            std::move(input_desc),
+            std::move(output_desc),
+            std::move(chunk_desc),
+            std::move(concat_desc),
+            has_random),
+        arg_dims_(std::move(arg_dims)),
+        arena_(std::move(arena)),
+        codegen_(std::move(codegen)) {}
+
+  at::Backend backend() const override {
+    return at::Backend::CPU;
+  }
+
+  void launch_raw(const uint32_t numel, std::vector<void*>& arguments)
+      const override {
+    TORCH_CHECK(
+        numel <= static_cast<uint32_t>(std::numeric_limits<int32_t>::max()),
+        "fused CPU kernels support at most 2^31 - 1 elements, got ",
+        numel);
+    std::vector<void*> argv;
+    argv.reserve(codegen_->buffer_args().size());
+    argv.push_back(arguments[0]);
+    for (size_t i = 0; i < arg_dims_.size(); i++) {
+      void* arg = arguments[i + 1];
+      if (arg_dims_[i] < 0) {
+        argv.push_back(arg);
+        continue;
+      }
+      auto* info = static_cast<TensorInfo*>(arg);
+      argv.push_back(info->data);
+      for (int64_t d = 0; d < 2 * arg_dims_[i]; d++) {
+        argv.push_back(&info->sizes_strides[d]);
+      }
+    }
+    codegen_->value<int>(argv.data());
+  }
+
+ private:
+  // The nDim of each flattened tensor argument, or -1 for a scalar
+  std::vector<int64_t> arg_dims_;
+  // Owns the statement compiled by codegen_, so it must outlive it
+  std::unique_ptr<te::KernelArena> arena_;
+  std::unique_ptr<te::LLVMCodeGen> codegen_;
+};
+
+c10::optional<te::Dtype> calcDtype(const at::ScalarType type) {
+  switch (type) {
+    case at::kFloat:
+      return te::kFloat;
+    case at::kDouble:
+      return te::kDouble;
+    case at::kBool:
+      return te::kBool;
+    default:
+      return c10::nullopt;
+  }
+}
+
+te::ExprHandle castTo(const te::ExprHandle& e, const te::Dtype dtype) {
+  return e.dtype() == dtype ? e : te::Cast::make(dtype, e);
+}
+
+te::ExprHandle immediate(const double v, const te::Dtype dtype) {
+  if (dtype == te::kFloat) {
+    return te::ExprHandle(static_cast<float>(v));
+  }
+  return te::ExprHandle(v);
+}
+
+// `lhs op rhs ? t : f`, comparing in the promoted type of the operands like
+// the C++ kernels do
+te::ExprHandle select(
+    const te::ExprHandle& lhs,
+    const te::ExprHandle& rhs,
+    const te::ExprHandle& t,
+    const te::ExprHandle& f,
+    const te::CompareSelectOperation op) {
+  const auto type = te::promoteTypes(lhs.dtype(), rhs.dtype());
+  return te::CompareSelect::make(
+      castTo(lhs, type), castTo(rhs, type), t, f, op);
+}
+
+te::ExprHandle compare(
+    const te::ExprHandle& lhs,
+    const te::ExprHandle& rhs,
+    const te::CompareSelectOperation op) {
+  return castTo(
+      select(lhs, rhs, te::ExprHandle(1), te::ExprHandle(0), op), te::kBool);
+}
+
+// fmin/fmax: a NaN operand is ignored unless both are NaN
+te::ExprHandle fminmax(
+    const te::ExprHandle& a,
+    const te::ExprHandle& b,
+    const te::CompareSelectOperation op) {
+  // x == x is false only for NaN
+  return te::CompareSelect::make(
+      a,
+      a,
+      te::CompareSelect::make(
+          b, b, te::CompareSelect::make(a, b, a, b, op), a, te::kEQ),
+      b,
+      te::kEQ);
+}
+
+// Mirrors encodeRHS and encodeSpecialRHS in codegen.cpp. Returns nullopt for
+// nodes the lowering doesn't handle.
+c10::optional<te::ExprHandle> lowerNode(const Node* n, const ValueMap& values) {
+  const auto tensor_type = n->output()->type()->cast<TensorType>();
+  if (!tensor_type || !tensor_type->scalarType()) {
+    return c10::nullopt;
+  }
+  const auto out = calcDtype(*tensor_type->scalarType());
+  if (!out) {
+    return c10::nullopt;
+  }
+  const auto value = [&](size_t i) { return values.at(n->input(i)); };
+  // Operands are converted to the calc type of the output, except for
+  // comparisons, which use the uncasted values
+  const auto in = [&](size_t i) { return castTo(value(i), *out); };
+
+  switch (n->kind()) {
+    case aten::eq:
+      return compare(value(0), value(1), te::kEQ);
+    case aten::ne:
+      // Unordered compares as not equal, hence no kNE
+      return castTo(
+          select(
+              value(0),
+              value(1),
+              te::ExprHandle(0),
+              te::ExprHandle(1),
+              te::kEQ),
+          te::kBool);
+    case aten::ge:
+      return compare(value(0), value(1), te::kGE);
+    case aten::gt:
+      return compare(value(0), value(1), te::kGT);
+    case aten::le:
+      return compare(value(0), value(1), te::kLE);
+    case aten::lt:
+      return compare(value(0), value(1), te::kLT);
+    default:
+      break;
+  }
+
+  // Everything else computes in float or double
+  if (*out == te::kBool) {
+    return c10::nullopt;
+  }
+  const auto zero = immediate(0, *out);
+  const auto one = immediate(1, *out);
+
+  switch (n->kind()) {
+    case aten::_cast_Float:
+    case aten::type_as:
+      return in(0);
+    case aten::abs:
+      return te::fabs(in(0));
+    case aten::sigmoid:
+      return one / (one + te::exp(in(0) * immediate(-1, *out)));
+    case aten::relu:
+      return te::CompareSelect::make(in(0), zero, zero, in(0), te::kLT);
+    case aten::threshold:
+      return te::CompareSelect::make(in(0), in(1), in(2), in(0), te::kLE);
+    case aten::log:
+      return te::log(in(0));
+    case aten::log10:
+      return te::log10(in(0));
+    case aten::log2:
+      return te::log2(in(0));
+    case aten::lgamma:
+      return te::lgamma(in(0));
+    case aten::exp:
+      return te::exp(in(0));
+    case aten::expm1:
+      return te::expm1(in(0));
+    case aten::erf:
+      return te::erf(in(0));
+    case aten::erfc:
+      return te::erfc(in(0));
+    case aten::cos:
+      return te::cos(in(0));
+    case aten::acos:
+      return te::acos(in(0));
+    case aten::cosh:
+      return te::cosh(in(0));
+    case aten::sin:
+      return te::sin(in(0));
+    case aten::asin:
+      return te::asin(in(0));
+    case aten::sinh:
+      return te::sinh(in(0));
+    case aten::tan:
+      return te::tan(in(0));
+    case aten::atan:
+      return te::atan(in(0));
+    case aten::tanh:
+      return te::tanh(in(0));
+    case aten::sqrt:
+      return te::sqrt(in(0));
+    case aten::rsqrt:
+      return te::rsqrt(in(0));
+    case aten::ceil:
+      return te::ceil(in(0));
+    case aten::floor:
+      return te::floor(in(0));
+    case aten::round:
+      return te::round(in(0));
+    case aten::trunc:
+      return te::trunc(in(0));
+    case aten::frac:
+      return in(0) - te::trunc(in(0));
+    case aten::reciprocal:
+      return one / in(0);
+    case aten::neg:
+      return in(0) * immediate(-1, *out);
+    case aten::atan2:
+      return te::atan2(in(0), in(1));
+    case aten::min:
+      return fminmax(in(0), in(1), te::kLT);
+    case aten::max:
+      return fminmax(in(0), in(1), te::kGT);
+    case aten::addcmul:
+      return in(0) + in(3) * in(1) * in(2);
+    case aten::div:
+      return in(0) / in(1);
+    case aten::fmod:
+      return te::fmod(in(0), in(1));
+    case aten::lerp:
+      return in(0) + in(2) * (in(1) - in(0));
+    case aten::mul:
+      return in(0) * in(1);
+    case aten::remainder:
+      return te::fmod(in(1) + te::fmod(in(0), in(1)), in(1));
+    case aten::pow:
+      return te::pow(in(0), in(1));
+    case aten::add:
+      return in(0) + in(2) * in(1);
+    case aten::sub:
+      return in(0) - in(2) * in(1);
+    case aten::where:
+      return te::CompareSelect::make(
+          castTo(value(0), te::kInt),
+          te::ExprHandle(0),
+          in(2),
+          in(1),
+          te::kEQ);
+    case aten::_sigmoid_backward:
+      return in(0) * in(1) * (one - in(1));
+    case aten::_tanh_backward:
+      return in(0) * (one - in(1) * in(1));
+    case aten::clamp: {
+      // The bounds come first so that a NaN bound is ignored, and a NaN input
+      // stays NaN
+      const auto min = n->input(1);
+      const auto max = n->input(2);
+      const auto x = value(0);
+      if (!min->node()->mustBeNone() && !max->node()->mustBeNone()) {
+        return select(
+            x,
+            value(1),
+            in(1),
+            select(x, value(2), in(2), in(0), te::kGT),
+            te::kLT);
+      } else if (min->node()->mustBeNone()) {
+        return select(x, value(2), in(2), in(0), te::kGT);
+      } else if (max->node()->mustBeNone()) {
+        return select(x, value(1), in(1), in(0), te::kLT);
+      }
+      return c10::nullopt;
+    }
+    default:
+      return c10::nullopt;
+  }
+}
+
+// A tensor argument of the kernel: its buffer, and the element offset of the
+// current iteration computed from its sizes and strides as emitIndexingFor
+// does in codegen.cpp
+struct TensorArg {
+  te::BufHandle buf;
+  te::ExprHandle offset;
+};
+
+TensorArg addTensorArg(
+    const std::string& name,
+    const TensorDesc& desc,
+    const te::VarHandle& numel,
+    const te::VarHandle& index,
+    const te::Dtype dtype,
+    std::vector<te::CodeGen::BufferArg>& args) {
+  te::BufHandle buf(name, {numel}, dtype);
+  args.emplace_back(te::Buffer(buf));
+
+  const int nDim = desc.nDim();
+  std::vector<te::VarHandle> sizes;
+  std::vector<te::VarHandle> strides;
+  for (int d = 0; d < nDim; d++) {
+    sizes.emplace_back(name + "_size" + c10::to_string(d), te::kInt);
+    args.emplace_back(sizes.back());
+  }
+  for (int d = 0; d < nDim; d++) {
+    strides.emplace_back(name + "_stride" + c10::to_string(d), te::kInt);
+    args.emplace_back(strides.back());
+  }
+
+  te::ExprHandle offset(0);
+  te::ExprHandle linear_index = index;
+  for (int d = nDim - 1; d >= 0; --d) {
+    te::ExprHandle dim_index = d > 0 ? linear_index % sizes[d] : linear_index;
+    if (d < nDim - 1 || !desc.lastIsContiguous()) {
+      dim_index = dim_index * strides[d];
+    }
+    offset = d == nDim - 1 ? dim_index : offset + dim_index;
+    if (d > 0) {
+      linear_index = linear_index / sizes[d];
+    }
+  }
+  return {buf, offset};
+}
+
+bool llvmDisabled() {
+  static const bool disabled = [] {
+    const char* env = std::getenv("PYTORCH_FUSER_DISABLE_LLVM");
+    return env && std::string(env) != "0";
+  }();
+  return disabled;
+}
+
+} // namespace
+
+std::shared_ptr<FusedKernel> compileLLVMKernel(
+    const std::string& name,
+    const Graph& graph,
+    const std::vector<std::pair<const Value*, const c10::optional<TensorDesc>>>&
+        flat_inputs,
+    const std::vector<std::pair<const Value*, const TensorDesc>>& flat_outputs,
+    std::vector<TensorDesc> input_desc,
+    std::vector<TensorDesc> output_desc,
+    std::vector<PartitionDesc> chunk_desc,
+    std::vector<PartitionDesc> concat_desc,
+    bool has_random) {
+  if (llvmDisabled() || has_random) {
+    return nullptr;
+  }
+
+  auto arena = std::make_unique<te::KernelArena>();
+  te::KernelScope kernel_scope(arena.get());
+
+  te::VarHandle numel("numel", te::kInt);
+  te::VarHandle index("linear_index", te::kInt);
+  std::vector<te::CodeGen::BufferArg> args{numel};
+  std::vector<int64_t> arg_dims;
+
+  // Every value is bound once per iteration, so that it's computed once no
+  // matter how many nodes use it
+  ValueMap values;
+  te::Block::VarMapping bindings;
+  const auto bind = [&](const Value* v, const te::ExprHandle& e) {
+    te::VarHandle var("n" + c10::to_string(v->unique()), e.dtype());
+    bindings.emplace_back(var.node(), e.node());
+    values.emplace(v, var);
+  };
+
+  for (const auto& input : flat_inputs) {
+    const std::string formal = "t" + c10::to_string(arg_dims.size());
+    if (!input.second) {
+      te::VarHandle scalar(formal, te::kDouble);
+      args.emplace_back(scalar);
+      arg_dims.push_back(-1);
+      values.emplace(input.first, scalar);
+      continue;
+    }
+    const auto& desc = *input.second;
+    const auto dtype = calcDtype(desc.scalar_type);
+    if (!dtype) {
+      return nullptr;
+    }
+    const auto arg = addTensorArg(formal, desc, numel, index, *dtype, args);
+    arg_dims.push_back(desc.nDim());
+    bind(
+        input.first,
+        te::Load::make(*dtype, arg.buf, {arg.offset}, te::ExprHandle(1)));
+  }
+
+  for (const Node* n : graph.nodes()) {
+    // Chunks and concats are handled by the flattened inputs and outputs
+    if (n->kind() == prim::FusedConcat || n->kind() == prim::ConstantChunk ||
+        n->mustBeNone()) {
+      continue;
+    }
+    if (n->kind() == prim::Constant) {
+      const auto val = toIValue(n->output()).value();
+      if (val.isDouble()) {
+        values.emplace(n->output(), te::ExprHandle(val.toDouble()));
+      } else if (val.isBool()) {
+        values.emplace(n->output(), te::ExprHandle(val.toBool()));
+      } else if (val.isInt()) {
+        values.emplace(n->output(), te::ExprHandle(val.toInt()));
+      } else {
+        return nullptr;
+      }
+      continue;
+    }
+    const auto e = lowerNode(n, values);
+    if (!e) {
+      if (debugFuser()) {
+        std::cerr << "fuser: no in-process lowering for "
+                  << n->kind().toQualString() << ", compiling " << name
+                  << " with the host compiler\n";
+      }
+      return nullptr;
+    }
+    bind(n->output(), *e);
+  }
+
+  std::vector<te::Stmt*> stores;
+  for (const auto& output : flat_outputs) {
+    const std::string formal = "t" + c10::to_string(arg_dims.size());
+    const auto& desc = output.second;
+    const auto dtype = calcDtype(desc.scalar_type);
+    if (!dtype) {
+      return nullptr;
+    }
+    const auto arg = addTensorArg(formal, desc, numel, index, *dtype, args);
+    arg_dims.push_back(desc.nDim());
+    stores.push_back(te::Store::make(
+        arg.buf,
+        {arg.offset},
+        castTo(values.at(output.first), *dtype),
+        te::ExprHandle(1)));
+  }
+
+  te::LoopOptions loop_options;
+  loop_options.set_parallel(kParallelGrainSize);
+  te::Stmt* loop = te::For::make(
+      index,
+      te::ExprHandle(0),
+      numel,
+      te::Block::make(bindings, stores),
+      loop_options);
+
+  std::unique_ptr<te::LLVMCodeGen> codegen;
+  try {
+    codegen = std::make_unique<te::LLVMCodeGen>(loop, args, at::kCPU);
+  } catch (const std::exception& e) {
+    if (debugFuser()) {
+      std::cerr << "fuser: in-process compilation of " << name
+                << " failed, compiling it with the host compiler: "
+                << e.what() << "\n";
+    }
+    return nullptr;
+  }
+
+  std::ostringstream code;
+  code << *loop;
+  if (debugFuser()) {
+    std::cerr << "fusion code:" << code.str() << std::endl;
+  }
+  return std::make_shared<FusedKernelLLVM>(
+      name,
+      code.str(),
+      std::move(input_desc),
+      std::move(output_desc),
+      std::move(chunk_desc),
+      std::move(concat_desc),
+      has_random,
+      std::move(arg_dims),
+      std::move(arena),
+      std::move(codegen));
+}
+
+#else
+
+std::shared_ptr<FusedKernel> compileLLVMKernel(
+    const std::string& name,
+    const Graph& graph,
+    const std::vector<std::pair<const Value*, const c10::optional<TensorDesc>>>&
+        flat_inputs,
+    const std::vector<std::pair<const Value*, const TensorDesc>>& flat_outputs,
+    std::vector<TensorDesc> input_desc,
+    std::vector<TensorDesc> output_desc,
+    std::vector<PartitionDesc> chunk_desc,
+    std::vector<PartitionDesc> concat_desc,
+    bool has_random) {
+  return nullptr;
+}
+
+#endif // TORCH_ENABLE_LLVM
+
+} // namespace cpu
+} // namespace fuser
+} // namespace jit
+} // namespace torch
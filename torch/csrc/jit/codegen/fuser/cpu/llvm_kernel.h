@@ -0,0 +1,40 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <c10/util/Optional.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/codegen/fuser/fused_kernel.h>
+#include <torch/csrc/jit/codegen/fuser/partition_desc.h>
+#include <torch/csrc/jit/codegen/fuser/tensor_desc.h>
+#include <torch/csrc/jit/ir/ir.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace fuser {
+namespace cpu {
+
+// Compiles a CPU fusion in process with the tensorexpr LLVM backend, see
+// [In-process CPU kernels]. Returns nullptr if the build has no LLVM or the
+// graph uses an op or dtype the lowering doesn't handle; the caller then
+// compiles the generated C++ source with the host compiler instead.
+TORCH_API std::shared_ptr<FusedKernel> compileLLVMKernel(
+    const std::string& name,
+    const Graph& graph,
+    const std::vector<std::pair<const Value*, const c10::optional<TensorDesc>>>&
+        flat_inputs,
+    const std::vector<std::pair<const Value*, const TensorDesc>>& flat_outputs,
+    std::vector<TensorDesc> input_desc,
+    std::vector<TensorDesc> output_desc,
+    std::vector<PartitionDesc> chunk_desc,
+    std::vector<PartitionDesc> concat_desc,
+    bool has_random);
+
+} // namespace cpu
+} // namespace fuser
+} // namespace jit
+} // namespace torch
@@ -53,7 +53,11 @@ namespace jit {
   _(FORK, "CN") /* launch a thread to run code entry x with N inputs  */    \
   _(WARN, "") /* emit a warning with line information */                    \
   _(ENTER, "EN") /* enter scope of a contextmanager */                      \
-  _(EXIT, "EX") /* exit the last entered contextmanager */
+  _(EXIT, "EX") /* exit the last entered contextmanager */                  \
+  /* superinstructions, see [Superinstructions] in interpreter.cpp */       \
+  _(LOAD_OP_STORE, "I") /* run X instructions: loads, OP, STORE */          \
+  _(GET_ATTR_CHAIN, "I") /* run X instructions: a load, GET_ATTRs */        \
+  _(LIST_CONSTRUCT_OP, "I") /* run X: loads, LIST_CONSTRUCT, loads, OP */
 
 enum OpCode : uint8_t {
 #define DEFINE_OP(op, _) op,
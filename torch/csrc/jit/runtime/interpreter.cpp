@@ -28,8 +28,10 @@
 using torch::distributed::autograd::DistAutogradContainer;
 #endif
 
+#include <atomic>
 #include <exception>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <ostream>
@@ -40,9 +42,21 @@ using torch::distributed::autograd::DistAutogradContainer;
 #include <utility>
 #include <vector>
 
+// The interpreter dispatches with computed gotos (see runImpl) where the
+// compiler supports them
+#if defined(__GNUC__) || defined(__clang__)
+#define JIT_USE_COMPUTED_GOTO
+#endif
+
 namespace torch {
 namespace jit {
 
+static std::atomic<bool> superinstructions_enabled{true};
+
+std::atomic<bool>& getSuperinstructionsEnabled() {
+  return superinstructions_enabled;
+}
+
 // Before we translate to intepreter instructions, we do
 // some preprocessing of the graph to turn it into a form that is closer
 // to what the instructions will look like.
@@ -411,9 +425,30 @@ struct BailoutBlock {
   std::vector<Instruction> instructions; // ends in a TAIL_CALL
 };
 
+// [Superinstructions]
+// Most instructions do little work, so the cost of dispatching them
+// dominates control-heavy programs. Once the code is emitted, frequent
+// straight-line sequences are replaced by superinstructions that run the
+// whole sequence with a single dispatch:
+//
+// * LOAD_OP_STORE: loads (LOAD, MOVE or LOADC), an OP and a STORE
+// * GET_ATTR_CHAIN: a LOAD or MOVE of an object and one or more GET_ATTRs,
+//   e.g. self.sub.weight; only the last attribute is pushed
+// * LIST_CONSTRUCT_OP: loads, a LIST_CONSTRUCT, loads and an OP, e.g.
+//   x.view([a, b])
+//
+// A superinstruction replaces the first instruction of its sequence, and
+// X is the length of the sequence. The other instructions stay in place,
+// so jump offsets, instructions_source_ and bailout requests are
+// unaffected, and jumping into the middle of a sequence runs the original
+// instructions from there. The superinstruction reads the replaced one from
+// unfused_instructions_, which is also what gets exported to mobile.
 struct CodeImpl {
   friend struct InterpreterState;
+  // what the interpreter runs, with superinstructions
   std::vector<Instruction> instructions_;
+  // the instructions as emitted, see [Superinstructions]
+  std::vector<Instruction> unfused_instructions_;
 
   // same length as instructions.
   // what node in the graph cause this
@@ -483,6 +518,7 @@ struct CodeImpl {
     // we deferred the emission of bailout blocks so they appear at the end
     // emit them now and patch up the jumps
     insertBailoutBlocks();
+    insertSuperinstructions();
   }
 
   const std::vector<c10::IValue>& constant_table() const {
@@ -510,7 +546,7 @@ struct CodeImpl {
   }
 
   const std::vector<Instruction>& instructions() const {
-    return instructions_;
+    return unfused_instructions_;
   }
 
   const std::vector<Node*>& instructions_source() const {
@@ -772,6 +808,62 @@ struct CodeImpl {
           instructions_source_[block.jf_instruction_index]);
     }
   }
+
+  static bool isLoad(OpCode op) {
+    return op == LOAD || op == MOVE || op == LOADC;
+  }
+
+  // Returns the superinstruction for the sequence starting at `start`, if
+  // there is one
+  c10::optional<Instruction> superinstructionAt(size_t start) const {
+    const auto& insts = unfused_instructions_;
+    const size_t size = insts.size();
+    size_t i = start;
+    if ((insts[i].op == LOAD || insts[i].op == MOVE) && i + 1 < size &&
+        insts[i + 1].op == GET_ATTR) {
+      i += 2;
+      while (i < size && insts[i].op == GET_ATTR) {
+        ++i;
+      }
+      return Instruction(GET_ATTR_CHAIN, i - start, 0);
+    }
+    while (i < size && isLoad(insts[i].op)) {
+      ++i;
+    }
+    if (i + 1 < size && insts[i].op == OP && insts[i + 1].op == STORE) {
+      return Instruction(LOAD_OP_STORE, i + 2 - start, 0);
+    }
+    if (i < size && insts[i].op == LIST_CONSTRUCT &&
+        i - start <= std::numeric_limits<uint16_t>::max()) {
+      const size_t list_construct = i++;
+      while (i < size && isLoad(insts[i].op)) {
+        ++i;
+      }
+      if (i < size && insts[i].op == OP) {
+        return Instruction(
+            LIST_CONSTRUCT_OP, i + 1 - start, list_construct - start);
+      }
+    }
+    return c10::nullopt;
+  }
+
+  // See [Superinstructions]
+  void insertSuperinstructions() {
+    unfused_instructions_ = instructions_;
+    if (!getSuperinstructionsEnabled()) {
+      return;
+    }
+    size_t i = 0;
+    while (i < instructions_.size()) {
+      if (auto super = superinstructionAt(i)) {
+        instructions_[i] = *super;
+        i += super->X;
+      } else {
+        ++i;
+      }
+    }
+  }
+
   void emitInterfaceCall(
       std::string method_name_str,
       c10::ArrayRef<Value*> inputs) {
@@ -966,6 +1058,25 @@ struct CodeImpl {
   }
 };
 
+// Labels and dispatch for the cases of runImpl. With computed gotos, every
+// instruction jumps straight to the code of the next one; otherwise, and for
+// cases that `break`, the loop in runImpl dispatches with its switch.
+#ifdef JIT_USE_COMPUTED_GOTO
+#define INST(NAME) \
+  NAME:            \
+  label_##NAME
+#define INST_DISPATCH            \
+  inst = af.instructions[af.pc]; \
+  goto* dispatch_table[inst.op]
+#else
+#define INST(NAME) NAME
+#define INST_DISPATCH break
+#endif
+
+#define INST_NEXT \
+  ++af.pc;        \
+  INST_DISPATCH
+
 // InterpreterState state that and used to compute a Code
 struct InterpreterStateImpl : c10::intrusive_ptr_target {
   InterpreterStateImpl(const Code& code) {
@@ -1024,6 +1135,8 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
   struct ActiveFrame {
     size_t pc;
     Instruction* instructions;
+    // read by superinstructions
+    const Instruction* unfused_instructions;
     IValue* constants;
     Operation* operators;
     Function** functions;
@@ -1033,6 +1146,7 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     ActiveFrame(const Frame& frame)
         : pc(frame.pc),
           instructions(frame.function->instructions_.data()),
+          unfused_instructions(frame.function->unfused_instructions_.data()),
           constants(frame.function->constant_table_.data()),
           operators(frame.function->operator_table_.data()),
           functions(frame.function->function_table_.data()),
@@ -1065,6 +1179,17 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     return *(registers.end() - reg);
   }
 
+  // Runs a LOAD, MOVE or LOADC that is part of a superinstruction
+  void loadOperand(Stack& stack, const ActiveFrame& af, Instruction inst) {
+    if (inst.op == LOAD) {
+      stack.emplace_back(reg(inst.X));
+    } else if (inst.op == MOVE) {
+      stack.emplace_back(std::move(reg(inst.X)));
+    } else {
+      stack.emplace_back(af.constants[inst.X]);
+    }
+  }
+
   void dump(std::ostream& out, const Stack& stack) const {
     out << "Stack:\n";
     for (const auto& val : stack) {
@@ -1125,19 +1250,26 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     }
 
     ActiveFrame af(frames.back());
+#ifdef JIT_USE_COMPUTED_GOTO
+    static void* dispatch_table[] = {
+#define DISPATCH_TABLE_ENTRY(op, _) &&label_##op,
+        FORALL_OPCODES(DISPATCH_TABLE_ENTRY)
+#undef DISPATCH_TABLE_ENTRY
+    };
+#endif
     try {
       while (true) {
         // std::cout << "RUNNING ";
         // frames.back().function->dump(std::cout, af.pc);
         Instruction inst = af.instructions[af.pc];
         switch (inst.op) {
-          case ENTER: {
+          case INST(ENTER): {
             auto obj = peek(stack, 0, 1);
             TORCH_INTERNAL_ASSERT(obj.isObject());
             entered_objects.push_back(obj);
-            ++af.pc;
-          } break;
-          case EXIT: {
+          }
+            INST_NEXT;
+          case INST(EXIT): {
             auto obj = entered_objects.back().toObject();
             auto& f = obj->type()->getMethod("__exit__");
             push(stack, obj);
@@ -1147,64 +1279,55 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
             push(stack, IValue());
             runGraphFunction(stack, &f, &af);
           } break;
-          case OP:
+          case INST(OP):
             af.operators[inst.X](&stack);
-            ++af.pc;
-            break;
-          case OPN:
+            INST_NEXT;
+          case INST(OPN):
             stack.push_back(inst.N);
             af.operators[inst.X](&stack);
-            ++af.pc;
-            break;
-          case LOAD:
+            INST_NEXT;
+          case INST(LOAD):
             stack.emplace_back(reg(inst.X));
-            ++af.pc;
-            break;
-          case MOVE:
+            INST_NEXT;
+          case INST(MOVE):
             stack.emplace_back(std::move(reg(inst.X)));
-            ++af.pc;
-            break;
-          case STORE:
+            INST_NEXT;
+          case INST(STORE):
             reg(inst.X) = pop(stack);
-            ++af.pc;
-            break;
-          case STOREN:
+            INST_NEXT;
+          case INST(STOREN):
             for (size_t i = inst.N; i > 0; --i) {
               reg(inst.X + i - 1) = pop(stack);
             }
-            ++af.pc;
-            break;
-          case DROP:
+            INST_NEXT;
+          case INST(DROP):
             pop(stack);
-            ++af.pc;
-            break;
-          case DROPR:
+            INST_NEXT;
+          case INST(DROPR):
             reg(inst.X) = IValue();
-            ++af.pc;
-            break;
-          case LOADC:
+            INST_NEXT;
+          case INST(LOADC):
             stack.emplace_back(af.constants[inst.X]);
-            ++af.pc;
-            break;
-          case GET_ATTR: {
+            INST_NEXT;
+          case INST(GET_ATTR): {
             auto userObj = pop(stack).toObject();
             auto value = userObj->getSlot(inst.X);
             push(stack, std::move(value));
-            ++af.pc;
-          } break;
-          case SET_ATTR: {
+          }
+            INST_NEXT;
+          case INST(SET_ATTR): {
             auto v = pop(stack);
             auto userObj = pop(stack).toObject();
             userObj->setSlot(inst.X, std::move(v));
-            ++af.pc;
-          } break;
-          case JF:
+          }
+            INST_NEXT;
+          case INST(JF):
             af.pc += (pop(stack).toBool()) ? 1 : inst.X;
-            break;
-          case JMP:
+            INST_DISPATCH;
+          case INST(JMP):
             af.pc += inst.X;
-            break;
-          case LOOP: {
+            INST_DISPATCH;
+          case INST(LOOP): {
             // stack: iteration_count, max_iter, cond, loop_carried_deps...
             auto frame = stack.end() - (inst.N + 1);
             int64_t trip_count = frame[0].toInt();
@@ -1222,8 +1345,9 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
               drop(stack, 3); // iteration_count, max_iter, cond
               af.pc += inst.X;
             }
-          } break;
-          case CALL: {
+          }
+            INST_DISPATCH;
+          case INST(CALL): {
             Function* fn = af.functions[inst.X];
             if (!fn->isGraphFunction()) {
               runBuiltinFunction(stack, fn, &af);
@@ -1231,7 +1355,7 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
               runGraphFunction(stack, fn, &af);
             }
           } break;
-          case INTERFACE_CALL: {
+          case INST(INTERFACE_CALL): {
             // note the hash table lookup to find the function
             // this can be more optimized if necessary, caching parts
             // of the hashing computation or storing the offset when
@@ -1255,7 +1379,7 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
               runGraphFunction(stack, &function, &af);
             }
           } break;
-          case RET:
+          case INST(RET):
             if (frames.size() > 1) {
               leaveFrame();
               af = ActiveFrame(frames.back());
@@ -1271,7 +1395,7 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
               }
             }
             return false;
-          case WAIT: {
+          case INST(WAIT): {
             auto future = stack.back().toFuture();
             if (!future->completed()) {
               getOrCreateFuture();
@@ -1323,9 +1447,9 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
             }
             stack.pop_back();
             stack.emplace_back(future->value());
-            ++af.pc;
-          } break;
-          case PROFILE_OP: {
+          }
+            INST_NEXT;
+          case INST(PROFILE_OP): {
             auto& frame_id_ref = frames.back().id;
             if (!frame_id_ref.has_value()) {
               frame_id_ref = Frame::num_frames++;
@@ -1333,19 +1457,17 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
             auto callback = af.profile_functions[inst.X];
             push(stack, c10::IValue{static_cast<int64_t>(*frame_id_ref)});
             callback(stack);
-            ++af.pc;
-            break;
+            INST_NEXT;
           }
-          case FAIL_GUARD: {
+          case INST(FAIL_GUARD): {
             // patch FAIL_GUARD back to GUARD
             GRAPH_DEBUG(
                 "Bailout ", inst.X, " triggered via bailout_requests_!");
             af.instructions[af.pc].op = GUARD;
             push(stack, false);
-            ++af.pc;
-            break;
+            INST_NEXT;
           }
-          case GUARD: {
+          case INST(GUARD): {
             if (!stack.back().isTensor()) {
               // stack.back() is an Uninitialized IValue and this is a guard
               // on a block output. Uninitialized IValues are never used
@@ -1363,9 +1485,9 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
                 push(stack, expected_type->matchTensor(t));
               }
             }
-            ++af.pc;
-          } break;
-          case TAIL_CALL: {
+          }
+            INST_NEXT;
+          case INST(TAIL_CALL): {
             GRAPH_DEBUG("running TAIL_CALL for ", inst.X);
             af.functions[inst.X]->ensure_defined();
             size_t remaining_bailout_depth =
@@ -1389,45 +1511,45 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
             enterFrame(code, base_pointer);
             af = ActiveFrame(frames.back());
           } break;
-          case LIST_UNPACK: {
+          case INST(LIST_UNPACK): {
             listUnpack(stack, inst.X);
-            ++af.pc;
-          } break;
-          case TUPLE_CONSTRUCT: {
+          }
+            INST_NEXT;
+          case INST(TUPLE_CONSTRUCT): {
             tupleConstruct(stack, inst.X);
-            ++af.pc;
-          } break;
-          case TUPLE_SLICE: {
+          }
+            INST_NEXT;
+          case INST(TUPLE_SLICE): {
             tupleSlice(stack, inst.X, inst.X + inst.N);
-            ++af.pc;
-          } break;
-          case NAMED_TUPLE_CONSTRUCT: {
+          }
+            INST_NEXT;
+          case INST(NAMED_TUPLE_CONSTRUCT): {
             auto type = af.types[inst.X]->expect<TupleType>();
             namedTupleConstruct(stack, type, inst.N);
-            ++af.pc;
-          } break;
-          case LIST_CONSTRUCT: {
+          }
+            INST_NEXT;
+          case INST(LIST_CONSTRUCT): {
             auto type = af.types[inst.X]->expect<ListType>();
             listConstruct(stack, type, inst.N);
-            ++af.pc;
-          } break;
-          case DICT_CONSTRUCT: {
+          }
+            INST_NEXT;
+          case INST(DICT_CONSTRUCT): {
             auto type = af.types[inst.X]->expect<DictType>();
             dictConstruct(stack, type, inst.N);
-            ++af.pc;
-          } break;
-          case CREATE_OBJECT: {
+          }
+            INST_NEXT;
+          case INST(CREATE_OBJECT): {
             auto type = af.types[inst.X]->expect<ClassType>();
             createObject(stack, type);
-            ++af.pc;
-          } break;
-          case ISINSTANCE: {
+          }
+            INST_NEXT;
+          case INST(ISINSTANCE): {
             at::ArrayRef<TypePtr> types(
                 af.types + inst.X, af.types + inst.X + inst.N);
             isinstance(stack, types);
-            ++af.pc;
-          } break;
-          case FORK: {
+          }
+            INST_NEXT;
+          case INST(FORK): {
             // Move inputs to a separate stack
             Function* forked_fn = af.functions[inst.X];
             InterpreterState forked_interpreter(
@@ -1441,9 +1563,9 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
             drop(stack, inst.N);
             push(stack, forked_interpreter.getFuture());
             at::launch(std::move(continuation));
-            ++af.pc;
-          } break;
-          case WARN: {
+          }
+            INST_NEXT;
+          case INST(WARN): {
             Node* node = frames.back().function->instructions_source_.at(af.pc);
             auto range = node->sourceRange().source();
             if (range->filename()) {
@@ -1460,8 +1582,53 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
             } else {
               TORCH_WARN(pop(stack).toStringRef());
             }
-            ++af.pc;
-          } break;
+          }
+            INST_NEXT;
+          case INST(LOAD_OP_STORE): {
+            const Instruction* seq = af.unfused_instructions + af.pc;
+            const int32_t op_index = inst.X - 2;
+            for (int32_t i = 0; i < op_index; ++i) {
+              loadOperand(stack, af, seq[i]);
+            }
+            // errors are reported for the OP
+            af.pc += op_index;
+            af.operators[seq[op_index].X](&stack);
+            reg(seq[op_index + 1].X) = pop(stack);
+            af.pc += 2;
+          }
+            INST_DISPATCH;
+          case INST(GET_ATTR_CHAIN): {
+            // only the last attribute is copied onto the stack
+            const Instruction* seq = af.unfused_instructions + af.pc;
+            IValue& object = reg(seq[0].X);
+            const IValue* value = &object;
+            for (int32_t i = 1; i < inst.X; ++i) {
+              value = &value->toObjectRef().getSlot(seq[i].X);
+            }
+            stack.push_back(*value);
+            if (seq[0].op == MOVE) {
+              object = IValue();
+            }
+            af.pc += inst.X;
+          }
+            INST_DISPATCH;
+          case INST(LIST_CONSTRUCT_OP): {
+            // N is the index of the LIST_CONSTRUCT in the sequence
+            const Instruction* seq = af.unfused_instructions + af.pc;
+            const int32_t op_index = inst.X - 1;
+            for (int32_t i = 0; i < inst.N; ++i) {
+              loadOperand(stack, af, seq[i]);
+            }
+            const Instruction& list = seq[inst.N];
+            listConstruct(stack, af.types[list.X]->expect<ListType>(), list.N);
+            for (int32_t i = inst.N + 1; i < op_index; ++i) {
+              loadOperand(stack, af, seq[i]);
+            }
+            // errors are reported for the OP
+            af.pc += op_index;
+            af.operators[seq[op_index].X](&stack);
+          }
+            INST_NEXT;
         }
       }
     } catch (std::exception& e) {
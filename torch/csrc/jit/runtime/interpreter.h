@@ -1,5 +1,6 @@
 #pragma once
 #include <c10/util/Optional.h>
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -126,5 +127,9 @@ struct InterpreterContinuation {
 TORCH_API at::TensorTypePtr tensorTypeInCurrentExecutionContext(
     const at::Tensor& t);
 
+// Whether Code created from now on runs frequent instruction sequences as
+// superinstructions (see [Superinstructions] in interpreter.cpp)
+TORCH_API std::atomic<bool>& getSuperinstructionsEnabled();
+
 } // namespace jit
 } // namespace torch
@@ -0,0 +1,798 @@
+#include <torch/csrc/jit/runtime/profiling_cache.h>
+
+#include <ATen/Version.h>
+#include <c10/util/ConstexprCrc.h>
+#include <torch/csrc/jit/codegen/fuser/interface.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/tensorexpr_fuser.h>
+#include <torch/csrc/jit/python/update_graph_executor_opt.h>
+#include <torch/csrc/jit/runtime/graph_executor.h>
+#include <torch/csrc/jit/runtime/graph_executor_impl.h>
+#include <torch/csrc/jit/serialization/pickle.h>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// First line of every cached profile; bump the version whenever the format
+// or the meaning of a profile changes
+constexpr const char* kProfileHeader = "pytorch_jit_profile 1";
+// First element of every cached plan, likewise
+constexpr const char* kPlanHeader = "pytorch_jit_plan 1";
+
+std::mutex& profileCacheMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::string& profileCacheDirectory() {
+  static std::string dir = []() -> std::string {
+    const char* env = std::getenv("PYTORCH_JIT_PROFILE_CACHE_DIR");
+    return env ? env : "";
+  }();
+  return dir;
+}
+
+long processId() {
+#ifdef _WIN32
+  return static_cast<long>(_getpid());
+#else
+  return static_cast<long>(getpid());
+#endif
+}
+
+// The outputs of the prim::profile nodes that record types, in a fixed
+// order. The counter at the end of the graph has no outputs.
+void collectProfiledValues(Block* block, std::vector<Value*>& values) {
+  for (Node* n : block->nodes()) {
+    if (n->kind() == prim::profile && n->outputs().size() == 1) {
+      values.push_back(n->output());
+    }
+    for (Block* b : n->blocks()) {
+      collectProfiledValues(b, values);
+    }
+  }
+}
+
+template <typename T>
+void writeOptional(std::ostream& out, const c10::optional<T>& value) {
+  if (value) {
+    out << ' ' << *value;
+  } else {
+    out << " -";
+  }
+}
+
+std::string readToken(std::istream& in) {
+  std::string token;
+  in >> token;
+  TORCH_CHECK(in, "truncated profile");
+  return token;
+}
+
+template <typename T>
+T parseToken(const std::string& token) {
+  std::istringstream ss(token);
+  T value;
+  ss >> value;
+  TORCH_CHECK(ss && ss.eof(), "unexpected token in profile: ", token);
+  return value;
+}
+
+template <typename T>
+c10::optional<T> readOptional(std::istream& in) {
+  const std::string token = readToken(in);
+  if (token == "-") {
+    return c10::nullopt;
+  }
+  return parseToken<T>(token);
+}
+
+// Writes `type` on one line. Dynamic shape symbols are numbered in the
+// order they're first seen across the whole profile, so that dimensions
+// sharing a symbol still share one once read back.
+void writeType(
+    std::ostream& out,
+    const TensorTypePtr& type,
+    std::map<c10::ShapeSymbol, size_t>& symbol_ids) {
+  c10::optional<int> scalar_type;
+  if (type->scalarType()) {
+    scalar_type = static_cast<int>(*type->scalarType());
+  }
+  c10::optional<std::string> device;
+  if (type->device()) {
+    device = type->device()->str();
+  }
+  writeOptional(out, scalar_type);
+  writeOptional(out, device);
+  writeOptional(out, type->requiresGrad());
+  writeOptional(out, type->undefined());
+
+  const auto sizes = type->symbolic_sizes().sizes();
+  writeOptional(out, type->symbolic_sizes().rank());
+  if (sizes) {
+    for (const auto& symbol : *sizes) {
+      if (symbol.is_static()) {
+        out << ' ' << symbol.static_size();
+      } else {
+        auto it = symbol_ids.emplace(symbol, symbol_ids.size()).first;
+        out << " s" << it->second;
+      }
+    }
+  }
+
+  const auto& strides = type->stride_properties().sizes();
+  writeOptional(out, type->stride_properties().size());
+  if (strides) {
+    for (const auto& stride : *strides) {
+      if (!stride) {
+        out << " x";
+        continue;
+      }
+      out << " +";
+      writeOptional(out, stride->stride_index_);
+      writeOptional(out, stride->contiguous_);
+      writeOptional(out, stride->stride_);
+    }
+  }
+  out << '\n';
+}
+
+TensorTypePtr readType(
+    std::istream& in,
+    std::map<size_t, c10::ShapeSymbol>& symbols) {
+  c10::optional<at::ScalarType> scalar_type;
+  if (auto st = readOptional<int>(in)) {
+    TORCH_CHECK(
+        *st >= 0 && *st < static_cast<int>(at::ScalarType::NumOptions),
+        "unknown scalar type in profile: ",
+        *st);
+    scalar_type = static_cast<at::ScalarType>(*st);
+  }
+  c10::optional<at::Device> device;
+  if (auto d = readOptional<std::string>(in)) {
+    device = at::Device(*d);
+  }
+  const auto requires_grad = readOptional<bool>(in);
+  const auto undefined = readOptional<bool>(in);
+
+  c10::SymbolicShape sizes;
+  if (auto rank = readOptional<size_t>(in)) {
+    std::vector<c10::ShapeSymbol> dims;
+    for (size_t i = 0; i < *rank; i++) {
+      const std::string token = readToken(in);
+      if (token[0] == 's') {
+        const auto id = parseToken<size_t>(token.substr(1));
+        auto it = symbols.find(id);
+        if (it == symbols.end()) {
+          it = symbols.emplace(id, c10::ShapeSymbol::newSymbol()).first;
+        }
+        dims.push_back(it->second);
+      } else {
+        dims.push_back(
+            c10::ShapeSymbol::fromStaticSize(parseToken<int64_t>(token)));
+      }
+    }
+    sizes = c10::SymbolicShape(dims);
+  }
+
+  c10::VaryingShape<c10::Stride> strides;
+  if (auto rank = readOptional<size_t>(in)) {
+    std::vector<c10::optional<c10::Stride>> dims;
+    for (size_t i = 0; i < *rank; i++) {
+      const std::string marker = readToken(in);
+      if (marker == "x") {
+        dims.emplace_back(c10::nullopt);
+        continue;
+      }
+      TORCH_CHECK(marker == "+", "unexpected token in profile: ", marker);
+      const auto stride_index = readOptional<size_t>(in);
+      const auto contiguous = readOptional<bool>(in);
+      const auto stride = readOptional<size_t>(in);
+      dims.emplace_back(c10::Stride(stride_index, contiguous, stride));
+    }
+    strides = c10::VaryingShape<c10::Stride>(dims);
+  }
+
+  return TensorType::create(
+      scalar_type, device, sizes, strides, requires_grad, undefined);
+}
+
+// Types that are fully described by their name
+const std::vector<TypePtr>& singletonTypes() {
+  static const std::vector<TypePtr> types = {
+      AnyType::get(),
+      AnyEnumType::get(),
+      NumberType::get(),
+      FloatType::get(),
+      IntType::get(),
+      BoolType::get(),
+      StringType::get(),
+      NoneType::get(),
+      GeneratorType::get(),
+      QSchemeType::get(),
+      DeviceObjType::get(),
+      CapsuleType::get(),
+      LayoutType::get(),
+      ScalarTypeType::get(),
+      AnyListType::get(),
+      AnyTupleType::get(),
+      AnyClassType::get()};
+  return types;
+}
+
+// Named types (classes, interfaces, enums, named tuples and functions)
+// can't be rebuilt from the plan; they're looked up by name among the types
+// used by the live graph the plan was compiled from.
+void collectNamedTypes(
+    const TypePtr& type,
+    std::unordered_map<std::string, TypePtr>& named_types) {
+  if (auto named = type->cast<c10::NamedType>()) {
+    if (named->name()) {
+      named_types.emplace(named->name()->qualifiedName(), type);
+    }
+  }
+  for (const TypePtr& contained : type->containedTypes()) {
+    collectNamedTypes(contained, named_types);
+  }
+}
+
+void collectNamedTypes(
+    Block* block,
+    std::unordered_map<std::string, TypePtr>& named_types) {
+  for (Value* v : block->inputs()) {
+    collectNamedTypes(v->type(), named_types);
+  }
+  for (Node* n : block->nodes()) {
+    for (Value* v : n->outputs()) {
+      collectNamedTypes(v->type(), named_types);
+    }
+    for (Block* b : n->blocks()) {
+      collectNamedTypes(b, named_types);
+    }
+  }
+}
+
+// The elements of the tuple `value`, which must have `size` of them unless
+// `size` is 0
+const std::vector<IValue>& fields(const IValue& value, size_t size) {
+  TORCH_CHECK(value.isTuple(), "unexpected value in plan: ", value);
+  const auto& elements = value.toTuple()->elements();
+  TORCH_CHECK(
+      size == 0 || elements.size() == size,
+      "unexpected value in plan: ",
+      value);
+  return elements;
+}
+
+template <typename T, typename F>
+IValue encodeAll(T items, F encode) {
+  std::vector<IValue> encoded;
+  for (auto&& item : items) {
+    encoded.emplace_back(encode(item));
+  }
+  return c10::ivalue::Tuple::create(std::move(encoded));
+}
+
+// Encodes a graph as nested tuples of strings, scalars and tensors, which
+// pickle_save writes in the archive format. A block is a tuple of its
+// parameters, nodes and outputs; values are referred to by the order in
+// which they're defined within their graph, and subgraph attributes are
+// encoded as graphs of their own.
+struct PlanEncoder {
+  IValue encodeGraph(const std::shared_ptr<Graph>& graph) {
+    std::unordered_map<Value*, int64_t> ids;
+    return encodeBlock(graph->block(), ids);
+  }
+
+ private:
+  IValue encodeType(const TypePtr& type) {
+    if (auto tensor = type->cast<TensorType>()) {
+      std::ostringstream out;
+      writeType(out, tensor, symbol_ids_);
+      return c10::ivalue::Tuple::create("Tensor", out.str());
+    }
+    auto named = type->cast<c10::NamedType>();
+    if (named && named->name()) {
+      return c10::ivalue::Tuple::create(
+          "Named", named->name()->qualifiedName());
+    }
+    const auto encodeContained = [&](const char* kind) -> IValue {
+      return c10::ivalue::Tuple::create(
+          kind,
+          encodeAll(type->containedTypes(), [&](const TypePtr& contained) {
+            return encodeType(contained);
+          }));
+    };
+    switch (type->kind()) {
+      case TypeKind::ListType:
+        return encodeContained("List");
+      case TypeKind::OptionalType:
+        return encodeContained("Optional");
+      case TypeKind::TupleType:
+        return encodeContained("Tuple");
+      case TypeKind::DictType:
+        return encodeContained("Dict");
+      case TypeKind::FutureType:
+        return encodeContained("Future");
+      case TypeKind::RRefType:
+        return encodeContained("RRef");
+      default:
+        break;
+    }
+    for (const TypePtr& singleton : singletonTypes()) {
+      if (*singleton == *type) {
+        return c10::ivalue::Tuple::create("Singleton", type->str());
+      }
+    }
+    TORCH_CHECK(false, "can't persist a plan with values of type ", *type);
+  }
+
+  IValue encodeValue(Value* v, std::unordered_map<Value*, int64_t>& ids) {
+    ids.emplace(v, ids.size());
+    return c10::ivalue::Tuple::create(
+        v->hasDebugName() ? v->debugName() : "", encodeType(v->type()));
+  }
+
+  IValue encodeAttribute(Node* n, Symbol name) {
+    const AttributeKind kind = n->kindOf(name);
+    IValue value;
+    switch (kind) {
+      case AttributeKind::f:
+        value = n->f(name);
+        break;
+      case AttributeKind::fs:
+        value = encodeAll(n->fs(name), [](double f) { return IValue(f); });
+        break;
+      case AttributeKind::i:
+        value = n->i(name);
+        break;
+      case AttributeKind::is:
+        value = encodeAll(n->is(name), [](int64_t i) { return IValue(i); });
+        break;
+      case AttributeKind::s:
+        value = n->s(name);
+        break;
+      case AttributeKind::ss:
+        value = encodeAll(
+            n->ss(name), [](const std::string& s) { return IValue(s); });
+        break;
+      case AttributeKind::t:
+        value = n->t(name);
+        break;
+      case AttributeKind::ts:
+        value = encodeAll(
+            n->ts(name), [](const at::Tensor& t) { return IValue(t); });
+        break;
+      case AttributeKind::g:
+        value = encodeGraph(n->g(name));
+        break;
+      case AttributeKind::gs:
+        value = encodeAll(
+            n->gs(name), [&](const std::shared_ptr<Graph>& g) {
+              return encodeGraph(g);
+            });
+        break;
+      case AttributeKind::ty:
+        value = encodeType(n->ty(name));
+        break;
+      case AttributeKind::tys:
+        value = encodeAll(
+            n->tys(name), [&](const TypePtr& t) { return encodeType(t); });
+        break;
+      case AttributeKind::ival:
+        value = n->ival(name);
+        // objects can't be unpickled without their class
+        value.visit([&](const IValue& v) {
+          TORCH_CHECK(
+              !v.isObject(), "can't persist a plan with object constants");
+          return false;
+        });
+        break;
+    }
+    return c10::ivalue::Tuple::create(
+        name.toUnqualString(), toString(kind), std::move(value));
+  }
+
+  IValue encodeNode(Node* n, std::unordered_map<Value*, int64_t>& ids) {
+    // these carry state, like callbacks, that isn't in their attributes
+    TORCH_CHECK(
+        n->kind() != prim::PythonOp && n->kind() != prim::profile,
+        "can't persist a plan with ",
+        n->kind().toQualString(),
+        " nodes");
+    IValue inputs = encodeAll(n->inputs(), [&](Value* v) {
+      auto it = ids.find(v);
+      TORCH_INTERNAL_ASSERT(it != ids.end());
+      return IValue(it->second);
+    });
+    IValue outputs = encodeAll(
+        n->outputs(), [&](Value* v) { return encodeValue(v, ids); });
+    IValue attributes = encodeAll(
+        n->attributeNames(), [&](Symbol name) {
+          return encodeAttribute(n, name);
+        });
+    IValue blocks = encodeAll(
+        n->blocks(), [&](Block* b) { return encodeBlock(b, ids); });
+    return c10::ivalue::Tuple::create(
+        n->kind().toQualString(),
+        std::move(inputs),
+        std::move(outputs),
+        std::move(attributes),
+        std::move(blocks));
+  }
+
+  IValue encodeBlock(Block* block, std::unordered_map<Value*, int64_t>& ids) {
+    IValue inputs = encodeAll(
+        block->inputs(), [&](Value* v) { return encodeValue(v, ids); });
+    IValue nodes =
+        encodeAll(block->nodes(), [&](Node* n) { return encodeNode(n, ids); });
+    IValue outputs = encodeAll(block->outputs(), [&](Value* v) {
+      auto it = ids.find(v);
+      TORCH_INTERNAL_ASSERT(it != ids.end());
+      return IValue(it->second);
+    });
+    return c10::ivalue::Tuple::create(
+        std::move(inputs), std::move(nodes), std::move(outputs));
+  }
+
+  std::map<c10::ShapeSymbol, size_t> symbol_ids_;
+};
+
+// The inverse of PlanEncoder. Named types are resolved through
+// `named_types`, see collectNamedTypes.
+struct PlanDecoder {
+  explicit PlanDecoder(
+      const std::unordered_map<std::string, TypePtr>& named_types)
+      : named_types_(named_types) {}
+
+  std::shared_ptr<Graph> decodeGraph(const IValue& encoded) {
+    auto graph = std::make_shared<Graph>();
+    std::vector<Value*> values;
+    decodeBlock(encoded, graph->block(), values);
+    return graph;
+  }
+
+ private:
+  TypePtr decodeType(const IValue& encoded) {
+    const auto& type = fields(encoded, 2);
+    const std::string& kind = type[0].toStringRef();
+    if (kind == "Tensor") {
+      std::istringstream in(type[1].toStringRef());
+      return readType(in, symbols_);
+    }
+    if (kind == "Named") {
+      auto it = named_types_.find(type[1].toStringRef());
+      TORCH_CHECK(
+          it != named_types_.end(),
+          "unknown type in plan: ",
+          type[1].toStringRef());
+      return it->second;
+    }
+    if (kind == "Singleton") {
+      for (const TypePtr& singleton : singletonTypes()) {
+        if (singleton->str() == type[1].toStringRef()) {
+          return singleton;
+        }
+      }
+      TORCH_CHECK(false, "unknown type in plan: ", type[1].toStringRef());
+    }
+    std::vector<TypePtr> contained;
+    for (const IValue& t : fields(type[1], 0)) {
+      contained.push_back(decodeType(t));
+    }
+    const auto expectContained = [&](size_t size) {
+      TORCH_CHECK(contained.size() == size, "unexpected ", kind, " in plan");
+    };
+    if (kind == "Tuple") {
+      return TupleType::create(std::move(contained));
+    }
+    if (kind == "Dict") {
+      expectContained(2);
+      return DictType::create(contained[0], contained[1]);
+    }
+    expectContained(1);
+    if (kind == "List") {
+      return ListType::create(contained[0]);
+    }
+    if (kind == "Optional") {
+      return OptionalType::create(contained[0]);
+    }
+    if (kind == "Future") {
+      return FutureType::create(contained[0]);
+    }
+    if (kind == "RRef") {
+      return RRefType::create(contained[0]);
+    }
+    TORCH_CHECK(false, "unknown type in plan: ", kind);
+  }
+
+  Value* decodeValueRef(const IValue& id, const std::vector<Value*>& values) {
+    const int64_t i = id.toInt();
+    TORCH_CHECK(
+        i >= 0 && i < static_cast<int64_t>(values.size()),
+        "unknown value in plan: ",
+        i);
+    return values[i];
+  }
+
+  void decodeValue(const IValue& encoded, Value* v) {
+    const auto& value = fields(encoded, 2);
+    if (!value[0].toStringRef().empty()) {
+      v->setDebugName(value[0].toStringRef());
+    }
+    v->setType(decodeType(value[1]));
+  }
+
+  void decodeAttribute(const IValue& encoded, Node* n) {
+    const auto& attribute = fields(encoded, 3);
+    const Symbol name = Symbol::attr(attribute[0].toStringRef());
+    const std::string& kind = attribute[1].toStringRef();
+    const IValue& value = attribute[2];
+    const auto decodeAll = [&](auto decode) {
+      std::vector<decltype(decode(value))> items;
+      for (const IValue& item : fields(value, 0)) {
+        items.push_back(decode(item));
+      }
+      return items;
+    };
+    if (kind == "f") {
+      n->f_(name, value.toDouble());
+    } else if (kind == "fs") {
+      n->fs_(name, decodeAll([](const IValue& v) { return v.toDouble(); }));
+    } else if (kind == "i") {
+      n->i_(name, value.toInt());
+    } else if (kind == "is") {
+      n->is_(name, decodeAll([](const IValue& v) { return v.toInt(); }));
+    } else if (kind == "s") {
+      n->s_(name, value.toStringRef());
+    } else if (kind == "ss") {
+      n->ss_(
+          name, decodeAll([](const IValue& v) { return v.toStringRef(); }));
+    } else if (kind == "t") {
+      n->t_(name, value.toTensor());
+    } else if (kind == "ts") {
+      n->ts_(name, decodeAll([](const IValue& v) { return v.toTensor(); }));
+    } else if (kind == "g") {
+      n->g_(name, decodeGraph(value));
+    } else if (kind == "gs") {
+      n->gs_(name, decodeAll([&](const IValue& v) { return decodeGraph(v); }));
+    } else if (kind == "ty") {
+      n->ty_(name, decodeType(value));
+    } else if (kind == "tys") {
+      n->tys_(name, decodeAll([&](const IValue& v) { return decodeType(v); }));
+    } else if (kind == "ival") {
+      n->ival_(name, value);
+    } else {
+      TORCH_CHECK(false, "unknown attribute kind in plan: ", kind);
+    }
+  }
+
+  void decodeNode(
+      const IValue& encoded,
+      Block* block,
+      std::vector<Value*>& values) {
+    const auto& node = fields(encoded, 5);
+    Node* n = block->owningGraph()->create(
+        Symbol::fromQualString(node[0].toStringRef()), /*num_outputs=*/0);
+    block->appendNode(n);
+    for (const IValue& id : fields(node[1], 0)) {
+      n->addInput(decodeValueRef(id, values));
+    }
+    for (const IValue& output : fields(node[2], 0)) {
+      Value* v = n->addOutput();
+      decodeValue(output, v);
+      values.push_back(v);
+    }
+    for (const IValue& attribute : fields(node[3], 0)) {
+      decodeAttribute(attribute, n);
+    }
+    for (const IValue& b : fields(node[4], 0)) {
+      decodeBlock(b, n->addBlock(), values);
+    }
+  }
+
+  void decodeBlock(
+      const IValue& encoded,
+      Block* block,
+      std::vector<Value*>& values) {
+    const auto& b = fields(encoded, 3);
+    for (const IValue& input : fields(b[0], 0)) {
+      Value* v = block->addInput();
+      decodeValue(input, v);
+      values.push_back(v);
+    }
+    for (const IValue& node : fields(b[1], 0)) {
+      decodeNode(node, block, values);
+    }
+    for (const IValue& id : fields(b[2], 0)) {
+      block->registerOutput(decodeValueRef(id, values));
+    }
+  }
+
+  const std::unordered_map<std::string, TypePtr>& named_types_;
+  std::map<size_t, c10::ShapeSymbol> symbols_;
+};
+
+// Returns "<dir>/<prefix>_<hash>", where the hash covers everything the
+// optimized plan of `pr` depends on besides its profile: the instrumented
+// graph, the build configuration, and the executor and fuser settings
+std::string cachePath(
+    const char* prefix,
+    const ProfilingRecord& pr,
+    size_t remaining_bailout_depth) {
+  const std::string dir = getProfileCacheDirectory();
+  if (dir.empty()) {
+    return dir;
+  }
+  static const std::string build_config = at::show_config();
+  std::ostringstream key;
+  key << kProfileHeader << ' ' << kPlanHeader << '\n'
+      << build_config << '\n'
+      << getNumProfiledRuns() << ' ' << remaining_bailout_depth << ' '
+      << getGraphExecutorOptimize() << ' ' << getAutodiffSubgraphInlining()
+      << ' ' << canFuseOnCPU() << ' ' << canFuseOnGPU() << ' '
+      << tensorExprFuserEnabled() << '\n'
+      << pr.graph()->toString(/*print_source_locations=*/false);
+  const std::string key_str = key.str();
+  const uint64_t hash =
+      c10::util::crc64(key_str.data(), key_str.size()).checksum();
+  std::ostringstream path;
+  path << dir << '/' << prefix << '_' << std::hex << hash;
+  return path.str();
+}
+
+// Writes `data` to `path` through a temporary file, so that readers never
+// see a partially written one. Failures are ignored.
+void writeCacheFile(const std::string& path, const std::string& data) {
+  const std::string tmp_path = path + ".tmp" + std::to_string(processId());
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    out << data;
+    if (!out) {
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    return;
+  }
+  GRAPH_DEBUG("Stored ", path);
+}
+
+} // namespace
+
+std::string getProfileCacheDirectory() {
+  std::lock_guard<std::mutex> lock(profileCacheMutex());
+  return profileCacheDirectory();
+}
+
+std::string setProfileCacheDirectory(std::string dir) {
+  std::lock_guard<std::mutex> lock(profileCacheMutex());
+  std::swap(profileCacheDirectory(), dir);
+  return dir;
+}
+
+std::string cachedProfilePath(
+    const ProfilingRecord& pr,
+    size_t remaining_bailout_depth) {
+  return cachePath("profile", pr, remaining_bailout_depth);
+}
+
+std::string cachedPlanPath(
+    const ProfilingRecord& pr,
+    size_t remaining_bailout_depth) {
+  return cachePath("plan", pr, remaining_bailout_depth);
+}
+
+bool loadCachedProfile(ProfilingRecord& pr, const std::string& path) {
+  std::ifstream in(path);
+  if (!in.good()) {
+    return false;
+  }
+  std::vector<Value*> values;
+  collectProfiledValues(pr.graph()->block(), values);
+  std::vector<TensorTypePtr> types;
+  try {
+    std::string header;
+    std::getline(in, header);
+    TORCH_CHECK(header == kProfileHeader, "unknown profile format");
+    const auto num_values = parseToken<size_t>(readToken(in));
+    TORCH_CHECK(
+        num_values == values.size(),
+        "profile of ",
+        num_values,
+        " values for a graph with ",
+        values.size());
+    std::map<size_t, c10::ShapeSymbol> symbols;
+    for (size_t i = 0; i < num_values; i++) {
+      types.push_back(readType(in, symbols));
+    }
+  } catch (const c10::Error& e) {
+    TORCH_WARN("Ignoring the invalid cached profile ", path, ": ", e.msg());
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(pr.mutex_);
+  for (size_t i = 0; i < values.size(); i++) {
+    values[i]->setType(types[i]);
+  }
+  pr.profiling_count_ = 0;
+  GRAPH_DEBUG("Loaded the cached profile ", path);
+  return true;
+}
+
+void storeCachedProfile(const ProfilingRecord& pr, const std::string& path) {
+  TORCH_INTERNAL_ASSERT(pr.ready());
+  std::vector<Value*> values;
+  collectProfiledValues(pr.graph()->block(), values);
+
+  std::ostringstream out;
+  out << kProfileHeader << '\n' << values.size() << '\n';
+  std::map<c10::ShapeSymbol, size_t> symbol_ids;
+  for (Value* v : values) {
+    writeType(out, v->type()->expect<TensorType>(), symbol_ids);
+  }
+  writeCacheFile(path, out.str());
+}
+
+std::shared_ptr<Graph> loadCachedPlan(
+    const ProfilingRecord& pr,
+    const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in.good()) {
+    return nullptr;
+  }
+  const std::vector<char> data(
+      (std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  std::unordered_map<std::string, TypePtr> named_types;
+  collectNamedTypes(pr.graph()->block(), named_types);
+  try {
+    const IValue archive = pickle_load(data);
+    const auto& plan = fields(archive, 2);
+    TORCH_CHECK(
+        plan[0].isString() && plan[0].toStringRef() == kPlanHeader,
+        "unknown plan format");
+    auto graph = PlanDecoder(named_types).decodeGraph(plan[1]);
+    graph->lint();
+    GRAPH_DEBUG("Loaded the cached plan ", path);
+    return graph;
+  } catch (const c10::Error& e) {
+    TORCH_WARN("Ignoring the invalid cached plan ", path, ": ", e.msg());
+    return nullptr;
+  }
+}
+
+void storeCachedPlan(
+    const std::shared_ptr<Graph>& graph,
+    const std::string& path) {
+  std::vector<char> data;
+  try {
+    data = pickle_save(c10::ivalue::Tuple::create(
+        kPlanHeader, PlanEncoder().encodeGraph(graph)));
+  } catch (const c10::Error& e) {
+    GRAPH_DEBUG("Can't store the plan in ", path, ": ", e.msg());
+    return;
+  }
+  writeCacheFile(path, std::string(data.begin(), data.end()));
+}
+
+} // namespace jit
+} // namespace torch
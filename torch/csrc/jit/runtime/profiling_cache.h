@@ -0,0 +1,81 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/runtime/profiling_record.h>
+
+#include <string>
+
+namespace torch {
+namespace jit {
+
+// [Profile cache]
+// The profiling executor reaches its optimized plan only after
+// getNumProfiledRuns() profiling runs and the profiling optimizations, so
+// every new process pays for them again. The profile cache keeps two files
+// per instrumented graph on disk, so that a later process can skip them:
+//
+// - the optimized graph, with its guards and fusion subgraphs, saved with
+//   pickle_save in the archive format. A process that finds it builds its
+//   execution plan from it right away, without profiling or optimizing.
+// - the merged profiling information. It's only used when there's no valid
+//   plan, e.g. because the graph calls into Python and couldn't be
+//   persisted, and saves the profiling runs but not the optimizations.
+//
+// Kernels aren't stored here: the fused kernels of a loaded graph are
+// compiled on its first run as usual, and the fuser kernel cache (see
+// [Fuser kernel cache]) keeps the host-compiled ones across processes.
+//
+// Both files are keyed by a hash of the instrumented graph, the build
+// configuration, the number of profiled runs, the remaining bailout depth
+// and the executor and fuser settings. A plan or profile recorded for other
+// input shapes is safe to use: its guards fail and execution falls back to
+// a freshly profiled graph.
+//
+// The cache is disabled unless a directory is given through
+// $PYTORCH_JIT_PROFILE_CACHE_DIR or setProfileCacheDirectory. The
+// directory is typically shipped alongside the model archive.
+
+// Returns the profile cache directory, or an empty string if the cache is
+// disabled
+TORCH_API std::string getProfileCacheDirectory();
+// Sets the profile cache directory and returns the previous one; an empty
+// string disables the cache
+TORCH_API std::string setProfileCacheDirectory(std::string dir);
+
+// Returns the path of the cached profile of the freshly instrumented `pr`,
+// or an empty string if the cache is disabled
+TORCH_API std::string cachedProfilePath(
+    const ProfilingRecord& pr,
+    size_t remaining_bailout_depth);
+
+// Returns the path of the cached optimized graph of the freshly
+// instrumented `pr`, or an empty string if the cache is disabled
+TORCH_API std::string cachedPlanPath(
+    const ProfilingRecord& pr,
+    size_t remaining_bailout_depth);
+
+// Applies the profile cached at `path` to `pr`, if there is one, and marks
+// `pr` ready. Returns whether a profile was applied.
+TORCH_API bool loadCachedProfile(ProfilingRecord& pr, const std::string& path);
+
+// Stores the profile of the ready record `pr` at `path`. Failures are
+// ignored; the next process profiles the graph again.
+TORCH_API void storeCachedProfile(
+    const ProfilingRecord& pr,
+    const std::string& path);
+
+// Returns the optimized graph cached at `path`, or nullptr if there isn't a
+// valid one. Classes and other named types are resolved among the types
+// used by the graph of `pr`.
+TORCH_API std::shared_ptr<Graph> loadCachedPlan(
+    const ProfilingRecord& pr,
+    const std::string& path);
+
+// Stores the optimized `graph` at `path`. Failures, including graphs that
+// can't be persisted, are ignored.
+TORCH_API void storeCachedPlan(
+    const std::shared_ptr<Graph>& graph,
+    const std::string& path);
+
+} // namespace jit
+} // namespace torch
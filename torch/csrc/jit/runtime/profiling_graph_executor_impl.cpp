@@ -23,6 +23,7 @@
 #include <torch/csrc/jit/passes/requires_grad_analysis.h>
 #include <torch/csrc/jit/passes/shape_analysis.h>
 #include <torch/csrc/jit/passes/specialize_autogradzero.h>
+#include <torch/csrc/jit/runtime/profiling_cache.h>
 
 C10_DECLARE_bool();
 
@@ -180,9 +181,26 @@ ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(
       PeelProfilingLoops(copy);
     }
     pr_ = ProfilingRecord::instrumentGraph(copy);
-    auto pr_copy = pr_->graph()->copy();
-    GRAPH_DUMP("Profiled Graph: ", pr_copy);
-    profiling_plan_ = ExecutionPlan(pr_copy, function_name_);
+    // see [Profile cache]
+    plan_cache_path_ = cachedPlanPath(*pr_, remaining_bailout_depth);
+    if (!plan_cache_path_.empty()) {
+      if (auto plan = loadCachedPlan(*pr_, plan_cache_path_)) {
+        GRAPH_DUMP("Cached Optimized Graph: ", plan);
+        optimized_plan_ =
+            ExecutionPlan(plan, function_name_, remaining_bailout_depth);
+        return *optimized_plan_;
+      }
+    }
+    profile_cache_path_ = cachedProfilePath(*pr_, remaining_bailout_depth);
+    if (!profile_cache_path_.empty() &&
+        loadCachedProfile(*pr_, profile_cache_path_)) {
+      // the cached profile is already in the graph
+      profile_cache_path_.clear();
+    } else {
+      auto pr_copy = pr_->graph()->copy();
+      GRAPH_DUMP("Profiled Graph: ", pr_copy);
+      profiling_plan_ = ExecutionPlan(pr_copy, function_name_);
+    }
     // fall-through
   }
 
@@ -191,8 +209,14 @@ ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(
     return *profiling_plan_;
   }
 
+  if (!profile_cache_path_.empty()) {
+    storeCachedProfile(*pr_, profile_cache_path_);
+  }
   auto copy = pr_->graph()->copy();
   runProfilingOptimizations(copy);
+  if (!plan_cache_path_.empty()) {
+    storeCachedPlan(copy, plan_cache_path_);
+  }
   // cache
   optimized_plan_ =
       ExecutionPlan(copy, function_name_, remaining_bailout_depth);
@@ -18,6 +18,12 @@ struct ProfilingGraphExecutorImpl : public GraphExecutorImplBase {
   void runProfilingInsensitiveOptimizations(std::shared_ptr<Graph>& graph);
   void runProfilingOptimizations(std::shared_ptr<Graph>& graph);
   std::unique_ptr<ProfilingRecord> pr_;
+  // where the profile of pr_ is stored once it's ready; empty if the profile
+  // cache is disabled or the profile was loaded from it
+  std::string profile_cache_path_;
+  // where the optimized graph is stored; empty if the profile cache is
+  // disabled
+  std::string plan_cache_path_;
   c10::optional<ExecutionPlan>
       profiling_plan_; // plan to run in order to profiling the code
   c10::optional<ExecutionPlan> optimized_plan_;
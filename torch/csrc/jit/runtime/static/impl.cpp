@@ -0,0 +1,320 @@
+#include <torch/csrc/jit/runtime/static/impl.h>
+
+#include <ATen/core/LegacyTypeDispatch.h>
+#include <ATen/core/interned_strings.h>
+#include <c10/core/CPUAllocator.h>
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/passes/constant_propagation.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/inliner.h>
+#include <torch/csrc/jit/passes/remove_mutation.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// Alignment of the slots in the arena
+constexpr size_t kSlotAlignment = 64;
+
+size_t alignSlot(size_t nbytes) {
+  return (nbytes + kSlotAlignment - 1) / kSlotAlignment * kSlotAlignment;
+}
+
+} // namespace
+
+std::shared_ptr<Graph> PrepareForStaticRuntime(std::shared_ptr<Graph> g) {
+  Inline(*g);
+  ConstantPropagation(g);
+  RemoveTensorMutation(g);
+  EliminateDeadCode(g);
+
+  AliasDb alias_db(g);
+  for (Node* n : g->nodes()) {
+    TORCH_CHECK(
+        n->blocks().empty(),
+        "Static runtime doesn't support control flow, found ",
+        n->kind().toQualString());
+    TORCH_CHECK(
+        !alias_db.isMutable(n),
+        "Static runtime doesn't support mutation, found ",
+        n->kind().toQualString());
+  }
+  return g;
+}
+
+std::shared_ptr<Graph> PrepareForStaticRuntime(const Module& m) {
+  auto g = m.get_method("forward").graph()->copy();
+  Inline(*g);
+  TORCH_CHECK(
+      !g->inputs().at(0)->hasUses(),
+      "Static runtime expects a frozen module (see freeze_module), "
+      "but its forward method still uses self");
+  g->eraseInput(0);
+  return PrepareForStaticRuntime(g);
+}
+
+ProcessedNode::ProcessedNode(
+    Node* node,
+    std::vector<size_t> inputs,
+    std::vector<size_t> outputs,
+    std::vector<IValue>* registers)
+    : node_(node),
+      inputs_(std::move(inputs)),
+      outputs_(std::move(outputs)),
+      registers_(registers) {
+  if (canRunOutOfPlace(node)) {
+    fn_ = getOutOfPlaceOperation(node);
+  } else {
+    op_ = node->getOperation();
+  }
+}
+
+void ProcessedNode::run() {
+  if (fn_) {
+    fn_(this);
+    return;
+  }
+  stack_.clear();
+  for (size_t i : inputs_) {
+    stack_.push_back((*registers_)[i]);
+  }
+  op_(&stack_);
+  TORCH_INTERNAL_ASSERT(stack_.size() == outputs_.size());
+  for (size_t i = 0; i < outputs_.size(); i++) {
+    (*registers_)[outputs_[i]] = std::move(stack_[i]);
+  }
+}
+
+MemoryPlanner::MemoryPlanner(
+    std::vector<std::vector<size_t>> slots,
+    std::vector<IValue>* registers)
+    : slots_(std::move(slots)),
+      registers_(registers),
+      slot_sizes_(slots_.size(), 0) {}
+
+namespace {
+
+// The arena is CPU memory; tensors on other devices are left alone
+bool isPlanned(const IValue& v) {
+  return v.isTensor() && v.toTensor().device().is_cpu();
+}
+
+} // namespace
+
+void MemoryPlanner::update() {
+  // Check whether every managed tensor still lives in its slot
+  bool replan = false;
+  size_t offset = 0;
+  char* arena = static_cast<char*>(arena_.get());
+  for (size_t s = 0; s < slots_.size(); s++) {
+    for (size_t reg : slots_[s]) {
+      const IValue& v = (*registers_)[reg];
+      if (!isPlanned(v)) {
+        continue;
+      }
+      const auto& storage = v.toTensor().storage();
+      const size_t nbytes = storage.nbytes();
+      if (nbytes > slot_sizes_[s]) {
+        slot_sizes_[s] = alignSlot(nbytes);
+        replan = true;
+      } else if (nbytes > 0 && storage.data() != arena + offset) {
+        replan = true;
+      }
+    }
+    offset += slot_sizes_[s];
+  }
+  if (!replan) {
+    return;
+  }
+
+  arena_size_ = offset;
+  at::DataPtr arena_ptr = c10::GetCPUAllocator()->allocate(arena_size_);
+  arena = static_cast<char*>(arena_ptr.get());
+  offset = 0;
+  for (size_t s = 0; s < slots_.size(); s++) {
+    for (size_t reg : slots_[s]) {
+      const IValue& v = (*registers_)[reg];
+      if (!isPlanned(v)) {
+        continue;
+      }
+      // The arena owns the memory; the previous allocation of the storage is
+      // freed here.
+      auto* impl = v.toTensor().storage().unsafeGetStorageImpl();
+      impl->set_data_ptr(at::DataPtr(arena + offset, at::kCPU));
+      impl->set_nbytes(slot_sizes_[s]);
+    }
+    offset += slot_sizes_[s];
+  }
+  // Only now that nothing points into it any more
+  arena_ = std::move(arena_ptr);
+}
+
+StaticRuntime::StaticRuntime(const Module& m)
+    : StaticRuntime(PrepareForStaticRuntime(m)) {}
+
+StaticRuntime::StaticRuntime(std::shared_ptr<Graph> g)
+    : graph_(PrepareForStaticRuntime(g->copy())) {
+  std::unordered_map<Value*, size_t> value_to_reg;
+  auto addRegister = [&](Value* v) {
+    value_to_reg[v] = registers_.size();
+    registers_.emplace_back();
+    return registers_.size() - 1;
+  };
+
+  std::unordered_set<size_t> constant_regs;
+  std::unordered_map<Node*, size_t> node_index;
+  for (Value* v : graph_->inputs()) {
+    input_regs_.push_back(addRegister(v));
+  }
+  for (Node* n : graph_->nodes()) {
+    if (n->kind() == prim::Constant) {
+      const size_t reg = addRegister(n->output());
+      registers_[reg] = toIValue(n->output()).value();
+      constant_regs.insert(reg);
+      continue;
+    }
+    std::vector<size_t> inputs;
+    std::vector<size_t> outputs;
+    for (Value* v : n->inputs()) {
+      inputs.push_back(value_to_reg.at(v));
+    }
+    for (Value* v : n->outputs()) {
+      outputs.push_back(addRegister(v));
+    }
+    node_index[n] = nodes_.size();
+    nodes_.emplace_back(n, std::move(inputs), std::move(outputs), &registers_);
+  }
+  for (Value* v : graph_->outputs()) {
+    output_regs_.push_back(value_to_reg.at(v));
+  }
+
+  // Managed tensors are the outputs of out variants that neither are nor
+  // may alias a graph output. Their live range runs from the node defining
+  // them to the last use of the tensor or of anything that may alias it.
+  // The graph is straight-line, so node indices give exact live ranges.
+  AliasDb alias_db(graph_);
+  std::vector<Value*> values(graph_->inputs().begin(), graph_->inputs().end());
+  for (Node* n : graph_->nodes()) {
+    values.insert(values.end(), n->outputs().begin(), n->outputs().end());
+  }
+  const std::unordered_set<Value*> graph_outputs(
+      graph_->outputs().begin(), graph_->outputs().end());
+
+  struct LiveRange {
+    size_t reg;
+    size_t begin;
+    size_t end;
+  };
+  std::vector<LiveRange> managed;
+  for (size_t i = 0; i < nodes_.size(); i++) {
+    if (!nodes_[i].has_out_variant()) {
+      continue;
+    }
+    Value* out = nodes_[i].node()->output();
+    size_t end = i;
+    bool escapes = false;
+    for (Value* w : values) {
+      if (w != out && !alias_db.mayContainAlias(out, w)) {
+        continue;
+      }
+      if (graph_outputs.count(w)) {
+        escapes = true;
+        break;
+      }
+      for (const Use& use : w->uses()) {
+        auto it = node_index.find(use.user);
+        if (it == node_index.end()) {
+          escapes = true;
+          break;
+        }
+        end = std::max(end, it->second);
+      }
+      if (escapes) {
+        break;
+      }
+    }
+    if (!escapes) {
+      managed.push_back({value_to_reg.at(out), i, end});
+    }
+  }
+
+  // Greedily assign the live ranges, which are ordered by their beginning,
+  // to the first slot that is free by then
+  std::vector<std::vector<size_t>> slots;
+  std::vector<size_t> slot_end;
+  std::unordered_set<size_t> managed_regs;
+  for (const auto& range : managed) {
+    size_t s = 0;
+    while (s < slots.size() && slot_end[s] >= range.begin) {
+      s++;
+    }
+    if (s == slots.size()) {
+      slots.emplace_back();
+      slot_end.push_back(0);
+    }
+    slots[s].push_back(range.reg);
+    slot_end[s] = range.end;
+    managed_regs.insert(range.reg);
+  }
+  num_managed_tensors_ = managed.size();
+  if (!slots.empty()) {
+    planner_ = std::make_unique<MemoryPlanner>(std::move(slots), &registers_);
+  }
+
+  for (size_t reg = 0; reg < registers_.size(); reg++) {
+    if (!constant_regs.count(reg) && !managed_regs.count(reg)) {
+      transient_regs_.push_back(reg);
+    }
+  }
+}
+
+std::vector<IValue> StaticRuntime::run(std::vector<IValue> inputs) {
+  TORCH_CHECK(
+      inputs.size() == input_regs_.size(),
+      "Expected ",
+      input_regs_.size(),
+      " inputs, but got ",
+      inputs.size());
+  // The static runtime is for inference only
+  at::AutoNonVariableTypeMode non_var_type_mode(true);
+
+  for (size_t i = 0; i < inputs.size(); i++) {
+    registers_[input_regs_[i]] = std::move(inputs[i]);
+  }
+  for (auto& n : nodes_) {
+    n.run();
+  }
+
+  std::vector<IValue> outputs;
+  outputs.reserve(output_regs_.size());
+  for (size_t reg : output_regs_) {
+    outputs.push_back(registers_[reg]);
+  }
+  for (size_t reg : transient_regs_) {
+    registers_[reg] = IValue();
+  }
+  if (planner_) {
+    planner_->update();
+  }
+  return outputs;
+}
+
+std::vector<at::Tensor> StaticRuntime::run(
+    const std::vector<at::Tensor>& inputs) {
+  auto outputs = run(std::vector<IValue>(inputs.begin(), inputs.end()));
+  std::vector<at::Tensor> tensors;
+  tensors.reserve(outputs.size());
+  for (auto& output : outputs) {
+    tensors.push_back(std::move(output).toTensor());
+  }
+  return tensors;
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <ATen/core/stack.h>
+#include <c10/core/CPUAllocator.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/ir/ir.h>
+#include <torch/csrc/jit/runtime/static/ops.h>
+
+#include <memory>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+// [Static runtime]
+// An inference runtime for frozen, straight-line TorchScript graphs that
+// avoids the per-call overheads of the interpreter:
+//
+// * The graph is lowered once into a flat list of ProcessedNodes. Every value
+//   of the graph lives in a fixed register, and nodes refer to their inputs
+//   and outputs by register index; constants are materialized once.
+// * Nodes with an out variant (see ops.cpp) call it directly through its
+//   unboxed C++ API, writing into the output tensors kept from the previous
+//   run instead of allocating new ones. Other nodes fall back to their boxed
+//   Operation.
+// * Intermediate tensors written by out variants are placed by a
+//   MemoryPlanner in a single CPU arena that is reused across runs. Tensors
+//   whose live ranges don't overlap share the same part of the arena.
+//   Tensors on other devices keep their own allocations.
+//
+// Graphs must not contain control flow or mutation, and the runtime doesn't
+// record autograd history.
+
+// Lowers the forward method of a frozen module (see freeze_module) or a
+// graph into the form the static runtime runs: inlined, constant propagated,
+// without tensor mutation, and without the `self` input for modules.
+TORCH_API std::shared_ptr<Graph> PrepareForStaticRuntime(
+    std::shared_ptr<Graph> g);
+TORCH_API std::shared_ptr<Graph> PrepareForStaticRuntime(const Module& m);
+
+class TORCH_API ProcessedNode {
+ public:
+  ProcessedNode(
+      Node* node,
+      std::vector<size_t> inputs,
+      std::vector<size_t> outputs,
+      std::vector<IValue>* registers);
+
+  void run();
+
+  Node* node() const {
+    return node_;
+  }
+
+  const IValue& Input(size_t i) const {
+    return (*registers_)[inputs_[i]];
+  }
+
+  IValue& Output(size_t i) {
+    return (*registers_)[outputs_[i]];
+  }
+
+  size_t num_inputs() const {
+    return inputs_.size();
+  }
+
+  bool has_out_variant() const {
+    return static_cast<bool>(fn_);
+  }
+
+ private:
+  Node* node_;
+  std::vector<size_t> inputs_;
+  std::vector<size_t> outputs_;
+  std::vector<IValue>* registers_;
+  SROperator fn_;
+  // fallback for nodes without an out variant
+  Operation op_;
+  Stack stack_;
+};
+
+// Places the managed tensors, intermediates written by out variants that
+// don't escape the graph, in one arena. Tensors are grouped into slots by
+// their live ranges; a slot is as large as its largest tensor. After every
+// run the sizes are checked, and the arena is only rebuilt when a tensor
+// outgrew its slot (e.g. the first run, or a new input shape).
+class MemoryPlanner {
+ public:
+  // `slots` lists, for each slot, the registers of the tensors in it
+  MemoryPlanner(
+      std::vector<std::vector<size_t>> slots,
+      std::vector<IValue>* registers);
+
+  // Called after each run
+  void update();
+
+  size_t arena_size() const {
+    return arena_size_;
+  }
+
+ private:
+  std::vector<std::vector<size_t>> slots_;
+  std::vector<IValue>* registers_;
+  std::vector<size_t> slot_sizes_;
+  at::DataPtr arena_;
+  size_t arena_size_ = 0;
+};
+
+class TORCH_API StaticRuntime {
+ public:
+  explicit StaticRuntime(std::shared_ptr<Graph> g);
+  explicit StaticRuntime(const Module& m);
+
+  // Nodes refer to registers_ by address
+  StaticRuntime(const StaticRuntime&) = delete;
+  StaticRuntime& operator=(const StaticRuntime&) = delete;
+
+  std::vector<IValue> run(std::vector<IValue> inputs);
+  std::vector<at::Tensor> run(const std::vector<at::Tensor>& inputs);
+
+  const std::shared_ptr<Graph>& graph() const {
+    return graph_;
+  }
+
+  // Bytes of the arena of the memory planner
+  size_t managed_bytes() const {
+    return planner_ ? planner_->arena_size() : 0;
+  }
+
+  // Number of intermediate tensors placed in the arena
+  size_t num_managed_tensors() const {
+    return num_managed_tensors_;
+  }
+
+ private:
+  std::shared_ptr<Graph> graph_;
+  std::vector<IValue> registers_;
+  std::vector<size_t> input_regs_;
+  std::vector<size_t> output_regs_;
+  // registers cleared after every run: everything but constants and
+  // managed tensors
+  std::vector<size_t> transient_regs_;
+  std::vector<ProcessedNode> nodes_;
+  std::unique_ptr<MemoryPlanner> planner_;
+  size_t num_managed_tensors_ = 0;
+};
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,232 @@
+#include <torch/csrc/jit/runtime/static/ops.h>
+
+#include <ATen/ATen.h>
+#include <torch/csrc/jit/runtime/static/impl.h>
+
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// Out variants are looked up by node kind; a generator returns an empty
+// SROperator if the node's schema isn't one its out variant handles.
+using SROperatorGenerator = std::function<SROperator(Node*)>;
+
+std::unordered_map<Symbol, SROperatorGenerator>& outOfPlaceRegistry() {
+  static std::unordered_map<Symbol, SROperatorGenerator> registry;
+  return registry;
+}
+
+struct RegisterOutOfPlace {
+  RegisterOutOfPlace(Symbol kind, SROperatorGenerator gen) {
+    outOfPlaceRegistry().emplace(kind, std::move(gen));
+  }
+};
+
+#define REGISTER_OUT_OF_PLACE(kind, gen)                                 \
+  static RegisterOutOfPlace C10_ANONYMOUS_VARIABLE(register_out_of_place)( \
+      kind, gen)
+
+// Returns the output tensor of `p_node` to be passed as `out`. The tensor
+// from the previous run is reused unless this is the first run or its dtype
+// changed; out variants resize it as needed. The returned tensor shares its
+// TensorImpl with the register.
+at::Tensor outputTensor(
+    ProcessedNode* p_node,
+    const at::TensorOptions& options) {
+  IValue& out = p_node->Output(0);
+  if (!out.isTensor() ||
+      out.toTensor().scalar_type() !=
+          c10::typeMetaToScalarType(options.dtype()) ||
+      out.toTensor().device() != options.device()) {
+    out = at::empty({0}, options);
+  }
+  return out.toTensor();
+}
+
+at::Tensor binaryOutput(
+    ProcessedNode* p_node,
+    const at::Tensor& self,
+    const at::Tensor& other) {
+  return outputTensor(
+      p_node, self.options().dtype(at::result_type(self, other)));
+}
+
+// aten::add, aten::sub: (Tensor self, Tensor other, *, Scalar alpha)
+template <at::Tensor& (*out_fn)(
+    at::Tensor&,
+    const at::Tensor&,
+    const at::Tensor&,
+    at::Scalar)>
+SROperator binaryAlphaOp(Node* n, const char* schema) {
+  if (!n->matches(schema)) {
+    return nullptr;
+  }
+  return [](ProcessedNode* p_node) {
+    const auto self = p_node->Input(0).toTensor();
+    const auto other = p_node->Input(1).toTensor();
+    auto out = binaryOutput(p_node, self, other);
+    out_fn(out, self, other, p_node->Input(2).toScalar());
+  };
+}
+
+// aten::mul, aten::div: (Tensor self, Tensor other)
+template <at::Tensor& (
+    *out_fn)(at::Tensor&, const at::Tensor&, const at::Tensor&)>
+SROperator binaryOp(Node* n, const char* schema) {
+  if (!n->matches(schema)) {
+    return nullptr;
+  }
+  return [](ProcessedNode* p_node) {
+    const auto self = p_node->Input(0).toTensor();
+    const auto other = p_node->Input(1).toTensor();
+    auto out = binaryOutput(p_node, self, other);
+    out_fn(out, self, other);
+  };
+}
+
+// Pointwise (Tensor self) -> Tensor
+template <at::Tensor& (*out_fn)(at::Tensor&, const at::Tensor&)>
+SROperator unaryOp(Node* n, const char* schema) {
+  if (!n->matches(schema)) {
+    return nullptr;
+  }
+  return [](ProcessedNode* p_node) {
+    const auto self = p_node->Input(0).toTensor();
+    auto out = outputTensor(p_node, self.options());
+    out_fn(out, self);
+  };
+}
+
+REGISTER_OUT_OF_PLACE(aten::add, [](Node* n) {
+  return binaryAlphaOp<at::add_out>(
+      n, "aten::add(Tensor self, Tensor other, *, Scalar alpha) -> Tensor");
+});
+
+REGISTER_OUT_OF_PLACE(aten::sub, [](Node* n) {
+  return binaryAlphaOp<at::sub_out>(
+      n, "aten::sub(Tensor self, Tensor other, *, Scalar alpha) -> Tensor");
+});
+
+REGISTER_OUT_OF_PLACE(aten::mul, [](Node* n) {
+  return binaryOp<at::mul_out>(
+      n, "aten::mul(Tensor self, Tensor other) -> Tensor");
+});
+
+REGISTER_OUT_OF_PLACE(aten::div, [](Node* n) {
+  return binaryOp<at::div_out>(
+      n, "aten::div(Tensor self, Tensor other) -> Tensor");
+});
+
+REGISTER_OUT_OF_PLACE(aten::mm, [](Node* n) {
+  return binaryOp<at::mm_out>(
+      n, "aten::mm(Tensor self, Tensor mat2) -> Tensor");
+});
+
+REGISTER_OUT_OF_PLACE(aten::bmm, [](Node* n) {
+  return binaryOp<at::bmm_out>(
+      n, "aten::bmm(Tensor self, Tensor mat2) -> Tensor");
+});
+
+REGISTER_OUT_OF_PLACE(aten::addmm, [](Node* n) -> SROperator {
+  if (!n->matches(
+          "aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, "
+          "Scalar beta, Scalar alpha) -> Tensor")) {
+    return nullptr;
+  }
+  return [](ProcessedNode* p_node) {
+    const auto self = p_node->Input(0).toTensor();
+    const auto mat1 = p_node->Input(1).toTensor();
+    const auto mat2 = p_node->Input(2).toTensor();
+    auto out = outputTensor(p_node, mat1.options());
+    at::addmm_out(
+        out,
+        self,
+        mat1,
+        mat2,
+        p_node->Input(3).toScalar(),
+        p_node->Input(4).toScalar());
+  };
+});
+
+REGISTER_OUT_OF_PLACE(aten::relu, [](Node* n) -> SROperator {
+  if (!n->matches("aten::relu(Tensor self) -> Tensor")) {
+    return nullptr;
+  }
+  return [](ProcessedNode* p_node) {
+    const auto self = p_node->Input(0).toTensor();
+    auto out = outputTensor(p_node, self.options());
+    at::threshold_out(out, self, 0, 0);
+  };
+});
+
+REGISTER_OUT_OF_PLACE(aten::sigmoid, [](Node* n) {
+  return unaryOp<at::sigmoid_out>(n, "aten::sigmoid(Tensor self) -> Tensor");
+});
+
+REGISTER_OUT_OF_PLACE(aten::tanh, [](Node* n) {
+  return unaryOp<at::tanh_out>(n, "aten::tanh(Tensor self) -> Tensor");
+});
+
+REGISTER_OUT_OF_PLACE(aten::exp, [](Node* n) {
+  return unaryOp<at::exp_out>(n, "aten::exp(Tensor self) -> Tensor");
+});
+
+REGISTER_OUT_OF_PLACE(aten::cat, [](Node* n) -> SROperator {
+  if (!n->matches("aten::cat(Tensor[] tensors, int dim) -> Tensor")) {
+    return nullptr;
+  }
+  return [](ProcessedNode* p_node) {
+    const auto tensors = p_node->Input(0).toTensorVector();
+    TORCH_CHECK(!tensors.empty(), "expected a non-empty list of Tensors");
+    auto out = outputTensor(p_node, tensors[0].options());
+    at::cat_out(out, tensors, p_node->Input(1).toInt());
+  };
+});
+
+REGISTER_OUT_OF_PLACE(aten::sum, [](Node* n) -> SROperator {
+  if (!n->matches(
+          "aten::sum(Tensor self, int[] dim, bool keepdim, *, "
+          "int? dtype) -> Tensor")) {
+    return nullptr;
+  }
+  return [](ProcessedNode* p_node) {
+    const auto self = p_node->Input(0).toTensor();
+    const auto dim = p_node->Input(1).toIntVector();
+    const bool keepdim = p_node->Input(2).toBool();
+    const auto& dtype_ivalue = p_node->Input(3);
+    c10::optional<at::ScalarType> dtype;
+    if (!dtype_ivalue.isNone()) {
+      dtype = dtype_ivalue.toScalarType();
+    }
+    // Integral inputs are summed as int64 unless a dtype is given
+    at::ScalarType out_dtype = self.scalar_type();
+    if (dtype) {
+      out_dtype = *dtype;
+    } else if (at::isIntegralType(out_dtype, /*includeBool=*/true)) {
+      out_dtype = at::kLong;
+    }
+    auto out = outputTensor(p_node, self.options().dtype(out_dtype));
+    at::sum_out(out, self, dim, keepdim, dtype);
+  };
+});
+
+} // namespace
+
+bool canRunOutOfPlace(Node* n) {
+  return static_cast<bool>(getOutOfPlaceOperation(n));
+}
+
+SROperator getOutOfPlaceOperation(Node* n) {
+  auto& registry = outOfPlaceRegistry();
+  auto it = registry.find(n->kind());
+  if (it == registry.end() || n->outputs().size() != 1) {
+    return nullptr;
+  }
+  return it->second(n);
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/ir/ir.h>
+
+#include <functional>
+
+namespace torch {
+namespace jit {
+
+class ProcessedNode;
+
+// An out variant kernel: reads the inputs of a ProcessedNode and writes its
+// outputs, reusing the output tensors left in place by the previous run.
+using SROperator = std::function<void(ProcessedNode*)>;
+
+// Returns whether there is an out variant kernel for `n`.
+TORCH_API bool canRunOutOfPlace(Node* n);
+
+// Returns the out variant kernel for `n`; only valid if canRunOutOfPlace(n).
+TORCH_API SROperator getOutOfPlaceOperation(Node* n);
+
+} // namespace jit
+} // namespace torch
@@ -1,5 +1,6 @@
 #include <torch/csrc/jit/tensorexpr/kernel.h>
 
+#include <ATen/Parallel.h>
 #include <c10/util/string_utils.h>
 #include <torch/csrc/jit/jit_log.h>
 #include <torch/csrc/jit/tensorexpr/analysis.h>
@@ -17,6 +18,7 @@ namespace tensorexpr {
 static int te_cuda_pointwise_loop_levels = -1;
 static int te_cuda_pointwise_block_count = -1;
 static int te_cuda_pointwise_block_size = -1;
+static bool te_parallelize_cpu_loops = true;
 static bool fallback_allowed = true;
 
 bool setFallbackAllowed(bool value) {
@@ -48,6 +50,63 @@ int& getTECudaPointwiseBlockSize() {
   return te_cuda_pointwise_block_size;
 }
 
+bool& getTEParallelizeCpuLoops() {
+  return te_parallelize_cpu_loops;
+}
+
+// Returns the For loops of `root` that aren't nested in another loop.
+static std::vector<For*> outerLoops(Stmt* root) {
+  std::vector<For*> loops;
+  if (For* rootF = dynamic_cast<For*>(root)) {
+    loops.push_back(rootF);
+  } else if (Block* body = dynamic_cast<Block*>(root)) {
+    std::vector<Block*> blocks = {body};
+    while (blocks.size()) {
+      Block* b = blocks.back();
+      blocks.pop_back();
+
+      for (Stmt* s : *b) {
+        if (For* f = dynamic_cast<For*>(s)) {
+          loops.push_back(f);
+        } else if (Block* b2 = dynamic_cast<Block*>(s)) {
+          blocks.push_back(b2);
+        }
+      }
+    }
+  }
+  return loops;
+}
+
+// Returns the number of scalar stores `s` executes, or -1 if that depends on
+// a loop bound that isn't constant.
+static int64_t countStores(Stmt* s) {
+  if (For* f = dynamic_cast<For*>(s)) {
+    const Expr* trips = IRSimplifier::simplify(new Sub(f->stop(), f->start()));
+    const int64_t body = countStores(f->body());
+    if (!trips->isConstant() || body < 0) {
+      return -1;
+    }
+    return immediateAs<int64_t>(trips) * body;
+  } else if (Block* b = dynamic_cast<Block*>(s)) {
+    int64_t stores = 0;
+    for (Stmt* s2 : *b) {
+      const int64_t n = countStores(s2);
+      if (n < 0) {
+        return -1;
+      }
+      stores += n;
+    }
+    return stores;
+  } else if (Cond* c = dynamic_cast<Cond*>(s)) {
+    const int64_t t = c->true_stmt() ? countStores(c->true_stmt()) : 0;
+    const int64_t f = c->false_stmt() ? countStores(c->false_stmt()) : 0;
+    return (t < 0 || f < 0) ? -1 : std::max(t, f);
+  } else if (Store* store = dynamic_cast<Store*>(s)) {
+    return store->value()->dtype().lanes();
+  }
+  return 0;
+}
+
 } // namespace tensorexpr
 } // namespace jit
 } // namespace torch
@@ -1086,26 +1145,9 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
 
   if (backendType == kLLVMCodeGen) {
     std::vector<For*> innerLoops;
-    std::vector<For*> worklist;
 
     // Find outer-most For loops
-    if (For* rootF = dynamic_cast<For*>(l.root_stmt())) {
-      worklist.push_back(rootF);
-    } else if (Block* body = dynamic_cast<Block*>(l.root_stmt())) {
-      std::vector<Block*> blocks = {body};
-      while (blocks.size()) {
-        Block* b = blocks.back();
-        blocks.pop_back();
-
-        for (Stmt* s : *b) {
-          if (For* f = dynamic_cast<For*>(s)) {
-            worklist.push_back(f);
-          } else if (Block* b2 = dynamic_cast<Block*>(s)) {
-            blocks.push_back(b2);
-          }
-        }
-      }
-    }
+    std::vector<For*> worklist = outerLoops(l.root_stmt());
 
     // Traverse the For loop nest find inner-most loops, which are
     // vectorization candidates.
@@ -1147,6 +1189,30 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
         l.vectorize(split2);
       }
     }
+
+    // Run the outer-most loops that have enough work in parallel, in chunks
+    // of about as many stores as at::parallel_for uses for eager pointwise
+    // ops. Iterations of an outer-most loop write distinct output elements.
+    if (getTEParallelizeCpuLoops() && !hasRandom_) {
+      for (For* loop : outerLoops(l.root_stmt())) {
+        const Expr* trips =
+            IRSimplifier::simplify(new Sub(loop->stop(), loop->start()));
+        const int64_t stores = countStores(loop);
+        if (!trips->isConstant() || stores < at::internal::GRAIN_SIZE) {
+          continue;
+        }
+        const int64_t iterations = immediateAs<int64_t>(trips);
+        if (iterations < 2) {
+          continue;
+        }
+        const int64_t storesPerIteration =
+            std::max<int64_t>(1, stores / iterations);
+        l.parallelize(
+            loop,
+            std::max<int64_t>(
+                1, at::internal::GRAIN_SIZE / storesPerIteration));
+      }
+    }
   }
 
   Stmt* stmt = l.root_stmt();
@@ -103,6 +103,9 @@ class LLVMCodeGenImpl : public IRVisitor {
   void visit(const Free* v) override;
   void visit(const Cond* v) override;
 
+  void emitSerialFor(const For* v, llvm::Value* start, llvm::Value* stop);
+  void emitParallelFor(const For* v);
+
   llvm::Value* emitUnmaskedLoad(llvm::Value* addr, llvm::Value* idx);
   llvm::Value* emitMaskedLoad(
       llvm::Value* addr,
@@ -435,7 +438,7 @@ void LLVMCodeGenImpl::emitKernel(
 #if DEBUG_PRINT
   llvm::errs() << *module_;
 #endif
-  if (llvm::verifyFunction(*fn_, &llvm::outs())) {
+  if (llvm::verifyModule(*module_, &llvm::outs())) {
     throw std::runtime_error("Function verification failed");
   }
   optimize(*module_);
@@ -961,12 +964,24 @@ void LLVMCodeGenImpl::visit(const Load* v) {
 }
 
 void LLVMCodeGenImpl::visit(const For* v) {
+  if (v->loop_options().is_parallel()) {
+    emitParallelFor(v);
+    return;
+  }
+
   // Create "start" and "stop" values.
   v->start()->accept(this);
   auto start = this->value_;
   v->stop()->accept(this);
   auto stop = this->value_;
 
+  emitSerialFor(v, start, stop);
+}
+
+void LLVMCodeGenImpl::emitSerialFor(
+    const For* v,
+    llvm::Value* start,
+    llvm::Value* stop) {
   // Create block for loop condition test.
   auto preheader = irb_.GetInsertBlock();
   auto condBlock = llvm::BasicBlock::Create(getContext(), "cond", fn_);
@@ -1010,6 +1025,95 @@ void LLVMCodeGenImpl::visit(const For* v) {
   value_ = llvm::ConstantInt::get(IntTy_, 0);
 }
 
+// A parallel loop is outlined into a function
+//   void parallel_body(int64_t begin, int64_t end, int8_t* env)
+// that runs the iterations [begin, end) serially, and is dispatched over
+// ATen's intra-op thread pool by nnc_parallel_for (see llvm_jit.cpp). The
+// kernel arguments and every value bound in the enclosing scopes are passed
+// to it through `env`, a struct on the stack of the calling function.
+void LLVMCodeGenImpl::emitParallelFor(const For* v) {
+  v->start()->accept(this);
+  auto start = irb_.CreateSExtOrTrunc(value_, LongTy_);
+  v->stop()->accept(this);
+  auto stop = irb_.CreateSExtOrTrunc(value_, LongTy_);
+
+  std::vector<const Var*> capturedVars;
+  std::vector<llvm::Value*> capturedVals;
+  std::vector<llvm::Type*> capturedTypes;
+  for (const auto& p : varToArg_) {
+    capturedVars.push_back(p.first);
+    capturedVals.push_back(fn_->arg_begin() + p.second);
+  }
+  for (const auto& p : varToVal_) {
+    capturedVars.push_back(p.first);
+    capturedVals.push_back(p.second);
+  }
+  for (llvm::Value* val : capturedVals) {
+    capturedTypes.push_back(val->getType());
+  }
+  auto envTy = llvm::StructType::get(getContext(), capturedTypes);
+
+  // Allocate the env in the entry block, so that a parallel loop nested in
+  // a serial one doesn't grow the stack.
+  llvm::IRBuilder<> entryBuilder(
+      &fn_->getEntryBlock(), fn_->getEntryBlock().begin());
+  auto env = entryBuilder.CreateAlloca(envTy);
+  for (size_t i = 0; i < capturedVals.size(); i++) {
+    irb_.CreateStore(capturedVals[i], irb_.CreateStructGEP(envTy, env, i));
+  }
+
+  auto bytePtrTy = llvm::Type::getInt8PtrTy(getContext());
+  auto bodyTy = llvm::FunctionType::get(
+      llvm::Type::getVoidTy(getContext()),
+      {LongTy_, LongTy_, bytePtrTy},
+      false);
+  auto bodyFn = llvm::Function::Create(
+      bodyTy, llvm::Function::PrivateLinkage, "parallel_body", module_.get());
+
+  // Emit the body function, with the captured values in place of the
+  // arguments and bindings of the kernel.
+  auto savedFn = fn_;
+  auto savedBlock = irb_.GetInsertBlock();
+  auto savedArgs = std::move(varToArg_);
+  auto savedVals = std::move(varToVal_);
+  varToArg_.clear();
+  varToVal_.clear();
+
+  fn_ = bodyFn;
+  irb_.SetInsertPoint(llvm::BasicBlock::Create(getContext(), "entry", fn_));
+  auto bodyArgs = bodyFn->arg_begin();
+  auto begin = irb_.CreateTrunc(bodyArgs, IntTy_);
+  auto end = irb_.CreateTrunc(bodyArgs + 1, IntTy_);
+  auto bodyEnv = irb_.CreatePointerCast(bodyArgs + 2, envTy->getPointerTo());
+  for (size_t i = 0; i < capturedVars.size(); i++) {
+    varToVal_[capturedVars[i]] =
+        irb_.CreateLoad(irb_.CreateStructGEP(envTy, bodyEnv, i));
+  }
+  emitSerialFor(v, begin, end);
+  irb_.CreateRetVoid();
+
+  fn_ = savedFn;
+  varToArg_ = std::move(savedArgs);
+  varToVal_ = std::move(savedVals);
+  irb_.SetInsertPoint(savedBlock);
+
+  auto parallelFor = module_->getOrInsertFunction(
+      "nnc_parallel_for",
+      llvm::FunctionType::get(
+          llvm::Type::getVoidTy(getContext()),
+          {LongTy_, LongTy_, LongTy_, bodyTy->getPointerTo(), bytePtrTy},
+          false));
+  irb_.CreateCall(
+      parallelFor,
+      {start,
+       stop,
+       llvm::ConstantInt::getSigned(
+           LongTy_, v->loop_options().parallel_grain_size()),
+       bodyFn,
+       irb_.CreatePointerCast(env, bytePtrTy)});
+  value_ = llvm::ConstantInt::get(IntTy_, 0);
+}
+
 void LLVMCodeGenImpl::visit(const Block* v) {
   for (auto pair : v->varBindings()) {
     const Var* v = pair.first;
@@ -2,6 +2,7 @@
 
 #include <torch/csrc/jit/tensorexpr/llvm_jit.h>
 
+#include <ATen/Parallel.h>
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
 #include <sleef.h>
 #include <algorithm>
@@ -9,6 +10,23 @@
 #include <string>
 #include <vector>
 
+namespace {
+
+// Runs the outlined body of a parallel loop, see
+// LLVMCodeGenImpl::emitParallelFor.
+void nnc_parallel_for(
+    int64_t start,
+    int64_t stop,
+    int64_t grain_size,
+    void (*body)(int64_t, int64_t, void*),
+    void* env) {
+  at::parallel_for(start, stop, grain_size, [&](int64_t begin, int64_t end) {
+    body(begin, end, env);
+  });
+}
+
+} // namespace
+
 namespace llvm {
 namespace orc {
 
@@ -416,6 +434,11 @@ class TORCH_API PytorchLLVMJITImpl {
         *Mangle("Sleef_fmodd4"),
         {llvm::pointerToJITTargetAddress(&Sleef_fmodd4), {}}));
 #endif
+
+    // Runtime support for parallel loops
+    cantFail(LLJ->defineAbsolute(
+        *Mangle("nnc_parallel_for"),
+        {llvm::pointerToJITTargetAddress(&nnc_parallel_for), {}}));
   }
 
   Error addModule(ThreadSafeModule M) {
@@ -497,6 +497,10 @@ class TORCH_API LoopOptions {
     if (is_gpu_thread_index()) {
       throw std::runtime_error("Cannot set both gpu block and thread index");
     }
+    if (is_parallel()) {
+      throw std::runtime_error(
+          "Cannot set a gpu block index on a parallel loop");
+    }
     if (is_gpu_block_index() && gpu_block_index() != index) {
       throw std::runtime_error("Cannot set a previously set block index");
     }
@@ -535,29 +539,57 @@ class TORCH_API LoopOptions {
     if (is_gpu_block_index()) {
       throw std::runtime_error("Cannot set both gpu thread and block index");
     }
+    if (is_parallel()) {
+      throw std::runtime_error(
+          "Cannot set a gpu thread index on a parallel loop");
+    }
     if (is_gpu_thread_index() && gpu_thread_index() != index) {
       throw std::runtime_error("Cannot set a previously set thread index");
     }
     gpu_thread_index_ = index;
   }
 
+  // CPU parallel loop, run over ATen's intra-op thread pool in chunks of at
+  // least `parallel_grain_size` iterations
+  bool is_parallel() const {
+    return parallel_grain_size_ > 0;
+  }
+
+  int64_t parallel_grain_size() const {
+    return parallel_grain_size_;
+  }
+
+  void set_parallel(int64_t grain_size = 1) {
+    if (grain_size < 1) {
+      throw malformed_input("invalid parallel grain size");
+    }
+    if (is_gpu_block_index() || is_gpu_thread_index()) {
+      throw std::runtime_error("Cannot parallelize a gpu loop");
+    }
+    parallel_grain_size_ = grain_size;
+  }
+
   std::string ToString() const {
     std::ostringstream oss;
     if (is_gpu_block_index()) {
       oss << gpu_block_index_str();
     } else if (is_gpu_thread_index()) {
       oss << gpu_thread_index_str();
+    } else if (is_parallel()) {
+      oss << "parallel(grain_size=" << parallel_grain_size_ << ")";
     }
     return oss.str();
   }
 
   bool isDefault() const {
-    return gpu_block_index_ == IDX_UNSET && gpu_thread_index_ == IDX_UNSET;
+    return gpu_block_index_ == IDX_UNSET && gpu_thread_index_ == IDX_UNSET &&
+        !is_parallel();
   }
 
  private:
   int gpu_block_index_{IDX_UNSET};
   int gpu_thread_index_{IDX_UNSET};
+  int64_t parallel_grain_size_{0};
 };
 
 class TORCH_API For : public StmtNode<For> {
@@ -651,6 +683,10 @@ class TORCH_API For : public StmtNode<For> {
     loop_options_.set_gpu_thread_index(thread_index);
   }
 
+  void set_parallel(int64_t grain_size) {
+    loop_options_.set_parallel(grain_size);
+  }
+
   For* cloneWithNewBody(Stmt* body) const {
     return new For(var_, start_, stop_, body, loop_options_);
   }
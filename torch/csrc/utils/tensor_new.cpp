@@ -630,6 +630,37 @@ Tensor sparse_coo_tensor_ctor(c10::DispatchKey dispatch_key, at::ScalarType scal
   throw std::runtime_error("sparse_coo_tensor(): invalid arguments");
 }
 
+Tensor sparse_csr_tensor_ctor(c10::DispatchKey dispatch_key, at::ScalarType scalar_type, PyObject* args, PyObject* kwargs) {
+  static PythonArgParser parser({
+    "sparse_csr_tensor(PyObject* crow_indices, PyObject* col_indices, PyObject* values, *, ScalarType dtype=None, Device? device=None, bool requires_grad=False)",
+    "sparse_csr_tensor(PyObject* crow_indices, PyObject* col_indices, PyObject* values, IntArrayRef size, *, ScalarType dtype=None, Device? device=None, bool requires_grad=False)",
+  });
+
+  ParsedArgs<7> parsed_args;
+  auto r = parser.parse(args, kwargs, parsed_args);
+  if (r.idx == 0) {
+    bool type_inference = r.isNone(3);
+    const auto inferred_dispatch_key = denseTypeIdWithDefault(r, 4, dispatch_key);
+    const auto inferred_scalar_type = r.scalartypeWithDefault(3, scalar_type);
+    at::OptionalDeviceGuard device_guard(r.deviceOptional(4));
+    // if no dtype provided, infer type based on value type.
+    Tensor values = internal_new_from_data(inferred_dispatch_key, inferred_scalar_type, r.deviceOptional(4), r.pyobject(2), false, true, type_inference);
+    Tensor crow_indices = internal_new_from_data(legacyExtractDispatchKey(values.key_set()), kLong, r.deviceOptional(4), r.pyobject(0), false, true, false);
+    Tensor col_indices = internal_new_from_data(legacyExtractDispatchKey(values.key_set()), kLong, r.deviceOptional(4), r.pyobject(1), false, true, false);
+    return at::sparse_csr_tensor(crow_indices, col_indices, values, values.options().layout(at::kSparseCsr)).set_requires_grad(r.toBool(5));
+  } else if (r.idx == 1) {
+    bool type_inference = r.isNone(4);
+    const auto inferred_dispatch_key = denseTypeIdWithDefault(r, 5, dispatch_key);
+    const auto inferred_scalar_type = r.scalartypeWithDefault(4, scalar_type);
+    at::OptionalDeviceGuard device_guard(r.deviceOptional(5));
+    Tensor values = internal_new_from_data(inferred_dispatch_key, inferred_scalar_type, r.deviceOptional(5), r.pyobject(2), false, true, type_inference);
+    Tensor crow_indices = internal_new_from_data(legacyExtractDispatchKey(values.key_set()), kLong, r.deviceOptional(5), r.pyobject(0), false, true, false);
+    Tensor col_indices = internal_new_from_data(legacyExtractDispatchKey(values.key_set()), kLong, r.deviceOptional(5), r.pyobject(1), false, true, false);
+    return at::sparse_csr_tensor(crow_indices, col_indices, values, r.intlist(3), values.options().layout(at::kSparseCsr)).set_requires_grad(r.toBool(6));
+  }
+  throw std::runtime_error("sparse_csr_tensor(): invalid arguments");
+}
+
 Tensor _sparse_coo_tensor_unsafe_ctor(c10::DispatchKey dispatch_key, at::ScalarType scalar_type, PyObject* args, PyObject* kwargs) {
   enum {
     ARG_INDICES = 0,
@@ -2008,6 +2008,73 @@ def embedding_bag(input, weight, offsets=None, max_norm=None, norm_type=2,
     return ret
 
 
+def embedding_bag_grouped(inputs, weights, offsets, mode='sum', per_sample_weights=None,
+                          include_last_offset=False):
+    # type: (List[Tensor], List[Tensor], List[Tensor], str, Optional[List[Tensor]], bool) -> List[Tensor]
+    r"""Computes :func:`embedding_bag` for several embedding tables in one call.
+
+    On CPU, when no gradient is required, the bags of all tables are reduced
+    by a single fused kernel that balances the work of all tables across
+    threads, instead of one :func:`embedding_bag` call per table. Otherwise
+    the tables are reduced one by one with :func:`embedding_bag`.
+
+    The fused kernel accepts ``float``, ``double``, ``half`` and ``bfloat16``
+    weights, as well as 8-bit rowwise quantized weights: ``uint8`` tables whose
+    rows hold the quantized values followed by a float scale and a float bias, as
+    produced by ``torch.ops.quantized.embedding_bag_byte_prepack``. Quantized
+    tables return ``float`` embeddings.
+
+    Args:
+        inputs (list of LongTensor): 1D indices into each table, one tensor per table
+        weights (list of Tensor): the embedding tables
+        offsets (list of LongTensor): the starting index position of each bag in
+            the corresponding tensor of :attr:`inputs`
+        mode (string, optional): ``"sum"``, ``"mean"`` or ``"max"``. Specifies the way
+            to reduce the bags. Default: ``"sum"``
+        per_sample_weights (list of Tensor, optional): one tensor of weights per table,
+            each with the same shape as the corresponding tensor of :attr:`inputs`.
+            Only supported for ``mode="sum"``.
+        include_last_offset (bool, optional): if ``True``, the size of each tensor of
+            :attr:`offsets` is equal to the number of bags + 1.
+
+    Returns:
+        A list with one tensor of shape `(B_i, embedding_dim_i)` per table.
+
+    Examples::
+
+        >>> weights = [torch.rand(10, 3), torch.rand(20, 4)]
+        >>> inputs = [torch.tensor([1, 2, 4, 5]), torch.tensor([7, 19])]
+        >>> offsets = [torch.tensor([0, 2]), torch.tensor([0, 1])]
+        >>> [o.shape for o in F.embedding_bag_grouped(inputs, weights, offsets)]
+        [torch.Size([2, 3]), torch.Size([2, 4])]
+    """
+    if not torch.jit.is_scripting():
+        tens_ops = tuple(t for arg in (inputs, weights, offsets, per_sample_weights) if arg is not None
+                         for t in (arg if isinstance(arg, (list, tuple)) else (arg,)))
+        if any([type(t) is not Tensor for t in tens_ops]) and has_torch_function(tens_ops):
+            return handle_torch_function(
+                embedding_bag_grouped, tens_ops, inputs, weights, offsets, mode=mode,
+                per_sample_weights=per_sample_weights, include_last_offset=include_last_offset)
+    if mode == 'sum':
+        mode_enum = 0
+    elif mode == 'mean':
+        mode_enum = 1
+    elif mode == 'max':
+        mode_enum = 2
+    else:
+        raise ValueError("mode has to be one of sum, mean or max")
+
+    if per_sample_weights is None:
+        per_sample_weights = []
+    elif mode != 'sum':
+        raise NotImplementedError("embedding_bag_grouped: per_sample_weights was not None. "
+                                  "per_sample_weights is only supported for mode='sum' "
+                                  "(got mode='{}').".format(mode))
+
+    return torch.embedding_bag_grouped(weights, inputs, offsets, per_sample_weights,
+                                       mode_enum, include_last_offset)
+
+
 def _verify_batch_size(size):
     # type: (List[int]) -> None
     # XXX: JIT script does not support the reduce from functools, and mul op is a
@@ -2454,6 +2521,13 @@ def cross_entropy(input, target, weight=None, size_average=None, ignore_index=-1
                 reduction=reduction)
     if size_average is not None or reduce is not None:
         reduction = _Reduction.legacy_get_string(size_average, reduce)
+    # mismatched shapes go through nll_loss for its error messages
+    if input.dim() == 2 and input.size(0) == target.size(0):
+        if not torch.jit.is_scripting() and torch._C._get_tracing_state():
+            # traced graphs keep log_softmax + nll_loss, which the ONNX
+            # exporter fuses into SoftmaxCrossEntropyLoss
+            return nll_loss(log_softmax(input, 1), target, weight, None, ignore_index, None, reduction)
+        return torch._C._nn.cross_entropy_loss(input, target, weight, _Reduction.get_enum(reduction), ignore_index)
     return nll_loss(log_softmax(input, 1), target, weight, None, ignore_index, None, reduction)
 
 
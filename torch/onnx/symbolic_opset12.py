@@ -58,6 +58,22 @@ def nll_loss2d(g, self, target, weight, reduction, ignore_index):
     return nll_loss(g, self, target, weight, reduction, ignore_index)
 
 
+def cross_entropy_loss(g, self, target, weight, reduction, ignore_index):
+    # emits the node that the ONNX peephole pass fuses log_softmax + nll_loss into
+    reduction = sym_help._maybe_get_const(reduction, 'i')
+    reduction_vals = ['none', 'mean', 'sum']
+    reduction = reduction_vals[reduction]
+
+    inputs = [self, target]
+    if not weight.node().mustBeNone():
+        inputs.append(weight)
+
+    ignore_index = sym_help._maybe_get_const(ignore_index, 'i')
+    if ignore_index == -100:
+        return g.op("SoftmaxCrossEntropyLoss", *inputs, reduction_s=reduction)
+    return g.op("SoftmaxCrossEntropyLoss", *inputs, reduction_s=reduction, ignore_index_i=ignore_index)
+
+
 def celu(g, self, alpha):
     alpha = sym_help._maybe_get_const(alpha, 'f')
     # if the input is of type double cast it to float
@@ -122,6 +122,13 @@ class Tensor(torch._C._TensorBase):
                 raise NotImplementedError(
                     'sparse tensor __reduce_ex__ for layout `%s`' % (self.layout))
             return (torch._utils._rebuild_sparse_tensor, args)
+        elif self.layout == torch.sparse_csr:
+            args = (self.layout,
+                    (self.crow_indices(),
+                     self.col_indices(),
+                     self.values(),
+                     self.size()))
+            return (torch._utils._rebuild_sparse_tensor, args)
         else:
             args = (self.storage(),
                     self.storage_offset(),
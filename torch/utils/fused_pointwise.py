@@ -0,0 +1,360 @@
+"""
+Deferred execution of chains of pointwise ops in eager mode.
+
+Every eager pointwise op makes a full pass over memory, so
+``x.mul(a).add_(b).relu_()`` reads and writes ``x``-sized tensors three times.
+:func:`defer` wraps a tensor in a :class:`DeferredTensor` that records
+consecutive pointwise ops instead of running them, and runs the whole chain
+as a single pass (``torch._fused_pointwise``) when the result is needed.
+"""
+
+import numbers
+import weakref
+
+import torch
+
+__all__ = ['defer', 'DeferredTensor']
+
+# Must match FusedPointwiseOp in aten/src/ATen/native/PointwiseOps.h.
+_ADD_TENSOR = 0
+_SUB_TENSOR = 1
+_MUL_TENSOR = 2
+_DIV_TENSOR = 3
+_ADD_SCALAR = 4
+_MUL_SCALAR = 5
+_DIV_SCALAR = 6
+_CLAMP_MIN = 7
+_CLAMP_MAX = 8
+_RELU = 9
+_SIGMOID = 10
+_TANH = 11
+_EXP = 12
+_LOG = 13
+_NEG = 14
+_ABS = 15
+_SQRT = 16
+_RECIPROCAL = 17
+
+_UNARY_OPS = {
+    'relu': _RELU,
+    'sigmoid': _SIGMOID,
+    'tanh': _TANH,
+    'exp': _EXP,
+    'log': _LOG,
+    'neg': _NEG,
+    'abs': _ABS,
+    'sqrt': _SQRT,
+    'reciprocal': _RECIPROCAL,
+}
+
+
+def defer(tensor):
+    r"""Returns a :class:`DeferredTensor` that records the pointwise ops applied
+    to :attr:`tensor` and runs them in a single pass over memory.
+
+    Example::
+
+        >>> from torch.utils.fused_pointwise import defer
+        >>> x = torch.randn(1000000)
+        >>> y = defer(x).mul(2).add_(b).relu_()  # nothing runs yet
+        >>> z = y.sum()                           # one fused pass, then sum
+    """
+    if isinstance(tensor, DeferredTensor):
+        return tensor
+    return DeferredTensor(tensor)
+
+
+def _materialize(obj):
+    if isinstance(obj, DeferredTensor):
+        return obj.materialize()
+    if isinstance(obj, (list, tuple)):
+        return type(obj)(_materialize(o) for o in obj)
+    if isinstance(obj, dict):
+        return {k: _materialize(v) for k, v in obj.items()}
+    return obj
+
+
+class DeferredTensor(object):
+    r"""A tensor whose pending pointwise ops have not been run yet.
+
+    Out-of-place and in-place ``add``, ``sub``, ``mul``, ``div`` (with a tensor
+    of the same shape, dtype and device, or a number), ``clamp``, ``relu``,
+    ``sigmoid``, ``tanh``, ``exp``, ``log``, ``neg``, ``abs``, ``sqrt`` and
+    ``reciprocal`` are recorded and return a :class:`DeferredTensor`. Any other
+    use, either as a method or attribute (``y.sum()``, ``y.shape`` excepted) or
+    as an argument of a ``torch`` function, first runs the recorded ops as one
+    fused pass and then proceeds on the resulting tensor.
+
+    Only CPU float and double tensors that do not require gradients are
+    deferred; ops on any other tensor run eagerly, so wrapping a tensor never
+    changes results beyond rounding.
+
+    In-place ops on the wrapped tensor are applied to it when the chain is
+    run, so other references to the same tensor see the update only after
+    :meth:`materialize` (or any non-pointwise use of the deferred tensor).
+    Likewise, the wrapped tensor and the tensors used as operands must not be
+    modified by other means while ops that read them are pending.
+    """
+
+    def __init__(self, base):
+        self._base = base
+        # Recorded steps: op codes, one scalar per step, and one operand per
+        # tensor step, in order.
+        self._ops = []
+        self._scalars = []
+        self._operands = []
+        # Whether the recorded steps write back into _base.
+        self._inplace = False
+        # Out-of-place chains recorded from this one that still read _base.
+        self._dependents = []
+
+    @property
+    def shape(self):
+        return self._base.shape
+
+    def size(self, dim=None):
+        return self._base.size() if dim is None else self._base.size(dim)
+
+    def dim(self):
+        return self._base.dim()
+
+    @property
+    def dtype(self):
+        return self._base.dtype
+
+    @property
+    def device(self):
+        return self._base.device
+
+    def _fusible(self):
+        base = self._base
+        return (base.device.type == 'cpu' and base.layout == torch.strided and
+                base.dtype in (torch.float, torch.double) and
+                not (base.requires_grad and torch.is_grad_enabled()))
+
+    def materialize(self):
+        r"""Runs the recorded ops and returns the resulting tensor."""
+        if self._ops:
+            if self._inplace:
+                torch._fused_pointwise(self._base, self._operands, self._ops, self._scalars,
+                                       out=self._base)
+            else:
+                self._base = torch._fused_pointwise(self._base, self._operands, self._ops,
+                                                    self._scalars)
+            self._ops = []
+            self._scalars = []
+            self._operands = []
+            self._inplace = False
+        return self._base
+
+    def _before_write(self):
+        # Chains that read _base have to run before _base is overwritten.
+        for ref in self._dependents:
+            dependent = ref()
+            if dependent is not None and dependent._base is self._base:
+                dependent.materialize()
+        self._dependents = []
+
+    def _record(self, op, scalar, operand, inplace):
+        if inplace:
+            if not self._ops:
+                self._before_write()
+                self._inplace = True
+            target = self
+        else:
+            if self._inplace and self._ops:
+                self.materialize()
+            target = DeferredTensor(self._base)
+            target._ops = list(self._ops)
+            target._scalars = list(self._scalars)
+            target._operands = list(self._operands)
+            self._dependents.append(weakref.ref(target))
+        target._ops.append(op)
+        target._scalars.append(float(scalar))
+        if operand is not None:
+            target._operands.append(operand)
+        return target
+
+    def _eager(self, name, inplace, *args, **kwargs):
+        if inplace:
+            self._before_write()
+        result = getattr(self.materialize(), name + ('_' if inplace else ''))(
+            *_materialize(args), **_materialize(kwargs))
+        return self if inplace else DeferredTensor(result)
+
+    def _tensor_operand(self, other):
+        # A tensor that can be read in the fused pass, or None.
+        other = _materialize(other)
+        base = self._base
+        if (isinstance(other, torch.Tensor) and other.shape == base.shape and
+                other.dtype == base.dtype and other.device == base.device and
+                other.layout == torch.strided and
+                not (other.requires_grad and torch.is_grad_enabled())):
+            # The fused pass reads operands before any step is written back,
+            # so an operand sharing memory with the output of a pending
+            # in-place chain has to see the chain's result first.
+            if self._inplace and self._ops and other.storage().data_ptr() == base.storage().data_ptr():
+                self.materialize()
+            return other
+        return None
+
+    def _binary(self, name, tensor_op, scalar_op, other, alpha, inplace):
+        if self._fusible():
+            if isinstance(other, numbers.Real) and not isinstance(other, bool):
+                if tensor_op == _SUB_TENSOR:
+                    return self._record(_ADD_SCALAR, -alpha * other, None, inplace)
+                if tensor_op == _ADD_TENSOR:
+                    return self._record(_ADD_SCALAR, alpha * other, None, inplace)
+                return self._record(scalar_op, other, None, inplace)
+            operand = self._tensor_operand(other)
+            if operand is not None:
+                return self._record(tensor_op, alpha, operand, inplace)
+        if tensor_op in (_ADD_TENSOR, _SUB_TENSOR):
+            return self._eager(name, inplace, other, alpha=alpha)
+        return self._eager(name, inplace, other)
+
+    def add(self, other, alpha=1):
+        return self._binary('add', _ADD_TENSOR, _ADD_SCALAR, other, alpha, False)
+
+    def add_(self, other, alpha=1):
+        return self._binary('add', _ADD_TENSOR, _ADD_SCALAR, other, alpha, True)
+
+    def sub(self, other, alpha=1):
+        return self._binary('sub', _SUB_TENSOR, _ADD_SCALAR, other, alpha, False)
+
+    def sub_(self, other, alpha=1):
+        return self._binary('sub', _SUB_TENSOR, _ADD_SCALAR, other, alpha, True)
+
+    def mul(self, other):
+        return self._binary('mul', _MUL_TENSOR, _MUL_SCALAR, other, 1, False)
+
+    def mul_(self, other):
+        return self._binary('mul', _MUL_TENSOR, _MUL_SCALAR, other, 1, True)
+
+    def div(self, other):
+        return self._binary('div', _DIV_TENSOR, _DIV_SCALAR, other, 1, False)
+
+    def div_(self, other):
+        return self._binary('div', _DIV_TENSOR, _DIV_SCALAR, other, 1, True)
+
+    def _clamp(self, min, max, inplace):
+        if not self._fusible():
+            return self._eager('clamp', inplace, min, max)
+        result = self
+        if min is not None:
+            result = result._record(_CLAMP_MIN, min, None, inplace)
+        if max is not None:
+            # The chain now writes its own output, so the second step can
+            # always be recorded in place.
+            result = result._record(_CLAMP_MAX, max, None, inplace or min is not None)
+        return result
+
+    def clamp(self, min=None, max=None):
+        return self._clamp(min, max, False)
+
+    def clamp_(self, min=None, max=None):
+        return self._clamp(min, max, True)
+
+    def _unary(self, name, inplace):
+        if not self._fusible():
+            return self._eager(name, inplace)
+        return self._record(_UNARY_OPS[name], 0, None, inplace)
+
+    def relu(self):
+        return self._unary('relu', False)
+
+    def relu_(self):
+        return self._unary('relu', True)
+
+    def sigmoid(self):
+        return self._unary('sigmoid', False)
+
+    def sigmoid_(self):
+        return self._unary('sigmoid', True)
+
+    def tanh(self):
+        return self._unary('tanh', False)
+
+    def tanh_(self):
+        return self._unary('tanh', True)
+
+    def exp(self):
+        return self._unary('exp', False)
+
+    def exp_(self):
+        return self._unary('exp', True)
+
+    def log(self):
+        return self._unary('log', False)
+
+    def log_(self):
+        return self._unary('log', True)
+
+    def neg(self):
+        return self._unary('neg', False)
+
+    def neg_(self):
+        return self._unary('neg', True)
+
+    def abs(self):
+        return self._unary('abs', False)
+
+    def abs_(self):
+        return self._unary('abs', True)
+
+    def sqrt(self):
+        return self._unary('sqrt', False)
+
+    def sqrt_(self):
+        return self._unary('sqrt', True)
+
+    def reciprocal(self):
+        return self._unary('reciprocal', False)
+
+    def reciprocal_(self):
+        return self._unary('reciprocal', True)
+
+    __add__ = add
+    __radd__ = add
+    __iadd__ = add_
+    __sub__ = sub
+    __isub__ = sub_
+    __mul__ = mul
+    __rmul__ = mul
+    __imul__ = mul_
+    __truediv__ = div
+    __itruediv__ = div_
+    __neg__ = neg
+    __abs__ = abs
+
+    def __rsub__(self, other):
+        return self.neg().add(other)
+
+    def __getattr__(self, name):
+        # Anything that is not recorded runs the pending ops first.
+        if name.startswith('_'):
+            raise AttributeError(name)
+        return getattr(self.materialize(), name)
+
+    def __repr__(self):
+        return repr(self.materialize())
+
+    def __len__(self):
+        return len(self._base)
+
+    def __torch_function__(self, func, types, args=(), kwargs=None):
+        if kwargs is None:
+            kwargs = {}
+        name = getattr(func, '__name__', None)
+        if (args and args[0] is self and name in _TORCH_FUNCTIONS and
+                getattr(torch, name, None) is func):
+            return getattr(self, name)(*args[1:], **kwargs)
+        return func(*_materialize(args), **_materialize(kwargs))
+
+
+# torch.<name>(deferred, ...) is recorded like deferred.<name>(...).
+_TORCH_FUNCTIONS = {
+    'add', 'sub', 'mul', 'div', 'clamp', 'relu', 'sigmoid', 'tanh', 'exp', 'log', 'neg', 'abs',
+    'sqrt', 'reciprocal', 'relu_', 'sigmoid_', 'tanh_', 'exp_', 'log_', 'neg_', 'abs_', 'sqrt_',
+    'reciprocal_', 'clamp_',
+}
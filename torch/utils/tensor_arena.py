@@ -0,0 +1,93 @@
+"""
+Preallocated output buffers for ``torch.cat`` and ``torch.stack``.
+
+Batching many small request tensors allocates a new output for every batch.
+A :class:`TensorArena` owns one buffer and hands out views of it as the
+outputs of :meth:`TensorArena.cat` and :meth:`TensorArena.stack`, so the
+concatenation writes straight into memory that is reused from batch to
+batch.
+"""
+
+import functools
+import operator
+
+import torch
+
+__all__ = ['TensorArena']
+
+
+def _cat_shape(tensors, dim):
+    # 1-D empty tensors are skipped by torch.cat.
+    tensors = [t for t in tensors if not (t.dim() == 1 and t.numel() == 0)]
+    if not tensors:
+        return [0]
+    shape = list(tensors[0].shape)
+    if dim < 0:
+        dim += len(shape)
+    shape[dim] = sum(t.shape[dim] for t in tensors)
+    return shape
+
+
+class TensorArena(object):
+    r"""A preallocated buffer that :meth:`cat` and :meth:`stack` write their
+    results into.
+
+    Every call takes the next free part of the buffer and returns it as a
+    view holding the result; :meth:`reset` makes the whole buffer free again,
+    after which the views returned so far must no longer be used.
+
+    Args:
+        numel (int): number of elements of the buffer.
+        dtype (:class:`torch.dtype`, optional): dtype of the buffer, and so of
+            every result. Inputs of other dtypes are converted as by the
+            ``out=`` argument of :func:`torch.cat`. Default: the default dtype.
+        device (:class:`torch.device`, optional): device of the buffer.
+            Default: ``'cpu'``.
+
+    Example::
+
+        >>> from torch.utils.tensor_arena import TensorArena
+        >>> arena = TensorArena(1 << 20)
+        >>> for requests in batches:
+        ...     batch = arena.stack(requests)  # a view of the arena
+        ...     results = model(batch)
+        ...     arena.reset()
+    """
+
+    def __init__(self, numel, dtype=None, device='cpu'):
+        self.buffer = torch.empty(numel, dtype=dtype, device=device)
+        self._offset = 0
+
+    @property
+    def free(self):
+        r"""Number of elements of the buffer not taken by a result."""
+        return self.buffer.numel() - self._offset
+
+    def reset(self):
+        r"""Makes the whole buffer available again."""
+        self._offset = 0
+
+    def _run(self, shape, fn):
+        numel = functools.reduce(operator.mul, shape, 1)
+        if numel > self.free:
+            raise RuntimeError(
+                "TensorArena: a result of {} elements does not fit in the {} free "
+                "elements of the arena".format(numel, self.free))
+        out = self.buffer[self._offset:self._offset + numel].view(shape)
+        result = fn(out)
+        self._offset += numel
+        return result
+
+    def cat(self, tensors, dim=0):
+        r"""Same as :func:`torch.cat`, with the result stored in the arena."""
+        return self._run(_cat_shape(tensors, dim), lambda out: torch.cat(tensors, dim, out=out))
+
+    def stack(self, tensors, dim=0):
+        r"""Same as :func:`torch.stack`, with the result stored in the arena."""
+        if len(tensors) == 0:
+            raise RuntimeError("stack expects a non-empty TensorList")
+        shape = list(tensors[0].shape)
+        if dim < 0:
+            dim += len(shape) + 1
+        shape.insert(dim, len(tensors))
+        return self._run(shape, lambda out: torch.stack(tensors, dim, out=out))